@@ -113,6 +113,7 @@ THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
 #include <stdarg.h>
 
 #include <iostream>
+#include <vector>
 #include <Calculus_cpp.h>
 
 class user_algebraic_operator
@@ -139,7 +140,7 @@ public:
 	    if (m_pP != NULL)
 		    m_pP->addref();
     }
-    user_algebraic_operator::~user_algebraic_operator() {
+    ~user_algebraic_operator() {
 	    if (m_pP != NULL)
 		    m_pP->release();
     }
@@ -168,7 +169,23 @@ public:
     }
 
     double operator()(double * pxs) const {
-        return m_pP->eval(pxs);
+        return m_pP->eval_tape(pxs);
+    }
+
+    double gradient(double * pxs,double * pd_gradient) const {
+        return m_pP->eval_gradient(pxs,pd_gradient);
+    }
+
+    double eval_dual(double * pxs,const double * pd_direction,double * pd_tangent) const {
+        return m_pP->eval_dual(pxs,pd_direction,pd_tangent);
+    }
+
+    void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) const {
+        m_pP->eval_batch(ppd_columns,st_n,pd_out);
+    }
+
+    void eval_batch_compiled(const double* const* ppd_columns,size_t st_n,double* pd_out) const {
+        m_pP->eval_batch_compiled(ppd_columns,st_n,pd_out);
     }
 
     double operator()(double x,...) const {
@@ -182,19 +199,18 @@ public:
 		    for(unsigned int i = 1;i < uiNumberOfvariables;i++)
 			    pVars[i] = va_arg(marker,double);
 		    va_end(marker);
-            val = m_pP->eval(pVars);
+            val = m_pP->eval_tape(pVars);
 		    delete [] pVars;
 	    }
-        else val = m_pP->eval(NULL);
+        else val = m_pP->eval_tape(NULL);
 	    return val;
     }
     inline std::ostream& operator<<(std::ostream &s) {
         if (!m_pP)
             return s;
-        char * pBuffer = new char[m_pP->to_string(NULL)+1];
-        m_pP->to_string(pBuffer);
-        s << pBuffer;
-        delete [] pBuffer;
+        calculus::string_writer sw;
+        m_pP->write_string(&sw);
+        s << sw.get_string();
         return s;
     }
     calculus::algebraic_operator * get_partial_derivative(calculus::variable* pvar)
@@ -220,6 +236,35 @@ public:
 };
 typedef user_algebraic_operator Function;
 
+//EVALUATES st_n POINTS OF f ON THE THREAD POOL, pd_points HOLDS THE f->get_number_of_variables() VALUES OF EACH POINT IN TURN
+inline void parallel_eval(const Function & f,const double* pd_points,size_t st_n,double* pd_out) {
+    f->eval_parallel(pd_points,st_n,pd_out);
+}
+
+//ONE Function PER LINE OF THE FILE, PARSED ON THE THREAD POOL, EMPTY FOR A BLANK OR INVALID LINE.  NO LINES WHEN THE FILE CAN'T BE READ
+inline std::vector<Function> load_functions(const char* psc_path) {
+    int i_num_lines;
+    calculus::algebraic_operator** ppao = calculus::algebra_parser::get_service()->parse_file(psc_path,&i_num_lines);
+    std::vector<Function> functions(ppao,ppao+((ppao)?i_num_lines:0));
+    calculus::algebra_parser::release_lines(ppao,i_num_lines);
+    return functions;
+}
+
+//A COMPILED Function FROM THE PARSE CACHE, REPEATED TEXTS ARE NEITHER PARSED NOR COMPILED AGAIN
+inline Function parse_cached(const char* psc_function) {
+    calculus::algebraic_operator* pao = calculus::algebra_parser::get_service()->parse_cached(psc_function);
+    Function f(pao);
+    if (pao != NULL)
+        pao->release();
+    return f;
+}
+
+//A COMPILED FUNCTION FROM AN IMAGE WRITTEN BY save_image(), NULL WHEN THE FILE CAN'T BE LOADED.  IT LIVES UNTIL uninitialize_calculus()
+inline FUNCTION load_function_image(const char* psc_path) {
+    calculus::IA32_binary* pia32 = calculus::IA32_binary::load_image(psc_path);
+    return (pia32)?pia32->get_header()->pInstructions:NULL;
+}
+
 class user_variable : public user_algebraic_operator
 {
 public:
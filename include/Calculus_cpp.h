@@ -117,6 +117,16 @@ THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
 #define UNREFERENCED_PARAMETER(x) (x);
 #endif
 
+#ifndef _MSC_VER
+#ifndef __cdecl
+#define __cdecl
+#endif
+#endif //_MSC_VER
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define COMPILER_TARGET_X64					//EMIT SYSTEM V AMD64 SSE2 CODE INSTEAD OF IA32 X87 CODE
+#endif
+
 #include <cstdio>
 #include <cstring>
 #include <cctype>
@@ -124,6 +134,19 @@ THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
 #include <malloc.h>
 #include <cstddef>
 #include <typeinfo>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+
+#ifndef _MSC_VER
+//THE MICROSOFT RUNTIME PREFIXES THE BESSEL FUNCTIONS WITH AN UNDERSCORE, POSIX DOES NOT
+inline double _j0(double x) { return ::j0(x); }
+inline double _j1(double x) { return ::j1(x); }
+inline double _jn(int n,double x) { return ::jn(n,x); }
+inline double _y0(double x) { return ::y0(x); }
+inline double _y1(double x) { return ::y1(x); }
+inline double _yn(int n,double x) { return ::yn(n,x); }
+#endif //_MSC_VER
 
 void *ParseAlloc(void *(*mallocProc)(size_t));
 
@@ -133,13 +156,27 @@ void *ParseAlloc(void *(*mallocProc)(size_t));
 //
 typedef double(*FUNCTION)(double,...);
 typedef double(*REAL_FUNCTION)(double*);
+typedef size_t(*BATCH_FUNCTION)(const double* const*,size_t,double*);
+typedef void(*JACOBIAN_FUNCTION)(const double*,double*);
+typedef void(*PARALLEL_TASK)(void*,size_t,size_t);
+
+typedef struct TAPE_INSTRUCTION {
+	int		i_opcode;						//One of the TAPE_OP_* opcodes
+	int		i_arg;							//Variable index, exponent or index table offset
+	union {
+		double	d_value;					//The value of TAPE_OP_CONSTANT
+		void*	pv_operator;				//The operator called back by TAPE_OP_UNARY, TAPE_OP_BINARY and TAPE_OP_CALL
+	};
+}	TAPE_INSTRUCTION,	*PTAPE_INSTRUCTION;
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
 //  DECLARATIONS FOR THE STRING PARSER
 //
 #define CLASS_UNARY_NORMAL		0x1u
-#define CLASS_UNARY_EXTENDED	0x2u
+#define CLASS_UNARY_EXTENDED	0x2u			//name(n,x), THE INTEGER LITERAL COMES FIRST
 #define CLASS_BINARY_NORMAL		0x4u
+#define CLASS_UNARY_EXTENDED_LAST	0x8u		//name(x,n), THE INTEGER LITERAL FOLLOWS THE OPERAND
+#define CLASS_UNARY_DERIVATIVE	0x10u			//name(x,v), THE DERIVATIVE OF x ALONG THE VARIABLE v
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -162,6 +199,7 @@ typedef unsigned long long int qword_type;
 #define COMPILER_LEAN_AND_MEAN				0x08u
 //FUTURE OF THESE LINES IS UNCERTAIN
 #define COMPILER_INFO_V(x)					2*sizeof(dword_type)+x*sizeof(double)
+#define COMPILER_X64_V(x)					(-(int)(((x)+1)*sizeof(double)))	//VARIABLES ARE SPILLED BELOW RBP
 //OPCODE DEFINITIONS
 
 #define CPU_ID() X86
@@ -175,6 +213,27 @@ typedef unsigned long long int qword_type;
 #define REG_EDI		((byte_type)0x7u)
 #define REG_EXX(x)	((byte_type)x)
 #define REG_STX(x)	((byte_type)x)
+#define REG_XMM(x)	((byte_type)x)
+//SSE2 OPCODE BYTES, ENCODED AFTER THE 0xF2 (SCALAR) OR 0x66 (PACKED) PREFIX AND THE 0x0F ESCAPE
+#define SSE2_MOVAPD			((byte_type)0x28u)
+#define SSE2_MOVSD_LOAD		((byte_type)0x10u)
+#define SSE2_MOVSD_STORE	((byte_type)0x11u)
+#define SSE2_SQRTSD			((byte_type)0x51u)
+#define SSE2_XORPD			((byte_type)0x57u)
+#define SSE2_ADDSD			((byte_type)0x58u)
+#define SSE2_MULSD			((byte_type)0x59u)
+#define SSE2_SUBSD			((byte_type)0x5Cu)
+#define SSE2_DIVSD			((byte_type)0x5Eu)
+#define VECTOR_MOVUPD_LOAD	((byte_type)0x10u)
+#define VECTOR_MOVUPD_STORE	((byte_type)0x11u)
+#define VECTOR_MOVAPD		((byte_type)0x28u)
+#define VECTOR_SQRTPD		((byte_type)0x51u)
+#define VECTOR_ADDPD		((byte_type)0x58u)
+#define VECTOR_MULPD		((byte_type)0x59u)
+#define VECTOR_SUBPD		((byte_type)0x5Cu)
+#define VECTOR_DIVPD		((byte_type)0x5Eu)
+#define VECTOR_MAXPD		((byte_type)0x5Fu)
+#define VECTOR_PXOR			((byte_type)0xEFu)
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -188,6 +247,8 @@ typedef unsigned long long int qword_type;
 	dword_type op = (dword_type)imm32val;
 #define IMM64(op,imm64val)																	\
 	qword_type op = *((qword_type*)&imm64val);
+#define INT32(op,int32val)																	\
+	int op = (int)int32val;
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
 //  X86 GENERAL PURPOSE ALU OPCODES
@@ -198,21 +259,21 @@ typedef unsigned long long int qword_type;
 	#define X86_NOP(op)             \
         byte_type op[] = { 0x90u };
 	#define X86_MOV_EXX_IMM32(op,x) \
-        byte_type op[] = { 0xB8u | REG_EXX(x) };
+        byte_type op[] = { (byte_type)(0xB8u | REG_EXX(x)) };
 	#define X86_MOV_EXX_EYX(op,x,y) \
-        byte_type op[] = { 0x8Bu, 0xC0u | (REG_EXX(x)<<3) | REG_EXX(y) };
+        byte_type op[] = { 0x8Bu, (byte_type)(0xC0u | (REG_EXX(x)<<3) | REG_EXX(y)) };
 	#define X86_PUSH_EXX(op,x)      \
-        byte_type op[] = { 0x50u|REG_EXX(x) };
+        byte_type op[] = { (byte_type)(0x50u|REG_EXX(x)) };
 	#define X86_PUSH_IMM32(op)      \
         byte_type op[] = { 0x68u };
 	#define X86_POP_EXX(op,x)       \
-        byte_type op[] = { 0x58u | REG_EXX(x) };
+        byte_type op[] = { (byte_type)(0x58u | REG_EXX(x)) };
 	#define X86_SUB_EXX_IMM32(op,x)	\
-        byte_type op[] = { 0x81u , 0xE8u | REG_EXX(x) };
+        byte_type op[] = { 0x81u , (byte_type)(0xE8u | REG_EXX(x)) };
 	#define X86_ADD_EXX_IMM32(op,x)	\
-        byte_type op[] = { 0x81u , 0xC0u | REG_EXX(x) };
+        byte_type op[] = { 0x81u , (byte_type)(0xC0u | REG_EXX(x)) };
 	#define X86_CMP_EXX_EYX(op,x,y) \
-        byte_type op[] = { 0x39u , 0xC0u | (REG_EXX(x)<<3) | REG_EXX(y) };
+        byte_type op[] = { 0x39u , (byte_type)(0xC0u | (REG_EXX(x)<<3) | REG_EXX(y)) };
 	#define X86_JMP_IMM8(op)	    \
         byte_type op[] = { 0xEBu };
 	#define X86_JE_IMM8(op)         \
@@ -222,13 +283,13 @@ typedef unsigned long long int qword_type;
 	#define X86_JBE_IMM8(op)		\
         byte_type op[] = { 0x76u };
 	#define X86_CALL_EXX(op,x)		\
-        byte_type op[] = { 0xFFu, 0xD0u | REG_EXX(x) };
+        byte_type op[] = { 0xFFu, (byte_type)(0xD0u | REG_EXX(x)) };
 	#define X86_RET(op)				\
         byte_type op[] = { 0xC3u };
 	#define X86_INC_EXX(op,x)		\
-        byte_type op[] = { 0x40u | REG_EXX(x) };
+        byte_type op[] = { (byte_type)(0x40u | REG_EXX(x)) };
 	#define X86_INC_dword_typePTREXX(op,x)\
-        byte_type op[] = { 0xFFu , x };
+        byte_type op[] = { 0xFFu , (byte_type)(x) };
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
 //  X87 FPU ESCAPE OPCODE INSTRUCTION SET
@@ -244,7 +305,7 @@ typedef unsigned long long int qword_type;
 	#define X86_FLDZ(op)				\
         byte_type op[] = { 0xD9u , 0xEEu };
 	#define X86_FCOMIP_STX(op,x)		\
-        byte_type op[] = { 0xDFu , 0xF0u | REG_STX(x) };
+        byte_type op[] = { 0xDFu , (byte_type)(0xF0u | REG_STX(x)) };
 	#define X86_FLD_EBPX_IMM8(op)       \
         byte_type op[] = { 0xDDu , 0x45u };
 	#define X86_FLD_EBPX_IMM32(op)		\
@@ -254,47 +315,47 @@ typedef unsigned long long int qword_type;
 	#define X86_FLD_IMM32(op)			\
         byte_type op[] = { 0xD9u , 0x04u, 0x25 };
 	#define X86_FLD_STX(op,x)			\
-        byte_type op[] = { 0xD9u , 0xC0u | REG_STX(x) };
+        byte_type op[] = { 0xD9u , (byte_type)(0xC0u | REG_STX(x)) };
 	#define X86_FSTP_EBPX_IMM8(op)		\
         byte_type op[] = { 0xDDu , 0x5Du };
 	#define X86_FSTP_EBPX_IMM32(op)		\
         byte_type op[] = { 0xDDu , 0x9Du };
 	#define X86_FSTP_STX(op,x)			\
-        byte_type op[] = { 0xDDu , 0xD8u | REG_STX(x) };
+        byte_type op[] = { 0xDDu , (byte_type)(0xD8u | REG_STX(x)) };
 	#define X86_FSTP_IMM32PTR64(op)		\
         byte_type op[] = { 0xDDu , 0x1Cu, 0x25u };
 	#define X86_FXCH_STX(op,x)			\
-        byte_type op[] = { 0xD9u , 0xC8u | REG_STX(x) };
+        byte_type op[] = { 0xD9u , (byte_type)(0xC8u | REG_STX(x)) };
 	#define X86_FCHS(op)				\
         byte_type op[] = { 0xD9u , 0xE0u };
 	#define X86_FADD_STX(op,x)			\
-        byte_type op[] = { 0xD8u , 0xC0u | REG_STX(x) };
+        byte_type op[] = { 0xD8u , (byte_type)(0xC0u | REG_STX(x)) };
 	#define X86_FADDP_STX(op,x)			\
-        byte_type op[] = { 0xDAu , 0xC0u | REG_STX(x)};
+        byte_type op[] = { 0xDAu , (byte_type)(0xC0u | REG_STX(x))};
 	#define X86_FRADD_STX(op,x)			\
-        byte_type op[] = { 0xDCu , 0xC0u | REG_STX(x) };
+        byte_type op[] = { 0xDCu , (byte_type)(0xC0u | REG_STX(x)) };
 	#define X86_FRADDP_STX(op,x)		\
-        byte_type op[] = { 0xDBu , 0xE2u | REG_STX(x) };
+        byte_type op[] = { 0xDBu , (byte_type)(0xE2u | REG_STX(x)) };
 	#define X86_FSUB_STX(op,x)			\
-        byte_type op[] = { 0xD8u , 0xE0u | REG_STX(x) };
+        byte_type op[] = { 0xD8u , (byte_type)(0xE0u | REG_STX(x)) };
 	#define X86_FSUBP_STX(op,x)			\
-        byte_type op[] = { 0xDEu , 0xE8u | REG_STX(x) };
+        byte_type op[] = { 0xDEu , (byte_type)(0xE8u | REG_STX(x)) };
 	#define X86_FRSUB_STX(op,x)			\
-        byte_type op[] = { 0xDCu , 0xE0u | REG_STX(x) };
+        byte_type op[] = { 0xDCu , (byte_type)(0xE0u | REG_STX(x)) };
 	#define X86_FRSUBP_STX(op,x)		\
-        byte_type op[] = { 0xDEu , 0xE0u | REG_STX(x) };
+        byte_type op[] = { 0xDEu , (byte_type)(0xE0u | REG_STX(x)) };
 	#define X86_FMUL_STX(op,x)			\
-        byte_type op[] = { 0xD8u , 0xC8u | REG_STX(x) };
+        byte_type op[] = { 0xD8u , (byte_type)(0xC8u | REG_STX(x)) };
 	#define X86_FMULP_STX(op,x)			\
-        byte_type op[] = { 0xDEu , 0xC8u | REG_STX(x) };
+        byte_type op[] = { 0xDEu , (byte_type)(0xC8u | REG_STX(x)) };
 	#define X86_FDIV_STX(op,x)			\
-        byte_type op[] = { 0xD8u , 0xF0u | REG_STX(x) };
+        byte_type op[] = { 0xD8u , (byte_type)(0xF0u | REG_STX(x)) };
 	#define X86_FDIVP_STX(op,x)			\
-        byte_type op[] = { 0xDEu , 0xF8u | REG_STX(x) };
+        byte_type op[] = { 0xDEu , (byte_type)(0xF8u | REG_STX(x)) };
 	#define X86_FRDIV_STX(op,x)			\
-        byte_type op[] = { 0xDCu , 0xF0u | REG_STX(x) };
+        byte_type op[] = { 0xDCu , (byte_type)(0xF0u | REG_STX(x)) };
 	#define X86_FRDIVP_STX(op,x)		\
-        byte_type op[] = { 0xDEu , 0xF0u | REG_STX(x) };
+        byte_type op[] = { 0xDEu , (byte_type)(0xF0u | REG_STX(x)) };
 	#define X86_FCOS(op)				\
         byte_type op[] = { 0xD9u , 0xFFu };
 	#define X86_FSIN(op)				\
@@ -303,6 +364,73 @@ typedef unsigned long long int qword_type;
         byte_type op[] = { 0xD9u , 0xFAu };
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
+//  X86-64 GENERAL PURPOSE AND SSE2 OPCODES
+//
+	#define X64_PUSH_RBP(op)					\
+        byte_type op[] = { 0x55u };
+	#define X64_POP_RBP(op)						\
+        byte_type op[] = { 0x5Du };
+	#define X64_MOV_RBP_RSP(op)					\
+        byte_type op[] = { 0x48u , 0x89u , 0xE5u };
+	#define X64_MOV_RSP_RBP(op)					\
+        byte_type op[] = { 0x48u , 0x89u , 0xECu };
+	#define X64_SUB_RSP_IMM32(op)				\
+        byte_type op[] = { 0x48u , 0x81u , 0xECu };
+	#define X64_MOV_RXX_IMM64(op,x)				\
+        byte_type op[] = { 0x48u , (byte_type)(0xB8u | REG_EXX(x)) };
+	#define X64_LEA_RXX_RBPX_IMM32(op,x)		\
+        byte_type op[] = { 0x48u , 0x8Du , (byte_type)(0x85u | (REG_EXX(x)<<3)) };
+	#define X64_SSE2_SD_XMM_XMM(op,code,x,y)	\
+        byte_type op[] = { 0xF2u , 0x0Fu , (byte_type)(code) , (byte_type)(0xC0u | (REG_XMM(x)<<3) | REG_XMM(y)) };
+	#define X64_SSE2_SD_XMM_RBPX_IMM32(op,code,x)\
+        byte_type op[] = { 0xF2u , 0x0Fu , (byte_type)(code) , (byte_type)(0x85u | (REG_XMM(x)<<3)) };
+	#define X64_SSE2_SD_XMM_RIPX_IMM32(op,code,x)\
+        byte_type op[] = { 0xF2u , 0x0Fu , (byte_type)(code) , (byte_type)(0x05u | (REG_XMM(x)<<3)) };
+	#define X64_SSE2_SD_XMM_RYXX_IMM32(op,code,x,y)\
+        byte_type op[] = { 0xF2u , 0x0Fu , (byte_type)(code) , (byte_type)(0x80u | (REG_XMM(x)<<3) | REG_EXX(y)) };
+	#define X64_SSE2_PD_XMM_XMM(op,code,x,y)	\
+        byte_type op[] = { 0x66u , 0x0Fu , (byte_type)(code) , (byte_type)(0xC0u | (REG_XMM(x)<<3) | REG_XMM(y)) };
+	#define X64_PUSH_RBX(op)					\
+        byte_type op[] = { 0x53u };
+	#define X64_MOV_RBPX_IMM32_RXX(op,x)		\
+        byte_type op[] = { 0x48u , 0x89u , (byte_type)(0x85u | (REG_EXX(x)<<3)) };
+	#define X64_MOV_RXX_RBPX_IMM32(op,x)		\
+        byte_type op[] = { 0x48u , 0x8Bu , (byte_type)(0x85u | (REG_EXX(x)<<3)) };
+	#define X64_MOV_RXX_RYXX_IMM32(op,x,y)		\
+        byte_type op[] = { 0x48u , 0x8Bu , (byte_type)(0x80u | (REG_EXX(x)<<3) | REG_EXX(y)) };
+	#define X64_MOV_RXX_RYX(op,x,y)				\
+        byte_type op[] = { 0x48u , 0x8Bu , (byte_type)(0xC0u | (REG_EXX(x)<<3) | REG_EXX(y)) };
+	#define X64_ADD_RXX_RYX(op,x,y)				\
+        byte_type op[] = { 0x48u , 0x03u , (byte_type)(0xC0u | (REG_EXX(x)<<3) | REG_EXX(y)) };
+	#define X64_ADD_RXX_IMM32(op,x)				\
+        byte_type op[] = { 0x48u , 0x81u , (byte_type)(0xC0u | REG_EXX(x)) };
+	#define X64_SUB_RXX_IMM32(op,x)				\
+        byte_type op[] = { 0x48u , 0x81u , (byte_type)(0xE8u | REG_EXX(x)) };
+	#define X64_CMP_RXX_IMM32(op,x)				\
+        byte_type op[] = { 0x48u , 0x81u , (byte_type)(0xF8u | REG_EXX(x)) };
+	#define X64_SHR_RXX_IMM8(op,x)				\
+        byte_type op[] = { 0x48u , 0xC1u , (byte_type)(0xE8u | REG_EXX(x)) };
+	#define X64_XOR_EXX_EXX(op,x)				\
+        byte_type op[] = { 0x31u , (byte_type)(0xC0u | (REG_EXX(x)<<3) | REG_EXX(x)) };
+	#define X64_REP_STOSQ(op)					\
+        byte_type op[] = { 0xF3u , 0x48u , 0xABu };
+	#define X64_JB_IMM32(op)					\
+        byte_type op[] = { 0x0Fu , 0x82u };
+	#define X64_JMP_IMM32(op)					\
+        byte_type op[] = { 0xE9u };
+	#define X64_VZEROUPPER(op)					\
+        byte_type op[] = { 0xC5u , 0xF8u , 0x77u };
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  X86-64 PACKED DOUBLE PREFIXES, ONLY REGISTERS 0-7 ARE ENCODED.  v IS THE FIRST SOURCE
+//  (VEX.vvvv), PASS 0 FOR THE TWO OPERAND FORMS
+//
+	#define X64_VEX256_PD(op,code,v)			\
+        byte_type op[] = { 0xC5u , (byte_type)(0x85u | ((~REG_XMM(v)&0xFu)<<3)) , (byte_type)(code) };
+	#define X64_EVEX512_PD(op,code,v)			\
+        byte_type op[] = { 0x62u , 0xF1u , (byte_type)(0x85u | ((~REG_XMM(v)&0xFu)<<3)) , 0x48u , (byte_type)(code) };
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
 //  PROCESSOR ABSTRACTION MACROS
 //
 	#define BREAK					X86_BREAK
@@ -363,10 +491,87 @@ typedef unsigned long long int qword_type;
 	#define FSIN					X86_FSIN
 	#define FCOS					X86_FCOS
 	#define FSQRT					X86_FSQRT
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  X86-64 GENERAL PURPOSE AND SSE2 OPCODES
+//
+	#define PUSH_RBP				X64_PUSH_RBP
+	#define POP_RBP					X64_POP_RBP
+	#define MOV_RBP_RSP				X64_MOV_RBP_RSP
+	#define MOV_RSP_RBP				X64_MOV_RSP_RBP
+	#define SUB_RSP_IMM32			X64_SUB_RSP_IMM32
+	#define MOV_RXX_IMM64			X64_MOV_RXX_IMM64
+	#define LEA_RXX_RBPX_IMM32		X64_LEA_RXX_RBPX_IMM32
+	#define SSE2_SD_XMM_XMM			X64_SSE2_SD_XMM_XMM
+	#define SSE2_SD_XMM_RBPX_IMM32	X64_SSE2_SD_XMM_RBPX_IMM32
+	#define SSE2_SD_XMM_RIPX_IMM32	X64_SSE2_SD_XMM_RIPX_IMM32
+	#define SSE2_SD_XMM_RYXX_IMM32	X64_SSE2_SD_XMM_RYXX_IMM32
+	#define SSE2_PD_XMM_XMM			X64_SSE2_PD_XMM_XMM
+	#define PUSH_RBX				X64_PUSH_RBX
+	#define MOV_RBPX_IMM32_RXX		X64_MOV_RBPX_IMM32_RXX
+	#define MOV_RXX_RBPX_IMM32		X64_MOV_RXX_RBPX_IMM32
+	#define MOV_RXX_RYXX_IMM32		X64_MOV_RXX_RYXX_IMM32
+	#define MOV_RXX_RYX				X64_MOV_RXX_RYX
+	#define ADD_RXX_RYX				X64_ADD_RXX_RYX
+	#define ADD_RXX_IMM32			X64_ADD_RXX_IMM32
+	#define SUB_RXX_IMM32			X64_SUB_RXX_IMM32
+	#define CMP_RXX_IMM32			X64_CMP_RXX_IMM32
+	#define SHR_RXX_IMM8			X64_SHR_RXX_IMM8
+	#define XOR_EXX_EXX				X64_XOR_EXX_EXX
+	#define REP_STOSQ				X64_REP_STOSQ
+	#define JB_IMM32				X64_JB_IMM32
+	#define JMP_IMM32				X64_JMP_IMM32
+	#define VZEROUPPER				X64_VZEROUPPER
+	#define VEX256_PD				X64_VEX256_PD
+	#define EVEX512_PD				X64_EVEX512_PD
 #endif //__cplusplus
 //FLAGS FOR THE PARSING PROCESS
 #define COMPILER_FPU_MAX_STACK		0x8u			//I386 FPU STACK SIZE
 #define COMPILER_FPU_MAX_STACK_USE	0x7u			//ACCOUNTS FOR VARIABLE LOADING
+//FLAGS FOR THE BATCH EVALUATION
+#define EVAL_BATCH_BLOCK_SIZE		0x100u			//POINTS PER BLOCK, BOUNDS THE SCRATCH OF EVERY BINARY OPERATOR
+#define EVAL_LOCAL_VARIABLES		0x10u			//OPERANDS WITH MORE VARIABLES ARE GATHERED ON THE HEAP
+//VECTOR INSTRUCTION SETS TARGETED BY THE BATCH KERNELS
+#define VECTOR_ISA_NONE				0x0u			//NO BATCH KERNELS, eval_batch() IS INTERPRETED
+#define VECTOR_ISA_AVX2				0x1u			//4 DOUBLES PER INSTRUCTION
+#define VECTOR_ISA_AVX512			0x2u			//8 DOUBLES PER INSTRUCTION
+//FRAME OF THE BATCH KERNELS, THE ARGUMENTS ARE KEPT BELOW THE SAVED RBX
+#define COMPILER_X64_BATCH_COLUMNS	(-16)
+#define COMPILER_X64_BATCH_COUNT	(-24)
+#define COMPILER_X64_BATCH_OUTPUT	(-32)
+#define COMPILER_X64_BATCH_FRAME	32
+//LAYOUTS OF THE MATRIX FILLED BY A JACOBIAN KERNEL
+#define JACOBIAN_LAYOUT_CSR			0x0u			//THE NONZEROS ONLY, ROW MAJOR, THE VALUES OF A CSR MATRIX
+#define JACOBIAN_LAYOUT_DENSE		0x1u			//ALL m*n ENTRIES, ROW MAJOR, THE STRUCTURAL ZEROS ARE WRITTEN TOO
+//OPCODES OF THE EVALUATION TAPE, A POST-ORDER PROGRAM FOR A STACK MACHINE
+#define TAPE_OP_VARIABLE			0x0u			//PUSH pVars[i_arg]
+#define TAPE_OP_CONSTANT			0x1u			//PUSH d_value
+#define TAPE_OP_NEGATE				0x2u			//TOP = -TOP
+#define TAPE_OP_SQRT				0x3u			//TOP = sqrt(TOP), NEGATIVE VALUES GIVE 0
+#define TAPE_OP_INT_POW				0x4u			//TOP = TOP^i_arg
+#define TAPE_OP_UNARY				0x5u			//TOP = pv_operator->eval_unary(TOP)
+#define TAPE_OP_ADD					0x6u			//POP b, TOP = TOP + b
+#define TAPE_OP_SUBTRACT			0x7u			//POP b, TOP = TOP - b
+#define TAPE_OP_MULTIPLY			0x8u			//POP b, TOP = TOP * b
+#define TAPE_OP_DIVIDE				0x9u			//POP b, TOP = TOP / b
+#define TAPE_OP_BINARY				0xAu			//POP b, TOP = pv_operator->eval_binary(TOP,b)
+#define TAPE_OP_CALL				0xBu			//PUSH pv_operator->eval(), ITS VARIABLES ARE GATHERED THROUGH THE INDEX TABLE AT i_arg
+#define TAPE_LOCAL_STACK_SIZE		0x40u			//DEEPER TAPES EVALUATE IN THE SCRATCH OF THE THREAD
+#define TAPE_DIFFERENCE_STEP		6.0554544523933395e-6	//CUBE ROOT OF THE MACHINE EPSILON, SCALED BY |a| WHEN |a| > 1
+#define TAPE_SECOND_DIFFERENCE_STEP	1.220703125e-4	//FOURTH ROOT OF THE MACHINE EPSILON, FOR DIFFERENCES OF DIFFERENCES
+#define NODE_POOL_GRANULE			0x10u			//BLOCKS OF THE NODE POOL ARE ROUNDED UP TO A MULTIPLE OF THIS
+#define NODE_POOL_MAX_SIZE			0x200u			//LARGER BLOCKS GO TO THE HEAP
+#define NODE_POOL_CLASSES			(NODE_POOL_MAX_SIZE/NODE_POOL_GRANULE)
+#define NODE_POOL_CHUNK_SIZE		0x10000u		//EVERY CHUNK HOLDS BLOCKS OF A SINGLE CLASS
+#define NODE_POOL_BATCH				0x20u			//BLOCKS TRADED AT ONCE BETWEEN A THREAD AND THE SHARED LISTS
+#define CONS_HAND_OUT_RING			0x10u			//OPERATORS EACH THREAD MAY HOLD UNREFERENCED ACROSS A SWEEP OF THE CONS TABLE
+#define PARALLEL_EVAL_GRAIN			0x100u			//SMALLEST CHUNK OF POINTS HANDED TO A WORKER
+#define PARALLEL_EVAL_CHUNKS		0x8u			//CHUNKS PER THREAD, THE SLACK THE STEALING BALANCES
+#define PARALLEL_EVAL_COMPILED_VARS	0x8u			//THE COMPILED FUNCTION IS CALLED WITH UP TO THIS MANY VARIABLES
+#define STRING_WRITER_LOCAL_SIZE	0x80u			//TEXTS UP TO THIS SIZE ARE RENDERED WITHOUT ALLOCATING
+#define ALGEBRA_PARSER_NAME_LENGTH	0x20u			//LONGEST REGISTERED OPERATOR NAME, WITH ITS TERMINATOR
+#define ALGEBRA_PARSER_TABLE_SIZE	0x40u			//INITIAL NUMBER OF BUCKETS OF THE OPERATOR REGISTRY
+#define PARSE_CACHE_CAPACITY		0x100u			//DEFAULT NUMBER OF EXPRESSIONS KEPT BY parse_cached()
 //FLAGS FOR THE FEATURES REQUESTED DURING PARSING
 #define FEAT_NEED_NONE				(dword_type)0x0000u	//RESET FEATURES
 #define FEAT_NEED_EAX				(dword_type)0x0001u
@@ -386,6 +591,57 @@ typedef unsigned long long int qword_type;
 //FLAGS FOR THE HEADER STRUCTURE
 #define COMPILER_FLAG_NOFLAGS					(dword_type)0x0u
 #define COMPILER_FLAG_FUNCTION_NOT_REMOTABLE	(dword_type)0x0001u
+//FUNCTION IMAGES, COMPILED FUNCTIONS WRITTEN TO DISK
+#define FUNCTION_IMAGE_MAGIC			0x4D494643u		//"CFIM"
+#define FUNCTION_IMAGE_VERSION			0x1u
+#define FUNCTION_IMAGE_ALIGNMENT		0x10u			//OF THE SECTIONS FROM THE START OF THE FILE
+#define FUNCTION_IMAGE_ISA_IA32			0x1u			//X87 CODE, 32 BIT POINTERS
+#define FUNCTION_IMAGE_ISA_X64			0x2u			//SYSTEM V AMD64 SSE2 CODE, 64 BIT POINTERS
+#define FUNCTION_IMAGE_RELOC_CALL_COUNT	0x0u			//&i_call_count OF THE HEADER OF THE LOADED FUNCTION
+#define FUNCTION_IMAGE_RELOC_CODE		0x1u			//THE CODE PLUS qw_target
+#define FUNCTION_IMAGE_RELOC_ROUTINE	0x2u			//THE NATIVE ROUTINE NUMBER qw_target OF THE LOADING PROCESS
+//EXPRESSION IMAGES, OPERATOR TREES WRITTEN TO DISK AS THEIR TAPES
+#define EXPRESSION_IMAGE_MAGIC			0x50584543u		//"CEXP"
+#define EXPRESSION_IMAGE_VERSION		0x1u
+#define EXPRESSION_IMAGE_ALIGNMENT		0x10u			//OF THE SECTIONS FROM THE START OF THE FILE
+//OPCODES OF THE NODES OF AN EXPRESSION IMAGE, THE NUMBERS ARE PART OF THE FORMAT
+#define EXPRESSION_OP_VARIABLE			0x0u			//PUSH pVars[i_arg]
+#define EXPRESSION_OP_CONSTANT			0x1u			//PUSH CONSTANT i_arg OF THE POOL
+#define EXPRESSION_OP_NEGATE			0x2u			//TOP = -TOP
+#define EXPRESSION_OP_SQRT				0x3u			//TOP = sqrt(TOP), NEGATIVE VALUES GIVE 0
+#define EXPRESSION_OP_INT_POW			0x4u			//TOP = TOP^i_arg
+#define EXPRESSION_OP_ADD				0x5u			//POP b, TOP = TOP + b
+#define EXPRESSION_OP_SUBTRACT			0x6u			//POP b, TOP = TOP - b
+#define EXPRESSION_OP_MULTIPLY			0x7u			//POP b, TOP = TOP * b
+#define EXPRESSION_OP_DIVIDE			0x8u			//POP b, TOP = TOP / b
+#define EXPRESSION_OP_POW				0x9u			//POP b, TOP = pow(TOP,b)
+#define EXPRESSION_OP_EXP				0xAu			//TOP = exp(TOP)
+#define EXPRESSION_OP_LN				0xBu			//TOP = log(TOP)
+#define EXPRESSION_OP_LOG10				0xCu			//TOP = log10(TOP)
+#define EXPRESSION_OP_SIN				0xDu
+#define EXPRESSION_OP_COS				0xEu
+#define EXPRESSION_OP_TAN				0xFu
+#define EXPRESSION_OP_ASIN				0x10u
+#define EXPRESSION_OP_ACOS				0x11u
+#define EXPRESSION_OP_ATAN				0x12u
+#define EXPRESSION_OP_SINH				0x13u
+#define EXPRESSION_OP_COSH				0x14u
+#define EXPRESSION_OP_TANH				0x15u
+#define EXPRESSION_OP_J0				0x16u
+#define EXPRESSION_OP_J1				0x17u
+#define EXPRESSION_OP_JN				0x18u			//TOP = jn(i_arg,TOP)
+#define EXPRESSION_OP_Y0				0x19u
+#define EXPRESSION_OP_Y1				0x1Au
+#define EXPRESSION_OP_YN				0x1Bu			//TOP = yn(i_arg,TOP)
+#define EXPRESSION_OP_COUNT				0x1Cu
+
+//THE STEP OF THE CENTRED DIFFERENCES TAKEN AROUND a
+inline double TapeDifferenceStep(double a) {
+	return TAPE_DIFFERENCE_STEP*((fabs(a) > 1)?fabs(a):1);
+}
+inline double TapeSecondDifferenceStep(double a) {
+	return TAPE_SECOND_DIFFERENCE_STEP*((fabs(a) > 1)?fabs(a):1);
+}
 
 void initialize_calculus(unsigned int cMode);
 int uninitialize_calculus();
@@ -393,12 +649,43 @@ int uninitialize_calculus();
 double inline INT_POW(int b,double a) {
     if (b == 0)
         return 1;
-    return INT_POW((b > 0)?b-1:b+1,a)*a;
+    return (b > 0)?INT_POW(b-1,a)*a:INT_POW(b+1,a)/a;
 }
 
 namespace calculus
 {
     class variable;
+    class algebraic_operator;
+}
+
+typedef struct COMPILER_SHARED_ENTRY {
+	calculus::algebraic_operator*	pao_operator;	//The operator, NULL when the entry is free
+	int								i_uses;			//Number of times the encoding reaches the operator
+	int								i_slot;			//Frame displacement of the slot holding its value, 0 when it isn't shared
+	bool							b_done;			//True once the current pass has encoded the operator
+} COMPILER_SHARED_ENTRY,*PCOMPILER_SHARED_ENTRY;
+
+typedef struct COMPILER_SHARED_TABLE {
+	PCOMPILER_SHARED_ENTRY	p_entries;				//Entries, open addressed by operator pointer
+	int						i_capacity;				//Number of entries, a power of 2
+	int						i_count;				//Number of entries in use
+	int						i_num_slots;			//Number of frame slots given to shared operators
+	bool					b_counting;				//True while the uses are being counted
+} COMPILER_SHARED_TABLE,*PCOMPILER_SHARED_TABLE;
+
+//HANDS A SLOT BELOW i_base TO EVERY OPERATOR REACHED MORE THAN ONCE, RETURNS THE NUMBER OF SLOTS
+inline int AssignSharedSlots(PCOMPILER_SHARED_TABLE pTable,int i_base) {
+	pTable->b_counting = false;
+	pTable->i_num_slots = 0;
+	for(int i = 0;i < pTable->i_capacity;i++)
+		if (pTable->p_entries[i].i_uses > 1)
+			pTable->p_entries[i].i_slot = -(i_base + (++pTable->i_num_slots)*(int)sizeof(double));
+	return pTable->i_num_slots;
+}
+//REWINDS THE TABLE BETWEEN THE SIZING AND THE ENCODING PASSES
+inline void ResetSharedTable(PCOMPILER_SHARED_TABLE pTable) {
+	for(int i = 0;i < pTable->i_capacity;i++)
+		pTable->p_entries[i].b_done = false;
 }
 
 typedef struct PARSE_TIME_INFO {
@@ -413,6 +700,10 @@ typedef struct PARSE_TIME_INFO {
 	int     i_operator_count;			//Number of algebraic operators in the function
 	int     i_instruction_count;		//An instruction counter
 	int     i_clock_count;				//A clock counter
+	int     i_stack_offset;				//Current depth of the temporaries spilled below the frame (X64)
+	int     i_max_stack_offset;			//Deepest temporary spill reached, in byte_types (X64)
+	int     i_vector_isa;				//VECTOR_ISA_* targeted by a batch kernel, VECTOR_ISA_NONE for scalar code
+	PCOMPILER_SHARED_TABLE p_shared;	//Operators reached more than once (X64), NULL to encode every use
 } PT_INFO,*PPT_INFO;
 
 typedef struct COMPILER_HEADER	{
@@ -432,8 +723,78 @@ typedef struct COMPILER_HEADER	{
 	unsigned char*		pv_local_storage;			//Local storage for the functions
 	unsigned char**		ppv_auxiliary_storage_toc;	//Table containing pointers to start addresses of the AUX storage
 	unsigned char*		pv_auxiliary_storage;		//First AUX storage entry
+	unsigned char*		pv_code_storage;			//Instructions and constants held in the code_arena, NULL when enclosed in this segment
+	size_t				st_code_size;				//Size of the code_arena slot
 }	COMPILER_HEADER,	*PCOMPILER_HEADER;
 
+//THE LAYOUT OF A FUNCTION IMAGE, EVERY FIELD IS LITTLE ENDIAN AND EVERY SECTION STARTS ON FUNCTION_IMAGE_ALIGNMENT
+//	FUNCTION_IMAGE_HEADER
+//	NAME			ui_name_size BYTES, THE NULL-TERMINATED psc_name OF THE FUNCTION
+//	RELOCATIONS		ui_num_relocations FUNCTION_IMAGE_RELOCATION, ONE PER ENTRY OF THE PTR MAP
+//	CODE			ui_code_size BYTES OF INSTRUCTIONS AND CONSTANTS, THE RELOCATED POINTERS ARE STORED AS ZERO
+//THE ARGUMENTS ARE THOSE OF THE SAVED FUNCTION, IN THE ORDER OF ITS get_variables()
+typedef struct FUNCTION_IMAGE_HEADER {
+	unsigned int		ui_magic;					//FUNCTION_IMAGE_MAGIC
+	unsigned int		ui_version;					//FUNCTION_IMAGE_VERSION
+	unsigned int		ui_isa;						//FUNCTION_IMAGE_ISA_* of the code
+	unsigned int		ui_flags;					//COMPILER_FLAG_* of the function
+	int					i_num_vars;					//Total number of variables in the function
+	int					i_operator_count;			//An operator count
+	int					i_instruction_count;		//An instruction count
+	int					i_clock_count;				//A clock time count
+	unsigned int		ui_name_offset;				//Offset of the name from the start of the file
+	unsigned int		ui_name_size;				//Size of the name with its terminator
+	unsigned int		ui_relocation_offset;		//Offset of the relocations from the start of the file
+	unsigned int		ui_num_relocations;			//Number of relocations
+	unsigned int		ui_code_offset;				//Offset of the code from the start of the file
+	unsigned int		ui_code_size;				//Size of the code
+	unsigned int		ui_entry_offset;			//Offset of the first instruction in the code
+	unsigned int		ui_local_offset;			//Offset of the constants in the code
+}	FUNCTION_IMAGE_HEADER,	*PFUNCTION_IMAGE_HEADER;
+
+typedef struct FUNCTION_IMAGE_RELOCATION {
+	unsigned int		ui_offset;					//Offset in the code of the pointer to write
+	unsigned int		ui_kind;					//FUNCTION_IMAGE_RELOC_*
+	qword_type			qw_target;					//Offset in the code or number of the routine, depending on ui_kind
+}	FUNCTION_IMAGE_RELOCATION,	*PFUNCTION_IMAGE_RELOCATION;
+
+//THE LAYOUT OF AN EXPRESSION IMAGE, EVERY FIELD IS LITTLE ENDIAN AND EVERY SECTION STARTS ON EXPRESSION_IMAGE_ALIGNMENT
+//	EXPRESSION_IMAGE_HEADER
+//	EXPRESSIONS		ui_num_expressions EXPRESSION_IMAGE_ENTRY
+//	NODES			ui_num_nodes EXPRESSION_IMAGE_NODE, THE POST-ORDER NODES OF EVERY EXPRESSION ONE AFTER THE OTHER
+//	CONSTANTS		ui_num_constants DOUBLES, THE POOL SHARED BY ALL THE EXPRESSIONS
+//	ARGUMENTS		ui_num_arguments INDICES IN THE NAME TABLE, THE VARIABLES OF EVERY EXPRESSION IN THEIR ARGUMENT ORDER
+//	NAMES			ui_num_names OFFSETS FROM THE START OF THE SECTION FOLLOWED BY THE NULL-TERMINATED VARIABLE NAMES
+typedef struct EXPRESSION_IMAGE_HEADER {
+	unsigned int		ui_magic;					//EXPRESSION_IMAGE_MAGIC
+	unsigned int		ui_version;					//EXPRESSION_IMAGE_VERSION
+	unsigned int		ui_num_expressions;			//Number of expressions
+	unsigned int		ui_num_nodes;				//Number of nodes of all the expressions
+	unsigned int		ui_num_constants;			//Number of constants in the pool
+	unsigned int		ui_num_arguments;			//Number of arguments of all the expressions
+	unsigned int		ui_num_names;				//Number of variable names
+	unsigned int		ui_name_size;				//Size of the name section
+	qword_type			qw_expression_offset;		//Offsets of the sections from the start of the file
+	qword_type			qw_node_offset;
+	qword_type			qw_constant_offset;
+	qword_type			qw_argument_offset;
+	qword_type			qw_name_offset;
+}	EXPRESSION_IMAGE_HEADER,	*PEXPRESSION_IMAGE_HEADER;
+
+typedef struct EXPRESSION_IMAGE_ENTRY {
+	unsigned int		ui_first_node;				//Index of the first node of the expression
+	unsigned int		ui_num_nodes;				//Number of nodes of the expression
+	unsigned int		ui_first_argument;			//Index of the first argument of the expression
+	unsigned int		ui_num_arguments;			//Number of variables of the expression
+	unsigned int		ui_max_depth;				//Deepest stack reached by the nodes
+	unsigned int		ui_reserved;				//Zero
+}	EXPRESSION_IMAGE_ENTRY,	*PEXPRESSION_IMAGE_ENTRY;
+
+typedef struct EXPRESSION_IMAGE_NODE {
+	unsigned int		ui_opcode;					//One of the EXPRESSION_OP_* opcodes
+	int					i_arg;						//Argument, constant, exponent or order
+}	EXPRESSION_IMAGE_NODE,	*PEXPRESSION_IMAGE_NODE;
+
 typedef struct COMPILE_TIME_INFO
 {
 	PCOMPILER_HEADER    pHeader;			//A pointer to the associated COMPILER_HEADER structure
@@ -444,9 +805,19 @@ typedef struct COMPILE_TIME_INFO
 	unsigned char*      pv_instruction_storage_pos;			//Current position in the instruction store
 	int                 i_stack_offset;				//Current stack offset from EBP in byte_types
 	int                 i_fpu_stack_offset;				//Number of stacked entries needed
+	int                 i_vector_isa;					//VECTOR_ISA_* targeted by a batch kernel, VECTOR_ISA_NONE for scalar code
+	PCOMPILER_SHARED_TABLE p_shared;				//Operators reached more than once (X64), NULL to encode every use
     calculus::variable** ppv_vars;
 } CT_INFO,*PCT_INFO;
 
+inline qword_type StructuralHashCombine(qword_type qw_hash,qword_type qw_value) {
+	qw_hash ^= qw_value + 0x9e3779b97f4a7c15ull + (qw_hash << 6) + (qw_hash >> 2);
+	//FINALIZER OF SPLITMIX64, SO THE HASHES OF SMALL TREES DIFFER IN THEIR LOW BITS TOO
+	qw_hash = (qw_hash ^ (qw_hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	qw_hash = (qw_hash ^ (qw_hash >> 27)) * 0x94d049bb133111ebull;
+	return qw_hash ^ (qw_hash >> 31);
+}
+
 template <class unknown> void addref_and_release(unknown * punknown) {
 	punknown->addref();
 	punknown->release();
@@ -926,9 +1297,581 @@ inline unsigned int CompilerSizeOfFSQRT() {
 	FSQRT(op)
 	return sizeof(op);
 }
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  X86-64 ENCODERS
+//
+//	THE X64 BACKEND FOLLOWS THE SYSTEM V AMD64 ABI.  THE RESULT OF EVERY OPERATOR IS LEFT IN
+//	XMM0, VARIABLES ARE SPILLED TO [RBP+COMPILER_X64_V(i)] BY THE PROLOGUE AND TEMPORARIES ARE
+//	KEPT BELOW THEM, AT [RBP-i_stack_offset].  CONSTANTS ARE ADDRESSED RIP-RELATIVE IN THE LOCAL
+//	STORE, WHICH FOLLOWS THE INSTRUCTIONS.
+//
+inline void CompilerWriteINT32(PCT_INFO pInfo,int val) {
+	INT32(int32,val)
+	CompilerWriteInstruction(pInfo,(byte_type*)&int32,sizeof(int32));
+}
+inline unsigned int CompilerSizeOfINT32() {
+	return sizeof(int);
+}
+inline void CompilerWriteRIPX_INT32(PCT_INFO pInfo,unsigned char* pTarget) {
+	//RIP-RELATIVE DISPLACEMENTS ARE TAKEN FROM THE END OF THE INSTRUCTION
+	CompilerWriteINT32(pInfo,(int)(pTarget-(pInfo->pv_instruction_storage_pos+CompilerSizeOfINT32())));
+}
+inline void CompilerWritePUSH_RBP(PCT_INFO pInfo) {
+	PUSH_RBP(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfPUSH_RBP() {
+	PUSH_RBP(op)
+	return sizeof(op);
+}
+inline void CompilerWritePOP_RBP(PCT_INFO pInfo) {
+	POP_RBP(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfPOP_RBP() {
+	POP_RBP(op)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RBP_RSP(PCT_INFO pInfo) {
+	MOV_RBP_RSP(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RBP_RSP() {
+	MOV_RBP_RSP(op)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RSP_RBP(PCT_INFO pInfo) {
+	MOV_RSP_RBP(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RSP_RBP() {
+	MOV_RSP_RBP(op)
+	return sizeof(op);
+}
+inline void CompilerWriteSUB_RSP_IMM32(PCT_INFO pInfo) {
+	SUB_RSP_IMM32(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSUB_RSP_IMM32() {
+	SUB_RSP_IMM32(op)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RXX_IMM64(PCT_INFO pInfo,byte_type x) {
+	MOV_RXX_IMM64(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RXX_IMM64() {
+	MOV_RXX_IMM64(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteLEA_RXX_RBPX_IMM32(PCT_INFO pInfo,byte_type x) {
+	LEA_RXX_RBPX_IMM32(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfLEA_RXX_RBPX_IMM32() {
+	LEA_RXX_RBPX_IMM32(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSSE2_SD_XMM_XMM(PCT_INFO pInfo,byte_type code,byte_type x,byte_type y) {
+	SSE2_SD_XMM_XMM(op,code,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_XMM() {
+	SSE2_SD_XMM_XMM(op,0,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSSE2_SD_XMM_RBPX_IMM32(PCT_INFO pInfo,byte_type code,byte_type x) {
+	SSE2_SD_XMM_RBPX_IMM32(op,code,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_RBPX_IMM32() {
+	SSE2_SD_XMM_RBPX_IMM32(op,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSSE2_SD_XMM_RIPX_IMM32(PCT_INFO pInfo,byte_type code,byte_type x) {
+	SSE2_SD_XMM_RIPX_IMM32(op,code,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_RIPX_IMM32() {
+	SSE2_SD_XMM_RIPX_IMM32(op,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSSE2_SD_XMM_RYXX_IMM32(PCT_INFO pInfo,byte_type code,byte_type x,byte_type y) {
+	SSE2_SD_XMM_RYXX_IMM32(op,code,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_RYXX_IMM32() {
+	SSE2_SD_XMM_RYXX_IMM32(op,0,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSSE2_PD_XMM_XMM(PCT_INFO pInfo,byte_type code,byte_type x,byte_type y) {
+	SSE2_PD_XMM_XMM(op,code,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSSE2_PD_XMM_XMM() {
+	SSE2_PD_XMM_XMM(op,0,0,0)
+	return sizeof(op);
+}
+//LOADS A DOUBLE INTO THE LOCAL STORE AND ENCODES code xmm(x),[rip+constant]
+inline void CompilerWriteSSE2_SD_XMM_CONSTANT(PCT_INFO pInfo,byte_type code,byte_type x,double d) {
+	unsigned char * pLocalPos = pInfo->pv_local_storage_pos;
+	CompilerWriteLocalInfo(pInfo,(byte_type*)&d,sizeof(double));
+	CompilerWriteSSE2_SD_XMM_RIPX_IMM32(pInfo,code,x);
+		CompilerWriteRIPX_INT32(pInfo,pLocalPos);
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_CONSTANT() {
+	return CompilerSizeOfSSE2_SD_XMM_RIPX_IMM32() + CompilerSizeOfINT32();
+}
+//ENCODES code xmm(x),[rbp+disp]
+inline void CompilerWriteSSE2_SD_XMM_FRAME(PCT_INFO pInfo,byte_type code,byte_type x,int disp) {
+	CompilerWriteSSE2_SD_XMM_RBPX_IMM32(pInfo,code,x);
+		CompilerWriteINT32(pInfo,disp);
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_FRAME() {
+	return CompilerSizeOfSSE2_SD_XMM_RBPX_IMM32() + CompilerSizeOfINT32();
+}
+//ENCODES code xmm(x),[y+disp], y MAY NOT BE RSP
+inline void CompilerWriteSSE2_SD_XMM_INDIRECT(PCT_INFO pInfo,byte_type code,byte_type x,byte_type y,int disp) {
+	CompilerWriteSSE2_SD_XMM_RYXX_IMM32(pInfo,code,x,y);
+		CompilerWriteINT32(pInfo,disp);
+}
+inline unsigned int CompilerSizeOfSSE2_SD_XMM_INDIRECT() {
+	return CompilerSizeOfSSE2_SD_XMM_RYXX_IMM32() + CompilerSizeOfINT32();
+}
+//ENCODES MOV rax,pFunction / CALL rax, THE ARGUMENT IS EXPECTED IN XMM0 AND THE RESULT IS LEFT THERE
+inline void CompilerWriteX64CALL_IMM64(PCT_INFO pInfo,void * pFunction) {
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EAX);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)pFunction);
+	CompilerWriteCALL_EXX(pInfo,REG_EAX);
+	pInfo->pHeader->i_f_flags |= COMPILER_FLAG_FUNCTION_NOT_REMOTABLE;
+}
+inline unsigned int CompilerSizeOfX64CALL_IMM64() {
+	return CompilerSizeOfMOV_RXX_IMM64() + CompilerSizeOfIMM64() + CompilerSizeOfCALL_EXX();
+}
+//RESERVES AND RELEASES TEMPORARIES BELOW THE SPILLED VARIABLES
+inline int CompilerPushX64Temporary(PCT_INFO pInfo,int n = 1) {
+	pInfo->i_stack_offset += n*sizeof(double);
+	return -pInfo->i_stack_offset;
+}
+inline void CompilerPopX64Temporary(PCT_INFO pInfo,int n = 1) {
+	pInfo->i_stack_offset -= n*sizeof(double);
+}
+inline void CompilerReserveX64Temporary(PPT_INFO pParseInfo,int n = 1) {
+	pParseInfo->i_stack_offset += n*sizeof(double);
+	if (pParseInfo->i_stack_offset > pParseInfo->i_max_stack_offset)
+		pParseInfo->i_max_stack_offset = pParseInfo->i_stack_offset;
+}
+inline void CompilerReleaseX64Temporary(PPT_INFO pParseInfo,int n = 1) {
+	pParseInfo->i_stack_offset -= n*sizeof(double);
+}
+//LOCATES A VARIABLE IN THE ARGUMENT LIST OF THE FUNCTION BEING COMPILED, DEFINED AFTER calculus::variable
+inline int CompilerIndexOfVariable(PCT_INFO pInfo,calculus::variable * pVar);
+//COPIES n VARIABLES INTO A CONTIGUOUS double[n] TEMPORARY AND RETURNS ITS DISPLACEMENT FROM RBP
+inline int CompilerWriteX64GatherVariables(PCT_INFO pInfo,int n,calculus::variable ** ppv_vars) {
+	int iBase = CompilerPushX64Temporary(pInfo,n);
+	for(int i = 0;i < n;i++) {
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),COMPILER_X64_V(CompilerIndexOfVariable(pInfo,ppv_vars[i])));
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),iBase+i*(int)sizeof(double));
+	}
+	return iBase;
+}
+inline unsigned int CompilerSizeOfX64GatherVariables(int n) {
+	return 2*n*CompilerSizeOfSSE2_SD_XMM_FRAME();
+}
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  X86-64 BATCH KERNEL ENCODERS
+//
+//	A BATCH KERNEL IS A BATCH_FUNCTION, IT KEEPS THE BYTE OFFSET OF THE CURRENT POINT IN RBX AND
+//	ITS ARGUMENTS AT [RBP+COMPILER_X64_BATCH_*].  THE RESULT OF EVERY OPERATOR IS LEFT IN YMM0/ZMM0
+//	AND TEMPORARIES ARE ONE VECTOR WIDE.
+//
+inline void CompilerWritePUSH_RBX(PCT_INFO pInfo) {
+	PUSH_RBX(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfPUSH_RBX() {
+	PUSH_RBX(op)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RBPX_IMM32_RXX(PCT_INFO pInfo,byte_type x) {
+	MOV_RBPX_IMM32_RXX(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RBPX_IMM32_RXX() {
+	MOV_RBPX_IMM32_RXX(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RXX_RBPX_IMM32(PCT_INFO pInfo,byte_type x) {
+	MOV_RXX_RBPX_IMM32(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RXX_RBPX_IMM32() {
+	MOV_RXX_RBPX_IMM32(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RXX_RYXX_IMM32(PCT_INFO pInfo,byte_type x,byte_type y) {
+	MOV_RXX_RYXX_IMM32(op,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RXX_RYXX_IMM32() {
+	MOV_RXX_RYXX_IMM32(op,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteMOV_RXX_RYX(PCT_INFO pInfo,byte_type x,byte_type y) {
+	MOV_RXX_RYX(op,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfMOV_RXX_RYX() {
+	MOV_RXX_RYX(op,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteADD_RXX_RYX(PCT_INFO pInfo,byte_type x,byte_type y) {
+	ADD_RXX_RYX(op,x,y)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfADD_RXX_RYX() {
+	ADD_RXX_RYX(op,0,0)
+	return sizeof(op);
+}
+inline void CompilerWriteADD_RXX_IMM32(PCT_INFO pInfo,byte_type x) {
+	ADD_RXX_IMM32(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfADD_RXX_IMM32() {
+	ADD_RXX_IMM32(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSUB_RXX_IMM32(PCT_INFO pInfo,byte_type x) {
+	SUB_RXX_IMM32(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSUB_RXX_IMM32() {
+	SUB_RXX_IMM32(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteCMP_RXX_IMM32(PCT_INFO pInfo,byte_type x) {
+	CMP_RXX_IMM32(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfCMP_RXX_IMM32() {
+	CMP_RXX_IMM32(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteSHR_RXX_IMM8(PCT_INFO pInfo,byte_type x) {
+	SHR_RXX_IMM8(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfSHR_RXX_IMM8() {
+	SHR_RXX_IMM8(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteXOR_EXX_EXX(PCT_INFO pInfo,byte_type x) {
+	XOR_EXX_EXX(op,x)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfXOR_EXX_EXX() {
+	XOR_EXX_EXX(op,0)
+	return sizeof(op);
+}
+inline void CompilerWriteREP_STOSQ(PCT_INFO pInfo) {
+	REP_STOSQ(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfREP_STOSQ() {
+	REP_STOSQ(op)
+	return sizeof(op);
+}
+inline void CompilerWriteJB_IMM32(PCT_INFO pInfo) {
+	JB_IMM32(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfJB_IMM32() {
+	JB_IMM32(op)
+	return sizeof(op);
+}
+inline void CompilerWriteJMP_IMM32(PCT_INFO pInfo) {
+	JMP_IMM32(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfJMP_IMM32() {
+	JMP_IMM32(op)
+	return sizeof(op);
+}
+inline void CompilerWriteVZEROUPPER(PCT_INFO pInfo) {
+	VZEROUPPER(op)
+	CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+}
+inline unsigned int CompilerSizeOfVZEROUPPER() {
+	VZEROUPPER(op)
+	return sizeof(op);
+}
+inline int CompilerVectorWidth(int i_vector_isa) {
+	return (i_vector_isa == VECTOR_ISA_AVX512)?8:(i_vector_isa == VECTOR_ISA_AVX2)?4:1;
+}
+//ENCODES THE VEX OR EVEX PREFIX AND THE OPCODE OF A PACKED DOUBLE INSTRUCTION
+inline void CompilerWriteVECTOR_PD(PCT_INFO pInfo,byte_type code,byte_type v) {
+	if (pInfo->i_vector_isa == VECTOR_ISA_AVX512) {
+		EVEX512_PD(op,code,v)
+		CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+	}
+	else {
+		VEX256_PD(op,code,v)
+		CompilerWriteInstruction(pInfo,(byte_type*)&op,sizeof(op));
+	}
+}
+inline unsigned int CompilerSizeOfVECTOR_PD(PPT_INFO pParseInfo) {
+	EVEX512_PD(evex,0,0)
+	VEX256_PD(vex,0,0)
+	return (pParseInfo->i_vector_isa == VECTOR_ISA_AVX512)?sizeof(evex):sizeof(vex);
+}
+//ENCODES code vec(x),vec(v),vec(y)
+inline void CompilerWriteVECTOR_PD_VEC_VEC(PCT_INFO pInfo,byte_type code,byte_type x,byte_type v,byte_type y) {
+	CompilerWriteVECTOR_PD(pInfo,code,v);
+	CompilerWriteIMM8(pInfo,0xC0u | (REG_XMM(x)<<3) | REG_XMM(y));
+}
+inline unsigned int CompilerSizeOfVECTOR_PD_VEC_VEC(PPT_INFO pParseInfo) {
+	return CompilerSizeOfVECTOR_PD(pParseInfo) + CompilerSizeOfIMM8();
+}
+//ENCODES code vec(x),vec(v),[rbp+disp]
+inline void CompilerWriteVECTOR_PD_VEC_FRAME(PCT_INFO pInfo,byte_type code,byte_type x,byte_type v,int disp) {
+	CompilerWriteVECTOR_PD(pInfo,code,v);
+	CompilerWriteIMM8(pInfo,0x85u | (REG_XMM(x)<<3));
+	CompilerWriteINT32(pInfo,disp);
+}
+inline unsigned int CompilerSizeOfVECTOR_PD_VEC_FRAME(PPT_INFO pParseInfo) {
+	return CompilerSizeOfVECTOR_PD(pParseInfo) + CompilerSizeOfIMM8() + CompilerSizeOfINT32();
+}
+//ENCODES code vec(x),vec(v),[rax+rbx]
+inline void CompilerWriteVECTOR_PD_VEC_RAX_RBX(PCT_INFO pInfo,byte_type code,byte_type x,byte_type v) {
+	CompilerWriteVECTOR_PD(pInfo,code,v);
+	CompilerWriteIMM8(pInfo,0x04u | (REG_XMM(x)<<3));
+	CompilerWriteIMM8(pInfo,(REG_EBX<<3) | REG_EAX);
+}
+inline unsigned int CompilerSizeOfVECTOR_PD_VEC_RAX_RBX(PPT_INFO pParseInfo) {
+	return CompilerSizeOfVECTOR_PD(pParseInfo) + 2*CompilerSizeOfIMM8();
+}
+//LOADS ONE VECTOR OF d INTO THE LOCAL STORE AND ENCODES code vec(x),vec(v),[rip+constant]
+inline void CompilerWriteVECTOR_PD_VEC_CONSTANT(PCT_INFO pInfo,byte_type code,byte_type x,byte_type v,double d) {
+	unsigned char * pLocalPos = pInfo->pv_local_storage_pos;
+	for(int i = 0;i < CompilerVectorWidth(pInfo->i_vector_isa);i++)
+		CompilerWriteLocalInfo(pInfo,(byte_type*)&d,sizeof(double));
+	CompilerWriteVECTOR_PD(pInfo,code,v);
+	CompilerWriteIMM8(pInfo,0x05u | (REG_XMM(x)<<3));
+	CompilerWriteRIPX_INT32(pInfo,pLocalPos);
+}
+inline unsigned int CompilerSizeOfVECTOR_PD_VEC_CONSTANT(PPT_INFO pParseInfo) {
+	return CompilerSizeOfVECTOR_PD(pParseInfo) + CompilerSizeOfIMM8() + CompilerSizeOfINT32();
+}
+inline size_t CompilerLocalSizeOfVECTOR_PD_VEC_CONSTANT(PPT_INFO pParseInfo) {
+	return CompilerVectorWidth(pParseInfo->i_vector_isa)*sizeof(double);
+}
+//LOADS THE ADDRESS OF COLUMN i INTO RAX
+inline void CompilerWriteX64LoadColumn(PCT_INFO pInfo,int i) {
+	CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COLUMNS);
+	CompilerWriteMOV_RXX_RYXX_IMM32(pInfo,REG_EAX,REG_EAX);
+		CompilerWriteINT32(pInfo,i*(int)sizeof(double*));
+}
+inline unsigned int CompilerSizeOfX64LoadColumn() {
+	return CompilerSizeOfMOV_RXX_RBPX_IMM32() + CompilerSizeOfMOV_RXX_RYXX_IMM32() + 2*CompilerSizeOfINT32();
+}
+//CALLS pFunction FROM A BATCH KERNEL, THE UPPER VECTOR STATE IS CLEARED FIRST
+inline void CompilerWriteX64VectorCALL_IMM64(PCT_INFO pInfo,void * pFunction) {
+	CompilerWriteVZEROUPPER(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,pFunction);
+}
+inline unsigned int CompilerSizeOfX64VectorCALL_IMM64() {
+	return CompilerSizeOfVZEROUPPER() + CompilerSizeOfX64CALL_IMM64();
+}
+//ENCODES MOV rdi,pObject, pObject IS RECORDED IN THE PTR MAP
+inline void CompilerWriteX64ThisArgument(PCT_INFO pInfo,void * pObject) {
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EDI);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)pObject);
+}
+inline unsigned int CompilerSizeOfX64ThisArgument() {
+	return CompilerSizeOfMOV_RXX_IMM64() + CompilerSizeOfIMM64();
+}
 
 namespace calculus 
 {
+	//SERIALIZES THE STRUCTURES SHARED BY EVERY THREAD: THE CONS TABLE, THE VARIABLE REGISTRY, THE CODE ARENA AND
+	//THE LAZY CACHES OF THE OPERATORS.  IT IS ONLY TAKEN TO BUILD, A BUILT OPERATOR EVALUATES WITHOUT IT
+	std::recursive_mutex& build_lock();
+
+	//EXECUTABLE STORAGE FOR THE COMPILED FUNCTIONS.  EVERY CHUNK IS MAPPED TWICE: A READ/EXECUTE VIEW THE CODE RUNS FROM
+	//AND A WRITE VIEW THAT IS ONLY ACCESSIBLE WHILE A SLOT OF THE CHUNK IS OPEN.  allocate() OPENS A SLOT AND RETURNS ITS
+	//ADDRESS IN THE WRITE VIEW, seal() MOVES THE FUNCTION OVER TO THE EXECUTE VIEW THROUGH ITS PTR MAP AND CLOSES THE
+	//WRITE VIEW ONCE NO SLOT IS OPEN.  SLOTS ARE PACKED SLOT_ALIGNMENT APART, NO VIEW IS EVER WRITABLE AND EXECUTABLE.
+	class code_arena
+	{
+		typedef struct CODE_ARENA_EXTENT {
+			size_t				st_offset;				//Offset of the free extent in its chunk
+			size_t				st_size;				//Size of the free extent
+			CODE_ARENA_EXTENT*	p_next;					//Next free extent, by increasing offset
+		} CODE_ARENA_EXTENT,*PCODE_ARENA_EXTENT;
+		typedef struct CODE_ARENA_CHUNK {
+			unsigned char*		pv_base;				//Start of the read/execute view
+			unsigned char*		pv_write;				//Start of the write view
+			size_t				st_size;				//Size of the mapping
+			size_t				st_used;				//Bytes held by live slots
+			int					i_open;					//Slots allocated but not sealed yet
+			CODE_ARENA_EXTENT*	p_free;					//Free extents, by increasing offset
+			CODE_ARENA_CHUNK*	p_next;					//Next chunk
+		} CODE_ARENA_CHUNK,*PCODE_ARENA_CHUNK;
+		static PCODE_ARENA_CHUNK s_p_first_chunk;
+		static size_t s_st_page_size;
+		static PCODE_ARENA_CHUNK map_chunk(size_t st_size);
+		static void unmap_chunk(PCODE_ARENA_CHUNK pChunk);
+		static PCODE_ARENA_CHUNK find_chunk(unsigned char * pv);
+		static bool protect(unsigned char * pv,size_t st_size,bool b_writable);
+		static bool close_slot(PCODE_ARENA_CHUNK pChunk);
+		static size_t round_to_pages(size_t st_size);
+	public :
+		static const size_t CHUNK_SIZE = 0x10000u;
+		static const size_t SLOT_ALIGNMENT = 0x10u;
+		static unsigned char * allocate(size_t st_size);
+		static bool seal(PCOMPILER_HEADER pHead);
+		static void release(unsigned char * pv,size_t st_size);
+		static void free_all();
+		static size_t get_mapped_size();
+		static size_t get_used_size();
+		static int get_chunk_count();
+	};
+
+	//SMALL BLOCKS FOR THE OPERATORS AND THEIR ARRAYS.  THE BLOCKS OF A SIZE CLASS ARE CARVED OUT OF CHUNKS OF THEIR OWN, SO
+	//THE NODES OF A TREE BUILT TOGETHER SIT TOGETHER.  EVERY THREAD KEEPS A FEW FREE BLOCKS OF EACH CLASS AND TRADES THEM
+	//WITH THE SHARED LISTS NODE_POOL_BATCH AT A TIME.  trim() FREES EVERY CHUNK AT ONCE, WHEN NO BLOCK IS OUTSTANDING.
+	class node_pool
+	{
+		typedef struct NODE_POOL_CLASS {
+			void*				pv_free;				//Shared free blocks, linked through their first word
+			size_t				st_free;				//Number of shared free blocks
+			size_t				st_outstanding;			//Blocks handed to the threads, in use or in their caches
+		} NODE_POOL_CLASS,*PNODE_POOL_CLASS;
+		typedef struct NODE_POOL_CACHE {
+			void*				ppv_free[NODE_POOL_CLASSES];	//Free blocks of this thread
+			unsigned int		pui_count[NODE_POOL_CLASSES];
+			~NODE_POOL_CACHE();
+		} NODE_POOL_CACHE,*PNODE_POOL_CACHE;
+		static NODE_POOL_CLASS s_npc_classes[NODE_POOL_CLASSES];
+		static void* s_pv_first_chunk;
+		static size_t s_st_chunk_count;
+		static std::mutex s_m_lock;
+		static thread_local NODE_POOL_CACHE s_npc_cache;
+		static void refill(int i_class);
+		static void flush(int i_class,unsigned int ui_count);
+	public :
+		static void* allocate(size_t st_size);
+		static void release(void* pv,size_t st_size);
+		//AN ARRAY REMEMBERS ITS SIZE IN THE GRANULE BEFORE IT, release_array() ONLY NEEDS THE POINTER
+		template <class T> static T* allocate_array(size_t st_count) {
+			unsigned char* pv = (unsigned char*)allocate(NODE_POOL_GRANULE + st_count*sizeof(T));
+			*(size_t*)pv = NODE_POOL_GRANULE + st_count*sizeof(T);
+			return (T*)(pv + NODE_POOL_GRANULE);
+		}
+		static void release_array(void* pv) {
+			unsigned char* pv_block = ((unsigned char*)pv) - NODE_POOL_GRANULE;
+			release(pv_block,*(size_t*)pv_block);
+		}
+		//RETURNS THE CHUNKS WHEN EVERY BLOCK IS BACK, FALSE WHEN SOME ARE STILL IN USE
+		static bool trim();
+		static size_t get_outstanding_count();
+		static size_t get_chunk_count();
+	};
+
+	//A FLATTENED, POST-ORDER COPY OF AN OPERATOR TREE.  THE VARIABLES ARE RESOLVED TO THE INDICES OF THE ROOT
+	//ONCE, SO eval() IS A SINGLE LOOP OVER THE INSTRUCTIONS THAT NEVER ALLOCATES.  OPERATORS WITHOUT AN OPCODE
+	//ARE CALLED BACK.  THE TAPE DOESN'T HOLD REFERENCES, IT LIVES AS LONG AS THE ROOT THAT OWNS IT.  A FINALIZED
+	//TAPE IS READ-ONLY, EVERY SWEEP WORKS IN THE SCRATCH OF ITS THREAD SO SEVERAL THREADS MAY SWEEP IT AT ONCE.
+	class tape
+	{
+		PTAPE_INSTRUCTION m_pti_instructions;
+		int m_i_instruction_count;
+		int m_i_instruction_capacity;
+		int* m_pi_indices;								//Index tables of the TAPE_OP_CALL instructions
+		int m_i_index_count;
+		int m_i_index_capacity;
+		int m_i_depth;
+		int m_i_max_depth;
+		int m_i_max_gather;								//Largest index table
+		int m_i_num_vars;
+		variable** m_ppv_vars;							//The variables of the root, in argument order
+		int* m_pi_operands;								//Instruction producing each operand, 2 per instruction, built by finalize()
+		PTAPE_INSTRUCTION append(int i_opcode,int i_arg,int i_stack_delta);
+		void link_operands();
+		//0 WHEN THE STACK, THE GATHER AND THE TANGENT STACK FIT IN TAPE_LOCAL_STACK_SIZE
+		size_t stack_scratch_size();
+	public :
+		tape(int i_num_vars,variable** ppv_vars);
+		~tape();
+		void write(int i_opcode,int i_arg = 0);
+		void write_constant(double d_value);
+		void write_operator(int i_opcode,algebraic_operator* pao_operator,int i_arg = 0);
+		void write_call(algebraic_operator* pao_operator,int i_num_vars,variable** ppv_vars);
+		int index_of(variable* pVar);
+		void finalize();
+		double eval(double* pVars);
+		//ONE FORWARD AND ONE REVERSE SWEEP, RETURNS THE VALUE AND STORES EVERY PARTIAL IN pd_gradient[m_i_num_vars]
+		double gradient(double* pVars,double* pd_gradient);
+		//ONE FORWARD SWEEP OF (VALUE,TANGENT) PAIRS, RETURNS THE VALUE AND STORES THE DERIVATIVE ALONG pd_direction IN *pd_tangent.
+		//THE TANGENT IS EXACT ONLY WHEN EVERY OPERATOR HAS AN ANALYTIC DERIVATIVE: A TAPE_OP_CALL TAKES A CENTRED DIFFERENCE
+		//ALONG THE DIRECTION, AND AN OPERATOR THAT DOESN'T OVERRIDE eval_unary_derivative() OR eval_binary_derivatives() FALLS BACK
+		//TO THEIR DEFAULT CENTRED DIFFERENCES
+		double eval_dual(double* pVars,const double* pd_direction,double* pd_tangent);
+		//eval_dual() OVER gradient(), ALSO STORES THE HESSIAN-VECTOR PRODUCT H*pd_direction IN pd_hv[m_i_num_vars]
+		double hessian_vector(double* pVars,const double* pd_direction,double* pd_gradient,double* pd_hv);
+		int get_instruction_count() { return m_i_instruction_count; };
+		int get_max_depth() { return m_i_max_depth; };
+		const TAPE_INSTRUCTION* get_instructions() { return m_pti_instructions; };
+	};
+
+	//ONE EXPRESSION OF AN expression_image, READ IN PLACE.  eval() IS A SINGLE LOOP OVER THE NODES THAT NEVER ALLOCATES
+	//UNLESS THE STACK IS DEEPER THAN TAPE_LOCAL_STACK_SIZE.  THE VIEW IS VALID AS LONG AS ITS IMAGE
+	class expression_view
+	{
+		friend class expression_image;
+		const EXPRESSION_IMAGE_NODE* m_pn_nodes;
+		int m_i_num_nodes;
+		int m_i_max_depth;
+		const double* m_pd_constants;
+		const unsigned int* m_pui_arguments;			//Indices of the variables in the name table
+		int m_i_num_vars;
+		const unsigned int* m_pui_name_offsets;
+		const char* m_psc_names;
+	public :
+		//pVars[i] IS THE VALUE OF get_variable_name(i), AN EXPRESSION WITHOUT NODES IS 0
+		double eval(const double* pVars);
+		int get_number_of_variables() { return m_i_num_vars; };
+		const char* get_variable_name(int i) { return m_psc_names + m_pui_name_offsets[m_pui_arguments[i]]; };
+		int get_node_count() { return m_i_num_nodes; };
+		//REBUILDS THE OPERATOR, ITS VARIABLES ARE REGISTERED BY NAME.  NULL FOR AN EXPRESSION WITHOUT NODES
+		algebraic_operator* to_algebra();
+	};
+
+	//A FILE OF EXPRESSIONS SAVED AS THEIR TAPES, MAPPED READ-ONLY.  THE NODES, THE CONSTANTS AND THE NAMES ARE NEVER
+	//COPIED, load() ONLY CHECKS THEM ONCE SO THE VIEWS CAN TRUST THEM
+	class expression_image
+	{
+		const unsigned char* m_pv_image;
+		size_t m_st_size;
+		int m_i_count;
+		expression_image(const unsigned char* pv_image,size_t st_size);
+		bool is_valid();
+	public :
+		~expression_image();
+		//FALSE WHEN THE FILE CAN'T BE WRITTEN OR WHEN AN OPERATOR HAS NO OPCODE IN THE FORMAT, AS A CALL BACK INTO A
+		//DERIVATIVE, A POLYNOMIAL OR A USER FUNCTION.  A NULL OPERATOR IS SAVED AS AN EXPRESSION WITHOUT NODES
+		static bool save(const char* psc_path,algebraic_operator** ppao_operators,int i_count);
+		//NULL WHEN THE FILE CAN'T BE MAPPED OR IS NOT A VALID IMAGE
+		static expression_image* load(const char* psc_path);
+		int get_count() { return m_i_count; };
+		expression_view get_expression(int i);
+	};
+
 	class IA32_binary
 	{
         friend class algebraic_operator;
@@ -936,13 +1879,17 @@ namespace calculus
 		static IA32_binary* s_pia32b_last;
 		IA32_binary * m_pia32b_next, * m_pia32b_previous;
 		unsigned short* m_pus_binary;
+		PCOMPILER_HEADER m_p_header;
+		static void free_compiler_header(PCOMPILER_HEADER pHead);
     public :
 		static inline void free_all_IA32_binaries() {
 			while(IA32_binary::s_pia32b_last)
 				delete IA32_binary::s_pia32b_last;
 		}
-		IA32_binary(unsigned short* pus_binary) {
-			m_pus_binary = pus_binary;
+		IA32_binary(PCOMPILER_HEADER pHead) {
+			std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+			m_p_header = pHead;
+			m_pus_binary = (unsigned short*)pHead->pInstructions;
 			if (IA32_binary::s_pia32b_first == NULL) {
 				IA32_binary::s_pia32b_last = IA32_binary::s_pia32b_first = this;
 				IA32_binary::s_pia32b_first->m_pia32b_previous = NULL;
@@ -954,67 +1901,322 @@ namespace calculus
 			IA32_binary::s_pia32b_last->m_pia32b_next = NULL;
 		}
 		~IA32_binary() {
-			PCOMPILER_HEADER pHead = PCOMPILER_HEADER(this->m_pus_binary-sizeof(dword_type));
-			free(pHead);
+			std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+			free_compiler_header(m_p_header);
 			if ((this != IA32_binary::s_pia32b_last)&&(this != IA32_binary::s_pia32b_first)) {
 				m_pia32b_previous->m_pia32b_next = m_pia32b_next;
 				m_pia32b_next->m_pia32b_previous = m_pia32b_previous;
 			}
-			else if (this == IA32_binary::s_pia32b_first) {
-				IA32_binary::s_pia32b_first = this->m_pia32b_next;
-				if (IA32_binary::s_pia32b_first)
-					IA32_binary::s_pia32b_first->m_pia32b_previous = NULL;
-			}
-            else {
-				IA32_binary::s_pia32b_last = this->m_pia32b_previous;
-				if (IA32_binary::s_pia32b_last)
-					IA32_binary::s_pia32b_last->m_pia32b_next = NULL;
+			else {
+				if (this == IA32_binary::s_pia32b_first) {
+					IA32_binary::s_pia32b_first = this->m_pia32b_next;
+					if (IA32_binary::s_pia32b_first)
+						IA32_binary::s_pia32b_first->m_pia32b_previous = NULL;
+				}
+				if (this == IA32_binary::s_pia32b_last) {
+					IA32_binary::s_pia32b_last = this->m_pia32b_previous;
+					if (IA32_binary::s_pia32b_last)
+						IA32_binary::s_pia32b_last->m_pia32b_next = NULL;
+				}
 			}
 		}
+		PCOMPILER_HEADER get_header() {
+			return m_p_header;
+		}
+		//WRITES THE CODE AS A FUNCTION IMAGE.  FALSE WHEN THE FILE CAN'T BE WRITTEN OR WHEN A POINTER OF THE CODE CAN'T BE
+		//RELOCATED, AS IN A CALL BACK INTO AN OPERATOR OR A USER FUNCTION OF THIS PROCESS
+		bool save_image(const char * psc_path);
+		//MAPS A FUNCTION IMAGE AND RELOCATES ITS CODE INTO THE code_arena, NULL WHEN THE FILE IS NOT A VALID IMAGE FOR THE
+		//TARGET OF THIS BUILD.  THE BINARY IS FREED WITH THE OTHERS BY uninitialize_calculus() UNLESS IT IS DELETED FIRST
+		static IA32_binary* load_image(const char * psc_path);
+	};
+
+	//THE PARTIALS OF m COMPONENTS WITH RESPECT TO n VARIABLES, COMPILED INTO ONE X64 KERNEL.  THE STRUCTURAL ZEROS
+	//ARE DROPPED WHEN THE PARTIALS ARE TAKEN, THE OPERATORS SHARED BY SEVERAL ENTRIES ARE COMPUTED ONCE PER CALL INTO
+	//A FRAME SLOT.  THE ENTRIES ARE HELD UNTIL THE JACOBIAN IS DELETED, WHICH MUST HAPPEN BEFORE uninitialize_calculus().
+	class jacobian
+	{
+		int m_i_rows;
+		int m_i_cols;
+		int m_i_layout;									//JACOBIAN_LAYOUT_*
+		int m_i_nonzeros;
+		int* m_pi_row_pointers;							//m_i_rows+1 offsets into m_pi_column_indices
+		int* m_pi_column_indices;						//Column of every nonzero, row major
+		algebraic_operator** m_ppao_entries;			//Partial of every nonzero, referenced
+		variable** m_ppv_vars;							//The columns, referenced
+		IA32_binary* m_pia32_binary;
+		JACOBIAN_FUNCTION m_pf_kernel;
+		jacobian(int i_rows,int i_cols,int i_layout,variable** ppv_vars);
+		IA32_binary* to_X64_binary();
+	public :
+		~jacobian();
+		//NULL WHEN A COMPONENT DEPENDS ON A VARIABLE MISSING FROM ppv_vars OR WHEN THERE IS NO X64 TARGET
+		static jacobian* compile_jacobian(algebraic_operator** ppao_functions,int m,variable** ppv_vars,int n,int i_layout = JACOBIAN_LAYOUT_CSR);
+		static jacobian* compile_hessian(algebraic_operator* pao_function,variable** ppv_vars,int n,int i_layout = JACOBIAN_LAYOUT_CSR);
+		//pd_x[n] HOLDS THE VALUES OF THE VARIABLES, pd_out RECEIVES get_nonzeros() OR m*n VALUES DEPENDING ON THE LAYOUT
+		void eval(const double* pd_x,double* pd_out) { m_pf_kernel(pd_x,pd_out); };
+		JACOBIAN_FUNCTION get_kernel() { return m_pf_kernel; };
+		int get_rows() { return m_i_rows; };
+		int get_cols() { return m_i_cols; };
+		int get_layout() { return m_i_layout; };
+		int get_nonzeros() { return m_i_nonzeros; };
+		const int* get_row_pointers() { return m_pi_row_pointers; };
+		const int* get_column_indices() { return m_pi_column_indices; };
+		algebraic_operator* get_entry(int k) { return m_ppao_entries[k]; };
+	};
+
+	//THE NONZERO PATTERN OF THE HESSIAN OF AN OPERATOR AND A COLORING OF ITS COLUMNS.  THE PATTERN IS READ FROM THE VARIABLES
+	//OF THE OPERATORS, ONLY THE OPERANDS OF A PRODUCT OR OF A NONLINEAR OPERATOR ARE COUPLED.  COLUMNS OF ONE COLOR NEVER SHARE
+	//A ROW, SO A SINGLE hessian_vector() SWEEP ALONG THE SUM OF THEIR UNIT VECTORS RECOVERS ALL OF THEIR ENTRIES.  NO PARTIAL
+	//IS EVER BUILT.  THE COLUMNS ARE get_variables().  eval() WORKS IN THE SCRATCH OF THE OBJECT, CREATE ONE PER THREAD.
+	class sparse_hessian
+	{
+		algebraic_operator* m_pao_function;				//Referenced
+		int m_i_num_vars;
+		int m_i_nonzeros;
+		int* m_pi_row_pointers;							//m_i_num_vars+1 offsets into m_pi_column_indices
+		int* m_pi_column_indices;						//Column of every nonzero, sorted within each row
+		int* m_pi_colors;								//Color of every column
+		int m_i_num_colors;
+		double* m_pd_direction;							//Seed of one color
+		double* m_pd_gradient;
+		double* m_pd_products;							//H times the seed of every color, m_i_num_vars per color
+		double* m_pd_values;							//Values of the last eval_comp_row()
+		sparse_hessian(algebraic_operator* pao_function);
+		void color_columns();
+	public :
+		~sparse_hessian();
+		static sparse_hessian* create(algebraic_operator* pao_function);
+		//RETURNS THE VALUE, pd_values RECEIVES get_nonzeros() ENTRIES IN CSR ORDER AND pd_gradient, WHEN GIVEN, THE GRADIENT
+		double eval(double* pVars,double* pd_values,double* pd_gradient = NULL);
+		//THE HESSIAN AS A COMPRESSED ROW MATRIX, FOR INSTANCE TNT::Sparse_Matrix_CompRow<double>, A VIEW VALID UNTIL THE NEXT CALL
+		template <class COMP_ROW_MATRIX> COMP_ROW_MATRIX eval_comp_row(double* pVars) {
+			eval(pVars,m_pd_values);
+			return COMP_ROW_MATRIX(m_i_num_vars,m_i_num_vars,m_i_nonzeros,m_pd_values,m_pi_row_pointers,m_pi_column_indices);
+		};
+		int get_num_vars() { return m_i_num_vars; };
+		int get_nonzeros() { return m_i_nonzeros; };
+		int get_num_colors() { return m_i_num_colors; };
+		const int* get_row_pointers() { return m_pi_row_pointers; };
+		const int* get_column_indices() { return m_pi_column_indices; };
+		const int* get_colors() { return m_pi_colors; };
 	};
 
+	//A WORK-STEALING POOL OF get_num_threads()-1 WORKERS.  parallel_for() CUTS [0,st_n) INTO CHUNKS DEALT TO THE QUEUES
+	//OF THE WORKERS, A WORKER TAKES THE NEWEST CHUNK OF ITS OWN QUEUE AND STEALS THE OLDEST OF ANOTHER WHEN IT RUNS DRY.
+	//THE CALLER WORKS UNTIL ITS CHUNKS ARE DONE, SO SEVERAL THREADS MAY CALL parallel_for() AND A TASK MAY CALL IT AGAIN.
+	struct THREAD_POOL_STATE;
+	class thread_pool
+	{
+		THREAD_POOL_STATE* m_p_state;
+		static std::atomic<thread_pool*> s_ptp_service;
+		thread_pool(int i_num_threads);
+		~thread_pool();
+		static void worker(thread_pool* ptp,int i_worker);
+	public :
+		//THE POOL IS STARTED BY THE FIRST CALL, WITH ONE THREAD PER HARDWARE THREAD
+		static thread_pool* get_service();
+		static void kill_service();
+		//STOPS THE POOL AND STARTS ONE WITH i_num_threads THREADS, 0 FOR ONE PER HARDWARE THREAD
+		static thread_pool* restart_service(int i_num_threads);
+		//CALLS pf_task(pv_context,st_begin,st_end) OVER CHUNKS OF AT LEAST st_grain INDICES COVERING [0,st_n)
+		void parallel_for(size_t st_n,size_t st_grain,PARALLEL_TASK pf_task,void* pv_context);
+		int get_num_threads();
+	};
+
+	//A GROWABLE TEXT BUFFER, ALWAYS TERMINATED.  THE OPERATORS APPEND THEMSELVES TO IT IN write_string(), SO A TREE IS
+	//RENDERED IN ONE PASS IN TIME LINEAR IN ITS TEXT.  SHORT TEXTS STAY IN THE WRITER, clear() KEEPS THE STORAGE.
+	class string_writer
+	{
+		char* m_psc_buffer;
+		size_t m_st_length;
+		size_t m_st_capacity;
+		char m_psc_local[STRING_WRITER_LOCAL_SIZE];
+		void grow(size_t st_length);
+		string_writer(const string_writer&);
+		string_writer& operator=(const string_writer&);
+	public :
+		string_writer();
+		~string_writer();
+		void write(const char* psc);
+		void write(const char* psc,size_t st_length);
+		void write(char c);
+		//APPENDS LIKE sprintf()
+		void print(const char* psc_format,...);
+		const char* get_string() const { return m_psc_buffer; }
+		size_t get_length() const { return m_st_length; }
+		void clear();
+	};
+
+	//THE SORTED VARIABLES OF AN OPERATOR.  A PARENT WHOSE NEW VARIABLES ALL FOLLOW THE LAST ONE OF ITS OPERAND
+	//APPENDS THEM IN PLACE WHILE THE OPERAND'S SPAN ENDS AT i_used, SO THE SPANS OF A LONG SUM SHARE ONE BUFFER
+	typedef struct VARIABLE_BUFFER {
+		int					i_used;					//Length of the longest span handed out
+		int					i_capacity;
+		variable*			ppv_variables[1];
+	} VARIABLE_BUFFER,*PVARIABLE_BUFFER;
+	#define VARIABLE_BUFFER_OF(ppv) ((calculus::PVARIABLE_BUFFER)(((unsigned char*)(ppv))-offsetof(calculus::VARIABLE_BUFFER,ppv_variables)))
+
 	class algebraic_operator
 	{
 
 	protected :
-        bool m_b_variables_identified;
+        std::atomic<bool> m_b_variables_identified;                   //Set once m_ppv_variables is complete
 		int m_i_number_of_variables;
 		variable** m_ppv_variables;
+		bool m_b_borrowed_variables;                                  //m_ppv_variables belongs to an operand
+		bool m_b_variable_buffer;                                     //m_ppv_variables is the span of a VARIABLE_BUFFER
+		int m_i_borrowed_variables;                                   //How many of m_ppv_variables the operand had, we appended the rest
         static unsigned int s_ui_compilation_deferral;
 		static unsigned short s_us_compile_flags;
-		unsigned int m_ui_call_count;
-		unsigned long m_ul_refcount;                             //The reference count
-		algebraic_operator** m_ppao_partial_derivatives;					//Link to the derived functions
-        IA32_binary * m_pia32_binary;                                 //Link to the IA32_binary version
+		std::atomic<unsigned int> m_ui_call_count;
+		std::atomic<unsigned long> m_ul_refcount;                //The reference count
+		algebraic_operator** m_ppao_partial_derivatives;					//Link to the derived functions, under build_lock()
+        std::atomic<IA32_binary*> m_pia32_binary;                     //Link to the IA32_binary version
+        std::atomic<IA32_binary*> m_pia32_batch_binary;               //Link to the batch kernel
+        std::atomic<tape*> m_pt_tape;                                 //The evaluation tape, owned by this operator
+        static int s_i_vector_isa;                                    //VECTOR_ISA_* used by compile_batch()
+        bool m_b_interned;                                            //True while this operator is listed in the cons table
+        algebraic_operator * m_pao_cons_next;                         //Next operator in the same cons table bucket
+        static algebraic_operator ** s_ppao_cons_table;               //The cons table, shares structurally identical operators
+        static size_t s_st_cons_table_size;                           //Number of buckets in the cons table, a power of 2
+        static size_t s_st_cons_count;                                //Number of operators held in the cons table
+        //THE LAST OPERATORS INTERNED OR FOUND FOR ONE THREAD, IT MAY STILL HOLD THEM UNREFERENCED.  UNDER build_lock()
+        typedef struct HAND_OUT_RING {
+			algebraic_operator*	ppao_operators[CONS_HAND_OUT_RING];
+			unsigned int		ui_next;
+			bool				b_registered;			//Linked in s_phor_rings
+			HAND_OUT_RING*		phor_next;
+			~HAND_OUT_RING();
+		} HAND_OUT_RING,*PHAND_OUT_RING;
+        static thread_local HAND_OUT_RING s_hor_ring;
+        static PHAND_OUT_RING s_phor_rings;                           //Every thread that was handed an operator
+        static thread_local bool s_b_sweeping;                        //This thread sweeps the cons table, release() queues what it leaves to the table
+        static algebraic_operator ** s_ppao_swept;                    //The operators the sweep frees next, under build_lock()
+        static size_t s_st_swept_count;
+        static size_t s_st_swept_capacity;
+        std::atomic<qword_type> m_qw_structural_hash;                 //The structural_hash(), 0 until get_hash() computes it, keys the cons table
 
         algebraic_operator();
         virtual ~algebraic_operator();
+		//RETURNS THE INTERNED TWIN OF pao_new AND DELETES pao_new, OR INTERNS AND RETURNS pao_new.  TWINS ARE FOUND BY
+		//get_hash() AND structural_equal(), ON INTERNED OPERANDS THAT IS THEIR ADDRESSES.  THE TABLE HOLDS A
+		//REFERENCE ON EVERY INTERNED OPERATOR AND THE RESULT IS HANDED OUT TO THE CALLING THREAD
+		static algebraic_operator * intern(algebraic_operator * pao_new);
+		//PUTS AN INTERNED OPERATOR IN THE HAND_OUT_RING OF THIS THREAD, UNDER build_lock()
+		void hand_out();
+		//FREES THE INTERNED OPERATORS ONLY THE TABLE REFERENCES, BUT NOT THOSE IN A HAND_OUT_RING, UNTIL THEIR
+		//OPERANDS ARE NO LONGER FREED.  RETURNS HOW MANY WERE FREED
+		static size_t sweep_cons_table();
+		//APPENDS THIS TO THE OPERATORS THE SWEEP FREES NEXT
+		void queue_swept();
+		//A HASH OF THE TYPE, THE CONSTANTS AND THE get_hash() OF THE OPERANDS.  BY DEFAULT THE ADDRESS, SO ONLY this equals() this
+		virtual qword_type structural_hash();
+		//TRUE WHEN pao_other IS OF THE SAME TYPE, WITH THE SAME CONSTANTS AND OPERANDS THAT equals() OURS.  ONLY CALLED ON EQUAL HASHES
+		virtual bool structural_equal(algebraic_operator * pao_other);
+		void release_partial_derivatives();
 		virtual algebraic_operator* partial_derivative(variable * pVar);
 		virtual variable** identify_variables();
+		//CALLS identify_variables() ONCE, THE OTHER THREADS WAIT FOR IT AND THEN SEE THE COMPLETE ARRAY
+		void identify_variables_once();
+		//RELEASES m_ppv_variables, GIVING BACK WHAT WE APPENDED WHEN IT IS BORROWED
+		void release_variables();
+		//SHARES THE VARIABLES OF pao_operand, THE OPERAND OUTLIVES US
+		void borrow_variables(algebraic_operator* pao_operand);
+		static double eval_callback(algebraic_operator * pao_operator,double* pVars);
+		static void eval_batch_callback(algebraic_operator * pao_operator,const double* const* ppd_columns,size_t st_n,double* pd_out);
 	public :
 		virtual void to_IA32_binary(PCT_INFO pInfo);
 		virtual void annotate(PPT_INFO pParseInfo);
-		virtual int to_string(char* pBuffer);
+		virtual void to_X64_binary(PCT_INFO pInfo);
+		virtual void annotate_X64(PPT_INFO pParseInfo);
+		virtual void to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_operand(PPT_INFO pParseInfo);
+		//to_X64_binary() AND annotate_X64() FOR AN OPERAND, A SHARED OPERAND IS COMPUTED ONCE INTO A FRAME SLOT
+		void to_X64_shared(PCT_INFO pInfo);
+		void annotate_X64_shared(PPT_INFO pParseInfo);
+		virtual void to_X64_vector(PCT_INFO pInfo);
+		virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+		virtual void to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_vector_operand(PPT_INFO pParseInfo);
+		virtual void to_tape(tape* pTape);
+		//APPENDS THE TEXT OF THE OPERATOR TO THE WRITER
+		virtual void write_string(string_writer* psw);
+		//COPIES THE TEXT TO pBuffer AND RETURNS ITS LENGTH, WITHOUT THE TERMINATOR.  A NULL pBuffer ONLY RETURNS THE LENGTH
+		int to_string(char* pBuffer);
 		virtual int get_number_of_variables();
 		virtual variable** get_variables();
+		//TRUE WHEN get_variables() IS SORTED BY NAME AND STARTS A VARIABLE_BUFFER
+		bool has_variable_buffer();
 		virtual bool is_function_of(variable* a);
 		virtual algebraic_operator * create_copy();
 		virtual double eval(double* pVars);
+		//EVALUATES st_n POINTS, ppd_columns[i][k] IS THE VALUE OF get_variables()[i] AT POINT k
+		virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out);
 
         IA32_binary* to_IA32_binary();
+        IA32_binary* to_X64_binary();
+        IA32_binary* to_X64_vector_binary();
 		unsigned int get_call_count();
+		//THE CACHED CODE IS BUILT ONCE UNDER build_lock().  IT IS WRITTEN THROUGH THE WRITABLE VIEW OF THE code_arena AND
+		//THE EXECUTABLE VIEW IS NEVER REMAPPED, SO ANY THREAD MAY COMPILE WHILE OTHERS CALL INTO COMPILED FUNCTIONS
 		FUNCTION compile();
+		//COMPILES AND WRITES THE CODE AS A FUNCTION IMAGE, SEE IA32_binary::save_image()
+		bool save_image(const char * psc_path);
+		//FLATTENS THIS OPERATOR ONCE, eval_tape() IS THE PORTABLE ALTERNATIVE TO compile()
+		tape* get_tape();
+		double eval_tape(double* pVars);
+		//THE VALUE AND ALL get_number_of_variables() PARTIALS THROUGH A REVERSE SWEEP OF THE TAPE
+		double eval_gradient(double* pVars,double* pd_gradient);
+		//THE VALUE AND THE DIRECTIONAL DERIVATIVE ALONG pd_direction, A JACOBIAN-VECTOR PRODUCT, THROUGH DUAL NUMBERS.
+		//OPAQUE OPERATORS AND THOSE WITHOUT ANALYTIC DERIVATIVES CONTRIBUTE CENTRED DIFFERENCES, SEE tape::eval_dual()
+		double eval_dual(double* pVars,const double* pd_direction,double* pd_tangent);
+		//THE VALUE, THE GRADIENT AND THE HESSIAN-VECTOR PRODUCT ALONG pd_direction IN ONE FORWARD AND ONE REVERSE SWEEP
+		double eval_hessian_vector(double* pVars,const double* pd_direction,double* pd_gradient,double* pd_hv);
+		//COMPILES A BATCH KERNEL FOR THE CURRENT VECTOR ISA, RETURNS NULL WHEN THERE IS NONE
+		BATCH_FUNCTION compile_batch();
+		//eval_batch() THROUGH THE BATCH KERNEL, THE POINTS THAT DON'T FILL A VECTOR ARE INTERPRETED
+		void eval_batch_compiled(const double* const* ppd_columns,size_t st_n,double* pd_out);
+		//EVALUATES st_n POINTS ON THE THREAD POOL, pd_points[k*get_number_of_variables()+i] IS THE VALUE OF get_variables()[i]
+		//AT POINT k.  THE COMPILED FUNCTION IS USED WHEN THERE IS ONE, THE TAPE OTHERWISE
+		void eval_parallel(const double* pd_points,size_t st_n,double* pd_out);
+		//eval_tape() WITH EVERY VARIABLE v READ FROM pd_slots[v->get_id()], pd_slots HOLDS variable::get_count() VALUES
+		double eval_by_id(const double* pd_slots);
+		static int get_vector_isa() { return s_i_vector_isa; };
+		static int set_vector_isa(int i_vector_isa);
+		static size_t get_cons_count() { return s_st_cons_count; };
+		//THE structural_hash(), COMPUTED ONCE.  NEVER 0, TWO OPERATORS THAT equals() EACH OTHER HAVE THE SAME HASH
+		qword_type get_hash();
+		//STRUCTURAL EQUALITY.  THE HASHES ARE COMPARED FIRST AND A SHARED OPERAND IS EQUAL BY ITS ADDRESS, SO THE
+		//OPERANDS ARE ONLY WALKED WHEN THE TREES ARE EQUAL WITHOUT SHARING THEIR NODES
+		bool equals(algebraic_operator * pao_other);
+		//DROPS THE CACHED DERIVATIVES OF THE INTERNED OPERATORS, THEY MAY CLOSE CYCLES (SIN -> COS -> -SIN), AND SWEEPS
+		//THE TABLE.  NOTHING ELSE FREES AN INTERNED OPERATOR, WHAT THE BUILDS RELEASE STAYS LISTED UNTIL THIS CALL.
+		//SAFE WHILE OTHER THREADS BUILD: A THREAD MAY HOLD THE LAST CONS_HAND_OUT_RING OPERATORS RETURNED TO IT BY
+		//THE CONSTRUCTORS OR get_partial_derivative() UNREFERENCED, IT MUST REFERENCE ANYTHING IT HOLDS LONGER
+		static size_t collect_cons_table();
+		static void FreeConsTable();
+		//DROPS A REFERENCE WITHOUT FREEING, SO THIS CAN BE RETURNED UNREFERENCED LIKE THE RESULT OF A CONSTRUCTOR
+		algebraic_operator* hand_back();
 		algebraic_operator* get_partial_derivative(variable * pVar);
 		void set_partial_derivative(variable * pVar,algebraic_operator * ppartial_derivative);
-		inline void increment_call_count() { this->m_ui_call_count++; };
+		//THE OPERATORS LIVE IN THE NODE POOL, THE VIRTUAL DESTRUCTOR HANDS operator delete() THE SIZE OF THE DERIVED CLASS
+		static void* operator new(size_t st_size) { return calculus::node_pool::allocate(st_size); }
+		static void operator delete(void* pv,size_t st_size) { calculus::node_pool::release(pv,st_size); }
+		inline void increment_call_count() { this->m_ui_call_count.fetch_add(1,std::memory_order_relaxed); };
 
+		//THE COUNT IS ATOMIC, ONE OPERATOR MAY BE SHARED BY EVERY THREAD
         virtual unsigned long addref(void) {
-			return ++(this->m_ul_refcount);
+			return this->m_ul_refcount.fetch_add(1,std::memory_order_relaxed) + 1;
 		}
 		virtual unsigned long release(void) {
-			unsigned long i = --(this->m_ul_refcount);
+			//THE LAST RELEASE MUST SEE EVERY WRITE MADE THROUGH THE OTHER REFERENCES BEFORE IT DELETES.  THE CONS
+			//TABLE HOLDS A REFERENCE, ONLY ITS SWEEP RELEASES AN INTERNED OPERATOR FOR THE LAST TIME
+			unsigned long i = this->m_ul_refcount.fetch_sub(1,std::memory_order_acq_rel) - 1;
 			if (!i)
 				delete this;
+			else if ((i == 1)&&(s_b_sweeping)&&(m_b_interned))
+				queue_swept();
 			return i;
 		}
 	};
@@ -1025,26 +2227,50 @@ namespace calculus
 #define MAX_VARIABLE_NAME_LENGTH 16
 		char m_scVarName[MAX_VARIABLE_NAME_LENGTH];
 		variable * pThis;
-		variable(const char *pVarName);
+		int m_i_id;											//Order of registration, stable until FreeRegistry()
+		size_t m_st_name_hash;
+		variable * m_pv_registry_next;						//Next variable in the same registry bucket
+		variable(const char *pVarName,int i_id);
 		virtual ~variable() {		
 			this->m_ppv_variables = NULL;
 		}
-		static unsigned int nums[27];
-		static variable ** ppVars[27];
+		static variable ** s_ppv_registry;					//Buckets of the registry, hashed on the name
+		static size_t s_st_registry_size;					//Number of buckets, a power of 2
+		static variable ** s_ppv_by_id;						//Every registered variable, indexed by its id
+		static int s_i_count;
+		static int s_i_capacity;
 	public :
 		static void FreeRegistry();
 		static algebraic_operator * create(const char * psc_name);
+		//THE VARIABLE REGISTERED WITH i_id, NULL WHEN THERE IS NONE
+		static variable * get_by_id(int i_id);
+		//THE IDS IN USE ARE [0,get_count())
+		static int get_count();
 		virtual algebraic_operator * create_copy() {
-			return new variable(get_variable_name());
+			return new variable(get_variable_name(),m_i_id);
 		}
 	protected :
 		virtual void to_IA32_binary(PCT_INFO pInfo);
 		virtual void annotate(PPT_INFO pParseInfo);
+		virtual void to_X64_binary(PCT_INFO pInfo);
+		virtual void annotate_X64(PPT_INFO pParseInfo);
+		virtual void to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_operand(PPT_INFO pParseInfo);
+		virtual void to_X64_vector(PCT_INFO pInfo);
+		virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+		virtual void to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_vector_operand(PPT_INFO pParseInfo);
+		virtual void to_tape(tape* pTape);
         virtual algebraic_operator* partial_derivative(variable * pVar);
 		virtual double eval(double* pVars);
+		virtual qword_type structural_hash();
+		virtual bool structural_equal(algebraic_operator * pao_other);
+		virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out);
 	public :
 		char * get_variable_name() { return this->m_scVarName; };
-		virtual int to_string(char* pBuffer);
+		//A COPY HAS THE ID OF THE REGISTERED VARIABLE, SO IT CAN INDEX AN ARRAY OF variable::get_count() VALUES
+		int get_id() { return this->m_i_id; };
+		virtual void write_string(string_writer* psw);
 		virtual variable** identify_variables();
 		virtual int get_number_of_variables();
 		virtual bool is_function_of(variable* a);
@@ -1061,19 +2287,31 @@ namespace calculus
 	public :
 		static algebraic_operator * create(double val)
 		{
-			return new constant(val);
+			return intern(new constant(val));
 		};
 		virtual algebraic_operator * create_copy()
 		{
-			return new constant(GetValue());
+			return intern(new constant(GetValue()));
 		};
 	protected :
 		virtual void to_IA32_binary(PCT_INFO pInfo);
 		virtual void annotate(PPT_INFO pParseInfo);
+		virtual void to_X64_binary(PCT_INFO pInfo);
+		virtual void annotate_X64(PPT_INFO pParseInfo);
+		virtual void to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_operand(PPT_INFO pParseInfo);
+		virtual void to_X64_vector(PCT_INFO pInfo);
+		virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+		virtual void to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x);
+		virtual void annotate_X64_vector_operand(PPT_INFO pParseInfo);
+		virtual void to_tape(tape* pTape);
 		virtual algebraic_operator* partial_derivative(variable * pVar);
 		virtual double eval(double *pVars);
+		virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out);
+		virtual qword_type structural_hash();
+		virtual bool structural_equal(algebraic_operator * pao_other);
 	public :
-		virtual int to_string(char* pBuffer);
+		virtual void write_string(string_writer* psw);
 		virtual variable** identify_variables();
 		virtual int get_number_of_variables();
 		virtual bool is_function_of(variable* a);
@@ -1099,9 +2337,13 @@ namespace calculus
 	protected :
 		virtual void to_IA32_binary(PCT_INFO pInfo);
 		virtual void annotate(PPT_INFO pParseInfo);
+		virtual void to_X64_binary(PCT_INFO pInfo);
+		virtual void annotate_X64(PPT_INFO pParseInfo);
 		virtual double eval(double *pVars);
+		virtual qword_type structural_hash();
+		virtual bool structural_equal(algebraic_operator * pao_other);
 	public :
-		virtual int to_string(char* pBuffer);
+		virtual void write_string(string_writer* psw);
 		virtual variable** identify_variables();
 		virtual int get_number_of_variables();
 		virtual algebraic_operator* partial_derivative(variable * pVar);
@@ -1116,6 +2358,21 @@ namespace calculus
 		return static_cast<calculus::function_adapter*>(calculus::function_adapter::create(pv_function_adapter,psc_function_adapter_name,i_num_vars,ppv_vars));
 	}
 
+	//WHERE AND WHY parse_to_algebra() FAILED
+	typedef struct PARSE_ERROR {
+		int					i_position;				//Offset of the offending character in the input
+		const char*			psc_message;
+	} PARSE_ERROR,*PPARSE_ERROR;
+
+	//COUNTERS OF THE parse_cached() CACHE SINCE THE PARSER STARTED
+	typedef struct PARSE_CACHE_STATISTICS {
+		size_t				st_hits;
+		size_t				st_misses;
+		size_t				st_evictions;
+		size_t				st_entries;
+		size_t				st_capacity;
+	} PARSE_CACHE_STATISTICS,*PPARSE_CACHE_STATISTICS;
+
 	class algebra_parser
 	{
 		static algebra_parser* _running_service;
@@ -1124,35 +2381,72 @@ namespace calculus
 	public :
         ~algebra_parser();
 		typedef calculus::algebraic_operator * (* unary_create_function)(calculus::algebraic_operator*);
-		unary_create_function * punary_create_functions;
-	private :
-		char * psc_unary_operator_string;
-		int * pi_unary_operator_string_positions;
-		int i_num_unary_operators;
-	public :
 		typedef calculus::algebraic_operator * (* unary_create_extended_function)(int,calculus::algebraic_operator*);
-		unary_create_extended_function * punary_create_extended_functions;
-	private :
-		char * psc_extended_unary_operator_string;
-		int * pi_extended_unary_operator_string_positions;
-		int i_num_extended_unary_operators;
-	public :
+		typedef calculus::algebraic_operator * (* derivative_create_function)(calculus::variable*,calculus::algebraic_operator*);
 		typedef calculus::algebraic_operator * (* binary_create_function)(calculus::algebraic_operator*,calculus::algebraic_operator*);
-		binary_create_function * pbinary_create_functions;
 	private :
-		char * psc_binary_operator_string;
-		int *pi_binary_operator_string_positions;
-		int i_num_binary_operators;
+		//THE REGISTERED CLASSES ARE CHAINED IN A HASH TABLE, A LOOKUP COSTS THE SAME WITH 20 OR 2000 OF THEM
+		typedef struct PARSER_CLASS {
+			char				sc_name[ALGEBRA_PARSER_NAME_LENGTH];
+			int					i_name_length;
+			size_t				st_hash;
+			dword_type			dw_operator_type;		//CLASS_*
+			dword_type			pcreate_function;
+			PARSER_CLASS*		ppc_next;				//Next class in the same bucket
+		} PARSER_CLASS,*PPARSER_CLASS;
+		PPARSER_CLASS * pppc_classes;
+		size_t st_class_table_size;						//A power of 2
+		int i_num_classes;
+		//THE CACHED OPERATORS, HASHED BY THEIR NORMALIZED TEXT AND LINKED FROM THE NEWEST TO THE OLDEST USE
+		typedef struct PARSE_CACHE_ENTRY {
+			char*				psc_key;				//The normalized text
+			size_t				st_hash;
+			algebraic_operator*	pao_operator;			//Compiled, the cache holds a reference
+			PARSE_CACHE_ENTRY*	ppce_next;				//Next entry in the same bucket
+			PARSE_CACHE_ENTRY*	ppce_newer;
+			PARSE_CACHE_ENTRY*	ppce_older;
+		} PARSE_CACHE_ENTRY,*PPARSE_CACHE_ENTRY;
+		PPARSE_CACHE_ENTRY * pppce_cache;
+		size_t st_cache_table_size;						//A power of 2, at least the capacity
+		PPARSE_CACHE_ENTRY ppce_newest;
+		PPARSE_CACHE_ENTRY ppce_oldest;
+		PARSE_CACHE_STATISTICS pcs_statistics;
+		std::mutex m_cache_lock;
+		void unlink_cache_entry(PPARSE_CACHE_ENTRY ppce);
+		void evict_cache_entry(PPARSE_CACHE_ENTRY ppce);
 	public :
-		unary_create_function get_unary_create_function(char * pString);
-		unary_create_extended_function get_extended_unary_create_function(char * pString);
-		binary_create_function get_binary_create_function(char * pString);
+		//THE CREATE FUNCTION OF THE CLASS NAMED BY THE i_length CHARACTERS AT psc_name, NULL WHEN THERE IS NONE
+		//psc_name DOESN'T NEED TO BE TERMINATED, *pdw_operator_type RECEIVES ITS CLASS_* TYPE
+		dword_type find_class(const char * psc_name,int i_length,dword_type * pdw_operator_type);
+		unary_create_function get_unary_create_function(const char * pString);
+		unary_create_extended_function get_extended_unary_create_function(const char * pString);
+		binary_create_function get_binary_create_function(const char * pString);
 
-		void register_class(dword_type dwOperatorType,dword_type pcreateFunc,char * pOperatorString );
+		void register_class(dword_type dwOperatorType,dword_type pcreateFunc,const char * pOperatorString );
 
 		static algebra_parser*  get_service();
 
-		calculus::algebraic_operator * parse_to_algebra(char * psc_algebraic_string);
+		//A SINGLE PASS PRECEDENCE CLIMBING PARSER, + - * / ^ AND THE REGISTERED FUNCTIONS, name(x) OR name(x,y)
+		//RETURNS NULL ON A SYNTAX ERROR AND DESCRIBES IT IN ppe_error WHEN IT ISN'T NULL
+		calculus::algebraic_operator * parse_to_algebra(const char * psc_algebraic_string,PPARSE_ERROR ppe_error = NULL);
+		//parse_to_algebra() OVER THE st_length CHARACTERS AT psc_text, WHICH NEEDN'T BE TERMINATED
+		calculus::algebraic_operator * parse_text(const char * psc_text,size_t st_length,PPARSE_ERROR ppe_error = NULL);
+		//PARSES EVERY LINE OF THE TEXT IN ORDER.  RETURNS A new[] ARRAY OF *pi_num_lines OPERATORS, EACH
+		//WITH A REFERENCE FOR THE CALLER, NULL FOR A BLANK OR INVALID LINE.  WHEN pppe_errors ISN'T NULL IT RECEIVES
+		//A new[] ARRAY WITH THE ERROR OF EVERY LINE, THE POSITIONS COUNT FROM THE START OF THE LINE
+		calculus::algebraic_operator ** parse_lines(const char * psc_text,size_t st_length,int * pi_num_lines,PPARSE_ERROR * pppe_errors = NULL);
+		//parse_lines() OVER A MEMORY MAPPED FILE, RETURNS NULL WHEN IT CAN'T BE READ
+		calculus::algebraic_operator ** parse_file(const char * psc_path,int * pi_num_lines,PPARSE_ERROR * pppe_errors = NULL);
+		//RELEASES THE OPERATORS OF parse_lines() OR parse_file() AND DELETES THE ARRAY
+		static void release_lines(calculus::algebraic_operator ** ppao_operators,int i_num_lines);
+		//parse_to_algebra() AND compile() THROUGH A LEAST RECENTLY USED CACHE KEYED BY THE TEXT WITHOUT ITS SPACING
+		//THE OPERATOR IS RETURNED WITH A REFERENCE FOR THE CALLER, WHO MUST release() IT, SO AN EVICTION BY ANOTHER
+		//THREAD NEVER PULLS IT AWAY.  ERRORS ARE NOT CACHED
+		calculus::algebraic_operator * parse_cached(const char * psc_algebraic_string,PPARSE_ERROR ppe_error = NULL);
+		//EVICTS THE OLDEST ENTRIES DOWN TO st_capacity, 0 DISABLES THE CACHE
+		void set_cache_capacity(size_t st_capacity);
+		void get_cache_statistics(PPARSE_CACHE_STATISTICS ppcs_statistics);
+		void clear_cache();
 
 		void initialize();
 		static void kill_service();
@@ -1175,6 +2469,8 @@ namespace calculus
 			};
 			virtual ~unary_operator()
 			{
+				//OUR VARIABLES MAY LIVE IN THE BUFFER OF THE OPERAND
+				release_variables();
 				if (m_pao_operand)
 					m_pao_operand->release();
 			};
@@ -1183,19 +2479,27 @@ namespace calculus
 				UNREFERENCED_PARAMETER(a);
 				return 0;
 			};
+			virtual void eval_unary_batch(double* pd,size_t st_n)
+			{
+				for(size_t i = 0;i < st_n;i++)
+					pd[i] = eval_unary(pd[i]);
+			};
+			//d eval_unary(a)/da, THE DEFAULT IS A CENTRED DIFFERENCE
+			virtual double eval_unary_derivative(double a);
+			//d eval_unary_derivative(a)/da, THE DEFAULT IS A CENTRED DIFFERENCE OF eval_unary_derivative()
+			virtual double eval_unary_second_derivative(double a);
+			static void eval_unary_batch_callback(unary_operator * puo_operator,double* pd,size_t st_n);
+			virtual void to_X64_vector(PCT_INFO pInfo);
+			virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+			virtual void to_tape(tape* pTape);
+			virtual qword_type structural_hash();
+			virtual bool structural_equal(algebraic_operator * pao_other);
+			friend class calculus::tape;
 			virtual variable** identify_variables()
 			{
-                if (m_ppv_variables)
-					delete [] m_ppv_variables;
-                m_ppv_variables = NULL;
-				m_i_number_of_variables = m_pao_operand->get_number_of_variables();
-                if (m_i_number_of_variables) {
-				    m_ppv_variables = new variable*[m_i_number_of_variables];
-				    calculus::variable** ppao_operand_variables = m_pao_operand->get_variables();
-				    mass_addref<calculus::variable>(ppao_operand_variables,m_i_number_of_variables);
-				    for(int i = 0;i < m_i_number_of_variables;i++)
-					    m_ppv_variables[i] = ppao_operand_variables[i];
-                }
+				//THE OPERAND HAS THE SAME VARIABLES, SO WE SHARE ITS ARRAY
+				release_variables();
+				borrow_variables(m_pao_operand);
                 m_b_variables_identified = true;
 				return m_ppv_variables;
 			};
@@ -1205,9 +2509,18 @@ namespace calculus
 			}
 			virtual double eval(double* pVars) {
                 if (m_pao_operand)
-                    eval_unary(m_pao_operand->eval(pVars));
+                    return eval_unary(m_pao_operand->eval(pVars));
                 return 0;
 			}
+			virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+				//THE OPERAND SHARES THE VARIABLES OF THIS OPERATOR, SO THE COLUMNS ARE PASSED THROUGH
+                if (m_pao_operand) {
+                    m_pao_operand->eval_batch(ppd_columns,st_n,pd_out);
+                    eval_unary_batch(pd_out,st_n);
+                }
+                else for(size_t i = 0;i < st_n;i++)
+                    pd_out[i] = 0;
+			}
 		};
 
 		namespace intrinsic_operators
@@ -1222,11 +2535,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new nop(pAlg); 
+					return intern(new nop(pAlg)); 
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new nop(get_operand());
+					return intern(new nop(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1236,10 +2549,18 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline nop* _nop(algebraic_operator * pArg) 
 			{ 
@@ -1254,11 +2575,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new negate(pAlg); 
+					return intern(new negate(pAlg)); 
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new negate(get_operand());
+					return intern(new negate(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1268,9 +2589,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			}; 
 			inline negate* _neg(algebraic_operator * parg) 
@@ -1286,11 +2613,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new square_root(pAlg); 
+					return intern(new square_root(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new square_root(get_operand());
+					return intern(new square_root(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1300,10 +2627,16 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 				virtual double eval_unary(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline square_root* _sqrt(algebraic_operator * parg) 
 			{ 
@@ -1318,11 +2651,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new ln(pAlg);
+					return intern(new ln(pAlg));
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new ln(get_operand());
+					return intern(new ln(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1333,10 +2666,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar);
-				virtual double eval_unary(double a); 
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline ln* _log(algebraic_operator * parg) 
 			{ 
@@ -1351,11 +2689,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new log(pAlg); 
+					return intern(new log(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new log(get_operand());
+					return intern(new log(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1366,10 +2704,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
-				virtual double eval_unary(double a); 
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline log* _log10(algebraic_operator * parg) 
 			{ 
@@ -1384,11 +2727,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new exponential(pAlg); 
+					return intern(new exponential(pAlg)); 
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new exponential(get_operand());
+					return intern(new exponential(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1398,11 +2741,16 @@ namespace calculus
 				}; 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 			public : 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
-				virtual double eval_unary(double a); 
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline exponential* _exp(algebraic_operator * parg) 
 			{ 
@@ -1418,25 +2766,33 @@ namespace calculus
 			public :
 				static algebraic_operator * create(int n,algebraic_operator * pAlg)
 				{
-					return new integer_power(pAlg,n);
+					return intern(new integer_power(pAlg,n));
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new integer_power(get_operand(),GetExponent());
+					return intern(new integer_power(get_operand(),GetExponent()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)integer_power::create,"INT_POW"); 
+					pService->register_class(CLASS_UNARY_EXTENDED_LAST,(dword_type)integer_power::create,"INT_POW"); 
 				};
 			protected :
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo);
+				virtual void to_X64_binary(PCT_INFO pInfo);
+				virtual void annotate_X64(PPT_INFO pParseInfo);
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
+				virtual qword_type structural_hash();
+				virtual bool structural_equal(algebraic_operator * pao_other);
 			public :
-				virtual int to_string(char* pBuffer);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar);
 				virtual double eval_unary(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				int GetExponent()
 				{
 					return this->m_iConstant;
@@ -1461,11 +2817,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg)
 				{
-					return new sine(pAlg);
+					return intern(new sine(pAlg));
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new sine(get_operand());
+					return intern(new sine(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1476,10 +2832,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline sine* _sin(algebraic_operator * parg) 
 			{ 
@@ -1495,11 +2856,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new cosine(pAlg); 
+					return intern(new cosine(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new cosine(get_operand());
+					return intern(new cosine(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1510,10 +2871,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
-				virtual double eval_unary(double a); 
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			};
 			inline cosine* _cos(algebraic_operator * parg) 
 			{ 
@@ -1529,11 +2895,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new tangent(pAlg); 
+					return intern(new tangent(pAlg)); 
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new tangent(get_operand());
+					return intern(new tangent(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1544,10 +2910,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			};
 			inline tangent* _tan(algebraic_operator * parg) 
 			{ 
@@ -1563,11 +2934,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new arcsine(pAlg); 
+					return intern(new arcsine(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new arcsine(get_operand());
+					return intern(new arcsine(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1578,10 +2949,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline arcsine* _asin(algebraic_operator * parg) 
 			{ 
@@ -1597,11 +2973,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new arccosine(pAlg); 
+					return intern(new arccosine(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new arccosine(get_operand());
+					return intern(new arccosine(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1612,10 +2988,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline arccosine* _acos(algebraic_operator * parg) 
 			{ 
@@ -1631,11 +3012,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new arctangent(pAlg); 
+					return intern(new arctangent(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new arctangent(get_operand());
+					return intern(new arctangent(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1646,10 +3027,15 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
-				virtual double eval_unary(double a); 
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline arctangent* _atan(algebraic_operator * parg) 
 			{ 
@@ -1667,11 +3053,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new sinh(pAlg);
+					return intern(new sinh(pAlg));
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new sinh(get_operand());
+					return intern(new sinh(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1682,9 +3068,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				virtual algebraic_operator* partial_derivative(variable * pVar);
 			}; 
 			inline sinh* _sinh(algebraic_operator * parg) 
@@ -1701,11 +3092,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new cosh(pAlg); 
+					return intern(new cosh(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new cosh(get_operand());
+					return intern(new cosh(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1716,9 +3107,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				virtual algebraic_operator* partial_derivative(variable * pVar);
 			}; 
 			inline cosh* _cosh(algebraic_operator * parg) 
@@ -1735,11 +3131,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new tanh(pAlg); 
+					return intern(new tanh(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new tanh(get_operand());
+					return intern(new tanh(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1750,9 +3146,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline tanh* _tanh(algebraic_operator * parg) 
 			{ 
@@ -1770,11 +3171,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg)
 				{ 
-					return new bessel_y0(pAlg); 
+					return intern(new bessel_y0(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_y0(get_operand());
+					return intern(new bessel_y0(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1785,9 +3186,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline bessel_y0* __y0(algebraic_operator * parg) 
 			{ 
@@ -1803,11 +3209,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new bessel_y1(pAlg); 
+					return intern(new bessel_y1(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_y1(get_operand());
+					return intern(new bessel_y1(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1818,9 +3224,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			};
 			inline bessel_y1* __y1(algebraic_operator * parg) 
 			{ 
@@ -1836,11 +3247,11 @@ namespace calculus
 			public :
 				static algebraic_operator * create(int n,algebraic_operator * pAlg)
 				{
-					return new bessel_yn(n,pAlg);
+					return intern(new bessel_yn(n,pAlg));
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_yn(GetBesselIndex(),get_operand());
+					return intern(new bessel_yn(GetBesselIndex(),get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1851,9 +3262,16 @@ namespace calculus
 			protected :
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo);
+				virtual void to_X64_binary(PCT_INFO pInfo);
+				virtual void annotate_X64(PPT_INFO pParseInfo);
+				virtual qword_type structural_hash();
+				virtual bool structural_equal(algebraic_operator * pao_other);
 			public :
-				virtual int to_string(char* pBuffer);
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				unsigned int GetBesselIndex()
 				{
 					return this->m_uiConstant;
@@ -1873,11 +3291,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new bessel_j0(pAlg); 
+					return intern(new bessel_j0(pAlg)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_j0(get_operand());
+					return intern(new bessel_j0(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1888,9 +3306,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
-				virtual double eval_unary(double a); 
+				virtual void write_string(string_writer* psw);
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline bessel_j0* __j0(algebraic_operator * parg) 
 			{ 
@@ -1906,11 +3329,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * pAlg) 
 				{ 
-					return new bessel_j1(pAlg); 
+					return intern(new bessel_j1(pAlg)); 
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_j1(get_operand());
+					return intern(new bessel_j1(get_operand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -1921,9 +3344,14 @@ namespace calculus
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			public : 
-				virtual int to_string(char* pBuffer); 
-				virtual double eval_unary(double a); 
+				virtual void write_string(string_writer* psw);
+				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a); 
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 			}; 
 			inline bessel_j1* __j1(algebraic_operator * parg) 
 			{ 
@@ -1939,11 +3367,11 @@ namespace calculus
 			public :
 				static algebraic_operator * create(int n,algebraic_operator * pAlg)
 				{
-					return new bessel_jn(n,pAlg);
+					return intern(new bessel_jn(n,pAlg));
 				};
 				virtual algebraic_operator * create_copy()
 				{
-					return new bessel_jn(GetBesselIndex(),get_operand());
+					return intern(new bessel_jn(GetBesselIndex(),get_operand()));
 				};
 				static void Register(algebra_parser * pService)
 				{
@@ -1954,9 +3382,16 @@ namespace calculus
 			protected :
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo);
+				virtual void to_X64_binary(PCT_INFO pInfo);
+				virtual void annotate_X64(PPT_INFO pParseInfo);
+				virtual qword_type structural_hash();
+				virtual bool structural_equal(algebraic_operator * pao_other);
 			public :
-				virtual int to_string(char* pBuffer);
+				virtual void write_string(string_writer* psw);
 				virtual double eval_unary(double a);
+				virtual double eval_unary_derivative(double a);
+				virtual double eval_unary_second_derivative(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				unsigned int GetBesselIndex()
 				{
 					return this->m_uiConstant;
@@ -1984,9 +3419,15 @@ namespace calculus
 				virtual ~derivative_operator();
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
+				virtual qword_type structural_hash();
+				virtual bool structural_equal(algebraic_operator * pao_other);
 			public :
-				virtual int to_string(char* pBuffer); 
+				virtual void write_string(string_writer* psw);
 				virtual double eval(double* pVars);
+				virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out);
 				variable * get_partial_derivative_variable();
 				int get_number_of_coefficients();
 			};
@@ -2007,7 +3448,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_3c::create,"_d3pc"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_3c::create,"_d3pc"); 
 				}; 
 			};
 			inline derivative_3c* __d3pc(variable * pvar,algebraic_operator * parg) 
@@ -2032,7 +3473,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_3f::create,"_d3pf"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_3f::create,"_d3pf"); 
 				}; 
 			};
 			inline derivative_3f* __d3pf(variable * pvar,algebraic_operator * parg) 
@@ -2057,7 +3498,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_3b::create,"_d3pb"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_3b::create,"_d3pb"); 
 				}; 
 			};
 			inline derivative_3b* __d3pb(variable * pvar,algebraic_operator * parg) 
@@ -2082,7 +3523,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_5c::create,"_d5pc"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_5c::create,"_d5pc"); 
 				}; 
 			};
 			inline derivative_5c* __d5pc(variable * pvar,algebraic_operator * parg) 
@@ -2107,7 +3548,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_5f::create,"_d5pf"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_5f::create,"_d5pf"); 
 				}; 
 			};
 			inline derivative_5f* __d5pf(variable * pvar,algebraic_operator * parg) 
@@ -2132,7 +3573,7 @@ namespace calculus
 				{ 
 					if (!pService) 
 						pService = algebra_parser::get_service(); 
-					pService->register_class(0x2u,(dword_type)derivative_5b::create,"_d5pb"); 
+					pService->register_class(CLASS_UNARY_DERIVATIVE,(dword_type)derivative_5b::create,"_d5pb"); 
 				}; 
 			};
 			inline derivative_5b* __d5pb(variable * pvar,algebraic_operator * parg) 
@@ -2163,6 +3604,8 @@ namespace calculus
 				polynomial(unsigned int uiOrder,double * pXs,double * pAis,algebraic_operator* pF);
 				virtual ~polynomial();
 				void __load_interpolant(unsigned int uiOrder,double * pIC_1,double * pIC_2);
+				virtual qword_type structural_hash();
+				virtual bool structural_equal(algebraic_operator * pao_other);
 			public :
 				static void get_lagrange_interpolatory_coefficients_from_function(unsigned int uiOrder,double a,double b,algebraic_operator* pF,double ** ppXs,double ** ppAis);
 				static void get_lagrange_interpolatory_coefficients_from_points(unsigned int uiNumPoints,double * pXs,double * pYs,double ** ppAis);
@@ -2192,11 +3635,14 @@ namespace calculus
 					return new polynomial(uiOrder,pXs,pAis,pF);
 				};
 				virtual double eval_unary(double a);
+				virtual void eval_unary_batch(double* pd,size_t st_n);
 				virtual algebraic_operator* partial_derivative(variable * pVar);
-				virtual int to_string(char* pBuffer);
+				virtual void write_string(string_writer* psw);
 			protected :
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo);
+				virtual void to_X64_binary(PCT_INFO pInfo);
+				virtual void annotate_X64(PPT_INFO pParseInfo);
 			};
 /*			
 			class CHermitePolyFunction : public polynomial
@@ -2236,7 +3682,7 @@ namespace calculus
 				virtual algebraic_operator* partial_derivative();
 				virtual algebraic_operator* Integral();
 			protected :
-				virtual int to_string(char* pBuffer);
+				virtual void write_string(string_writer* psw);
 				virtual void to_IA32_binary(PCT_INFO pInfo);
 				virtual void annotate(PPT_INFO pParseInfo);
 			};
@@ -2249,8 +3695,10 @@ namespace calculus
 		{
 			algebraic_operator* m_pao_left_operand;
 			algebraic_operator* m_pao_right_operand;
+			int* m_pi_left_indices;								//Index of every left operand variable in m_ppv_variables, NULL when they match
+			int* m_pi_right_indices;							//Index of every right operand variable in m_ppv_variables, NULL when they match
 		protected :
-			binary_operator(algebraic_operator * pAlg1,algebraic_operator * pAlg2) : algebraic_operator(), m_pao_left_operand(pAlg1), m_pao_right_operand(pAlg2)
+			binary_operator(algebraic_operator * pAlg1,algebraic_operator * pAlg2) : algebraic_operator(), m_pao_left_operand(pAlg1), m_pao_right_operand(pAlg2), m_pi_left_indices(NULL), m_pi_right_indices(NULL)
 			{
 				if (m_pao_left_operand)
 					m_pao_left_operand->addref();
@@ -2259,6 +3707,12 @@ namespace calculus
 			};
 			virtual ~binary_operator()
 			{
+				if (m_pi_left_indices)
+					calculus::node_pool::release_array(m_pi_left_indices);
+				if (m_pi_right_indices)
+					calculus::node_pool::release_array(m_pi_right_indices);
+				//OUR VARIABLES MAY LIVE IN THE BUFFER OF AN OPERAND
+				release_variables();
 				if (m_pao_left_operand)
 					m_pao_left_operand->release();
 				if (m_pao_right_operand)
@@ -2270,7 +3724,27 @@ namespace calculus
 				UNREFERENCED_PARAMETER(y);
 				return 0;
 			};
+			virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n)
+			{
+				for(size_t i = 0;i < st_n;i++)
+					pd_a[i] = eval_binary(pd_a[i],pd_b[i]);
+			};
+			//THE PARTIALS OF eval_binary(x,y), THE DEFAULT IS A CENTRED DIFFERENCE
+			virtual void eval_binary_derivatives(double x,double y,double* pd_x,double* pd_y);
+			//THE SECOND PARTIALS OF eval_binary(x,y), THE DEFAULT IS A CENTRED DIFFERENCE OF eval_binary_derivatives()
+			virtual void eval_binary_second_derivatives(double x,double y,double* pd_xx,double* pd_xy,double* pd_yy);
 			virtual variable** identify_variables();
+			void to_X64_arithmetic(PCT_INFO pInfo,byte_type code,bool b_commutative);
+			void annotate_X64_arithmetic(PPT_INFO pParseInfo,bool b_commutative);
+			void to_X64_vector_arithmetic(PCT_INFO pInfo,byte_type code,bool b_commutative);
+			void annotate_X64_vector_arithmetic(PPT_INFO pParseInfo,bool b_commutative);
+			static void eval_binary_batch_callback(binary_operator * pbo_operator,double* pd_a,const double* pd_b,size_t st_n);
+			virtual void to_X64_vector(PCT_INFO pInfo);
+			virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+			virtual void to_tape(tape* pTape);
+			virtual qword_type structural_hash();
+			virtual bool structural_equal(algebraic_operator * pao_other);
+			friend class calculus::tape;
 		private:
 			static bool UseConstantOptimizations;
 		public :
@@ -2290,6 +3764,7 @@ namespace calculus
 			static inline bool EnableDisorderedOptimizations() { bool pstate = IsUsingDisorderedOptimizations(); UseDisorderedOptimizations = true; return pstate; };
 			static inline bool DisableDisorderedOptimizations() { bool pstate = IsUsingDisorderedOptimizations(); UseDisorderedOptimizations = false; return pstate; };
 			virtual double eval(double* pVars);
+			virtual void eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out);
 			algebraic_operator* GetLeftOperand()
 			{
 				return m_pao_left_operand;
@@ -2310,11 +3785,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * Alg1,algebraic_operator * Alg2) 
 				{ 
-					return new addition(Alg1,Alg2); 
+					return intern(new addition(Alg1,Alg2)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new addition(GetLeftOperand(),GetRightOperand());
+					return intern(new addition(GetLeftOperand(),GetRightOperand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -2323,11 +3798,17 @@ namespace calculus
 					pService->register_class(0x4u,(dword_type)addition::create,"add"); 
 				}; 
 				virtual double eval_binary(double x,double y); 
-				virtual int to_string(char* pBuffer); 
+				virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			}; 
 			algebraic_operator * _add(algebraic_operator * arg1,algebraic_operator * arg2);
 
@@ -2339,11 +3820,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * Alg1,algebraic_operator * Alg2) 
 				{ 
-					return new subtraction(Alg1,Alg2); 
+					return intern(new subtraction(Alg1,Alg2)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new subtraction(GetLeftOperand(),GetRightOperand());
+					return intern(new subtraction(GetLeftOperand(),GetRightOperand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -2352,11 +3833,17 @@ namespace calculus
 					pService->register_class(0x4u,(dword_type)subtraction::create,"subtract"); 
 				}; 
 				virtual double eval_binary(double x,double y); 
-				virtual int to_string(char* pBuffer); 
+				virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			}; 
 			calculus::algebraic_operator * _subtract(calculus::algebraic_operator * arg1,calculus::algebraic_operator * arg2); 
 
@@ -2368,11 +3855,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * Alg1,algebraic_operator * Alg2) 
 				{ 
-					return new multiplication(Alg1,Alg2);
+					return intern(new multiplication(Alg1,Alg2));
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new multiplication(GetLeftOperand(),GetRightOperand());
+					return intern(new multiplication(GetLeftOperand(),GetRightOperand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -2381,11 +3868,17 @@ namespace calculus
 					pService->register_class(0x4u,(dword_type)multiplication::create,"multiply");
 				};
 				virtual double eval_binary(double x,double y); 
-				virtual int to_string(char* pBuffer); 
+				virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			}; 
 			calculus::algebraic_operator * _multiply(calculus::algebraic_operator * arg1,calculus::algebraic_operator * arg2); 
 
@@ -2397,11 +3890,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * Alg1,algebraic_operator * Alg2) 
 				{ 
-					return new division(Alg1,Alg2); 
+					return intern(new division(Alg1,Alg2)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new division(GetLeftOperand(),GetRightOperand());
+					return intern(new division(GetLeftOperand(),GetRightOperand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -2410,11 +3903,17 @@ namespace calculus
 					pService->register_class(0x4u,(dword_type)division::create,"divide"); 
 				};
 				virtual double eval_binary(double x,double y); 
-				virtual int to_string(char* pBuffer); 
+				virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
+				virtual void to_X64_vector(PCT_INFO pInfo);
+				virtual void annotate_X64_vector(PPT_INFO pParseInfo);
+				virtual void to_tape(tape* pTape);
 			}; 
 			calculus::algebraic_operator * _divide(calculus::algebraic_operator * arg1,calculus::algebraic_operator * arg2); 
 
@@ -2426,11 +3925,11 @@ namespace calculus
 			public : 
 				static algebraic_operator * create(algebraic_operator * Alg1,algebraic_operator * Alg2) 
 				{
-					return new exponentiation(Alg1,Alg2); 
+					return intern(new exponentiation(Alg1,Alg2)); 
 				}; 
 				virtual algebraic_operator * create_copy()
 				{
-					return new exponentiation(GetLeftOperand(),GetRightOperand());
+					return intern(new exponentiation(GetLeftOperand(),GetRightOperand()));
 				};
 				static void Register(algebra_parser * pService) 
 				{ 
@@ -2439,14 +3938,29 @@ namespace calculus
 					pService->register_class(0x4u,(dword_type)exponentiation::create,"pow"); 
 				}; 
 				virtual double eval_binary(double x,double y);
-				virtual int to_string(char* pBuffer); 
+				virtual void eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n);
+				virtual void eval_binary_derivatives(double x,double y,double* pd_x,double* pd_y);
+				virtual void eval_binary_second_derivatives(double x,double y,double* pd_xx,double* pd_xy,double* pd_yy);
+				virtual void write_string(string_writer* psw);
 				virtual algebraic_operator* partial_derivative(variable * pVar); 
 			protected : 
 				virtual void to_IA32_binary(PCT_INFO pInfo); 
 				virtual void annotate(PPT_INFO pParseInfo); 
+				virtual void to_X64_binary(PCT_INFO pInfo); 
+				virtual void annotate_X64(PPT_INFO pParseInfo); 
 			}; 
 			calculus::algebraic_operator * _pow(calculus::algebraic_operator * arg1,calculus::algebraic_operator * arg2);
 		}
 	}
 }
 
+//THE ARGUMENTS ARE MATCHED BY ID, A COPY OF A VARIABLE NAMES THE SAME ARGUMENT
+inline int CompilerIndexOfVariable(PCT_INFO pInfo,calculus::variable * pVar) {
+	int i_id = pVar->get_id();
+	for(int i = 0;i < pInfo->pHeader->i_num_vars;i++)
+		if (pInfo->ppv_vars[i]->get_id() == i_id)
+			return i;
+	_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+	return 0;
+}
+
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <algorithm>
+#include <new>
 
 namespace calc {
 
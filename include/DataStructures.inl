@@ -116,14 +116,12 @@ namespace calc
 	template<typename T, std::size_t SIZE>
 	void SmallVector<T, SIZE>::CopyFrom(const T* begin, const T* end)
 	{
-/*
 		std::size_t newSize = end - begin;
 		this->Clear();
 		this->Reserve(newSize);
 
 		std::copy(begin, end, this->m_Begin);
 		this->m_End = this->m_Begin + newSize;
-*/
 	}
 
 	template<typename T, std::size_t SIZE>
@@ -105,17 +105,19 @@ double calculus::binary_operators::intrinsic_operators::addition::eval_binary(do
 	return a+b;
 };
 
-int calculus::binary_operators::intrinsic_operators::addition::to_string(char* pBuffer)
+void calculus::binary_operators::intrinsic_operators::addition::eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n)
 {
-	if (!pBuffer)
-		return 3+this->GetLeftOperand()->to_string(NULL)+this->GetRightOperand()->to_string(NULL);
-	int iOffset = 1;
-	strcpy(pBuffer,"(");
-	iOffset += this->GetLeftOperand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,"+");
-	iOffset += this->GetRightOperand()->to_string(pBuffer+(++iOffset));
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+	for(size_t i = 0;i < st_n;i++)
+		pd_a[i] = addition::eval_binary(pd_a[i],pd_b[i]);
+};
+
+void calculus::binary_operators::intrinsic_operators::addition::write_string(string_writer* psw)
+{
+	psw->write('(');
+	this->GetLeftOperand()->write_string(psw);
+	psw->write('+');
+	this->GetRightOperand()->write_string(psw);
+	psw->write(')');
 };
 /*
 THIS IS THE OPCODE BLUEPRINT FOR THE BINARY INTRINSIC OPERATOR ADD
@@ -170,6 +172,41 @@ void calculus::binary_operators::intrinsic_operators::addition::annotate(PPT_INF
 	this->GetLeftOperand()->annotate(pParseInfo);
 };
 
+/*
+	THE X64 ENCODING IS binary_operator::to_X64_arithmetic WITH OPSD = ADDSD
+*/
+
+void calculus::binary_operators::intrinsic_operators::addition::to_X64_binary(PCT_INFO pInfo)
+{
+	this->to_X64_arithmetic(pInfo,SSE2_ADDSD,true);
+};
+
+void calculus::binary_operators::intrinsic_operators::addition::annotate_X64(PPT_INFO pParseInfo)
+{
+	this->annotate_X64_arithmetic(pParseInfo,true);
+};
+
+/*
+	THE BATCH ENCODING IS binary_operator::to_X64_vector_arithmetic WITH OPPD = VADDPD
+*/
+
+void calculus::binary_operators::intrinsic_operators::addition::to_X64_vector(PCT_INFO pInfo)
+{
+	this->to_X64_vector_arithmetic(pInfo,VECTOR_ADDPD,true);
+};
+
+void calculus::binary_operators::intrinsic_operators::addition::annotate_X64_vector(PPT_INFO pParseInfo)
+{
+	this->annotate_X64_vector_arithmetic(pParseInfo,true);
+};
+
+void calculus::binary_operators::intrinsic_operators::addition::to_tape(calculus::tape* pTape)
+{
+	this->GetLeftOperand()->to_tape(pTape);
+	this->GetRightOperand()->to_tape(pTape);
+	pTape->write(TAPE_OP_ADD);
+};
+
 calculus::algebraic_operator* calculus::binary_operators::intrinsic_operators::addition::partial_derivative(variable * pVar)
 {
 	if (!this->is_function_of(pVar))
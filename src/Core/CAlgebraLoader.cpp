@@ -0,0 +1,215 @@
+/*
+
+CALGEBRALOADER.CPP: 
+IMPLEMENTS THE BULK LOADING OF calculus::algebra_parser
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static calculus::algebraic_operator* ParseLine(calculus::algebra_parser* pap_parser,const char* psc_line,size_t st_length,calculus::PPARSE_ERROR ppe_error) {
+	size_t st_first = 0;
+	while ((st_first < st_length) && isspace((unsigned char)psc_line[st_first]))
+		st_first++;
+	if (st_first == st_length) {
+		//A BLANK LINE IS NOT AN ERROR
+		if (ppe_error) {
+			ppe_error->i_position = -1;
+			ppe_error->psc_message = NULL;
+		}
+		return NULL;
+	}
+	calculus::algebraic_operator* pao = pap_parser->parse_text(psc_line,st_length,ppe_error);
+	if (pao)
+		pao->addref();
+	return pao;
+}
+
+calculus::algebraic_operator ** calculus::algebra_parser::parse_lines(const char * psc_text,size_t st_length,int * pi_num_lines,PPARSE_ERROR * pppe_errors)
+{
+	//THE LINES ARE COUNTED FIRST TO SIZE THE RESULTS, A LAST LINE WITHOUT ITS NEWLINE COUNTS TOO
+	size_t st_num_lines = 0;
+	for(const char* psc = psc_text;(psc = (const char*)memchr(psc,'\n',psc_text+st_length-psc)) != NULL;psc++)
+		st_num_lines++;
+	if (st_length && (psc_text[st_length-1] != '\n'))
+		st_num_lines++;
+	algebraic_operator ** ppao_operators = new algebraic_operator*[st_num_lines];
+	PPARSE_ERROR ppe_errors = (pppe_errors)?new PARSE_ERROR[st_num_lines]:NULL;
+	//EVERY OPERATOR A LINE BUILDS IS INTERNED UNDER build_lock(), SO THE LINES ARE PARSED IN ORDER ON THIS THREAD
+	const char* psc_line = psc_text;
+	const char* psc_end = psc_text+st_length;
+	for(size_t i = 0;i < st_num_lines;i++) {
+		const char* psc_newline = (const char*)memchr(psc_line,'\n',psc_end-psc_line);
+		size_t st_line = ((psc_newline)?psc_newline:psc_end)-psc_line;
+		ppao_operators[i] = ParseLine(this,psc_line,st_line,(ppe_errors)?ppe_errors+i:NULL);
+		psc_line += st_line+1;
+	}
+
+	if (pppe_errors)
+		*pppe_errors = ppe_errors;
+	*pi_num_lines = (int)st_num_lines;
+	return ppao_operators;
+}
+
+calculus::algebraic_operator ** calculus::algebra_parser::parse_file(const char * psc_path,int * pi_num_lines,PPARSE_ERROR * pppe_errors)
+{
+	*pi_num_lines = 0;
+	if (pppe_errors)
+		*pppe_errors = NULL;
+	algebraic_operator ** ppao_operators = NULL;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(psc_path,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile,&liSize)) {
+		CloseHandle(hFile);
+		return NULL;
+	}
+	size_t st_size = (size_t)liSize.QuadPart;
+	if (!st_size) {
+		CloseHandle(hFile);
+		return parse_lines("",0,pi_num_lines,pppe_errors);
+	}
+	HANDLE hMapping = CreateFileMappingA(hFile,NULL,PAGE_READONLY,0,0,NULL);
+	const char * psc_text = (hMapping)?(const char*)MapViewOfFile(hMapping,FILE_MAP_READ,0,0,0):NULL;
+	if (psc_text) {
+		ppao_operators = parse_lines(psc_text,st_size,pi_num_lines,pppe_errors);
+		UnmapViewOfFile(psc_text);
+	}
+	if (hMapping)
+		CloseHandle(hMapping);
+	CloseHandle(hFile);
+#else
+	int iFile = open(psc_path,O_RDONLY);
+	if (iFile < 0)
+		return NULL;
+	struct stat statFile;
+	if (fstat(iFile,&statFile) != 0) {
+		close(iFile);
+		return NULL;
+	}
+	size_t st_size = (size_t)statFile.st_size;
+	if (!st_size) {
+		close(iFile);
+		return parse_lines("",0,pi_num_lines,pppe_errors);
+	}
+	void * pvMap = mmap(NULL,st_size,PROT_READ,MAP_PRIVATE,iFile,0);
+	close(iFile);
+	if (pvMap == MAP_FAILED)
+		return NULL;
+	//THE LINES ARE READ IN ONE SEQUENTIAL PASS
+	madvise(pvMap,st_size,MADV_SEQUENTIAL);
+	ppao_operators = parse_lines((const char*)pvMap,st_size,pi_num_lines,pppe_errors);
+	munmap(pvMap,st_size);
+#endif
+	return ppao_operators;
+}
+
+void calculus::algebra_parser::release_lines(calculus::algebraic_operator ** ppao_operators,int i_num_lines)
+{
+	if (!ppao_operators)
+		return;
+	for(int i = 0;i < i_num_lines;i++)
+		if (ppao_operators[i])
+			ppao_operators[i]->release();
+	delete [] ppao_operators;
+}
@@ -95,6 +95,7 @@ THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
 */
 
 #include "Calculus_cpp.h"
+#include <climits>
 
 #pragma warning(disable:4244)
 #pragma warning(disable:4267)
@@ -107,20 +108,15 @@ calculus::algebra_parser* calculus::algebra_parser::_running_service = NULL;
 
 calculus::algebra_parser::algebra_parser()
 {
-	this->punary_create_functions = NULL;
-	psc_unary_operator_string = NULL;
-	pi_unary_operator_string_positions = NULL;
-	i_num_unary_operators = 0;
+	pppc_classes = NULL;
+	st_class_table_size = 0;
+	i_num_classes = 0;
 
-	punary_create_extended_functions = NULL;
-	psc_extended_unary_operator_string = NULL;
-	pi_extended_unary_operator_string_positions = NULL;
-	i_num_extended_unary_operators = 0;
-
-	pbinary_create_functions = NULL;
-	psc_binary_operator_string = NULL;
-	pi_binary_operator_string_positions = NULL;
-	i_num_binary_operators = 0;
+	pppce_cache = NULL;
+	st_cache_table_size = 0;
+	ppce_newest = ppce_oldest = NULL;
+	memset(&pcs_statistics,0,sizeof(pcs_statistics));
+	pcs_statistics.st_capacity = PARSE_CACHE_CAPACITY;
 
 	if (_running_service == NULL)
 		_running_service = this;
@@ -129,26 +125,22 @@ calculus::algebra_parser::algebra_parser()
 
 calculus::algebra_parser::~algebra_parser()
 {
-	if (punary_create_functions)
-		delete [] punary_create_functions;
-	if (psc_unary_operator_string)
-		delete [] psc_unary_operator_string;
-	if (pi_unary_operator_string_positions)
-		delete [] pi_unary_operator_string_positions;
-
-	if (punary_create_extended_functions)
-		delete [] punary_create_extended_functions;
-	if (psc_extended_unary_operator_string)
-		delete [] psc_extended_unary_operator_string;
-	if (pi_extended_unary_operator_string_positions)
-		delete [] pi_extended_unary_operator_string_positions;
-
-	if (pbinary_create_functions)
-		delete [] pbinary_create_functions;
-	if (psc_binary_operator_string)
-		delete [] psc_binary_operator_string;
-	if (pi_binary_operator_string_positions)
-		delete [] pi_binary_operator_string_positions;
+	clear_cache();
+	if (pppce_cache)
+		delete [] pppce_cache;
+
+	for(size_t i = 0;i < st_class_table_size;i++)
+	{
+		PPARSER_CLASS ppc = pppc_classes[i];
+		while(ppc)
+		{
+			PPARSER_CLASS ppc_next = ppc->ppc_next;
+			delete ppc;
+			ppc = ppc_next;
+		}
+	}
+	if (pppc_classes)
+		delete [] pppc_classes;
 
 	if (_running_service == this)
 		_running_service = NULL;
@@ -188,6 +180,12 @@ void calculus::algebra_parser::initialize()
 	calculus::unary_operators::hyperbolic_operators::sinh::Register(this);
 	calculus::unary_operators::hyperbolic_operators::cosh::Register(this);
 	calculus::unary_operators::hyperbolic_operators::tanh::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_j0::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_j1::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_jn::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_y0::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_y1::Register(this);
+	calculus::unary_operators::bessel_operators::bessel_yn::Register(this);
 	calculus::unary_operators::derivative_operators::derivative_3b::Register(this);
 	calculus::unary_operators::derivative_operators::derivative_3c::Register(this);
 	calculus::unary_operators::derivative_operators::derivative_3f::Register(this);
@@ -202,202 +200,661 @@ void calculus::algebra_parser::initialize()
 	calculus::binary_operators::intrinsic_operators::subtraction::Register(this);
 }
 
-inline void _add_class_registry_info(int * pNumRegEntries,dword_type ** ppFuncReg,char ** ppsc_nameReg,int ** ppPosReg,dword_type pFunc,char * psc_name)
+static size_t HashName(const char * psc_name,size_t st_length)
 {
-	unsigned int uiLen;
-	if (*ppsc_nameReg)
+	size_t st_hash = (size_t)14695981039346656037ull;
+	for(size_t i = 0;i < st_length;i++)
+		st_hash = (st_hash ^ (unsigned char)psc_name[i])*(size_t)1099511628211ull;
+	return st_hash;
+}
+
+void calculus::algebra_parser::register_class(dword_type dwOperatorType,dword_type pcreateFunc,const char * pOperatorString )
+{
+	int i_length = (int)strlen(pOperatorString);
+	_ASSERT(i_length < (int)ALGEBRA_PARSER_NAME_LENGTH);	//THE NAME MUST FIT IN PARSER_CLASS
+	if (i_length >= (int)ALGEBRA_PARSER_NAME_LENGTH)
+		return;
+	//A NAME REGISTERED TWICE KEEPS ITS FIRST CLASS
+	dword_type dw_type;
+	if (find_class(pOperatorString,i_length,&dw_type))
+		return;
+	//GROW THE TABLE WHEN IT IS FULL, THE CHAINS STAY SHORT
+	if ((size_t)i_num_classes >= st_class_table_size)
 	{
-		*ppsc_nameReg = (char*)realloc(*ppsc_nameReg,(strlen(psc_name)+ 2 + (uiLen = strlen(*ppsc_nameReg)))*(unsigned int)sizeof(char));
-		strcat(*ppsc_nameReg,psc_name);
+		size_t st_size = (st_class_table_size)?2*st_class_table_size:ALGEBRA_PARSER_TABLE_SIZE;
+		PPARSER_CLASS * pppc_table = new PPARSER_CLASS[st_size];
+		for(size_t i = 0;i < st_size;i++)
+			pppc_table[i] = NULL;
+		for(size_t i = 0;i < st_class_table_size;i++)
+		{
+			PPARSER_CLASS ppc = pppc_classes[i];
+			while(ppc)
+			{
+				PPARSER_CLASS ppc_next = ppc->ppc_next;
+				ppc->ppc_next = pppc_table[ppc->st_hash&(st_size-1)];
+				pppc_table[ppc->st_hash&(st_size-1)] = ppc;
+				ppc = ppc_next;
+			}
+		}
+		if (pppc_classes)
+			delete [] pppc_classes;
+		pppc_classes = pppc_table;
+		st_class_table_size = st_size;
 	}
-	else
+	PPARSER_CLASS ppc = new PARSER_CLASS;
+	strcpy(ppc->sc_name,pOperatorString);
+	ppc->i_name_length = i_length;
+	ppc->st_hash = HashName(pOperatorString,i_length);
+	ppc->dw_operator_type = dwOperatorType;
+	ppc->pcreate_function = pcreateFunc;
+	ppc->ppc_next = pppc_classes[ppc->st_hash&(st_class_table_size-1)];
+	pppc_classes[ppc->st_hash&(st_class_table_size-1)] = ppc;
+	i_num_classes++;
+};
+
+dword_type calculus::algebra_parser::find_class(const char * psc_name,int i_length,dword_type * pdw_operator_type)
+{
+	if (!pppc_classes)
+		return 0;
+	size_t st_hash = HashName(psc_name,i_length);
+	for(PPARSER_CLASS ppc = pppc_classes[st_hash&(st_class_table_size-1)];ppc;ppc = ppc->ppc_next)
 	{
-		*ppsc_nameReg = (char*)malloc((strlen(psc_name) + 2 + (uiLen = 1))*sizeof(char));
-		strcpy(*ppsc_nameReg,";");
-		strcat(*ppsc_nameReg,psc_name);
+		if ((ppc->st_hash == st_hash) && (ppc->i_name_length == i_length) && (!memcmp(ppc->sc_name,psc_name,i_length)))
+		{
+			if (pdw_operator_type)
+				*pdw_operator_type = ppc->dw_operator_type;
+			return ppc->pcreate_function;
+		}
 	}
-	strcat(*ppsc_nameReg,";");
-	if (*ppPosReg)
-	{
-		*ppPosReg = (int *)realloc(*ppPosReg,(*pNumRegEntries+1)*sizeof(unsigned int));
+	return 0;
+};
+
+//THE NAMES USED TO BE LOOKED UP AS ";name;", THE SEPARATORS ARE STILL ACCEPTED
+static dword_type FindClassOfType(calculus::algebra_parser * pap_parser,const char * pString,dword_type dw_operator_type)
+{
+	if (*pString == ';')
+		pString++;
+	int i_length = (int)strlen(pString);
+	if (i_length && (pString[i_length-1] == ';'))
+		i_length--;
+	dword_type dw_type;
+	dword_type pcreate_function = pap_parser->find_class(pString,i_length,&dw_type);
+	return (pcreate_function && (dw_type == dw_operator_type))?pcreate_function:0;
+}
+
+calculus::algebra_parser::unary_create_function calculus::algebra_parser::get_unary_create_function(const char * pString)
+{
+	return (unary_create_function)FindClassOfType(this,pString,CLASS_UNARY_NORMAL);
+};
+
+calculus::algebra_parser::binary_create_function calculus::algebra_parser::get_binary_create_function(const char * pString)
+{
+	return (binary_create_function)FindClassOfType(this,pString,CLASS_BINARY_NORMAL);
+};
+
+calculus::algebra_parser::unary_create_extended_function calculus::algebra_parser::get_extended_unary_create_function(const char * pString)
+{
+	//THE ORDER OF THE ARGUMENTS ONLY MATTERS TO THE TEXT, BOTH KINDS ARE CREATED THE SAME WAY
+	dword_type pcreate_function = FindClassOfType(this,pString,CLASS_UNARY_EXTENDED);
+	if (!pcreate_function)
+		pcreate_function = FindClassOfType(this,pString,CLASS_UNARY_EXTENDED_LAST);
+	return (unary_create_extended_function)pcreate_function;
+};
+
+#define PARSE_PRECEDENCE_SUM		1
+#define PARSE_PRECEDENCE_PRODUCT	2
+#define PARSE_PRECEDENCE_POWER		3
+
+#define PARSE_TOKEN_END			0
+#define PARSE_TOKEN_NUMBER		1
+#define PARSE_TOKEN_NAME		2
+#define PARSE_TOKEN_SYMBOL		3
+
+#define PARSE_NUMBER_LENGTH		0x40
+#define PARSE_MAX_DEPTH			4096			//Nested subexpressions, the parser recurses once for each
+
+//THE TOKENIZER READS ONE TOKEN AHEAD, STRAIGHT FROM THE CALLER'S STRING
+typedef struct PARSE_STATE {
+	calculus::algebra_parser*	pap_parser;
+	const char*					psc_begin;
+	const char*					psc_next;				//First character after the current token
+	const char*					psc_end;				//End of the text, it needn't be terminated
+	int							i_token;				//PARSE_TOKEN_*
+	const char*					psc_token;				//First character of the current token
+	int							i_token_length;
+	double						d_token_value;			//The value of a PARSE_TOKEN_NUMBER
+	int							i_depth;				//Subexpressions being parsed, bounded by PARSE_MAX_DEPTH
+	calculus::PPARSE_ERROR		ppe_error;
+} PARSE_STATE,*PPARSE_STATE;
+
+static void ParseError(PPARSE_STATE pps,const char* psc_at,const char* psc_message) {
+	//ONLY THE FIRST ERROR IS REPORTED, THE CALLERS UNWIND WITHOUT LOOKING FURTHER
+	if ((pps->ppe_error) && (!pps->ppe_error->psc_message)) {
+		pps->ppe_error->i_position = (int)(psc_at - pps->psc_begin);
+		pps->ppe_error->psc_message = psc_message;
 	}
-	else
-	{
-		*ppPosReg = (int *)malloc((*pNumRegEntries+1)*sizeof(unsigned int));
+}
+
+//DELETES A SUBTREE NOBODY REFERENCES, AFTER AN ERROR
+static void ParseDiscard(calculus::algebraic_operator* pao) {
+	if (pao) {
+		pao->addref();
+		pao->release();
 	}
-	(*ppPosReg)[*pNumRegEntries] = uiLen-1;
-	if (*ppFuncReg)
-	{
-		*ppFuncReg = (dword_type*)realloc(*ppFuncReg,(*pNumRegEntries+1)*sizeof(void*));
+}
+
+static bool ParseNextToken(PPARSE_STATE pps) {
+	const char* psc = pps->psc_next;
+	const char* psc_end = pps->psc_end;
+	while ((psc < psc_end) && isspace((unsigned char)*psc))
+		psc++;
+	pps->psc_token = psc;
+	if (psc == psc_end) {
+		pps->i_token = PARSE_TOKEN_END;
+		pps->i_token_length = 0;
+	} else if (isdigit((unsigned char)*psc) || ((*psc == '.') && (psc+1 < psc_end) && isdigit((unsigned char)psc[1]))) {
+		//THE LEXEME IS BOUNDED HERE, strtod() ALONE COULD READ PAST AN UNTERMINATED TEXT
+		const char* psc_number = psc;
+		while ((psc_number < psc_end) && isdigit((unsigned char)*psc_number))
+			psc_number++;
+		if ((psc_number < psc_end) && (*psc_number == '.'))
+			for(psc_number++;(psc_number < psc_end) && isdigit((unsigned char)*psc_number);psc_number++);
+		if ((psc_number < psc_end) && ((*psc_number == 'e') || (*psc_number == 'E'))) {
+			const char* psc_exponent = psc_number+1;
+			if ((psc_exponent < psc_end) && ((*psc_exponent == '+') || (*psc_exponent == '-')))
+				psc_exponent++;
+			if ((psc_exponent < psc_end) && isdigit((unsigned char)*psc_exponent))
+				for(psc_number = psc_exponent;(psc_number < psc_end) && isdigit((unsigned char)*psc_number);psc_number++);
+		}
+		char sc_number[PARSE_NUMBER_LENGTH];
+		if (psc_number - psc >= (int)PARSE_NUMBER_LENGTH) {
+			ParseError(pps,psc,"number too long");
+			return false;
+		}
+		memcpy(sc_number,psc,psc_number - psc);
+		sc_number[psc_number - psc] = 0;
+		pps->i_token = PARSE_TOKEN_NUMBER;
+		pps->d_token_value = strtod(sc_number,NULL);
+		pps->i_token_length = (int)(psc_number - psc);
+	} else if (isalpha((unsigned char)*psc) || (*psc == '_')) {
+		const char* psc_name = psc;
+		while ((psc_name < psc_end) && (isalnum((unsigned char)*psc_name) || (*psc_name == '_')))
+			psc_name++;
+		pps->i_token = PARSE_TOKEN_NAME;
+		pps->i_token_length = (int)(psc_name - psc);
+	} else if (*psc && strchr("+-*/^(),",*psc)) {
+		pps->i_token = PARSE_TOKEN_SYMBOL;
+		pps->i_token_length = 1;
+	} else {
+		ParseError(pps,psc,"unexpected character");
+		return false;
 	}
-	else
-	{
-		*ppFuncReg = (dword_type*)malloc((*pNumRegEntries+1)*sizeof(void*));
+	pps->psc_next = psc + pps->i_token_length;
+	return true;
+}
+
+inline bool ParseIsSymbol(PPARSE_STATE pps,char c) {
+	return (pps->i_token == PARSE_TOKEN_SYMBOL) && (*pps->psc_token == c);
+}
+
+static bool ParseExpect(PPARSE_STATE pps,char c,const char* psc_message) {
+	if (!ParseIsSymbol(pps,c)) {
+		ParseError(pps,pps->psc_token,psc_message);
+		return false;
 	}
-	(*ppFuncReg)[*pNumRegEntries] = pFunc;
-	(*pNumRegEntries)++;
-};
+	return ParseNextToken(pps);
+}
 
-void calculus::algebra_parser::register_class(dword_type dwOperatorType,dword_type pcreateFunc,char * pOperatorString )
-{
-	switch(dwOperatorType)
-	{
+//THE PRECEDENCE OF THE CURRENT TOKEN AS A BINARY OPERATOR, 0 WHEN IT ISN'T ONE
+static int ParseBinaryPrecedence(PPARSE_STATE pps) {
+	if (pps->i_token != PARSE_TOKEN_SYMBOL)
+		return 0;
+	switch (*pps->psc_token) {
+	case '+' :
+	case '-' :	return PARSE_PRECEDENCE_SUM;
+	case '*' :
+	case '/' :	return PARSE_PRECEDENCE_PRODUCT;
+	case '^' :	return PARSE_PRECEDENCE_POWER;
+	}
+	return 0;
+}
+
+static calculus::algebraic_operator* ParseExpression(PPARSE_STATE pps,int i_min_precedence);
+static calculus::algebraic_operator* ParseExpressionAt(PPARSE_STATE pps,int i_min_precedence);
+
+//AN INTEGER LITERAL, MAYBE NEGATIVE, AS THE ARGUMENT OF AN EXTENDED FUNCTION
+static bool ParseInteger(PPARSE_STATE pps,int* pi_value) {
+	bool b_negative = ParseIsSymbol(pps,'-');
+	if (b_negative && !ParseNextToken(pps))
+		return false;
+	if ((pps->i_token != PARSE_TOKEN_NUMBER) || (pps->d_token_value != floor(pps->d_token_value))) {
+		ParseError(pps,pps->psc_token,"expected an integer");
+		return false;
+	}
+	//THE RANGE IS CHECKED BEFORE THE CAST, A DOUBLE OUTSIDE OF IT HAS NO int
+	double d_value = (b_negative)?-pps->d_token_value:pps->d_token_value;
+	if ((d_value < (double)INT_MIN) || (d_value > (double)INT_MAX)) {
+		ParseError(pps,pps->psc_token,"integer out of range");
+		return false;
+	}
+	*pi_value = (int)d_value;
+	return ParseNextToken(pps);
+}
+
+//name(x), name(n,x), name(x,n), name(x,v) OR name(x,y), THE CURRENT TOKEN IS THE OPENING PARENTHESIS
+static calculus::algebraic_operator* ParseCall(PPARSE_STATE pps,const char* psc_name,int i_name_length) {
+	dword_type dw_type = 0;
+	dword_type pcreate_function = pps->pap_parser->find_class(psc_name,i_name_length,&dw_type);
+	if (!pcreate_function) {
+		ParseError(pps,psc_name,"unknown function");
+		return NULL;
+	}
+	if (!ParseNextToken(pps))
+		return NULL;
+	//THE INTEGER OF name(n,x) IS READ BEFORE THE OPERAND
+	int n = 0;
+	if (dw_type == CLASS_UNARY_EXTENDED) {
+		if (!ParseInteger(pps,&n) || !ParseExpect(pps,',',"expected ','"))
+			return NULL;
+	}
+	calculus::algebraic_operator* pao_left = ParseExpression(pps,PARSE_PRECEDENCE_SUM);
+	if (!pao_left)
+		return NULL;
+	//THE OTHER THREADS MAY SWEEP THE CONS TABLE WHILE WE PARSE THE RIGHT ARGUMENT
+	pao_left->addref();
+	calculus::algebraic_operator* pao_right = NULL;
+	if (dw_type != CLASS_UNARY_NORMAL && dw_type != CLASS_UNARY_EXTENDED) {
+		if (!ParseExpect(pps,',',"expected ','")) {
+			pao_left->release();
+			return NULL;
+		}
+		if (dw_type == CLASS_UNARY_EXTENDED_LAST) {
+			if (!ParseInteger(pps,&n)) {
+				pao_left->release();
+				return NULL;
+			}
+		} else {
+			const char* psc_right = pps->psc_token;
+			pao_right = ParseExpression(pps,PARSE_PRECEDENCE_SUM);
+			if (!pao_right) {
+				pao_left->release();
+				return NULL;
+			}
+			if ((dw_type == CLASS_UNARY_DERIVATIVE) && (typeid(*pao_right) != typeid(calculus::variable))) {
+				ParseError(pps,psc_right,"expected a variable");
+				pao_left->release();
+				ParseDiscard(pao_right);
+				return NULL;
+			}
+		}
+	}
+	if (!ParseExpect(pps,')',"expected ')'")) {
+		pao_left->release();
+		ParseDiscard(pao_right);
+		return NULL;
+	}
+	calculus::algebraic_operator* pao = NULL;
+	switch (dw_type) {
 	case CLASS_UNARY_NORMAL :
-		_add_class_registry_info(&this->i_num_unary_operators,(dword_type**)&this->punary_create_functions,&this->psc_unary_operator_string,&this->pi_unary_operator_string_positions,pcreateFunc,pOperatorString);
+		pao = ((calculus::algebra_parser::unary_create_function)pcreate_function)(pao_left);
 		break;
 	case CLASS_UNARY_EXTENDED :
-		_add_class_registry_info(&this->i_num_extended_unary_operators,(dword_type**)&this->punary_create_extended_functions,&this->psc_extended_unary_operator_string,&this->pi_extended_unary_operator_string_positions,pcreateFunc,pOperatorString);
+	case CLASS_UNARY_EXTENDED_LAST :
+		pao = ((calculus::algebra_parser::unary_create_extended_function)pcreate_function)(n,pao_left);
 		break;
-	case CLASS_BINARY_NORMAL :
-		_add_class_registry_info(&this->i_num_binary_operators,(dword_type**)&this->pbinary_create_functions,&this->psc_binary_operator_string,&this->pi_binary_operator_string_positions,pcreateFunc,pOperatorString);
+	case CLASS_UNARY_DERIVATIVE :
+		pao = ((calculus::algebra_parser::derivative_create_function)pcreate_function)(static_cast<calculus::variable*>(pao_right),pao_left);
+		break;
+	default :
+		pao = ((calculus::algebra_parser::binary_create_function)pcreate_function)(pao_left,pao_right);
 		break;
 	}
-};
+	//THE RESULT MAY BE pao_left ITSELF
+	pao->addref();
+	pao_left->release();
+	return pao->hand_back();
+}
 
-inline void remove_all_spaces(char * pscString)
-{
-	char * pscCur = pscString;
-	while(*pscCur)
-	{
-		if (isspace(*pscCur))
-		{
-			char *pscSwap = pscCur;
-			while(*pscCur)
-			{
-				pscCur[0] = pscCur[1];
-				pscCur++;
-			}
-			pscCur = pscSwap;
+static calculus::algebraic_operator* ParsePrimary(PPARSE_STATE pps) {
+	if (pps->i_token == PARSE_TOKEN_NUMBER) {
+		calculus::algebraic_operator* pao = calculus::_cst(pps->d_token_value);
+		if (!ParseNextToken(pps)) {
+			ParseDiscard(pao);
+			return NULL;
 		}
-		pscCur++;
+		return pao;
 	}
-};
+	if (pps->i_token == PARSE_TOKEN_NAME) {
+		const char* psc_name = pps->psc_token;
+		int i_name_length = pps->i_token_length;
+		if (!ParseNextToken(pps))
+			return NULL;
+		if (ParseIsSymbol(pps,'('))
+			return ParseCall(pps,psc_name,i_name_length);
+		//THE CONSTANTS write_string() PRINTS WITHOUT DIGITS, -inf IS THE NEGATION OF inf
+		if ((i_name_length == 3) && (!memcmp(psc_name,"inf",3) || !memcmp(psc_name,"nan",3)))
+			return calculus::_cst((*psc_name == 'i')?HUGE_VAL:NAN);
+		//A VARIABLE NAME IS COPIED ON THE STACK TO BE TERMINATED
+		char sc_name[MAX_VARIABLE_NAME_LENGTH];
+		if (i_name_length >= MAX_VARIABLE_NAME_LENGTH) {
+			ParseError(pps,psc_name,"name too long");
+			return NULL;
+		}
+		memcpy(sc_name,psc_name,i_name_length);
+		sc_name[i_name_length] = 0;
+		return calculus::_var(sc_name);
+	}
+	if (ParseIsSymbol(pps,'(')) {
+		if (!ParseNextToken(pps))
+			return NULL;
+		calculus::algebraic_operator* pao = ParseExpression(pps,PARSE_PRECEDENCE_SUM);
+		if (!pao)
+			return NULL;
+		if (!ParseExpect(pps,')',"expected ')'")) {
+			ParseDiscard(pao);
+			return NULL;
+		}
+		return pao;
+	}
+	ParseError(pps,pps->psc_token,(pps->i_token == PARSE_TOKEN_END)?"unexpected end of input":"expected an operand");
+	return NULL;
+}
+
+//UNARY SIGNS BIND LOOSER THAN ^, SO -x^2 IS -(x^2), AND TIGHTER THAN * AND /
+static calculus::algebraic_operator* ParseUnary(PPARSE_STATE pps) {
+	if (ParseIsSymbol(pps,'-') || ParseIsSymbol(pps,'+')) {
+		bool b_negate = ParseIsSymbol(pps,'-');
+		if (!ParseNextToken(pps))
+			return NULL;
+		calculus::algebraic_operator* pao = ParseExpression(pps,PARSE_PRECEDENCE_POWER);
+		if (!pao || !b_negate)
+			return pao;
+		if (typeid(*pao) == typeid(calculus::constant))
+			return calculus::_cst(-dynamic_cast<calculus::constant*>(pao)->GetValue());
+		return calculus::unary_operators::intrinsic_operators::_neg(pao);
+	}
+	return ParsePrimary(pps);
+}
+
+//PRECEDENCE CLIMBING, ONLY THE OPERATORS BINDING AT LEAST AS TIGHT AS i_min_precedence ARE TAKEN HERE
+static calculus::algebraic_operator* ParseExpression(PPARSE_STATE pps,int i_min_precedence) {
+	//EVERY NESTED SUBEXPRESSION COMES BACK HERE, A DEEP TEXT IS REFUSED BEFORE IT EXHAUSTS THE STACK
+	if (pps->i_depth >= PARSE_MAX_DEPTH) {
+		ParseError(pps,pps->psc_token,"expression nested too deeply");
+		return NULL;
+	}
+	pps->i_depth++;
+	calculus::algebraic_operator* pao_left = ParseExpressionAt(pps,i_min_precedence);
+	pps->i_depth--;
+	return pao_left;
+}
+
+static calculus::algebraic_operator* ParseExpressionAt(PPARSE_STATE pps,int i_min_precedence) {
+	calculus::algebraic_operator* pao_left = ParseUnary(pps);
+	if (!pao_left)
+		return NULL;
+	//THE LEFT OPERAND IS REFERENCED WHILE THE RIGHT ONE IS PARSED, THE OTHER THREADS MAY SWEEP THE CONS TABLE
+	pao_left->addref();
+	int i_precedence;
+	while ((i_precedence = ParseBinaryPrecedence(pps)) >= i_min_precedence && i_precedence) {
+		char c_operator = *pps->psc_token;
+		if (!ParseNextToken(pps)) {
+			pao_left->release();
+			return NULL;
+		}
+		//^ IS RIGHT ASSOCIATIVE, THE OTHERS ARE LEFT ASSOCIATIVE
+		calculus::algebraic_operator* pao_right = ParseExpression(pps,(c_operator == '^')?i_precedence:i_precedence+1);
+		if (!pao_right) {
+			pao_left->release();
+			return NULL;
+		}
+		calculus::algebraic_operator* pao = NULL;
+		switch (c_operator) {
+		case '+' :	pao = calculus::binary_operators::intrinsic_operators::_add(pao_left,pao_right);		break;
+		case '-' :	pao = calculus::binary_operators::intrinsic_operators::_subtract(pao_left,pao_right);	break;
+		case '*' :	pao = calculus::binary_operators::intrinsic_operators::_multiply(pao_left,pao_right);	break;
+		case '/' :	pao = calculus::binary_operators::intrinsic_operators::_divide(pao_left,pao_right);		break;
+		case '^' :	pao = calculus::binary_operators::intrinsic_operators::_pow(pao_left,pao_right);		break;
+		}
+		//THE RESULT MAY BE pao_left ITSELF
+		pao->addref();
+		pao_left->release();
+		pao_left = pao;
+	}
+	return pao_left->hand_back();
+}
 
-calculus::algebra_parser::unary_create_function calculus::algebra_parser::get_unary_create_function(char * pString)
+calculus::algebraic_operator * calculus::algebra_parser::parse_to_algebra(const char * psc_algebraic_string,PPARSE_ERROR ppe_error)
 {
-	int iOffset = dword_type(strstr(this->psc_unary_operator_string,pString) - (char*)this->psc_unary_operator_string);
-	for(int i = 0;i < this->i_num_unary_operators;i++)
-	{
-		if (iOffset == this->pi_unary_operator_string_positions[i])
-			return this->punary_create_functions[i];
+	if (!psc_algebraic_string) {
+		if (ppe_error) {
+			ppe_error->i_position = -1;
+			ppe_error->psc_message = NULL;
+		}
+		return NULL;
 	}
-	return NULL;
+	return parse_text(psc_algebraic_string,strlen(psc_algebraic_string),ppe_error);
 };
 
-calculus::algebra_parser::binary_create_function calculus::algebra_parser::get_binary_create_function(char * pString)
+calculus::algebraic_operator * calculus::algebra_parser::parse_text(const char * psc_text,size_t st_length,PPARSE_ERROR ppe_error)
 {
-	int iOffset = strstr(this->psc_binary_operator_string,pString) - this->psc_binary_operator_string;
-	for(int i = 0;i < this->i_num_binary_operators;i++)
-	{
-		if (iOffset == this->pi_binary_operator_string_positions[i])
-			return this->pbinary_create_functions[i];
+	PARSE_STATE ps;
+	ps.pap_parser = this;
+	ps.psc_begin = ps.psc_next = psc_text;
+	ps.psc_end = psc_text + st_length;
+	ps.ppe_error = ppe_error;
+	ps.i_depth = 0;
+	if (ppe_error) {
+		ppe_error->i_position = -1;
+		ppe_error->psc_message = NULL;
 	}
-	return NULL;
+	if (!ParseNextToken(&ps))
+		return NULL;
+	calculus::algebraic_operator * palg = ParseExpression(&ps,PARSE_PRECEDENCE_SUM);
+	if (palg && (ps.i_token != PARSE_TOKEN_END)) {
+		ParseError(&ps,ps.psc_token,(ParseIsSymbol(&ps,')'))?"unbalanced ')'":"expected an operator");
+		ParseDiscard(palg);
+		palg = NULL;
+	}
+	return palg;
 };
 
-calculus::algebra_parser::unary_create_extended_function calculus::algebra_parser::get_extended_unary_create_function(char * pString)
+//THE TEXT WITHOUT ITS SPACING, ONE SPACE IS KEPT WHERE IT SEPARATES TWO NAMES OR NUMBERS SO "x y" STAYS AN ERROR,
+//AND AROUND THE SIGN OF AN EXPONENT SO "1e -5" DOESN'T BECOME THE NUMBER 1e-5
+static bool IsWordCharacter(char c)
 {
-	int iOffset = strstr(this->psc_extended_unary_operator_string,pString) - this->psc_extended_unary_operator_string;
-	for(int i = 0;i < this->i_num_extended_unary_operators;i++)
+	return isalnum((unsigned char)c) || (c == '_') || (c == '.');
+}
+
+static char * NormalizeExpression(const char * psc_algebraic_string,size_t * pst_length)
+{
+	char * psc_key = new char[strlen(psc_algebraic_string)+1];
+	size_t n = 0;
+	bool b_space = false;
+	bool b_number = false;		//THE KEY ENDS IN A NUMBER, MAYBE UP TO THE SIGN OF ITS EXPONENT
+	for(const char * psc = psc_algebraic_string;*psc;psc++)
 	{
-		if (iOffset == this->pi_extended_unary_operator_string_positions[i])
-			return this->punary_create_extended_functions[i];
+		if (isspace((unsigned char)*psc))
+		{
+			b_space = true;
+			continue;
+		}
+		char c_last = (n)?psc_key[n-1]:0;
+		bool b_exponent_sign = b_number && ((c_last == 'e') || (c_last == 'E')) && ((*psc == '+') || (*psc == '-'));
+		bool b_after_sign = b_number && ((c_last == '+') || (c_last == '-'));
+		if (b_space && n && ((IsWordCharacter(c_last) && IsWordCharacter(*psc)) || b_exponent_sign || (b_after_sign && IsWordCharacter(*psc))))
+			psc_key[n++] = ' ';
+		//WITHOUT A SPACE BETWEEN THEM, A NAME OR A NUMBER GOES ON WITH THE TOKEN THE KEY ENDS WITH
+		bool b_continued = !b_space && ((IsWordCharacter(*psc))?(IsWordCharacter(c_last) || b_after_sign):b_exponent_sign);
+		if (!b_continued)
+			b_number = isdigit((unsigned char)*psc) || (*psc == '.');
+		b_space = false;
+		psc_key[n++] = *psc;
 	}
-	return NULL;
-};
+	psc_key[n] = 0;
+	*pst_length = n;
+	return psc_key;
+}
 
-//#include "calculus_grammar.h"
+void calculus::algebra_parser::unlink_cache_entry(PPARSE_CACHE_ENTRY ppce)
+{
+	PPARSE_CACHE_ENTRY * pppce = &pppce_cache[ppce->st_hash&(st_cache_table_size-1)];
+	while (*pppce != ppce)
+		pppce = &(*pppce)->ppce_next;
+	*pppce = ppce->ppce_next;
+	if (ppce->ppce_newer)
+		ppce->ppce_newer->ppce_older = ppce->ppce_older;
+	else
+		ppce_newest = ppce->ppce_older;
+	if (ppce->ppce_older)
+		ppce->ppce_older->ppce_newer = ppce->ppce_newer;
+	else
+		ppce_oldest = ppce->ppce_newer;
+	ppce->ppce_newer = ppce->ppce_older = NULL;
+}
 
-#pragma warning(push)
-#pragma warning(disable : 4100 4065)
-//#include "calculus_grammar.c"
-#pragma warning(pop)
+void calculus::algebra_parser::evict_cache_entry(PPARSE_CACHE_ENTRY ppce)
+{
+	unlink_cache_entry(ppce);
+	ppce->pao_operator->release();
+	delete [] ppce->psc_key;
+	delete ppce;
+	pcs_statistics.st_entries--;
+}
 
-calculus::algebraic_operator * calculus::algebra_parser::parse_to_algebra(char * psc_algebraic_string)
+calculus::algebraic_operator * calculus::algebra_parser::parse_cached(const char * psc_algebraic_string,PPARSE_ERROR ppe_error)
 {
-	calculus::algebraic_operator * palg = NULL;
-	/*
-	void * pParser = ParseAlloc(malloc);
-	if (pParser)
+	if (!psc_algebraic_string)
+		return parse_to_algebra(psc_algebraic_string,ppe_error);
+	size_t st_length;
+	char * psc_key = NormalizeExpression(psc_algebraic_string,&st_length);
+	size_t st_hash = HashName(psc_key,st_length);
 	{
-		char * pscCurrentBuffer = new char[strlen(psc_algebraic_string)+1];
-		if (pscCurrentBuffer)
+		std::lock_guard<std::mutex> lg_cache(m_cache_lock);
+		for(PPARSE_CACHE_ENTRY ppce = (pppce_cache)?pppce_cache[st_hash&(st_cache_table_size-1)]:NULL;ppce;ppce = ppce->ppce_next)
 		{
-			strcpy(pscCurrentBuffer,psc_algebraic_string);
-			remove_all_spaces(pscCurrentBuffer);
-			char * pscLocalPos = pscCurrentBuffer;
-
-			Parse(pParser,BEGIN,0,&palg);
-			while(*pscLocalPos)
+			if ((ppce->st_hash == st_hash) && (!strcmp(ppce->psc_key,psc_key)))
 			{
-				//Let's see if the current location is a simple terminal symbol
-				switch(*pscLocalPos)
-				{
-				case '(' :	Parse(pParser,LPAREN,0,&palg);	break;
-				case ')' :	Parse(pParser,RPAREN,0,&palg);	break;
-				case '+' :	Parse(pParser,PLUS,0,&palg);	break;
-				case '-' :	Parse(pParser,MINUS,0,&palg);	break;
-				case '*' :	Parse(pParser,TIMES,0,&palg);	break;
-				case '/' :	Parse(pParser,DIVIDE,0,&palg);	break;
-				case '^' :	Parse(pParser,EXP,0,&palg);		break;
-				case ',' :	Parse(pParser,COMMA,0,&palg);	break;
-				default :	goto not_a_symbol;
-				}
-				pscLocalPos++;
-				continue;
-not_a_symbol:	//If we get here then this is a function/variable/constant
-
-				//Variables and terminals must start with a letter or an underscore
-				if (isalpha(*pscLocalPos) || *pscLocalPos == '_')
-				{
-					char *pscEndOfLocalPos = pscLocalPos;
-					for(;isalnum(*pscEndOfLocalPos) || *pscEndOfLocalPos == '_';pscEndOfLocalPos++);
-					char c = *pscEndOfLocalPos;
-					*pscEndOfLocalPos = 0;
-
-					char * pscNameBuffer = new char[strlen(pscLocalPos)+3];
-					if (pscNameBuffer)
-					{
-						sprintf(pscNameBuffer,";%s;",pscLocalPos);
-
-						void * pFunc = (void*)get_unary_create_function(pscNameBuffer);
-						if (pFunc) {
-							Parse(pParser,UNARY_OPERATOR,pFunc,&palg);
-						}
-						else {
-							pFunc = (void*)get_extended_unary_create_function(pscNameBuffer);
-							if (pFunc) {
-								//Parse(pParser,BINARY_OPERATOR,pFunc,&palg);
-							}
-							else {
-								pFunc = (void*)get_binary_create_function(pscNameBuffer);
-								if (pFunc) {
-									Parse(pParser,BINARY_OPERATOR,pFunc,&palg);
-								}
-								else {
-									Parse(pParser,VARIABLE,_var(pscLocalPos),&palg);
-								}
-							}
-						}
-						delete [] pscNameBuffer;
-					}
-
-					*pscEndOfLocalPos = c;
-					pscLocalPos = pscEndOfLocalPos;
-				}
-				//Constants must start with a digit
-				else if (isdigit(*pscLocalPos))
+				//A HIT BECOMES THE NEWEST ENTRY
+				unlink_cache_entry(ppce);
+				ppce->ppce_next = pppce_cache[st_hash&(st_cache_table_size-1)];
+				pppce_cache[st_hash&(st_cache_table_size-1)] = ppce;
+				ppce->ppce_older = ppce_newest;
+				if (ppce_newest)
+					ppce_newest->ppce_newer = ppce;
+				else
+					ppce_oldest = ppce;
+				ppce_newest = ppce;
+				pcs_statistics.st_hits++;
+				ppce->pao_operator->addref();
+				delete [] psc_key;
+				if (ppe_error)
 				{
-					
+					ppe_error->i_position = -1;
+					ppe_error->psc_message = NULL;
 				}
-                else{ //ILLEGAL CHARACTER SEQUENCE
-                }
+				return ppce->pao_operator;
 			}
-			Parse(pParser,END,0,&palg);
-			Parse(pParser, 0, 0,&palg);
 		}
-		delete [] pscCurrentBuffer;
-		ParseFree(pParser,free);
-	}*/
-	return palg;
-};
+		pcs_statistics.st_misses++;
+	}
+	//PARSE THE CALLER'S TEXT SO THE ERROR POSITIONS REFER TO IT, AND COMPILE OUTSIDE THE CACHE LOCK
+	calculus::algebraic_operator * pao = parse_to_algebra(psc_algebraic_string,ppe_error);
+	if (!pao)
+	{
+		delete [] psc_key;
+		return NULL;
+	}
+	pao->addref();
+	pao->compile();
+
+	std::lock_guard<std::mutex> lg_cache(m_cache_lock);
+	if (!pcs_statistics.st_capacity)
+	{
+		delete [] psc_key;
+		return pao;
+	}
+	if (!pppce_cache)
+	{
+		st_cache_table_size = 0x10;
+		while (st_cache_table_size < pcs_statistics.st_capacity)
+			st_cache_table_size <<= 1;
+		pppce_cache = new PPARSE_CACHE_ENTRY[st_cache_table_size];
+		for(size_t i = 0;i < st_cache_table_size;i++)
+			pppce_cache[i] = NULL;
+	}
+	//ANOTHER THREAD MAY HAVE CACHED THE SAME TEXT MEANWHILE, ITS OPERATOR WINS
+	for(PPARSE_CACHE_ENTRY ppce = pppce_cache[st_hash&(st_cache_table_size-1)];ppce;ppce = ppce->ppce_next)
+	{
+		if ((ppce->st_hash == st_hash) && (!strcmp(ppce->psc_key,psc_key)))
+		{
+			ppce->pao_operator->addref();
+			pao->release();
+			delete [] psc_key;
+			return ppce->pao_operator;
+		}
+	}
+	PPARSE_CACHE_ENTRY ppce = new PARSE_CACHE_ENTRY;
+	ppce->psc_key = psc_key;
+	ppce->st_hash = st_hash;
+	ppce->pao_operator = pao;
+	pao->addref();
+	ppce->ppce_next = pppce_cache[st_hash&(st_cache_table_size-1)];
+	pppce_cache[st_hash&(st_cache_table_size-1)] = ppce;
+	ppce->ppce_newer = NULL;
+	ppce->ppce_older = ppce_newest;
+	if (ppce_newest)
+		ppce_newest->ppce_newer = ppce;
+	else
+		ppce_oldest = ppce;
+	ppce_newest = ppce;
+	pcs_statistics.st_entries++;
+	while (pcs_statistics.st_entries > pcs_statistics.st_capacity)
+	{
+		evict_cache_entry(ppce_oldest);
+		pcs_statistics.st_evictions++;
+	}
+	return pao;
+}
+
+void calculus::algebra_parser::set_cache_capacity(size_t st_capacity)
+{
+	std::lock_guard<std::mutex> lg_cache(m_cache_lock);
+	pcs_statistics.st_capacity = st_capacity;
+	while (pcs_statistics.st_entries > st_capacity)
+	{
+		evict_cache_entry(ppce_oldest);
+		pcs_statistics.st_evictions++;
+	}
+	//THE BUCKETS GROW WITH THE CAPACITY SO THE CHAINS STAY SHORT
+	if (pppce_cache && (st_cache_table_size < st_capacity))
+	{
+		size_t st_size = st_cache_table_size;
+		while (st_size < st_capacity)
+			st_size <<= 1;
+		PPARSE_CACHE_ENTRY * pppce_table = new PPARSE_CACHE_ENTRY[st_size];
+		for(size_t i = 0;i < st_size;i++)
+			pppce_table[i] = NULL;
+		for(PPARSE_CACHE_ENTRY ppce = ppce_oldest;ppce;ppce = ppce->ppce_newer)
+		{
+			ppce->ppce_next = pppce_table[ppce->st_hash&(st_size-1)];
+			pppce_table[ppce->st_hash&(st_size-1)] = ppce;
+		}
+		delete [] pppce_cache;
+		pppce_cache = pppce_table;
+		st_cache_table_size = st_size;
+	}
+}
+
+void calculus::algebra_parser::get_cache_statistics(PPARSE_CACHE_STATISTICS ppcs_statistics)
+{
+	std::lock_guard<std::mutex> lg_cache(m_cache_lock);
+	*ppcs_statistics = pcs_statistics;
+}
+
+void calculus::algebra_parser::clear_cache()
+{
+	std::lock_guard<std::mutex> lg_cache(m_cache_lock);
+	while (ppce_oldest)
+		evict_cache_entry(ppce_oldest);
+}
@@ -104,35 +104,318 @@ unsigned int calculus::algebraic_operator::s_ui_compilation_deferral = UINT_MAX;
 calculus::IA32_binary* calculus::IA32_binary::s_pia32b_first = NULL;
 calculus::IA32_binary* calculus::IA32_binary::s_pia32b_last = NULL;
 unsigned short calculus::algebraic_operator::s_us_compile_flags = COMPILER_ADAPT;
+int calculus::algebraic_operator::s_i_vector_isa = VECTOR_ISA_NONE;
+calculus::algebraic_operator** calculus::algebraic_operator::s_ppao_cons_table = NULL;
+size_t calculus::algebraic_operator::s_st_cons_table_size = 0;
+size_t calculus::algebraic_operator::s_st_cons_count = 0;
+thread_local calculus::algebraic_operator::HAND_OUT_RING calculus::algebraic_operator::s_hor_ring;
+calculus::algebraic_operator::PHAND_OUT_RING calculus::algebraic_operator::s_phor_rings = NULL;
+thread_local bool calculus::algebraic_operator::s_b_sweeping = false;
+calculus::algebraic_operator** calculus::algebraic_operator::s_ppao_swept = NULL;
+size_t calculus::algebraic_operator::s_st_swept_count = 0;
+size_t calculus::algebraic_operator::s_st_swept_capacity = 0;
+
+#define CONS_TABLE_INITIAL_SIZE 0x100
+
+std::recursive_mutex& calculus::build_lock() {
+	//CONSTRUCTED ON FIRST USE, EVEN WHEN THE FIRST USE IS A STATIC CONSTRUCTOR IN ANOTHER TRANSLATION UNIT
+	static std::recursive_mutex s_rm_build;
+	return s_rm_build;
+}
 
 calculus::algebraic_operator::algebraic_operator() {
     m_b_variables_identified = false;
 	m_ul_refcount = 0;
 	m_ui_call_count = 0;
     m_pia32_binary = NULL;
+    m_pia32_batch_binary = NULL;
+    m_pt_tape = NULL;
 	m_i_number_of_variables = 0;
 	m_ppao_partial_derivatives = NULL;
 	m_i_number_of_variables = 0;
 	m_ppv_variables = NULL;
+	m_b_borrowed_variables = false;
+	m_b_variable_buffer = false;
+	m_i_borrowed_variables = 0;
+	m_b_interned = false;
+	m_pao_cons_next = NULL;
+	m_qw_structural_hash = 0;
 }
 
 calculus::algebraic_operator::~algebraic_operator() {
-	if (m_ppao_partial_derivatives != NULL) {
-		unsigned int num_vars = get_number_of_variables();
-		for(;num_vars;) {
-			num_vars--;
-			if (m_ppao_partial_derivatives[num_vars])
-				m_ppao_partial_derivatives[num_vars]->release();
+	//THE CONS TABLE HOLDS A REFERENCE, AN INTERNED OPERATOR IS ONLY DELETED ONCE DETACHED
+	_ASSERT(!m_b_interned);
+
+	if (m_pt_tape != NULL)
+		delete m_pt_tape;
+	m_pt_tape = NULL;
+
+	release_partial_derivatives();
+
+	release_variables();
+}
+
+void calculus::algebraic_operator::release_variables() {
+	if (m_ppv_variables != NULL) {
+		if (!m_b_borrowed_variables) {
+			mass_release<calculus::variable>(m_ppv_variables,m_i_number_of_variables);
+			if (m_b_variable_buffer)
+				calculus::node_pool::release_array(VARIABLE_BUFFER_OF(m_ppv_variables));
+			else
+				calculus::node_pool::release_array(m_ppv_variables);
+		} else if (m_i_number_of_variables > m_i_borrowed_variables) {
+			//WE APPENDED TO THE BUFFER OF AN OPERAND, THE NEXT PARENT OF THAT OPERAND MAY APPEND AGAIN
+			std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+			PVARIABLE_BUFFER pvb_buffer = VARIABLE_BUFFER_OF(m_ppv_variables);
+			if (pvb_buffer->i_used == m_i_number_of_variables)
+				pvb_buffer->i_used = m_i_borrowed_variables;
+			mass_release<calculus::variable>(m_ppv_variables+m_i_borrowed_variables,m_i_number_of_variables-m_i_borrowed_variables);
 		}
-		delete [] m_ppao_partial_derivatives;
-		this->m_ppao_partial_derivatives = NULL;
 	}
+	m_ppv_variables = NULL;
+	m_b_borrowed_variables = false;
+	m_b_variable_buffer = false;
+	m_i_borrowed_variables = 0;
+}
 
-	if (m_ppv_variables != NULL) {
-		mass_release<calculus::variable>(m_ppv_variables,m_i_number_of_variables);
-		delete [] m_ppv_variables;
+void calculus::algebraic_operator::borrow_variables(calculus::algebraic_operator* pao_operand) {
+	m_i_number_of_variables = pao_operand->get_number_of_variables();
+	m_ppv_variables = (m_i_number_of_variables)?pao_operand->get_variables():NULL;
+	m_b_borrowed_variables = (m_ppv_variables != NULL);
+	m_b_variable_buffer = (m_ppv_variables != NULL) && pao_operand->has_variable_buffer();
+	m_i_borrowed_variables = m_i_number_of_variables;
+}
+
+bool calculus::algebraic_operator::has_variable_buffer() {
+	get_variables();
+	return m_b_variable_buffer;
+}
+
+qword_type calculus::algebraic_operator::structural_hash() {
+	return StructuralHashCombine(typeid(*this).hash_code(),(qword_type)this);
+}
+
+bool calculus::algebraic_operator::structural_equal(calculus::algebraic_operator * pao_other) {
+	return this == pao_other;
+}
+
+qword_type calculus::algebraic_operator::get_hash() {
+	//A RACE ONLY COMPUTES THE SAME VALUE TWICE
+	qword_type qw_hash = m_qw_structural_hash.load(std::memory_order_relaxed);
+	if (!qw_hash) {
+		qw_hash = structural_hash();
+		if (!qw_hash)
+			qw_hash = 1;
+		m_qw_structural_hash.store(qw_hash,std::memory_order_relaxed);
+	}
+	return qw_hash;
+}
+
+bool calculus::algebraic_operator::equals(calculus::algebraic_operator * pao_other) {
+	if (this == pao_other)
+		return true;
+	if (!pao_other)
+		return false;
+	if (get_hash() != pao_other->get_hash())
+		return false;
+	return structural_equal(pao_other);
+}
+
+calculus::algebraic_operator* calculus::algebraic_operator::intern(calculus::algebraic_operator * pao_new) {
+	_ASSERT(pao_new);
+	_ASSERT(!pao_new->m_ul_refcount);
+	//THE OPERANDS ARE INTERNED OR UNSHARED, THEIR HASHES ARE ALREADY CACHED AND EQUAL ONES ARE THE SAME ADDRESS
+	qword_type qw_hash = pao_new->get_hash();
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	if (s_ppao_cons_table) {
+		for(algebraic_operator* pao = s_ppao_cons_table[qw_hash&(s_st_cons_table_size-1)];pao;pao = pao->m_pao_cons_next)
+			if ((pao->get_hash() == qw_hash)&&(pao->structural_equal(pao_new))) {
+				//THE TWIN ALREADY HOLDS A REFERENCE ON EVERY OPERAND, DELETING pao_new FREES NOTHING ELSE
+				pao->hand_out();
+				delete pao_new;
+				return pao;
+			}
+	}
+	if (s_st_cons_count >= s_st_cons_table_size) {
+		//DOUBLE THE BUCKETS AND RELINK EVERY OPERATOR
+		size_t st_size = (s_st_cons_table_size)?2*s_st_cons_table_size:CONS_TABLE_INITIAL_SIZE;
+		algebraic_operator** ppao_table = (algebraic_operator**)calloc(st_size,sizeof(algebraic_operator*));
+		if (!ppao_table)
+			return pao_new;
+		for(size_t i = 0;i < s_st_cons_table_size;i++) {
+			for(algebraic_operator* pao = s_ppao_cons_table[i];pao;) {
+				algebraic_operator* pao_next = pao->m_pao_cons_next;
+				size_t st_bucket = pao->get_hash()&(st_size-1);
+				pao->m_pao_cons_next = ppao_table[st_bucket];
+				ppao_table[st_bucket] = pao;
+				pao = pao_next;
+			}
+		}
+		if (s_ppao_cons_table)
+			free(s_ppao_cons_table);
+		s_ppao_cons_table = ppao_table;
+		s_st_cons_table_size = st_size;
 	}
-	this->m_ppv_variables = NULL;
+	algebraic_operator** ppao_bucket = s_ppao_cons_table+(qw_hash&(s_st_cons_table_size-1));
+	pao_new->m_pao_cons_next = *ppao_bucket;
+	pao_new->m_b_interned = true;
+	pao_new->addref();
+	pao_new->hand_out();
+	*ppao_bucket = pao_new;
+	s_st_cons_count++;
+	return pao_new;
+}
+
+calculus::algebraic_operator::HAND_OUT_RING::~HAND_OUT_RING() {
+	//A THREAD THAT EXITS HOLDS NOTHING
+	if (!b_registered)
+		return;
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	PHAND_OUT_RING* pphor_link = &s_phor_rings;
+	while(*pphor_link != this)
+		pphor_link = &((*pphor_link)->phor_next);
+	*pphor_link = phor_next;
+}
+
+void calculus::algebraic_operator::hand_out() {
+	PHAND_OUT_RING phor = &s_hor_ring;
+	if (!phor->b_registered) {
+		phor->phor_next = s_phor_rings;
+		s_phor_rings = phor;
+		phor->b_registered = true;
+	}
+	phor->ppao_operators[(phor->ui_next++)%CONS_HAND_OUT_RING] = this;
+}
+
+calculus::algebraic_operator* calculus::algebraic_operator::hand_back() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	if (m_b_interned)
+		hand_out();
+	this->m_ul_refcount.fetch_sub(1,std::memory_order_acq_rel);
+	return this;
+}
+
+void calculus::algebraic_operator::queue_swept() {
+	//UNDER build_lock(), ONLY THE SWEEPING THREAD QUEUES
+	if (s_st_swept_count == s_st_swept_capacity) {
+		size_t st_capacity = (s_st_swept_capacity)?2*s_st_swept_capacity:CONS_TABLE_INITIAL_SIZE;
+		algebraic_operator** ppao_swept = (algebraic_operator**)realloc(s_ppao_swept,st_capacity*sizeof(algebraic_operator*));
+		if (!ppao_swept)
+			return;		//THE NEXT SWEEP FINDS IT
+		s_ppao_swept = ppao_swept;
+		s_st_swept_capacity = st_capacity;
+	}
+	s_ppao_swept[s_st_swept_count++] = this;
+}
+
+size_t calculus::algebraic_operator::sweep_cons_table() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	//A COUNT OF 1 IS THE TABLE'S OWN REFERENCE.  THE OPERATORS IN THE RINGS MAY STILL BE HELD UNREFERENCED BY
+	//THREADS THAT ARE BUILDING, THEY ARE PINNED WHILE WE SWEEP.  THEY ARE ALL INTERNED, SO UNPINNING FREES NOTHING
+	for(PHAND_OUT_RING phor = s_phor_rings;phor;phor = phor->phor_next)
+		for(int i = 0;i < (int)CONS_HAND_OUT_RING;i++)
+			if (phor->ppao_operators[i])
+				phor->ppao_operators[i]->m_ul_refcount.fetch_add(1,std::memory_order_relaxed);
+	//ONE PASS QUEUES WHAT ONLY THE TABLE REFERENCES.  FREEING AN OPERATOR QUEUES THE OPERANDS IT LEAVES WITH THE
+	//TABLE'S REFERENCE, SO A RELEASED CHAIN IS FREED IN ONE WALK OF THE QUEUE, NOT ONE PASS PER LEVEL
+	s_st_swept_count = 0;
+	for(size_t i = 0;i < s_st_cons_table_size;i++)
+		for(algebraic_operator* pao = s_ppao_cons_table[i];pao;pao = pao->m_pao_cons_next)
+			if (pao->m_ul_refcount.load(std::memory_order_acquire) == 1)
+				pao->queue_swept();
+	size_t st_freed = 0;
+	s_b_sweeping = true;
+	while(s_st_swept_count) {
+		algebraic_operator* pao = s_ppao_swept[--s_st_swept_count];
+		//ANOTHER THREAD MAY HAVE REFERENCED IT SINCE IT WAS QUEUED
+		if (pao->m_ul_refcount.load(std::memory_order_acquire) != 1)
+			continue;
+		algebraic_operator** ppao_link = s_ppao_cons_table+(pao->get_hash()&(s_st_cons_table_size-1));
+		while(*ppao_link != pao)
+			ppao_link = &((*ppao_link)->m_pao_cons_next);
+		*ppao_link = pao->m_pao_cons_next;
+		pao->m_pao_cons_next = NULL;
+		pao->m_b_interned = false;
+		s_st_cons_count--;
+		pao->release();
+		st_freed++;
+	}
+	s_b_sweeping = false;
+	for(PHAND_OUT_RING phor = s_phor_rings;phor;phor = phor->phor_next)
+		for(int i = 0;i < (int)CONS_HAND_OUT_RING;i++)
+			if (phor->ppao_operators[i])
+				phor->ppao_operators[i]->m_ul_refcount.fetch_sub(1,std::memory_order_relaxed);
+	return st_freed;
+}
+
+size_t calculus::algebraic_operator::collect_cons_table() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	//THE DERIVATIVE LINKS MAY CLOSE CYCLES (SIN -> COS -> -SIN), DROP THEM BEFORE LOOKING AT THE COUNTS.  A
+	//DERIVATIVE OUTSIDE THE TABLE THAT ONLY ITS CACHE REFERENCES MAY BE HELD UNREFERENCED, IT STAYS CACHED
+	for(size_t i = 0;i < s_st_cons_table_size;i++)
+		for(algebraic_operator* pao = s_ppao_cons_table[i];pao;pao = pao->m_pao_cons_next) {
+			if (pao->m_ppao_partial_derivatives == NULL)
+				continue;
+			for(int j = pao->get_number_of_variables();j;) {
+				algebraic_operator* pD = pao->m_ppao_partial_derivatives[--j];
+				if ((pD)&&((pD->m_b_interned)||(pD->m_ul_refcount.load(std::memory_order_acquire) > 1))) {
+					pao->m_ppao_partial_derivatives[j] = NULL;
+					pD->release();
+				}
+			}
+		}
+	return sweep_cons_table();
+}
+
+void calculus::algebraic_operator::FreeConsTable() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	for(size_t i = 0;i < s_st_cons_table_size;i++)
+		for(algebraic_operator* pao = s_ppao_cons_table[i];pao;pao = pao->m_pao_cons_next)
+			pao->release_partial_derivatives();
+	for(PHAND_OUT_RING phor = s_phor_rings;phor;phor = phor->phor_next)
+		for(int i = 0;i < (int)CONS_HAND_OUT_RING;i++)
+			phor->ppao_operators[i] = NULL;
+	//DETACH EVERY OPERATOR, THEN DROP THE TABLE'S REFERENCES, THE OPERATORS STILL IN USE SURVIVE UNSHARED
+	algebraic_operator* pao_detached = NULL;
+	for(size_t i = 0;i < s_st_cons_table_size;i++) {
+		for(algebraic_operator* pao = s_ppao_cons_table[i];pao;) {
+			algebraic_operator* pao_next = pao->m_pao_cons_next;
+			pao->m_pao_cons_next = pao_detached;
+			pao->m_b_interned = false;
+			pao_detached = pao;
+			pao = pao_next;
+		}
+	}
+	if (s_ppao_cons_table)
+		free(s_ppao_cons_table);
+	s_ppao_cons_table = NULL;
+	s_st_cons_table_size = 0;
+	s_st_cons_count = 0;
+	if (s_ppao_swept)
+		free(s_ppao_swept);
+	s_ppao_swept = NULL;
+	s_st_swept_count = s_st_swept_capacity = 0;
+	while(pao_detached) {
+		algebraic_operator* pao_next = pao_detached->m_pao_cons_next;
+		pao_detached->m_pao_cons_next = NULL;
+		pao_detached->release();
+		pao_detached = pao_next;
+	}
+}
+
+void calculus::algebraic_operator::release_partial_derivatives() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	if (m_ppao_partial_derivatives == NULL)
+		return;
+	unsigned int num_vars = get_number_of_variables();
+	for(;num_vars;) {
+		num_vars--;
+		algebraic_operator* pD = m_ppao_partial_derivatives[num_vars];
+		if (pD)
+			pD->release();
+	}
+	calculus::node_pool::release_array(m_ppao_partial_derivatives);
+	this->m_ppao_partial_derivatives = NULL;
 }
 
 double calculus::algebraic_operator::eval(double* pVars) {
@@ -141,39 +424,113 @@ double calculus::algebraic_operator::eval(double* pVars) {
 	return 0;
 }
 
+void calculus::algebraic_operator::eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	//THE DEFAULT GATHERS EVERY POINT AND CALLS eval(), OVERRIDE THIS TO EVALUATE COLUMN-WISE
+	int i_num_vars = get_number_of_variables();
+	double* pd_point = (i_num_vars)?new double[i_num_vars]:NULL;
+	for(size_t k = 0;k < st_n;k++) {
+		for(int i = 0;i < i_num_vars;i++)
+			pd_point[i] = ppd_columns[i][k];
+		pd_out[k] = eval(pd_point);
+	}
+	if (pd_point)
+		delete [] pd_point;
+}
+
+void calculus::algebraic_operator::to_tape(calculus::tape* pTape) {
+	//THE DEFAULT CALLS BACK INTO eval(), OVERRIDE THIS TO EMIT OPCODES
+	pTape->write_call(this,get_number_of_variables(),get_variables());
+}
+
+calculus::tape* calculus::algebraic_operator::get_tape() {
+	tape* pt = m_pt_tape.load(std::memory_order_acquire);
+	if (pt == NULL) {
+		//THE TAPE IS ONLY PUBLISHED ONCE FINALIZED, A THREAD THAT LOST THE RACE TAKES THE WINNER'S
+		std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+		pt = m_pt_tape.load(std::memory_order_relaxed);
+		if (pt == NULL) {
+			pt = new calculus::tape(get_number_of_variables(),get_variables());
+			to_tape(pt);
+			pt->finalize();
+			m_pt_tape.store(pt,std::memory_order_release);
+		}
+	}
+	return pt;
+}
+
+double calculus::algebraic_operator::eval_tape(double* pVars) {
+	return get_tape()->eval(pVars);
+}
+
+double calculus::algebraic_operator::eval_gradient(double* pVars,double* pd_gradient) {
+	return get_tape()->gradient(pVars,pd_gradient);
+}
+
+double calculus::algebraic_operator::eval_dual(double* pVars,const double* pd_direction,double* pd_tangent) {
+	return get_tape()->eval_dual(pVars,pd_direction,pd_tangent);
+}
+
+double calculus::algebraic_operator::eval_hessian_vector(double* pVars,const double* pd_direction,double* pd_gradient,double* pd_hv) {
+	return get_tape()->hessian_vector(pVars,pd_direction,pd_gradient,pd_hv);
+}
+
 FUNCTION calculus::algebraic_operator::compile() {
-	if (m_pia32_binary == NULL)
-		m_pia32_binary = to_IA32_binary();
-	return (FUNCTION)(m_pia32_binary->m_pus_binary);
+	IA32_binary* pia32 = m_pia32_binary.load(std::memory_order_acquire);
+	if (pia32 == NULL) {
+		std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+		pia32 = m_pia32_binary.load(std::memory_order_relaxed);
+		if (pia32 == NULL) {
+#ifdef COMPILER_TARGET_X64
+			pia32 = to_X64_binary();
+#else
+			pia32 = to_IA32_binary();
+#endif
+			m_pia32_binary.store(pia32,std::memory_order_release);
+		}
+	}
+	return (pia32)?(FUNCTION)(pia32->m_pus_binary):NULL;
 };
 
+void calculus::algebraic_operator::write_string(string_writer* psw) {
+	psw->write("#ERROR");
+}
+
 int calculus::algebraic_operator::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 6;
-	return sprintf(pBuffer,"#ERROR");
+	string_writer sw;
+	this->write_string(&sw);
+	if (pBuffer)
+		memcpy(pBuffer,sw.get_string(),sw.get_length()+1);
+	return (int)sw.get_length();
 }
 
 calculus::algebraic_operator* calculus::algebraic_operator::get_partial_derivative(calculus::variable * pVar) {
 	//IF IT'S NOT A FUNCTION OF THAT VARIABLE THEN THERE IS NO POINT IN GOING FORWARD
 	if (!is_function_of(pVar))
 		return calculus::_cst(0);
+	//THE DERIVATIVE OF EVERY OPERAND IS BUILT AND CACHED UNDER THE SAME LOCK
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
 	variable ** ppv_vars = get_variables();
 	int num_vars = this->get_number_of_variables();
 	//LOCATE THE ENTRY IN THE VARS ARRAY TO RELATE TO THE DERIVATIVE ARRAY
     int i;
     for(i = 0;i < num_vars;i++)
-		if (ppv_vars[i] == pVar)
+		if (ppv_vars[i]->get_id() == pVar->get_id())
             break;
 	//IF DERIVATIVE ARRAY IS NULL
 	if (m_ppao_partial_derivatives == NULL) {
 		//ALLOCATE A NEW ARRAY
-		m_ppao_partial_derivatives = new algebraic_operator*[num_vars];
+		m_ppao_partial_derivatives = calculus::node_pool::allocate_array<algebraic_operator*>(num_vars);
 		//ZERO MEMORY OF NEW ARRAY
         for(int i = 0;i < num_vars;i++)
             m_ppao_partial_derivatives[i] = NULL;
 	}
-    if (m_ppao_partial_derivatives[i] == NULL)
-        (m_ppao_partial_derivatives[i] = partial_derivative(pVar))->addref();
+    if (m_ppao_partial_derivatives[i] == NULL) {
+        m_ppao_partial_derivatives[i] = partial_derivative(pVar);
+		m_ppao_partial_derivatives[i]->addref();
+	}
+	//THE CALLER MAY HOLD IT UNREFERENCED AND collect_cons_table() MAY DROP THE CACHED ONE
+	if (m_ppao_partial_derivatives[i]->m_b_interned)
+		m_ppao_partial_derivatives[i]->hand_out();
 	return m_ppao_partial_derivatives[i];
 }
 
@@ -181,22 +538,26 @@ void calculus::algebraic_operator::set_partial_derivative(calculus::variable * p
 	//IF IT'S NOT A FUNCTION OF THAT VARIABLE THEN THERE IS NO POINT IN GOING FORWARD
 	if (!is_function_of(pVar))
 		return;
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
 	//LOCATE THE ENTRY IN THE VARS ARRAY TO RELATE TO THE DERIVATIVE ARRAY
 	variable ** ppv_vars = get_variables();
 	int num_vars = get_number_of_variables();
     int i;
 	for(i = 0;i < num_vars;i++)
-		if (ppv_vars[i] == pVar)
+		if (ppv_vars[i]->get_id() == pVar->get_id())
 			break;
 	//IF DERIVATIVE ARRAY IS NULL
 	if (m_ppao_partial_derivatives == NULL) {
 		//ALLOCATE A NEW ARRAY
-		m_ppao_partial_derivatives = new algebraic_operator*[num_vars];
+		m_ppao_partial_derivatives = calculus::node_pool::allocate_array<algebraic_operator*>(num_vars);
 		//ZERO MEMORY OF NEW ARRAY
 		for(int i = 0;i < num_vars;i++)
 			m_ppao_partial_derivatives[i] = NULL;
 	}
-	(m_ppao_partial_derivatives[i] = ppartial_derivative)->addref();
+	ppartial_derivative->addref();
+	if (m_ppao_partial_derivatives[i] != NULL)
+		m_ppao_partial_derivatives[i]->release();
+	m_ppao_partial_derivatives[i] = ppartial_derivative;
 }
 
 calculus::algebraic_operator* calculus::algebraic_operator::create_copy() {
@@ -228,8 +589,9 @@ void calculus::algebraic_operator::to_IA32_binary(PCT_INFO pInfo)
 
 calculus::IA32_binary* calculus::algebraic_operator::to_IA32_binary()
 {
-	char * sc_name_buffer = new char[this->to_string(NULL)];
-	this->to_string(sc_name_buffer);
+	string_writer sw_name;
+	this->write_string(&sw_name);
+	const char * sc_name_buffer = sw_name.get_string();
 
 	PT_INFO parse_info;
 	parse_info.st_size = sizeof(parse_info);
@@ -243,6 +605,8 @@ calculus::IA32_binary* calculus::algebraic_operator::to_IA32_binary()
 	parse_info.i_clock_count = 0;
 	parse_info.i_operator_count = 0;
 	parse_info.i_fpu_stack_offset = 0;
+	parse_info.i_vector_isa = VECTOR_ISA_NONE;
+	parse_info.p_shared = NULL;
 	
 	annotate(&parse_info);
 
@@ -300,6 +664,8 @@ calculus::IA32_binary* calculus::algebraic_operator::to_IA32_binary()
 	pHead->pv_auxiliary_storage		= (unsigned char*)(pHead->ppv_auxiliary_storage_toc + AUX_FEATURE_TABLE_SIZE);
 	*((void**)(pHead->pv_auxiliary_storage + AUX_FEATURE_SIZE)) = pHead;
 	pHead->pInstructions			= (FUNCTION)(pHead->pv_auxiliary_storage + AUX_FEATURE_SIZE + sizeof(void*));
+	pHead->pv_code_storage			= NULL;
+	pHead->st_code_size				= 0;
 
 	CT_INFO info;	PCT_INFO pInfo = &info;
 	pInfo->pHeader				= pHead;
@@ -310,6 +676,8 @@ calculus::IA32_binary* calculus::algebraic_operator::to_IA32_binary()
 	pInfo->pv_aux_storage_pos			= pHead->pv_auxiliary_storage;
 	pInfo->ppv_vars				= this->m_ppv_variables;
 	pInfo->i_stack_offset		= 0;
+	pInfo->i_vector_isa			= VECTOR_ISA_NONE;
+	pInfo->p_shared				= NULL;
 	//BEGIN OUTPUT TO OPCODE STREAM
 #ifdef INSERT_BREAK
 	CompilerWriteBREAK(pInfo);
@@ -360,16 +728,743 @@ calculus::IA32_binary* calculus::algebraic_operator::to_IA32_binary()
 	_ASSERT(pEND == (byte_type*)pHead + pHead->st_mem_size);
 	_ASSERT(pInfo->pv_instruction_storage_pos == pEND);							//THE ALLOCATED SIZE DIDN'T MATCH THE USED SIZE
 
-    delete [] sc_name_buffer;
 
-	return (new IA32_binary((unsigned short*)(pHead->pInstructions)));
+	return (new IA32_binary(pHead));
 };
 
+void calculus::algebraic_operator::to_X64_binary(PCT_INFO pInfo)
+//THE DEFAULT ENCODING CALLS BACK INTO eval(), OVERRIDE THIS VIRTUAL MEMBER FUNCTION TO SUPPLY A NATIVE ONE
+/*
+	GATHER THE VARIABLES OF THIS OPERATOR INTO double[n] AT [rbp-d]
+MOV		rdi,this
+LEA		rsi,[rbp-d]
+MOV		rax,algebraic_operator::eval_callback
+CALL	rax
+*/
+{
+	int i_num_vars = this->get_number_of_variables();
+	int iBase = CompilerWriteX64GatherVariables(pInfo,i_num_vars,this->get_variables());
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EDI);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)this);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,iBase);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)calculus::algebraic_operator::eval_callback);
+	CompilerPopX64Temporary(pInfo,i_num_vars);
+}
+
+void calculus::algebraic_operator::annotate_X64(PPT_INFO pParseInfo)
+{
+	int i_num_vars = this->get_number_of_variables();
+	CompilerReserveX64Temporary(pParseInfo,i_num_vars);
+	CompilerReleaseX64Temporary(pParseInfo,i_num_vars);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfX64GatherVariables(i_num_vars)
+											+	CompilerSizeOfMOV_RXX_IMM64()
+											+	CompilerSizeOfIMM64()
+											+	CompilerSizeOfLEA_RXX_RBPX_IMM32()
+											+	CompilerSizeOfINT32()
+											+	CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2*i_num_vars + 4;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size				+=	2;
+}
+
+void calculus::algebraic_operator::to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x)
+//ONLY LEAF OPERATORS CAN BE ENCODED AS A MEMORY OPERAND
+{
+	UNREFERENCED_PARAMETER(pInfo);
+	UNREFERENCED_PARAMETER(code);
+	UNREFERENCED_PARAMETER(x);
+	_ASSERT(0);
+}
+
+void calculus::algebraic_operator::annotate_X64_operand(PPT_INFO pParseInfo)
+{
+	UNREFERENCED_PARAMETER(pParseInfo);
+	_ASSERT(0);
+}
+
+static PCOMPILER_SHARED_ENTRY FindSharedEntry(PCOMPILER_SHARED_TABLE pTable,calculus::algebraic_operator * pao_operator,bool b_insert)
+{
+	if (b_insert && (2*(pTable->i_count+1) > pTable->i_capacity)) {
+		//KEEP THE TABLE AT MOST HALF FULL
+		PCOMPILER_SHARED_ENTRY p_old = pTable->p_entries;
+		int i_old = pTable->i_capacity;
+		pTable->i_capacity = (i_old)?2*i_old:0x40;
+		pTable->p_entries = (PCOMPILER_SHARED_ENTRY)calloc(pTable->i_capacity,sizeof(COMPILER_SHARED_ENTRY));
+		pTable->i_count = 0;
+		for(int i = 0;i < i_old;i++)
+			if (p_old[i].pao_operator)
+				*FindSharedEntry(pTable,p_old[i].pao_operator,true) = p_old[i];
+		if (p_old)
+			free(p_old);
+	}
+	if (!pTable->i_capacity)
+		return NULL;
+	int i_mask = pTable->i_capacity-1;
+	for(int i = (int)((((size_t)pao_operator)>>4)*2654435761u) & i_mask;;i = (i+1) & i_mask) {
+		if (pTable->p_entries[i].pao_operator == pao_operator)
+			return pTable->p_entries+i;
+		if (pTable->p_entries[i].pao_operator == NULL) {
+			if (!b_insert)
+				return NULL;
+			pTable->p_entries[i].pao_operator = pao_operator;
+			pTable->i_count++;
+			return pTable->p_entries+i;
+		}
+	}
+}
+
+/*
+THIS IS THE OPCODE BLUEPRINT FOR A SHARED OPERAND
+
+	OPERAND OPCODE					FIRST USE
+MOVSD	qword PTR[rbp-s],xmm0
+	OR
+MOVSD	xmm0,qword PTR[rbp-s]		LATER USES
+*/
+
+void calculus::algebraic_operator::to_X64_shared(PCT_INFO pInfo)
+{
+	PCOMPILER_SHARED_ENTRY pEntry = (pInfo->p_shared)?FindSharedEntry(pInfo->p_shared,this,false):NULL;
+	if ((pEntry == NULL) || (pEntry->i_slot == 0)) {
+		this->to_X64_binary(pInfo);
+		return;
+	}
+	if (pEntry->b_done) {
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),pEntry->i_slot);
+		return;
+	}
+	this->to_X64_binary(pInfo);
+	CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),pEntry->i_slot);
+	pEntry->b_done = true;
+}
+
+void calculus::algebraic_operator::annotate_X64_shared(PPT_INFO pParseInfo)
+{
+	//VARIABLES AND CONSTANTS ARE AS CHEAP TO RELOAD AS A SLOT
+	if ((pParseInfo->p_shared == NULL) || (typeid(*this) == typeid(calculus::variable)) || (typeid(*this) == typeid(calculus::constant))) {
+		this->annotate_X64(pParseInfo);
+		return;
+	}
+	PCOMPILER_SHARED_TABLE pTable = pParseInfo->p_shared;
+	if (pTable->b_counting) {
+		//ONLY THE FIRST USE IS WALKED, THE OPERANDS OF A SHARED OPERATOR ARE REACHED ONCE
+		if (++(FindSharedEntry(pTable,this,true)->i_uses) == 1)
+			this->annotate_X64(pParseInfo);
+		return;
+	}
+	PCOMPILER_SHARED_ENTRY pEntry = FindSharedEntry(pTable,this,false);
+	if ((pEntry == NULL) || (pEntry->i_slot == 0)) {
+		this->annotate_X64(pParseInfo);
+		return;
+	}
+	if (!pEntry->b_done) {
+		this->annotate_X64(pParseInfo);
+		pEntry->b_done = true;
+	}
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_FRAME();
+	pParseInfo->i_instruction_count++;
+}
+
+double calculus::algebraic_operator::eval_callback(calculus::algebraic_operator * pao_operator,double* pVars)
+{
+	return pao_operator->eval(pVars);
+}
+
+void calculus::IA32_binary::free_compiler_header(PCOMPILER_HEADER pHead)
+{
+	if (pHead->pv_code_storage)
+		calculus::code_arena::release(pHead->pv_code_storage,pHead->st_code_size);
+	free(pHead);
+}
+
+/*
+THIS IS THE OPCODE BLUEPRINT FOR THE SYSTEM V AMD64 FUNCTION FRAME
+
+PUSH	rbp
+MOV		rbp,rsp
+SUB		rsp,(8*n + temporaries) rounded to 16
+MOV		rax,&i_call_count
+INC		dword PTR[rax]
+MOVSD	qword PTR[rbp-8*(i+1)],xmm(i)			i < 8
+MOVSD	xmm0,qword PTR[rbp+16+8*(i-8)]			i >= 8, PASSED ON THE STACK
+MOVSD	qword PTR[rbp-8*(i+1)],xmm0
+	OPERATOR OPCODE, RESULT IN XMM0
+MOV		rsp,rbp
+POP		rbp
+RET
+*/
+
+calculus::IA32_binary* calculus::algebraic_operator::to_X64_binary()
+{
+#ifdef COMPILER_TARGET_X64
+	string_writer sw_name;
+	this->write_string(&sw_name);
+	const char * sc_name_buffer = sw_name.get_string();
+	int i_num_vars = this->get_number_of_variables();
+	int i_num_register_vars = (i_num_vars < 8)?i_num_vars:8;
+
+	PT_INFO parse_info;
+	parse_info.st_size = sizeof(parse_info);
+	parse_info.i_aux_features_needed = FEAT_AUX_NEED_NONE;
+	parse_info.i_features_needed = FEAT_NEED_NONE;
+	parse_info.st_global_storage_size = 0;
+	parse_info.i_instruction_count = 0;
+	parse_info.st_instruction_storage_size = 0;
+	parse_info.st_local_storage_size = 0;
+	parse_info.st_pmap_size = 1;	//MOV rax,&i_call_count
+	parse_info.i_clock_count = 0;
+	parse_info.i_operator_count = 0;
+	parse_info.i_fpu_stack_offset = 0;
+	parse_info.i_stack_offset = 0;
+	parse_info.i_max_stack_offset = 0;
+	parse_info.i_vector_isa = VECTOR_ISA_NONE;
+	parse_info.p_shared = NULL;
+
+	//COUNT THE USES OF EVERY OPERATOR, THE ONES REACHED MORE THAN ONCE GET A SLOT BELOW THE VARIABLES
+	COMPILER_SHARED_TABLE shared_table;
+	memset(&shared_table,0,sizeof(shared_table));
+	shared_table.b_counting = true;
+	PT_INFO count_info = parse_info;
+	count_info.p_shared = &shared_table;
+	annotate_X64(&count_info);
+	int i_num_slots = AssignSharedSlots(&shared_table,i_num_vars*sizeof(double));
+	parse_info.p_shared = &shared_table;
+	parse_info.i_stack_offset = parse_info.i_max_stack_offset = i_num_slots*sizeof(double);
+
+	annotate_X64(&parse_info);
+	ResetSharedTable(&shared_table);
+
+	size_t InstructionLengthCheck = parse_info.st_instruction_storage_size;
+	int i_frame_size = (int)((i_num_vars*sizeof(double) + parse_info.i_max_stack_offset + 15) & ~15);
+	parse_info.i_instruction_count += 8 + i_num_vars + (i_num_vars - i_num_register_vars);
+	parse_info.st_instruction_storage_size	+=	CompilerSizeOfPUSH_RBP()
+											+	CompilerSizeOfMOV_RBP_RSP()
+											+	CompilerSizeOfSUB_RSP_IMM32()
+											+	CompilerSizeOfINT32()
+											+	CompilerSizeOfMOV_RXX_IMM64()
+											+	CompilerSizeOfIMM64()
+											+	CompilerSizeOfINC_dword_typePTREXX()
+											+	(2*i_num_vars - i_num_register_vars)*CompilerSizeOfSSE2_SD_XMM_FRAME()
+											+	CompilerSizeOfMOV_RSP_RBP()
+											+	CompilerSizeOfPOP_RBP()
+											+	CompilerSizeOfRET();
+	//CONSTANTS FOLLOW THE INSTRUCTIONS SO THEY CAN BE ADDRESSED RIP-RELATIVE
+	size_t st_instructions = (parse_info.st_instruction_storage_size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+	size_t st_code_size = st_instructions + parse_info.st_local_storage_size;
+	size_t st_mem_required = sizeof(COMPILER_HEADER)
+						+ (strlen(sc_name_buffer)+1)*sizeof(char)
+						+ parse_info.st_pmap_size*sizeof(unsigned char*);
+
+	unsigned char * pv_code = calculus::code_arena::allocate(st_code_size);
+	if (pv_code == NULL) {
+		if (shared_table.p_entries)
+			free(shared_table.p_entries);
+		return NULL;
+	}
+	PCOMPILER_HEADER pHead = (PCOMPILER_HEADER)malloc(st_mem_required);
+
+	pHead->st_size					= sizeof(COMPILER_HEADER);
+	pHead->pSelf					= pHead;
+	pHead->i_f_flags				= COMPILER_FLAG_NOFLAGS;
+	pHead->i_call_count				= this->m_ui_call_count;
+	pHead->i_clock_count			= parse_info.i_clock_count;
+	pHead->i_operator_count			= parse_info.i_operator_count;
+	pHead->i_instruction_count		= parse_info.i_instruction_count;
+	pHead->i_num_vars				= i_num_vars;
+	pHead->st_mem_size				= st_mem_required;
+	pHead->psc_name					= ((unsigned char*)pHead)+(sizeof(COMPILER_HEADER)/sizeof(unsigned char));
+	strcpy((char*)pHead->psc_name,sc_name_buffer);
+	pHead->ppv_pmap					= (unsigned char**)(pHead->psc_name + strlen((char*)pHead->psc_name) + 1);
+	pHead->pv_global_storage		= (unsigned char*)(pHead->ppv_pmap + parse_info.st_pmap_size);
+	pHead->pv_code_storage			= pv_code;
+	pHead->st_code_size				= st_code_size;
+	pHead->pInstructions			= (FUNCTION)pv_code;
+	pHead->pv_local_storage			= pv_code + st_instructions;
+	pHead->ppv_auxiliary_storage_toc	= NULL;
+	pHead->pv_auxiliary_storage		= NULL;
+	memset(pv_code,0xCC,st_instructions);	//PAD WITH INT3
+
+	CT_INFO info;	PCT_INFO pInfo = &info;
+	pInfo->pHeader				= pHead;
+	pInfo->pv_instruction_storage_pos = pv_code;
+	pInfo->pv_local_storage_pos		= pHead->pv_local_storage;
+	pInfo->ppv_pmapPos			= pHead->ppv_pmap;
+	pInfo->pv_global_storage_pos		= pHead->pv_global_storage;
+	pInfo->pv_aux_storage_pos			= NULL;
+	pInfo->ppv_vars				= this->get_variables();
+	pInfo->i_stack_offset		= (i_num_vars + i_num_slots)*sizeof(double);
+	pInfo->i_fpu_stack_offset	= 0;
+	pInfo->i_vector_isa			= VECTOR_ISA_NONE;
+	pInfo->p_shared				= &shared_table;
+	//BEGIN OUTPUT TO OPCODE STREAM
+	CompilerWritePUSH_RBP(pInfo);
+	CompilerWriteMOV_RBP_RSP(pInfo);
+	CompilerWriteSUB_RSP_IMM32(pInfo);
+		CompilerWriteINT32(pInfo,i_frame_size);
+	//OUTPUT CALL COUNT INCREMENTING PROCEDURE
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EAX);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)&(pHead->i_call_count));
+	CompilerWriteINC_dword_typePTREXX(pInfo,REG_EAX);
+	//SPILL THE ARGUMENTS, THE FIRST EIGHT ARRIVE IN XMM0-XMM7 AND THE REST ON THE STACK
+	for(int i = 0;i < i_num_vars;i++) {
+		if (i >= i_num_register_vars) {
+			CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),(int)(2*sizeof(void*)+(i-i_num_register_vars)*sizeof(double)));
+			CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),COMPILER_X64_V(i));
+		}
+		else
+			CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(i),COMPILER_X64_V(i));
+	}
+	//RECURSE OUTPUT TO OPCODES
+	byte_type * pPreEncodePos = pInfo->pv_instruction_storage_pos;
+
+	to_X64_binary(pInfo);
+
+	//CHECK IF THE REQUESTED SIZE DIDN'T MATCH THE USED SIZE
+	_ASSERT(pPreEncodePos+InstructionLengthCheck == pInfo->pv_instruction_storage_pos);
+	CompilerWriteMOV_RSP_RBP(pInfo);
+	CompilerWritePOP_RBP(pInfo);
+	CompilerWriteRET(pInfo);
+
+	_ASSERT(pInfo->i_stack_offset == (i_num_vars + i_num_slots)*(int)sizeof(double));	//THERE WAS A STACK LEAK
+	_ASSERT((byte_type*)pInfo->ppv_pmapPos == (byte_type*)pHead->pv_global_storage);	//THERE WERE MORE PTR ENTRIES THEN PLANNED
+	_ASSERT(pInfo->pv_local_storage_pos == pv_code + st_code_size);					//TOO MUCH LOCAL INFO WAS WRITTEN
+	_ASSERT(pInfo->pv_instruction_storage_pos == pv_code + parse_info.st_instruction_storage_size);	//THE ALLOCATED SIZE DIDN'T MATCH THE USED SIZE
+
+	//THE COMPILE FAILS WHEN THE CODE CAN'T BE SEALED
+	bool b_sealed = calculus::code_arena::seal(pHead);
+	if (!b_sealed) {
+		calculus::code_arena::release(pHead->pv_code_storage,pHead->st_code_size);
+		free(pHead);
+	}
+
+	if (shared_table.p_entries)
+		free(shared_table.p_entries);
+
+	return (b_sealed)?(new IA32_binary(pHead)):NULL;
+#else
+	return NULL;
+#endif
+};
+
+void calculus::algebraic_operator::to_X64_vector(PCT_INFO pInfo)
+//THE DEFAULT BATCH ENCODING CALLS BACK INTO eval_batch() FOR THE POINTS OF ONE VECTOR
+/*
+	FOR EACH VARIABLE i OF THIS OPERATOR
+MOV		rax,[rbp-16]
+MOV		rax,[rax+8*index(i)]
+ADD		rax,rbx
+MOV		[rbp-c+8*i],rax
+	END
+MOV		rdi,this
+LEA		rsi,[rbp-c]
+MOV		edx,W
+LEA		rcx,[rbp-o]
+VZEROUPPER
+MOV		rax,algebraic_operator::eval_batch_callback
+CALL	rax
+VMOVUPD	v0,[rbp-o]
+*/
+{
+	int i_num_vars = this->get_number_of_variables();
+	calculus::variable ** ppv_vars = this->get_variables();
+	int i_width = CompilerVectorWidth(pInfo->i_vector_isa);
+	int iColumns = CompilerPushX64Temporary(pInfo,i_num_vars);
+	int iOut = CompilerPushX64Temporary(pInfo,i_width);
+	for(int i = 0;i < i_num_vars;i++) {
+		CompilerWriteX64LoadColumn(pInfo,CompilerIndexOfVariable(pInfo,ppv_vars[i]));
+		CompilerWriteADD_RXX_RYX(pInfo,REG_EAX,REG_EBX);
+		CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_EAX);
+			CompilerWriteINT32(pInfo,iColumns+i*(int)sizeof(double*));
+	}
+	CompilerWriteX64ThisArgument(pInfo,this);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,iColumns);
+	CompilerWriteMOV_EXX_IMM32(pInfo,REG_EDX);
+		CompilerWriteINT32(pInfo,i_width);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_ECX);
+		CompilerWriteINT32(pInfo,iOut);
+	CompilerWriteX64VectorCALL_IMM64(pInfo,(void*)calculus::algebraic_operator::eval_batch_callback);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0),REG_XMM(0),iOut);
+	CompilerPopX64Temporary(pInfo,i_width);
+	CompilerPopX64Temporary(pInfo,i_num_vars);
+}
+
+void calculus::algebraic_operator::annotate_X64_vector(PPT_INFO pParseInfo)
+{
+	int i_num_vars = this->get_number_of_variables();
+	int i_width = CompilerVectorWidth(pParseInfo->i_vector_isa);
+	CompilerReserveX64Temporary(pParseInfo,i_num_vars+i_width);
+	CompilerReleaseX64Temporary(pParseInfo,i_num_vars+i_width);
+	pParseInfo->st_instruction_storage_size	+=	i_num_vars*(CompilerSizeOfX64LoadColumn()
+														+	CompilerSizeOfADD_RXX_RYX()
+														+	CompilerSizeOfMOV_RBPX_IMM32_RXX()
+														+	CompilerSizeOfINT32())
+											+	CompilerSizeOfX64ThisArgument()
+											+	2*CompilerSizeOfLEA_RXX_RBPX_IMM32()
+											+	CompilerSizeOfMOV_EXX_IMM32()
+											+	3*CompilerSizeOfINT32()
+											+	CompilerSizeOfX64VectorCALL_IMM64()
+											+	CompilerSizeOfVECTOR_PD_VEC_FRAME(pParseInfo);
+	pParseInfo->i_instruction_count			+=	4*i_num_vars + 8;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size				+=	2;
+}
+
+void calculus::algebraic_operator::to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x)
+//ONLY LEAF OPERATORS CAN BE ENCODED AS A MEMORY OPERAND
+{
+	UNREFERENCED_PARAMETER(pInfo);
+	UNREFERENCED_PARAMETER(code);
+	UNREFERENCED_PARAMETER(x);
+	_ASSERT(0);
+}
+
+void calculus::algebraic_operator::annotate_X64_vector_operand(PPT_INFO pParseInfo)
+{
+	UNREFERENCED_PARAMETER(pParseInfo);
+	_ASSERT(0);
+}
+
+void calculus::algebraic_operator::eval_batch_callback(calculus::algebraic_operator * pao_operator,const double* const* ppd_columns,size_t st_n,double* pd_out)
+{
+	pao_operator->eval_batch(ppd_columns,st_n,pd_out);
+}
+
+calculus::IA32_binary* calculus::algebraic_operator::to_X64_vector_binary()
+//EMITS A BATCH_FUNCTION, IT RETURNS THE NUMBER OF POINTS IT EVALUATED (A MULTIPLE OF THE VECTOR WIDTH)
+/*
+PUSH	rbp
+MOV		rbp,rsp
+PUSH	rbx
+SUB		rsp,frame
+MOV		rax,&i_call_count
+INC		dword ptr [rax]
+MOV		[rbp-16],rdi
+MOV		[rbp-24],rsi
+MOV		[rbp-32],rdx
+XOR		ebx,ebx
+loop:
+MOV		rax,[rbp-24]
+CMP		rax,W
+JB		done
+	BODY, THE RESULT IS LEFT IN v0
+MOV		rax,[rbp-32]
+VMOVUPD	[rax+rbx],v0
+ADD		rbx,8*W
+MOV		rax,[rbp-24]
+SUB		rax,W
+MOV		[rbp-24],rax
+JMP		loop
+done:
+MOV		rax,rbx
+SHR		rax,3
+VZEROUPPER
+MOV		rbx,[rbp-8]
+MOV		rsp,rbp
+POP		rbp
+RET
+*/
+{
+#ifdef COMPILER_TARGET_X64
+	if (s_i_vector_isa == VECTOR_ISA_NONE)
+		return NULL;
+	string_writer sw_name;
+	this->write_string(&sw_name);
+	const char * sc_name_buffer = sw_name.get_string();
+	int i_num_vars = this->get_number_of_variables();
+	int i_width = CompilerVectorWidth(s_i_vector_isa);
+
+	PT_INFO parse_info;
+	parse_info.st_size = sizeof(parse_info);
+	parse_info.i_aux_features_needed = FEAT_AUX_NEED_NONE;
+	parse_info.i_features_needed = FEAT_NEED_NONE;
+	parse_info.st_global_storage_size = 0;
+	parse_info.i_instruction_count = 0;
+	parse_info.st_instruction_storage_size = 0;
+	parse_info.st_local_storage_size = 0;
+	parse_info.st_pmap_size = 1;	//MOV rax,&i_call_count
+	parse_info.i_clock_count = 0;
+	parse_info.i_operator_count = 0;
+	parse_info.i_fpu_stack_offset = 0;
+	parse_info.i_stack_offset = COMPILER_X64_BATCH_FRAME;
+	parse_info.i_max_stack_offset = COMPILER_X64_BATCH_FRAME;
+	parse_info.i_vector_isa = s_i_vector_isa;
+	parse_info.p_shared = NULL;
+
+	annotate_X64_vector(&parse_info);
+
+	size_t InstructionLengthCheck = parse_info.st_instruction_storage_size;
+	//RSP IS KEPT 16 BYTE ALIGNED ONCE RBX IS PUSHED
+	int i_frame_size = (int)((parse_info.i_max_stack_offset + 15) & ~15) - (int)sizeof(void*);
+	parse_info.i_instruction_count += 27;
+	parse_info.st_instruction_storage_size	+=	CompilerSizeOfPUSH_RBP()
+											+	CompilerSizeOfMOV_RBP_RSP()
+											+	CompilerSizeOfPUSH_RBX()
+											+	CompilerSizeOfSUB_RSP_IMM32()
+											+	CompilerSizeOfMOV_RXX_IMM64()
+											+	CompilerSizeOfIMM64()
+											+	CompilerSizeOfINC_dword_typePTREXX()
+											+	3*CompilerSizeOfMOV_RBPX_IMM32_RXX()
+											+	CompilerSizeOfXOR_EXX_EXX()
+											+	3*CompilerSizeOfMOV_RXX_RBPX_IMM32()
+											+	CompilerSizeOfCMP_RXX_IMM32()
+											+	CompilerSizeOfJB_IMM32()
+											+	CompilerSizeOfVECTOR_PD_VEC_RAX_RBX(&parse_info)
+											+	CompilerSizeOfADD_RXX_IMM32()
+											+	CompilerSizeOfSUB_RXX_IMM32()
+											+	CompilerSizeOfMOV_RBPX_IMM32_RXX()
+											+	CompilerSizeOfJMP_IMM32()
+											+	CompilerSizeOfMOV_RXX_RYX()
+											+	CompilerSizeOfSHR_RXX_IMM8()
+											+	CompilerSizeOfIMM8()
+											+	CompilerSizeOfVZEROUPPER()
+											+	CompilerSizeOfMOV_RXX_RBPX_IMM32()
+											+	CompilerSizeOfMOV_RSP_RBP()
+											+	CompilerSizeOfPOP_RBP()
+											+	CompilerSizeOfRET()
+											+	14*CompilerSizeOfINT32();
+	//CONSTANTS FOLLOW THE INSTRUCTIONS SO THEY CAN BE ADDRESSED RIP-RELATIVE
+	size_t st_instructions = (parse_info.st_instruction_storage_size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+	size_t st_code_size = st_instructions + parse_info.st_local_storage_size;
+	size_t st_mem_required = sizeof(COMPILER_HEADER)
+						+ (strlen(sc_name_buffer)+1)*sizeof(char)
+						+ parse_info.st_pmap_size*sizeof(unsigned char*);
+
+	unsigned char * pv_code = calculus::code_arena::allocate(st_code_size);
+	if (pv_code == NULL) {
+		return NULL;
+	}
+	PCOMPILER_HEADER pHead = (PCOMPILER_HEADER)malloc(st_mem_required);
+
+	pHead->st_size					= sizeof(COMPILER_HEADER);
+	pHead->pSelf					= pHead;
+	pHead->i_f_flags				= COMPILER_FLAG_NOFLAGS;
+	pHead->i_call_count				= 0;
+	pHead->i_clock_count			= parse_info.i_clock_count;
+	pHead->i_operator_count			= parse_info.i_operator_count;
+	pHead->i_instruction_count		= parse_info.i_instruction_count;
+	pHead->i_num_vars				= i_num_vars;
+	pHead->st_mem_size				= st_mem_required;
+	pHead->psc_name					= ((unsigned char*)pHead)+(sizeof(COMPILER_HEADER)/sizeof(unsigned char));
+	strcpy((char*)pHead->psc_name,sc_name_buffer);
+	pHead->ppv_pmap					= (unsigned char**)(pHead->psc_name + strlen((char*)pHead->psc_name) + 1);
+	pHead->pv_global_storage		= (unsigned char*)(pHead->ppv_pmap + parse_info.st_pmap_size);
+	pHead->pv_code_storage			= pv_code;
+	pHead->st_code_size				= st_code_size;
+	pHead->pInstructions			= (FUNCTION)pv_code;
+	pHead->pv_local_storage			= pv_code + st_instructions;
+	pHead->ppv_auxiliary_storage_toc	= NULL;
+	pHead->pv_auxiliary_storage		= NULL;
+	memset(pv_code,0xCC,st_instructions);	//PAD WITH INT3
+
+	CT_INFO info;	PCT_INFO pInfo = &info;
+	pInfo->pHeader				= pHead;
+	pInfo->pv_instruction_storage_pos = pv_code;
+	pInfo->pv_local_storage_pos		= pHead->pv_local_storage;
+	pInfo->ppv_pmapPos			= pHead->ppv_pmap;
+	pInfo->pv_global_storage_pos		= pHead->pv_global_storage;
+	pInfo->pv_aux_storage_pos			= NULL;
+	pInfo->ppv_vars				= this->get_variables();
+	pInfo->i_stack_offset		= COMPILER_X64_BATCH_FRAME;
+	pInfo->i_fpu_stack_offset	= 0;
+	pInfo->i_vector_isa			= s_i_vector_isa;
+	pInfo->p_shared				= NULL;
+	//BEGIN OUTPUT TO OPCODE STREAM
+	CompilerWritePUSH_RBP(pInfo);
+	CompilerWriteMOV_RBP_RSP(pInfo);
+	CompilerWritePUSH_RBX(pInfo);
+	CompilerWriteSUB_RSP_IMM32(pInfo);
+		CompilerWriteINT32(pInfo,i_frame_size);
+	//OUTPUT CALL COUNT INCREMENTING PROCEDURE
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EAX);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)&(pHead->i_call_count));
+	CompilerWriteINC_dword_typePTREXX(pInfo,REG_EAX);
+	//SPILL THE ARGUMENTS AND CLEAR THE POINT OFFSET
+	CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_EDI);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COLUMNS);
+	CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COUNT);
+	CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_EDX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_OUTPUT);
+	CompilerWriteXOR_EXX_EXX(pInfo,REG_EBX);
+	//LOOP WHILE A FULL VECTOR OF POINTS REMAINS
+	byte_type * pLoop = pInfo->pv_instruction_storage_pos;
+	CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COUNT);
+	CompilerWriteCMP_RXX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,i_width);
+	CompilerWriteJB_IMM32(pInfo);
+	byte_type * pExitDisplacement = pInfo->pv_instruction_storage_pos;
+		CompilerWriteINT32(pInfo,0);
+	//RECURSE OUTPUT TO OPCODES
+	byte_type * pPreEncodePos = pInfo->pv_instruction_storage_pos;
+
+	to_X64_vector(pInfo);
+
+	//CHECK IF THE REQUESTED SIZE DIDN'T MATCH THE USED SIZE
+	_ASSERT(pPreEncodePos+InstructionLengthCheck == pInfo->pv_instruction_storage_pos);
+	CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_OUTPUT);
+	CompilerWriteVECTOR_PD_VEC_RAX_RBX(pInfo,VECTOR_MOVUPD_STORE,REG_XMM(0),REG_XMM(0));
+	CompilerWriteADD_RXX_IMM32(pInfo,REG_EBX);
+		CompilerWriteINT32(pInfo,i_width*(int)sizeof(double));
+	CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COUNT);
+	CompilerWriteSUB_RXX_IMM32(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,i_width);
+	CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_EAX);
+		CompilerWriteINT32(pInfo,COMPILER_X64_BATCH_COUNT);
+	CompilerWriteJMP_IMM32(pInfo);
+		CompilerWriteINT32(pInfo,(int)(pLoop - (pInfo->pv_instruction_storage_pos + CompilerSizeOfINT32())));
+	//PATCH THE LOOP EXIT
+	*((int*)pExitDisplacement) = (int)(pInfo->pv_instruction_storage_pos - (pExitDisplacement + CompilerSizeOfINT32()));
+	CompilerWriteMOV_RXX_RYX(pInfo,REG_EAX,REG_EBX);
+	CompilerWriteSHR_RXX_IMM8(pInfo,REG_EAX);
+		CompilerWriteIMM8(pInfo,3);
+	CompilerWriteVZEROUPPER(pInfo);
+	CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EBX);
+		CompilerWriteINT32(pInfo,-(int)sizeof(void*));
+	CompilerWriteMOV_RSP_RBP(pInfo);
+	CompilerWritePOP_RBP(pInfo);
+	CompilerWriteRET(pInfo);
+
+	_ASSERT(pInfo->i_stack_offset == COMPILER_X64_BATCH_FRAME);						//THERE WAS A STACK LEAK
+	_ASSERT((byte_type*)pInfo->ppv_pmapPos == (byte_type*)pHead->pv_global_storage);	//THERE WERE MORE PTR ENTRIES THEN PLANNED
+	_ASSERT(pInfo->pv_local_storage_pos == pv_code + st_code_size);					//TOO MUCH LOCAL INFO WAS WRITTEN
+	_ASSERT(pInfo->pv_instruction_storage_pos == pv_code + parse_info.st_instruction_storage_size);	//THE ALLOCATED SIZE DIDN'T MATCH THE USED SIZE
+
+	//THE COMPILE FAILS WHEN THE CODE CAN'T BE SEALED
+	if (!calculus::code_arena::seal(pHead)) {
+		calculus::code_arena::release(pHead->pv_code_storage,pHead->st_code_size);
+		free(pHead);
+		return NULL;
+	}
+
+	return (new IA32_binary(pHead));
+#else
+	return NULL;
+#endif
+};
+
+BATCH_FUNCTION calculus::algebraic_operator::compile_batch() {
+	IA32_binary* pia32 = m_pia32_batch_binary.load(std::memory_order_acquire);
+	if (pia32 == NULL) {
+		std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+		pia32 = m_pia32_batch_binary.load(std::memory_order_relaxed);
+		if (pia32 == NULL) {
+			pia32 = to_X64_vector_binary();
+			m_pia32_batch_binary.store(pia32,std::memory_order_release);
+		}
+	}
+	return (pia32)?(BATCH_FUNCTION)(pia32->m_pus_binary):NULL;
+};
+
+void calculus::algebraic_operator::eval_batch_compiled(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	BATCH_FUNCTION pf_kernel = compile_batch();
+	size_t st_done = (pf_kernel)?pf_kernel(ppd_columns,st_n,pd_out):0;
+	if (st_done < st_n) {
+		//THE TAIL IS SHORTER THAN A VECTOR
+		int i_num_vars = get_number_of_variables();
+		const double** ppd_tail = (i_num_vars)?new const double*[i_num_vars]:NULL;
+		for(int i = 0;i < i_num_vars;i++)
+			ppd_tail[i] = ppd_columns[i] + st_done;
+		eval_batch(ppd_tail,st_n-st_done,pd_out+st_done);
+		if (ppd_tail)
+			delete [] ppd_tail;
+	}
+}
+
+typedef struct PARALLEL_EVAL_CONTEXT {
+	calculus::algebraic_operator*	pao_operator;
+	FUNCTION						pf_compiled;		//NULL WHEN THE POINTS ARE EVALUATED ON THE TAPE
+	int								i_num_vars;
+	const double*					pd_points;
+	double*							pd_out;
+} PARALLEL_EVAL_CONTEXT,*PPARALLEL_EVAL_CONTEXT;
+
+static double CallCompiled(FUNCTION pf_compiled,int i_num_vars,const double* p) {
+	//THE COMPILED FUNCTION TAKES ITS VARIABLES BY VALUE, UP TO PARALLEL_EVAL_COMPILED_VARS
+	switch(i_num_vars) {
+	case 0 : return pf_compiled(0.0);
+	case 1 : return pf_compiled(p[0]);
+	case 2 : return pf_compiled(p[0],p[1]);
+	case 3 : return pf_compiled(p[0],p[1],p[2]);
+	case 4 : return pf_compiled(p[0],p[1],p[2],p[3]);
+	case 5 : return pf_compiled(p[0],p[1],p[2],p[3],p[4]);
+	case 6 : return pf_compiled(p[0],p[1],p[2],p[3],p[4],p[5]);
+	case 7 : return pf_compiled(p[0],p[1],p[2],p[3],p[4],p[5],p[6]);
+	case 8 : return pf_compiled(p[0],p[1],p[2],p[3],p[4],p[5],p[6],p[7]);
+	default :
+		_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		return 0;
+	}
+}
+
+static void EvalParallelTask(void* pv_context,size_t st_begin,size_t st_end) {
+	PPARALLEL_EVAL_CONTEXT pContext = (PPARALLEL_EVAL_CONTEXT)pv_context;
+	int i_num_vars = pContext->i_num_vars;
+	const double* pd_point = pContext->pd_points + st_begin*i_num_vars;
+	if (pContext->pf_compiled) {
+		for(size_t k = st_begin;k < st_end;k++,pd_point += i_num_vars)
+			pContext->pd_out[k] = CallCompiled(pContext->pf_compiled,i_num_vars,pd_point);
+	}
+	else {
+		calculus::tape* pt = pContext->pao_operator->get_tape();
+		for(size_t k = st_begin;k < st_end;k++,pd_point += i_num_vars)
+			pContext->pd_out[k] = pt->eval((double*)pd_point);
+	}
+}
+
+void calculus::algebraic_operator::eval_parallel(const double* pd_points,size_t st_n,double* pd_out) {
+	PARALLEL_EVAL_CONTEXT context;
+	context.pao_operator = this;
+	context.i_num_vars = get_number_of_variables();
+	context.pd_points = pd_points;
+	context.pd_out = pd_out;
+	//COMPILE OR RECORD ON THIS THREAD, BEFORE ANY WORKER CALLS IN
+	context.pf_compiled = (context.i_num_vars <= (int)PARALLEL_EVAL_COMPILED_VARS)?compile():NULL;
+	if (context.pf_compiled == NULL)
+		get_tape();
+	calculus::thread_pool* ptp = calculus::thread_pool::get_service();
+	size_t st_grain = st_n/(PARALLEL_EVAL_CHUNKS*ptp->get_num_threads());
+	if (st_grain < PARALLEL_EVAL_GRAIN)
+		st_grain = PARALLEL_EVAL_GRAIN;
+	ptp->parallel_for(st_n,st_grain,EvalParallelTask,&context);
+}
+
+double calculus::algebraic_operator::eval_by_id(const double* pd_slots) {
+	int i_num_vars = get_number_of_variables();
+	variable** ppv_vars = get_variables();
+	double pd_local[EVAL_LOCAL_VARIABLES];
+	double* pd_vars = (i_num_vars <= (int)EVAL_LOCAL_VARIABLES)?pd_local:new double[i_num_vars];
+	for(int i = 0;i < i_num_vars;i++)
+		pd_vars[i] = pd_slots[ppv_vars[i]->get_id()];
+	double d = eval_tape(pd_vars);
+	if (pd_vars != pd_local)
+		delete [] pd_vars;
+	return d;
+}
+
+int calculus::algebraic_operator::set_vector_isa(int i_vector_isa) {
+	int i_previous = s_i_vector_isa;
+#ifdef COMPILER_TARGET_X64
+	s_i_vector_isa = i_vector_isa;
+#else
+	UNREFERENCED_PARAMETER(i_vector_isa);
+#endif
+	return i_previous;
+}
+
 bool calculus::algebraic_operator::is_function_of(calculus::variable* a) {
 	variable ** ppv_vars = get_variables();
 	int i = get_number_of_variables();
+	int i_id = a->get_id();
     while(i)
-		if (ppv_vars[--i] == a)
+		if (ppv_vars[--i]->get_id() == i_id)
             return true;
 	return false;
 }
@@ -379,13 +1474,23 @@ calculus::variable** calculus::algebraic_operator::identify_variables() {
     return NULL;
 }
 
+void calculus::algebraic_operator::identify_variables_once() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	if (!m_b_variables_identified) {
+		identify_variables();
+		m_b_variables_identified = true;
+	}
+}
+
 calculus::variable** calculus::algebraic_operator::get_variables() {
-	return (m_ppv_variables == NULL)?identify_variables():m_ppv_variables;
+	if (!m_b_variables_identified)
+		identify_variables_once();
+	return m_ppv_variables;
 }
 
 int calculus::algebraic_operator::get_number_of_variables() {
 	if (!m_b_variables_identified)
-		identify_variables();
+		identify_variables_once();
 	return m_i_number_of_variables;
 }
 
@@ -104,14 +104,24 @@ double calculus::unary_operators::trigonometric_operators::arccosine::eval_unary
 	return (double)::acos(a);
 }
 
-int calculus::unary_operators::trigonometric_operators::arccosine::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"acos(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::trigonometric_operators::arccosine::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = arccosine::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::trigonometric_operators::arccosine::eval_unary_derivative(double a) {
+	return -1.0/(double)::sqrt(1.0-a*a);
+}
+
+double calculus::unary_operators::trigonometric_operators::arccosine::eval_unary_second_derivative(double a) {
+	double s = 1.0-a*a;
+	return -a/(s*(double)::sqrt(s));
+}
+
+void calculus::unary_operators::trigonometric_operators::arccosine::write_string(string_writer* psw) {
+	psw->write("acos(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::trigonometric_operators::arccosine::to_IA32_binary(PCT_INFO pInfo) {
@@ -144,6 +154,26 @@ void calculus::unary_operators::trigonometric_operators::arccosine::annotate(PPT
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,acos
+CALL	rax
+*/
+
+void calculus::unary_operators::trigonometric_operators::arccosine::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* pacos)(double) = ::acos;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)pacos);
+}
+
+void calculus::unary_operators::trigonometric_operators::arccosine::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::trigonometric_operators::arccosine::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -104,14 +104,24 @@ double calculus::unary_operators::trigonometric_operators::arctangent::eval_unar
 	return (double)::atan(a);
 }
 
-int calculus::unary_operators::trigonometric_operators::arctangent::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"atan(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::trigonometric_operators::arctangent::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = arctangent::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::trigonometric_operators::arctangent::eval_unary_derivative(double a) {
+	return 1.0/(1.0+a*a);
+}
+
+double calculus::unary_operators::trigonometric_operators::arctangent::eval_unary_second_derivative(double a) {
+	double s = 1.0+a*a;
+	return -2.0*a/(s*s);
+}
+
+void calculus::unary_operators::trigonometric_operators::arctangent::write_string(string_writer* psw) {
+	psw->write("atan(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::trigonometric_operators::arctangent::to_IA32_binary(PCT_INFO pInfo) {
@@ -144,6 +154,26 @@ void calculus::unary_operators::trigonometric_operators::arctangent::annotate(PP
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,atan
+CALL	rax
+*/
+
+void calculus::unary_operators::trigonometric_operators::arctangent::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* patan)(double) = ::atan;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)patan);
+}
+
+void calculus::unary_operators::trigonometric_operators::arctangent::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::trigonometric_operators::arctangent::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
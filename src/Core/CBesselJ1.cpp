@@ -105,14 +105,27 @@ double calculus::unary_operators::bessel_operators::bessel_j1::eval_unary(double
 	return (double)p_j1(a);
 }
 
-int calculus::unary_operators::bessel_operators::bessel_j1::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"_j1(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::bessel_operators::bessel_j1::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = bessel_j1::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::bessel_operators::bessel_j1::eval_unary_derivative(double a) {
+	//J1'(a) = (J0(a) - J2(a))/2
+	double (__cdecl* p_jn)(int,double) = ::_jn;
+	return 0.5*((double)p_jn(0,a)-(double)p_jn(2,a));
+}
+
+double calculus::unary_operators::bessel_operators::bessel_j1::eval_unary_second_derivative(double a) {
+	//J1''(a) = (J3(a) - 3*J1(a))/4
+	double (__cdecl* p_jn)(int,double) = ::_jn;
+	return 0.25*((double)p_jn(3,a)-3.0*(double)p_jn(1,a));
+}
+
+void calculus::unary_operators::bessel_operators::bessel_j1::write_string(string_writer* psw) {
+	psw->write("_j1(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::bessel_operators::bessel_j1::to_IA32_binary(PCT_INFO pInfo) {
@@ -144,3 +157,23 @@ void calculus::unary_operators::bessel_operators::bessel_j1::annotate(PPT_INFO p
 	pParseInfo->i_operator_count++;
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
+
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,_j1
+CALL	rax
+*/
+
+void calculus::unary_operators::bessel_operators::bessel_j1::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* p_j1)(double) = ::_j1;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)p_j1);
+}
+
+void calculus::unary_operators::bessel_operators::bessel_j1::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
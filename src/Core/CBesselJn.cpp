@@ -106,13 +106,32 @@ double calculus::unary_operators::bessel_operators::bessel_jn::eval_unary(double
 	return (double)p_jn(this->m_uiConstant,a);
 }
 
-int calculus::unary_operators::bessel_operators::bessel_jn::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 25+this->get_operand()->to_string(NULL);
-	int iOffset = sprintf(pBuffer,"_jn(%i,",this->m_uiConstant);
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::bessel_operators::bessel_jn::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = bessel_jn::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::bessel_operators::bessel_jn::eval_unary_derivative(double a) {
+	//Jn'(a) = (Jn-1(a) - Jn+1(a))/2 AND J0'(a) = -J1(a)
+	double (__cdecl* p_jn)(int,double) = ::_jn;
+	int n = (int)this->m_uiConstant;
+	if (n == 0)
+		return -(double)p_jn(1,a);
+	return 0.5*((double)p_jn(n-1,a)-(double)p_jn(n+1,a));
+}
+
+double calculus::unary_operators::bessel_operators::bessel_jn::eval_unary_second_derivative(double a) {
+	//Jn''(a) = (Jn-2(a) - 2*Jn(a) + Jn+2(a))/4, WITH J-k(a) = (-1)^k*Jk(a)
+	double (__cdecl* p_jn)(int,double) = ::_jn;
+	int n = (int)this->m_uiConstant;
+	double d_below = (n >= 2)?(double)p_jn(n-2,a):((n == 1)?-(double)p_jn(1,a):(double)p_jn(2,a));
+	return 0.25*(d_below-2.0*(double)p_jn(n,a)+(double)p_jn(n+2,a));
+}
+
+void calculus::unary_operators::bessel_operators::bessel_jn::write_string(string_writer* psw) {
+	psw->print("_jn(%i,",this->m_uiConstant);
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::bessel_operators::bessel_jn::to_IA32_binary(PCT_INFO pInfo) {
@@ -147,3 +166,36 @@ void calculus::unary_operators::bessel_operators::bessel_jn::annotate(PPT_INFO p
 	pParseInfo->i_operator_count++;
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
+
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		edi,n
+MOV		rax,_jn
+CALL	rax
+*/
+
+void calculus::unary_operators::bessel_operators::bessel_jn::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* p_jn)(int,double) = ::_jn;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteMOV_EXX_IMM32(pInfo,REG_EDI);
+		CompilerWriteINT32(pInfo,(int)this->m_uiConstant);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)p_jn);
+}
+
+void calculus::unary_operators::bessel_operators::bessel_jn::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfMOV_EXX_IMM32()
+											+  CompilerSizeOfINT32()
+											+  CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	3;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
+qword_type calculus::unary_operators::bessel_operators::bessel_jn::structural_hash() {
+	return StructuralHashCombine(unary_operator::structural_hash(),(qword_type)this->m_uiConstant);
+}
+
+bool calculus::unary_operators::bessel_operators::bessel_jn::structural_equal(calculus::algebraic_operator * pao_other) {
+	return unary_operator::structural_equal(pao_other)&&(static_cast<bessel_jn*>(pao_other)->m_uiConstant == this->m_uiConstant);
+}
@@ -105,14 +105,26 @@ double calculus::unary_operators::bessel_operators::bessel_y0::eval_unary(double
 	return (double)p_y0(a);
 }
 
-int calculus::unary_operators::bessel_operators::bessel_y0::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"_y0(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::bessel_operators::bessel_y0::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = bessel_y0::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::bessel_operators::bessel_y0::eval_unary_derivative(double a) {
+	double (__cdecl* p_y1)(double) = ::_y1;
+	return -(double)p_y1(a);
+}
+
+double calculus::unary_operators::bessel_operators::bessel_y0::eval_unary_second_derivative(double a) {
+	//Y0''(a) = (Y2(a) - Y0(a))/2
+	double (__cdecl* p_yn)(int,double) = ::_yn;
+	return 0.5*((double)p_yn(2,a)-(double)p_yn(0,a));
+}
+
+void calculus::unary_operators::bessel_operators::bessel_y0::write_string(string_writer* psw) {
+	psw->write("_y0(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::bessel_operators::bessel_y0::to_IA32_binary(PCT_INFO pInfo) {
@@ -144,3 +156,23 @@ void calculus::unary_operators::bessel_operators::bessel_y0::annotate(PPT_INFO p
 	pParseInfo->i_operator_count++;
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
+
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,_y0
+CALL	rax
+*/
+
+void calculus::unary_operators::bessel_operators::bessel_y0::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* p_y0)(double) = ::_y0;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)p_y0);
+}
+
+void calculus::unary_operators::bessel_operators::bessel_y0::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
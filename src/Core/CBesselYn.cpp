@@ -107,14 +107,36 @@ double calculus::unary_operators::bessel_operators::bessel_yn::eval_unary(double
 	return (double)p_yn(this->m_uiConstant,a);
 };
 
-int calculus::unary_operators::bessel_operators::bessel_yn::to_string(char* pBuffer)
+void calculus::unary_operators::bessel_operators::bessel_yn::eval_unary_batch(double* pd,size_t st_n)
 {
-	if (!pBuffer)
-		return 25+this->get_operand()->to_string(NULL);
-	int iOffset = sprintf(pBuffer,"_yn(%i,",this->m_uiConstant);
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = bessel_yn::eval_unary(pd[i]);
+};
+
+double calculus::unary_operators::bessel_operators::bessel_yn::eval_unary_derivative(double a)
+{
+	//Yn'(a) = (Yn-1(a) - Yn+1(a))/2 AND Y0'(a) = -Y1(a)
+	double (__cdecl* p_yn)(int,double) = ::_yn;
+	int n = (int)this->m_uiConstant;
+	if (n == 0)
+		return -(double)p_yn(1,a);
+	return 0.5*((double)p_yn(n-1,a)-(double)p_yn(n+1,a));
+};
+
+double calculus::unary_operators::bessel_operators::bessel_yn::eval_unary_second_derivative(double a)
+{
+	//Yn''(a) = (Yn-2(a) - 2*Yn(a) + Yn+2(a))/4, WITH Y-k(a) = (-1)^k*Yk(a)
+	double (__cdecl* p_yn)(int,double) = ::_yn;
+	int n = (int)this->m_uiConstant;
+	double d_below = (n >= 2)?(double)p_yn(n-2,a):((n == 1)?-(double)p_yn(1,a):(double)p_yn(2,a));
+	return 0.25*(d_below-2.0*(double)p_yn(n,a)+(double)p_yn(n+2,a));
+};
+
+void calculus::unary_operators::bessel_operators::bessel_yn::write_string(string_writer* psw)
+{
+	psw->print("_yn(%i,",this->m_uiConstant);
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 };
 
 void calculus::unary_operators::bessel_operators::bessel_yn::to_IA32_binary(PCT_INFO pInfo)
@@ -152,3 +174,40 @@ void calculus::unary_operators::bessel_operators::bessel_yn::annotate(PPT_INFO p
 	pParseInfo->i_operator_count++;
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 };
+
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		edi,n
+MOV		rax,_yn
+CALL	rax
+*/
+
+void calculus::unary_operators::bessel_operators::bessel_yn::to_X64_binary(PCT_INFO pInfo)
+{
+	double (__cdecl* p_yn)(int,double) = ::_yn;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteMOV_EXX_IMM32(pInfo,REG_EDI);
+		CompilerWriteINT32(pInfo,(int)this->m_uiConstant);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)p_yn);
+};
+
+void calculus::unary_operators::bessel_operators::bessel_yn::annotate_X64(PPT_INFO pParseInfo)
+{
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfMOV_EXX_IMM32()
+											+  CompilerSizeOfINT32()
+											+  CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	3;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+};
+
+qword_type calculus::unary_operators::bessel_operators::bessel_yn::structural_hash()
+{
+	return StructuralHashCombine(unary_operator::structural_hash(),(qword_type)this->m_uiConstant);
+};
+
+bool calculus::unary_operators::bessel_operators::bessel_yn::structural_equal(calculus::algebraic_operator * pao_other)
+{
+	return unary_operator::structural_equal(pao_other)&&(static_cast<bessel_yn*>(pao_other)->m_uiConstant == this->m_uiConstant);
+};
@@ -101,110 +101,492 @@ bool calculus::binary_operators::binary_operator::UseConstantOptimizations = tru
 bool calculus::binary_operators::binary_operator::UseDisorderedOptimizations = true;
 bool calculus::binary_operators::binary_operator::UseFlipOptimizations = true;
 
-double calculus::binary_operators::binary_operator::eval(double* pVars) {
-	double a = 0,b = 0;
-	if (m_pao_left_operand) {
-		int i_num_left_vars = m_pao_left_operand->get_number_of_variables();
-		calculus::variable** ppv_left_vars = m_pao_left_operand->get_variables();
-		double* pd_left_vars = new double[i_num_left_vars];
-		for(int i = 0;i < i_num_left_vars;i++) {
-            int j;
-			for(j = 0;j < m_i_number_of_variables;j++)
-				if (m_ppv_variables[j] == ppv_left_vars[i])
-					break;
-			if (m_ppv_variables[j] == ppv_left_vars[i]) {
-				pd_left_vars[i] = pVars[j];
-			}
-			else pd_left_vars[i] = 0;
+//ORDERS THE VARIABLES BY NAME, THE SAME ID IS THE SAME VARIABLE AND SPARES THE strcmp()
+static int CompareVariables(calculus::variable* pv_a,calculus::variable* pv_b) {
+	if (pv_a->get_id() == pv_b->get_id())
+		return 0;
+	return strcmp(pv_a->get_variable_name(),pv_b->get_variable_name());
+}
+
+//TRUE WHEN ppv_vars IS IN STRICTLY INCREASING VARIABLE NAME ORDER
+static bool IsSortedByName(int i_num_vars,calculus::variable** ppv_vars) {
+	for(int i = 1;i < i_num_vars;i++)
+		if (CompareVariables(ppv_vars[i-1],ppv_vars[i]) >= 0)
+			return false;
+	return true;
+}
+
+static int CompareVariableNames(const void* pv_a,const void* pv_b) {
+	return CompareVariables(*(calculus::variable* const*)pv_a,*(calculus::variable* const*)pv_b);
+}
+
+//RETURNS THE INDEX OF pv IN THE SORTED ppv_vars, -1 WHEN IT'S NOT THERE
+static int FindVariable(calculus::variable* pv,int i_num_vars,calculus::variable** ppv_vars) {
+	int i_low = 0,i_high = i_num_vars-1;
+	while (i_low <= i_high) {
+		int i_mid = (i_low+i_high)>>1;
+		int i_compare = CompareVariables(ppv_vars[i_mid],pv);
+		if (!i_compare)
+			return i_mid;
+		if (i_compare < 0)
+			i_low = i_mid+1;
+		else
+			i_high = i_mid-1;
+	}
+	return -1;
+}
+
+//ALLOCATES A VARIABLE_BUFFER WITH ROOM FOR i_capacity VARIABLES, RETURNS ITS SPAN
+static calculus::variable** AllocateVariableBuffer(int i_capacity) {
+	calculus::PVARIABLE_BUFFER pvb_buffer = (calculus::PVARIABLE_BUFFER)calculus::node_pool::allocate_array<unsigned char>(offsetof(calculus::VARIABLE_BUFFER,ppv_variables)+i_capacity*sizeof(calculus::variable*));
+	pvb_buffer->i_used = 0;
+	pvb_buffer->i_capacity = i_capacity;
+	return pvb_buffer->ppv_variables;
+}
+
+//RETURNS THE FIRST INDEX FROM i_low IN THE SORTED ppv_vars WHOSE VARIABLE DOESN'T PRECEDE pv
+static int LowerBound(calculus::variable* pv,int i_low,int i_num_vars,calculus::variable** ppv_vars) {
+	int i_high = i_num_vars;
+	while (i_low < i_high) {
+		int i_mid = (i_low+i_high)>>1;
+		if (CompareVariables(ppv_vars[i_mid],pv) < 0)
+			i_low = i_mid+1;
+		else
+			i_high = i_mid;
+	}
+	return i_low;
+}
+
+//MERGES THE SORTED ppv_a AND ppv_b INTO ppv_out DROPPING DUPLICATES, ppv_out MAY BE NULL TO ONLY COUNT.  THE SHORTER
+//SET IS WALKED AND THE RUNS OF THE LONGER ONE BETWEEN ITS VARIABLES ARE COPIED, A VARIABLE ADDED TO A LONG SET
+//COSTS A BINARY SEARCH AND A COPY INSTEAD OF A NAME COMPARISON PER VARIABLE
+static int MergeVariables(int i_num_a,calculus::variable** ppv_a,int i_num_b,calculus::variable** ppv_b,calculus::variable** ppv_out) {
+	bool b_walk_a = (i_num_a < i_num_b);
+	int i_num_short = (b_walk_a)?i_num_a:i_num_b,i_num_long = (b_walk_a)?i_num_b:i_num_a;
+	calculus::variable** ppv_short = (b_walk_a)?ppv_a:ppv_b;
+	calculus::variable** ppv_long = (b_walk_a)?ppv_b:ppv_a;
+	int i = 0,k = 0;
+	for(int j = 0;j < i_num_short;j++) {
+		int i_run = LowerBound(ppv_short[j],i,i_num_long,ppv_long);
+		if ((ppv_out)&&(i_run > i))
+			memcpy(ppv_out+k,ppv_long+i,(i_run-i)*sizeof(calculus::variable*));
+		k += i_run-i;
+		i = i_run;
+		calculus::variable* pv_next = ppv_short[j];
+		//THE SAME VARIABLE IN BOTH SETS, THE ONE OF ppv_a IS KEPT
+		if ((i < i_num_long)&&(ppv_long[i]->get_id() == pv_next->get_id())) {
+			if (!b_walk_a)
+				pv_next = ppv_long[i];
+			i++;
+		}
+		if (ppv_out)
+			ppv_out[k] = pv_next;
+		k++;
+	}
+	if ((ppv_out)&&(i_num_long > i))
+		memcpy(ppv_out+k,ppv_long+i,(i_num_long-i)*sizeof(calculus::variable*));
+	return k+i_num_long-i;
+}
+
+//RETURNS A SORTED COPY OF THE VARIABLES OF pao_operand FROM THE NODE POOL, OR ppv_vars ITSELF WHEN IT'S SORTED ALREADY
+static calculus::variable** SortedVariables(calculus::algebraic_operator* pao_operand,int* pi_num_vars,calculus::variable** ppv_vars) {
+	int i_num_vars = *pi_num_vars;
+	//A VARIABLE_BUFFER IS SORTED, CHECKING IT WOULD MAKE A LONG SUM QUADRATIC
+	if (pao_operand->has_variable_buffer() || IsSortedByName(i_num_vars,ppv_vars))
+		return ppv_vars;
+	calculus::variable** ppv_sorted = calculus::node_pool::allocate_array<calculus::variable*>(i_num_vars);
+	for(int i = 0;i < i_num_vars;i++)
+		ppv_sorted[i] = ppv_vars[i];
+	qsort(ppv_sorted,i_num_vars,sizeof(calculus::variable*),CompareVariableNames);
+	//A SORTED SET HAS NO DUPLICATES, function_adapter MAY REPEAT A VARIABLE
+	int k = 0;
+	for(int i = 0;i < i_num_vars;i++)
+		if ((!k)||(ppv_sorted[k-1]->get_id() != ppv_sorted[i]->get_id()))
+			ppv_sorted[k++] = ppv_sorted[i];
+	*pi_num_vars = k;
+	return ppv_sorted;
+}
+
+//BUILDS THE INDEX OF EVERY OPERAND VARIABLE IN THE SORTED ppv_vars, RETURNS NULL WHEN THE OPERAND TAKES ppv_vars AS IS
+//THE OPERAND ONLY READS THE FIRST i_num_operand_vars VALUES, SO A PREFIX OF ppv_vars IS PASSED AS IS TOO.  A SORTED
+//OPERAND IS A SUBSEQUENCE OF ppv_vars, A LINEAR WALK COMPARING THE IDS FROM ITS FIRST VARIABLE FINDS EVERY INDEX
+static int* BuildIndexMap(int i_num_operand_vars,calculus::variable** ppv_operand_vars,bool b_operand_sorted,int i_num_vars,calculus::variable** ppv_vars) {
+	if (ppv_operand_vars == ppv_vars)
+		return NULL;
+	bool b_identity = true;
+	int* pi_indices = (i_num_operand_vars)?calculus::node_pool::allocate_array<int>(i_num_operand_vars):NULL;
+	int j = (b_operand_sorted && i_num_operand_vars)?FindVariable(ppv_operand_vars[0],i_num_vars,ppv_vars):0;
+	for(int i = 0;i < i_num_operand_vars;i++) {
+		if (b_operand_sorted) {
+			while((j < i_num_vars) && (ppv_vars[j]->get_id() != ppv_operand_vars[i]->get_id()))
+				j++;
+			_ASSERT(j < i_num_vars);	//THIS IS AN ILLEGAL PROGRAM STATE
 		}
-        a = m_pao_left_operand->eval(pd_left_vars);
-		delete [] pd_left_vars;
-	}
-	if (m_pao_right_operand) {
-		int i_num_right_vars = m_pao_right_operand->get_number_of_variables();
-		calculus::variable** ppv_right_vars = m_pao_right_operand->get_variables();
-		double* pd_right_vars = new double[i_num_right_vars];
-		for(int i = 0;i < i_num_right_vars;i++) {
-            int j;
-			for(j = 0;j < m_i_number_of_variables;j++) {
-				if (m_ppv_variables[j] == ppv_right_vars[i])
-					break;
-			}
-			if (m_ppv_variables[j] == ppv_right_vars[i]) {
-				pd_right_vars[i] = pVars[j];
-			}
-			else pd_right_vars[i] = 0;
+		else {
+			j = FindVariable(ppv_operand_vars[i],i_num_vars,ppv_vars);
+			_ASSERT(j >= 0);	//THIS IS AN ILLEGAL PROGRAM STATE
 		}
-        b = m_pao_right_operand->eval(pd_right_vars);
-		delete [] pd_right_vars;
+		pi_indices[i] = j;
+		b_identity = b_identity && (j == i);
 	}
+	if (b_identity && pi_indices) {
+		calculus::node_pool::release_array(pi_indices);
+		pi_indices = NULL;
+	}
+	return pi_indices;
+}
+
+//GATHERS THE VARIABLES OF pao_operand ON THE STACK AND EVALUATES IT
+static double EvalOperand(calculus::algebraic_operator* pao_operand,const int* pi_indices,double* pVars) {
+	if (pi_indices == NULL)
+		return pao_operand->eval(pVars);
+	int i_num_vars = pao_operand->get_number_of_variables();
+	double pd_local[EVAL_LOCAL_VARIABLES];
+	double* pd_vars = (i_num_vars <= (int)EVAL_LOCAL_VARIABLES)?pd_local:new double[i_num_vars];
+	for(int i = 0;i < i_num_vars;i++)
+		pd_vars[i] = pVars[pi_indices[i]];
+	double d = pao_operand->eval(pd_vars);
+	if (pd_vars != pd_local)
+		delete [] pd_vars;
+	return d;
+}
+
+double calculus::binary_operators::binary_operator::eval(double* pVars) {
+	if (!m_b_variables_identified)
+		identify_variables_once();
+	double a = 0,b = 0;
+	if (m_pao_left_operand)
+		a = EvalOperand(m_pao_left_operand,m_pi_left_indices,pVars);
+	if (m_pao_right_operand)
+		b = EvalOperand(m_pao_right_operand,m_pi_right_indices,pVars);
 	return eval_binary(a,b);
 }
 
+void calculus::binary_operators::binary_operator::eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	if (!m_b_variables_identified)
+		identify_variables_once();
+	int i_num_left_vars = m_pao_left_operand->get_number_of_variables();
+	int i_num_right_vars = m_pao_right_operand->get_number_of_variables();
+	//REMAP THE COLUMNS ONCE PER CALL, THE FIRST HALF HOLDS THE COLUMNS AND THE SECOND THE CURRENT BLOCK
+	const double* ppd_local[4*EVAL_LOCAL_VARIABLES+1];
+	int i_num_pointers = 2*(i_num_left_vars+i_num_right_vars)+1;
+	const double** ppd_operand_columns = (i_num_pointers <= (int)(4*EVAL_LOCAL_VARIABLES+1))?ppd_local:new const double*[i_num_pointers];
+	const double** ppd_left_block = ppd_operand_columns + (i_num_left_vars+i_num_right_vars);
+	const double** ppd_right_block = ppd_left_block + i_num_left_vars;
+	for(int i = 0;i < i_num_left_vars;i++)
+		ppd_operand_columns[i] = ppd_columns[(m_pi_left_indices)?m_pi_left_indices[i]:i];
+	for(int i = 0;i < i_num_right_vars;i++)
+		ppd_operand_columns[i_num_left_vars+i] = ppd_columns[(m_pi_right_indices)?m_pi_right_indices[i]:i];
+	//EVALUATE BLOCK BY BLOCK SO THE SCRATCH STAYS ON THE STACK AND IN CACHE
+	double pd_right[EVAL_BATCH_BLOCK_SIZE];
+	for(size_t k = 0;k < st_n;k += EVAL_BATCH_BLOCK_SIZE) {
+		size_t st_block = (st_n-k < EVAL_BATCH_BLOCK_SIZE)?st_n-k:EVAL_BATCH_BLOCK_SIZE;
+		for(int i = 0;i < i_num_left_vars+i_num_right_vars;i++)
+			ppd_left_block[i] = ppd_operand_columns[i] + k;
+		m_pao_left_operand->eval_batch(ppd_left_block,st_block,pd_out+k);
+		m_pao_right_operand->eval_batch(ppd_right_block,st_block,pd_right);
+		eval_binary_batch(pd_out+k,pd_right,st_block);
+	}
+	if (ppd_operand_columns != ppd_local)
+		delete [] ppd_operand_columns;
+}
+
 calculus::variable** calculus::binary_operators::binary_operator::identify_variables() {
-	unsigned int numLeftVars = m_pao_left_operand->get_number_of_variables();
-	unsigned int numRightVars = m_pao_right_operand->get_number_of_variables();
-	m_i_number_of_variables = numLeftVars+numRightVars;
-	if (m_ppv_variables)
-		delete [] m_ppv_variables;
+	int numLeftVars = m_pao_left_operand->get_number_of_variables();
+	int numRightVars = m_pao_right_operand->get_number_of_variables();
+	release_variables();
+    if (m_pi_left_indices)
+        calculus::node_pool::release_array(m_pi_left_indices);
+    if (m_pi_right_indices)
+        calculus::node_pool::release_array(m_pi_right_indices);
+    m_pi_left_indices = m_pi_right_indices = NULL;
+	m_i_number_of_variables = 0;
     
-    if (!m_i_number_of_variables)
-        return m_ppv_variables = NULL;
-
-	m_ppv_variables = new calculus::variable*[m_i_number_of_variables+1];
+    if (!(numLeftVars+numRightVars)) {
+        m_b_variables_identified = true;
+        return m_ppv_variables;
+    }
 
 	calculus::variable** ppv_left_vars = m_pao_left_operand->get_variables();
 	calculus::variable** ppv_right_vars = m_pao_right_operand->get_variables();
-	
-    { for(unsigned int i = 0;i < numLeftVars;i++)
-        m_ppv_variables[i] = ppv_left_vars[i]; }
-    { for(unsigned int i = 0;i < numRightVars;i++)
-        m_ppv_variables[i+numLeftVars] = ppv_right_vars[i]; }
-
-
-    //LETS PRUNE THE LIST TO REMOVE DUPLICATES
-    for(int i = 0;i < m_i_number_of_variables;i++) {
-        //IF THIS REFERENCE IS NULL, THEN LEAVE
-        if (!m_ppv_variables[i])
-            break;
-        //THIS WILL PUT ALL LIKE REFERENCES TO NULL
-        for(int j = i+1;j < m_i_number_of_variables;j++)
-            if (m_ppv_variables[j])
-                if (!strcmp(m_ppv_variables[i]->get_variable_name(),m_ppv_variables[j]->get_variable_name()))
-                    m_ppv_variables[j] = NULL;
-        //THIS WILL COMPRESS THE ARRAY
-        int i_next_var = i+1;
-        { for(int j = i+1;j < m_i_number_of_variables;j++) {
-            //FIND THE NEXT NON-NULL VARIABLE REFERENCE
-            for(;i_next_var < m_i_number_of_variables;i_next_var++)
-                if (m_ppv_variables[i_next_var])
-                    break;
-            //IF WE REACHED THE END OF THE LIST THEN LETS DEPART
-            if (i_next_var == m_i_number_of_variables)
-                break;
-            //SET THE CURRENT VAR TO THE NEXT-VAR
-            m_ppv_variables[j] = m_ppv_variables[i_next_var++];
-        } }
-    }
-    //WE NEED TO COUNT THE NUMBER OF NON-NULL VARIABLES AT THIS POINT
-    {int i;
-    for(i = 0;i < m_i_number_of_variables;i++)
-        if (!m_ppv_variables[i])
-            break;
-    m_i_number_of_variables = i;}
-    //LETS SORT THE ARRAY NOW
-    { for(int i = 0;i < m_i_number_of_variables-1;i++)
-    {
-        //CURRENTLY LOOKING FOR I-TH CANDIDATE
-        int i_candidate = i;
-        for(int j = i+1;j < m_i_number_of_variables;j++)
-            if (strcmp(m_ppv_variables[i]->get_variable_name(),m_ppv_variables[j]->get_variable_name()) > 0)
-                i_candidate = j;
-        calculus::variable* temp = m_ppv_variables[i];
-        m_ppv_variables[i] = m_ppv_variables[i_candidate];
-        m_ppv_variables[i_candidate] = temp;
-    } }
-	mass_addref<calculus::variable>(m_ppv_variables,m_i_number_of_variables);
+	//THE SETS ARE KEPT SORTED BY VARIABLE NAME SO THE UNION IS A LINEAR MERGE
+	int numLeftSorted = numLeftVars,numRightSorted = numRightVars;
+	calculus::variable** ppv_left_sorted = SortedVariables(m_pao_left_operand,&numLeftSorted,ppv_left_vars);
+	calculus::variable** ppv_right_sorted = SortedVariables(m_pao_right_operand,&numRightSorted,ppv_right_vars);
+	//WHEN EVERY RIGHT VARIABLE FOLLOWS THE LEFT ONES THE UNION IS THE LEFT SET WITH THE RIGHT ONE APPENDED
+	bool b_append = (numLeftSorted)&&(numRightSorted)&&(CompareVariables(ppv_left_sorted[numLeftSorted-1],ppv_right_sorted[0]) < 0);
+	int i_num_vars = (b_append)?numLeftSorted+numRightSorted:MergeVariables(numLeftSorted,ppv_left_sorted,numRightSorted,ppv_right_sorted,NULL);
+
+	if ((i_num_vars == numLeftVars) && (ppv_left_sorted == ppv_left_vars))
+		borrow_variables(m_pao_left_operand);
+	else if ((i_num_vars == numRightVars) && (ppv_right_sorted == ppv_right_vars))
+		borrow_variables(m_pao_right_operand);
+	else if (b_append && (ppv_left_sorted == ppv_left_vars) && m_pao_left_operand->has_variable_buffer() &&
+		(VARIABLE_BUFFER_OF(ppv_left_vars)->i_used == numLeftVars) && (VARIABLE_BUFFER_OF(ppv_left_vars)->i_capacity >= i_num_vars)) {
+		//THE LEFT SPAN ENDS THE BUFFER, WE GROW IT IN PLACE
+		borrow_variables(m_pao_left_operand);
+		for(int i = 0;i < numRightSorted;i++)
+			ppv_left_vars[numLeftVars+i] = ppv_right_sorted[i];
+		mass_addref<calculus::variable>(ppv_left_vars+numLeftVars,numRightSorted);
+		VARIABLE_BUFFER_OF(ppv_left_vars)->i_used = m_i_number_of_variables = i_num_vars;
+	} else {
+		//AFTER AN APPEND THE BUFFER HAS ROOM FOR THE PARENTS TO APPEND TOO, A LONG SUM DOUBLES IT A LOGARITHMIC
+		//NUMBER OF TIMES.  NAMES THAT DON'T COME IN ORDER MERGE INTO A COPY AT EVERY PARENT, SO IT GETS NO SPARE ROOM
+		m_ppv_variables = AllocateVariableBuffer((b_append)?i_num_vars*2:i_num_vars);
+		m_b_variable_buffer = true;
+		m_i_number_of_variables = i_num_vars;
+		VARIABLE_BUFFER_OF(m_ppv_variables)->i_used = i_num_vars;
+		MergeVariables(numLeftSorted,ppv_left_sorted,numRightSorted,ppv_right_sorted,m_ppv_variables);
+		mass_addref<calculus::variable>(m_ppv_variables,m_i_number_of_variables);
+	}
+	bool b_left_sorted = (ppv_left_sorted == ppv_left_vars),b_right_sorted = (ppv_right_sorted == ppv_right_vars);
+	if (ppv_left_sorted != ppv_left_vars)
+		calculus::node_pool::release_array(ppv_left_sorted);
+	if (ppv_right_sorted != ppv_right_vars)
+		calculus::node_pool::release_array(ppv_right_sorted);
+    //MAP THE OPERAND VARIABLES ONCE SO eval() NEVER SEARCHES
+    m_pi_left_indices = BuildIndexMap(numLeftVars,ppv_left_vars,b_left_sorted,m_i_number_of_variables,m_ppv_variables);
+    m_pi_right_indices = BuildIndexMap(numRightVars,ppv_right_vars,b_right_sorted,m_i_number_of_variables,m_ppv_variables);
     m_b_variables_identified = true;
 	return m_ppv_variables;
 }
+
+/*
+THIS IS THE OPCODE BLUEPRINT SHARED BY THE X64 ARITHMETIC BINARY OPERATORS
+
+	RIGHT OPERAND OPCODE
+MOVSD	qword PTR[rbp-d],xmm0
+	LEFT OPERAND OPCODE
+OPSD	xmm0,qword PTR[rbp-d]
+
+WHEN THE RIGHT OPERAND IS A VARIABLE OR A CONSTANT
+
+	LEFT OPERAND OPCODE
+OPSD	xmm0,RIGHT OPERAND
+
+WHEN THE LEFT OPERAND IS A VARIABLE OR A CONSTANT
+
+	RIGHT OPERAND OPCODE
+OPSD	xmm0,LEFT OPERAND				COMMUTATIVE
+	OR
+MOVAPD	xmm1,xmm0						NON COMMUTATIVE
+MOVSD	xmm0,LEFT OPERAND
+OPSD	xmm0,xmm1
+*/
+
+void calculus::binary_operators::binary_operator::to_X64_arithmetic(PCT_INFO pInfo,byte_type code,bool b_commutative)
+{
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	bool bStack = ((typeid(*this->GetLeftOperand()) == typeid(calculus::variable)) || (typeid(*this->GetLeftOperand()) == typeid(calculus::constant))) && IsUsingDisorderedOptimizations();
+	if (bFlip) {
+		this->GetLeftOperand()->to_X64_shared(pInfo);
+		this->GetRightOperand()->to_X64_operand(pInfo,code,REG_XMM(0));
+	}
+	else if (bStack) {
+		this->GetRightOperand()->to_X64_shared(pInfo);
+		if (b_commutative)
+			this->GetLeftOperand()->to_X64_operand(pInfo,code,REG_XMM(0));
+		else {
+			CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_MOVAPD,REG_XMM(1),REG_XMM(0));
+			this->GetLeftOperand()->to_X64_operand(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0));
+			CompilerWriteSSE2_SD_XMM_XMM(pInfo,code,REG_XMM(0),REG_XMM(1));
+		}
+	}
+	else {
+		this->GetRightOperand()->to_X64_shared(pInfo);
+		int iTemp = CompilerPushX64Temporary(pInfo);
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),iTemp);
+		this->GetLeftOperand()->to_X64_shared(pInfo);
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,code,REG_XMM(0),iTemp);
+		CompilerPopX64Temporary(pInfo);
+	}
+}
+
+void calculus::binary_operators::binary_operator::annotate_X64_arithmetic(PPT_INFO pParseInfo,bool b_commutative)
+{
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	bool bStack = ((typeid(*this->GetLeftOperand()) == typeid(calculus::variable)) || (typeid(*this->GetLeftOperand()) == typeid(calculus::constant))) && IsUsingDisorderedOptimizations();
+	pParseInfo->i_operator_count++;
+	if (bFlip) {
+		this->GetLeftOperand()->annotate_X64_shared(pParseInfo);
+		this->GetRightOperand()->annotate_X64_operand(pParseInfo);
+	}
+	else if (bStack) {
+		this->GetRightOperand()->annotate_X64_shared(pParseInfo);
+		this->GetLeftOperand()->annotate_X64_operand(pParseInfo);
+		if (!b_commutative) {
+			pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_PD_XMM_XMM()
+													+	CompilerSizeOfSSE2_SD_XMM_XMM();
+			pParseInfo->i_instruction_count			+=	2;
+		}
+	}
+	else {
+		this->GetRightOperand()->annotate_X64_shared(pParseInfo);
+		CompilerReserveX64Temporary(pParseInfo);
+		this->GetLeftOperand()->annotate_X64_shared(pParseInfo);
+		CompilerReleaseX64Temporary(pParseInfo);
+		pParseInfo->st_instruction_storage_size	+=	2*CompilerSizeOfSSE2_SD_XMM_FRAME();
+		pParseInfo->i_instruction_count			+=	2;
+	}
+}
+
+void calculus::binary_operators::binary_operator::to_X64_vector_arithmetic(PCT_INFO pInfo,byte_type code,bool b_commutative)
+//THE PACKED COUNTERPART OF to_X64_arithmetic(), TEMPORARIES ARE ONE VECTOR WIDE
+{
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	bool bStack = ((typeid(*this->GetLeftOperand()) == typeid(calculus::variable)) || (typeid(*this->GetLeftOperand()) == typeid(calculus::constant))) && IsUsingDisorderedOptimizations();
+	if (bFlip) {
+		this->GetLeftOperand()->to_X64_vector(pInfo);
+		this->GetRightOperand()->to_X64_vector_operand(pInfo,code,REG_XMM(0));
+	}
+	else if (bStack) {
+		this->GetRightOperand()->to_X64_vector(pInfo);
+		if (b_commutative)
+			this->GetLeftOperand()->to_X64_vector_operand(pInfo,code,REG_XMM(0));
+		else {
+			CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_MOVAPD,REG_XMM(1),REG_XMM(0),REG_XMM(0));
+			this->GetLeftOperand()->to_X64_vector_operand(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0));
+			CompilerWriteVECTOR_PD_VEC_VEC(pInfo,code,REG_XMM(0),REG_XMM(0),REG_XMM(1));
+		}
+	}
+	else {
+		int i_width = CompilerVectorWidth(pInfo->i_vector_isa);
+		this->GetRightOperand()->to_X64_vector(pInfo);
+		int iTemp = CompilerPushX64Temporary(pInfo,i_width);
+		CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_STORE,REG_XMM(0),REG_XMM(0),iTemp);
+		this->GetLeftOperand()->to_X64_vector(pInfo);
+		CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,code,REG_XMM(0),REG_XMM(0),iTemp);
+		CompilerPopX64Temporary(pInfo,i_width);
+	}
+}
+
+void calculus::binary_operators::binary_operator::annotate_X64_vector_arithmetic(PPT_INFO pParseInfo,bool b_commutative)
+{
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	bool bStack = ((typeid(*this->GetLeftOperand()) == typeid(calculus::variable)) || (typeid(*this->GetLeftOperand()) == typeid(calculus::constant))) && IsUsingDisorderedOptimizations();
+	pParseInfo->i_operator_count++;
+	if (bFlip) {
+		this->GetLeftOperand()->annotate_X64_vector(pParseInfo);
+		this->GetRightOperand()->annotate_X64_vector_operand(pParseInfo);
+	}
+	else if (bStack) {
+		this->GetRightOperand()->annotate_X64_vector(pParseInfo);
+		this->GetLeftOperand()->annotate_X64_vector_operand(pParseInfo);
+		if (!b_commutative) {
+			pParseInfo->st_instruction_storage_size	+=	2*CompilerSizeOfVECTOR_PD_VEC_VEC(pParseInfo);
+			pParseInfo->i_instruction_count			+=	2;
+		}
+	}
+	else {
+		int i_width = CompilerVectorWidth(pParseInfo->i_vector_isa);
+		this->GetRightOperand()->annotate_X64_vector(pParseInfo);
+		CompilerReserveX64Temporary(pParseInfo,i_width);
+		this->GetLeftOperand()->annotate_X64_vector(pParseInfo);
+		CompilerReleaseX64Temporary(pParseInfo,i_width);
+		pParseInfo->st_instruction_storage_size	+=	2*CompilerSizeOfVECTOR_PD_VEC_FRAME(pParseInfo);
+		pParseInfo->i_instruction_count			+=	2;
+	}
+}
+
+void calculus::binary_operators::binary_operator::eval_binary_batch_callback(calculus::binary_operators::binary_operator * pbo_operator,double* pd_a,const double* pd_b,size_t st_n)
+{
+	pbo_operator->eval_binary_batch(pd_a,pd_b,st_n);
+}
+
+void calculus::binary_operators::binary_operator::to_X64_vector(PCT_INFO pInfo)
+//THE DEFAULT BATCH ENCODING EVALUATES BOTH OPERANDS NATIVELY AND CALLS BACK INTO eval_binary_batch() FOR THEIR W LANES
+/*
+	LEFT OPERAND
+VMOVUPD	[rbp-a],v0
+	RIGHT OPERAND
+VMOVUPD	[rbp-b],v0
+MOV		rdi,this
+LEA		rsi,[rbp-a]
+LEA		rdx,[rbp-b]
+MOV		ecx,W
+VZEROUPPER
+MOV		rax,binary_operator::eval_binary_batch_callback
+CALL	rax
+VMOVUPD	v0,[rbp-a]
+*/
+{
+	int i_width = CompilerVectorWidth(pInfo->i_vector_isa);
+	this->GetLeftOperand()->to_X64_vector(pInfo);
+	int iLeft = CompilerPushX64Temporary(pInfo,i_width);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_STORE,REG_XMM(0),REG_XMM(0),iLeft);
+	this->GetRightOperand()->to_X64_vector(pInfo);
+	int iRight = CompilerPushX64Temporary(pInfo,i_width);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_STORE,REG_XMM(0),REG_XMM(0),iRight);
+	CompilerWriteX64ThisArgument(pInfo,this);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,iLeft);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_EDX);
+		CompilerWriteINT32(pInfo,iRight);
+	CompilerWriteMOV_EXX_IMM32(pInfo,REG_ECX);
+		CompilerWriteINT32(pInfo,i_width);
+	CompilerWriteX64VectorCALL_IMM64(pInfo,(void*)calculus::binary_operators::binary_operator::eval_binary_batch_callback);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0),REG_XMM(0),iLeft);
+	CompilerPopX64Temporary(pInfo,2*i_width);
+}
+
+void calculus::binary_operators::binary_operator::annotate_X64_vector(PPT_INFO pParseInfo)
+{
+	int i_width = CompilerVectorWidth(pParseInfo->i_vector_isa);
+	this->GetLeftOperand()->annotate_X64_vector(pParseInfo);
+	CompilerReserveX64Temporary(pParseInfo,i_width);
+	this->GetRightOperand()->annotate_X64_vector(pParseInfo);
+	CompilerReserveX64Temporary(pParseInfo,i_width);
+	CompilerReleaseX64Temporary(pParseInfo,2*i_width);
+	pParseInfo->st_instruction_storage_size	+=	3*CompilerSizeOfVECTOR_PD_VEC_FRAME(pParseInfo)
+											+	CompilerSizeOfX64ThisArgument()
+											+	2*CompilerSizeOfLEA_RXX_RBPX_IMM32()
+											+	CompilerSizeOfMOV_EXX_IMM32()
+											+	3*CompilerSizeOfINT32()
+											+	CompilerSizeOfX64VectorCALL_IMM64();
+	pParseInfo->i_instruction_count			+=	9;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size				+=	2;
+}
+
+void calculus::binary_operators::binary_operator::to_tape(calculus::tape* pTape)
+{
+	this->GetLeftOperand()->to_tape(pTape);
+	this->GetRightOperand()->to_tape(pTape);
+	pTape->write_operator(TAPE_OP_BINARY,this);
+}
+
+qword_type calculus::binary_operators::binary_operator::structural_hash()
+{
+	qword_type qw_hash = StructuralHashCombine(typeid(*this).hash_code(),this->m_pao_left_operand->get_hash());
+	return StructuralHashCombine(qw_hash,this->m_pao_right_operand->get_hash());
+}
+
+bool calculus::binary_operators::binary_operator::structural_equal(calculus::algebraic_operator * pao_other)
+{
+	if (typeid(*this) != typeid(*pao_other))
+		return false;
+	binary_operator* pbo_other = static_cast<binary_operator*>(pao_other);
+	return this->m_pao_left_operand->equals(pbo_other->m_pao_left_operand)&&this->m_pao_right_operand->equals(pbo_other->m_pao_right_operand);
+}
+
+void calculus::binary_operators::binary_operator::eval_binary_derivatives(double x,double y,double* pd_x,double* pd_y)
+{
+	double h_x = TapeDifferenceStep(x);
+	double h_y = TapeDifferenceStep(y);
+	*pd_x = (eval_binary(x+h_x,y)-eval_binary(x-h_x,y))/(2*h_x);
+	*pd_y = (eval_binary(x,y+h_y)-eval_binary(x,y-h_y))/(2*h_y);
+}
+
+void calculus::binary_operators::binary_operator::eval_binary_second_derivatives(double x,double y,double* pd_xx,double* pd_xy,double* pd_yy)
+{
+	double h_x = TapeDifferenceStep(x);
+	double h_y = TapeDifferenceStep(y);
+	double d_forward_x,d_forward_y,d_backward_x,d_backward_y;
+	eval_binary_derivatives(x+h_x,y,&d_forward_x,&d_forward_y);
+	eval_binary_derivatives(x-h_x,y,&d_backward_x,&d_backward_y);
+	*pd_xx = (d_forward_x-d_backward_x)/(2*h_x);
+	eval_binary_derivatives(x,y+h_y,&d_forward_x,&d_forward_y);
+	eval_binary_derivatives(x,y-h_y,&d_backward_x,&d_backward_y);
+	*pd_xy = (d_forward_x-d_backward_x)/(2*h_y);
+	*pd_yy = (d_forward_y-d_backward_y)/(2*h_y);
+}
@@ -0,0 +1,373 @@
+/*
+
+CCODEARENA.CPP: IMPLEMENTS calculus::code_arena
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+calculus::code_arena::PCODE_ARENA_CHUNK calculus::code_arena::s_p_first_chunk = NULL;
+size_t calculus::code_arena::s_st_page_size = 0;
+
+size_t calculus::code_arena::round_to_pages(size_t st_size) {
+	if (s_st_page_size == 0) {
+#ifdef _WIN32
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		s_st_page_size = si.dwPageSize;
+#else
+		s_st_page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	}
+	if (st_size == 0)
+		return s_st_page_size;
+	return (st_size + s_st_page_size - 1) & ~(s_st_page_size - 1);
+}
+
+calculus::code_arena::PCODE_ARENA_CHUNK calculus::code_arena::map_chunk(size_t st_size) {
+	st_size = round_to_pages(st_size);
+	//BOTH VIEWS MAP THE SAME PAGES, THE WRITE VIEW STARTS OUT INACCESSIBLE
+#ifdef _WIN32
+	HANDLE hSection = CreateFileMappingA(INVALID_HANDLE_VALUE,NULL,PAGE_EXECUTE_READWRITE,(DWORD)(((unsigned long long)st_size) >> 32),(DWORD)st_size,NULL);
+	if (hSection == NULL)
+		return NULL;
+	unsigned char * pv = (unsigned char*)MapViewOfFile(hSection,FILE_MAP_READ|FILE_MAP_EXECUTE,0,0,st_size);
+	unsigned char * pv_write = (unsigned char*)MapViewOfFile(hSection,FILE_MAP_WRITE,0,0,st_size);
+	CloseHandle(hSection);
+	DWORD dwOld;
+	if ((pv_write != NULL) && !VirtualProtect(pv_write,st_size,PAGE_NOACCESS,&dwOld)) {
+		UnmapViewOfFile(pv_write);
+		pv_write = NULL;
+	}
+	if ((pv == NULL) || (pv_write == NULL)) {
+		if (pv)
+			UnmapViewOfFile(pv);
+		if (pv_write)
+			UnmapViewOfFile(pv_write);
+		return NULL;
+	}
+#else
+#ifdef __linux__
+	int fd = memfd_create("calculus-code",MFD_CLOEXEC);
+#else
+	char sc_name[64];
+	sprintf(sc_name,"/calculus-code-%d-%p",(int)getpid(),(void*)&st_size);
+	int fd = shm_open(sc_name,O_RDWR|O_CREAT|O_EXCL,0600);
+	if (fd != -1)
+		shm_unlink(sc_name);
+#endif
+	if (fd == -1)
+		return NULL;
+	void * pvMap = MAP_FAILED;
+	void * pvWrite = MAP_FAILED;
+	if (ftruncate(fd,(off_t)st_size) == 0) {
+		pvMap = mmap(NULL,st_size,PROT_READ|PROT_EXEC,MAP_SHARED,fd,0);
+		pvWrite = mmap(NULL,st_size,PROT_NONE,MAP_SHARED,fd,0);
+	}
+	close(fd);
+	if ((pvMap == MAP_FAILED) || (pvWrite == MAP_FAILED)) {
+		if (pvMap != MAP_FAILED)
+			munmap(pvMap,st_size);
+		if (pvWrite != MAP_FAILED)
+			munmap(pvWrite,st_size);
+		return NULL;
+	}
+	unsigned char * pv = (unsigned char*)pvMap;
+	unsigned char * pv_write = (unsigned char*)pvWrite;
+#endif
+	PCODE_ARENA_CHUNK pChunk = (PCODE_ARENA_CHUNK)malloc(sizeof(CODE_ARENA_CHUNK));
+	pChunk->pv_base = pv;
+	pChunk->pv_write = pv_write;
+	pChunk->st_size = st_size;
+	pChunk->st_used = 0;
+	pChunk->i_open = 0;
+	pChunk->p_free = (PCODE_ARENA_EXTENT)malloc(sizeof(CODE_ARENA_EXTENT));
+	pChunk->p_free->st_offset = 0;
+	pChunk->p_free->st_size = st_size;
+	pChunk->p_free->p_next = NULL;
+	pChunk->p_next = s_p_first_chunk;
+	s_p_first_chunk = pChunk;
+	return pChunk;
+}
+
+void calculus::code_arena::unmap_chunk(PCODE_ARENA_CHUNK pChunk) {
+	PCODE_ARENA_CHUNK * ppLink = &s_p_first_chunk;
+	while(*ppLink != pChunk)
+		ppLink = &((*ppLink)->p_next);
+	*ppLink = pChunk->p_next;
+	while(pChunk->p_free) {
+		PCODE_ARENA_EXTENT pNext = pChunk->p_free->p_next;
+		free(pChunk->p_free);
+		pChunk->p_free = pNext;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(pChunk->pv_write);
+	UnmapViewOfFile(pChunk->pv_base);
+#else
+	munmap(pChunk->pv_write,pChunk->st_size);
+	munmap(pChunk->pv_base,pChunk->st_size);
+#endif
+	free(pChunk);
+}
+
+calculus::code_arena::PCODE_ARENA_CHUNK calculus::code_arena::find_chunk(unsigned char * pv) {
+	for(PCODE_ARENA_CHUNK pChunk = s_p_first_chunk;pChunk;pChunk = pChunk->p_next)
+		if (((pv >= pChunk->pv_base) && (pv < pChunk->pv_base + pChunk->st_size))
+		||	((pv >= pChunk->pv_write) && (pv < pChunk->pv_write + pChunk->st_size)))
+			return pChunk;
+	return NULL;
+}
+
+bool calculus::code_arena::protect(unsigned char * pv,size_t st_size,bool b_writable) {
+	//ONLY THE WRITE VIEW CHANGES, THE EXECUTE VIEW KEEPS READ/EXECUTE FOR THE LIFE OF THE CHUNK
+	_ASSERT((((size_t)pv) & (s_st_page_size - 1)) == 0);
+#ifdef _WIN32
+	DWORD dwOld;
+	return (VirtualProtect(pv,round_to_pages(st_size),(b_writable)?PAGE_READWRITE:PAGE_NOACCESS,&dwOld) != 0);
+#else
+	return (mprotect(pv,round_to_pages(st_size),(b_writable)?(PROT_READ|PROT_WRITE):PROT_NONE) == 0);
+#endif
+}
+
+bool calculus::code_arena::close_slot(PCODE_ARENA_CHUNK pChunk) {
+	_ASSERT(pChunk->i_open > 0);	//NO SLOT OF THIS CHUNK WAS OPEN
+	if (--pChunk->i_open > 0)
+		return true;
+	return protect(pChunk->pv_write,pChunk->st_size,false);
+}
+
+unsigned char * calculus::code_arena::allocate(size_t st_size) {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	st_size = (st_size + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+	if (st_size == 0)
+		st_size = SLOT_ALIGNMENT;
+	//FIRST FIT OVER THE EXISTING CHUNKS, A NEW CHUNK IS MAPPED ONLY WHEN NONE HAS ROOM
+	PCODE_ARENA_CHUNK pChunk;
+	PCODE_ARENA_EXTENT * ppExtent = NULL;
+	for(pChunk = s_p_first_chunk;pChunk;pChunk = pChunk->p_next) {
+		for(ppExtent = &pChunk->p_free;*ppExtent;ppExtent = &((*ppExtent)->p_next))
+			if ((*ppExtent)->st_size >= st_size)
+				break;
+		if (*ppExtent)
+			break;
+	}
+	if (pChunk == NULL) {
+		pChunk = map_chunk((st_size > CHUNK_SIZE)?st_size:(size_t)CHUNK_SIZE);
+		if (pChunk == NULL)
+			return NULL;
+		ppExtent = &pChunk->p_free;
+	}
+	//THE FIRST OPEN SLOT OPENS THE WRITE VIEW OF ITS CHUNK
+	if ((pChunk->i_open == 0) && !protect(pChunk->pv_write,pChunk->st_size,true))
+		return NULL;
+	pChunk->i_open++;
+	PCODE_ARENA_EXTENT pExtent = *ppExtent;
+	unsigned char * pv = pChunk->pv_write + pExtent->st_offset;
+	pExtent->st_offset += st_size;
+	pExtent->st_size -= st_size;
+	if (pExtent->st_size == 0) {
+		*ppExtent = pExtent->p_next;
+		free(pExtent);
+	}
+	pChunk->st_used += st_size;
+	return pv;
+}
+
+bool calculus::code_arena::seal(PCOMPILER_HEADER pHead) {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	unsigned char * pv = pHead->pv_code_storage;
+	PCODE_ARENA_CHUNK pChunk = find_chunk(pv);
+	_ASSERT(pChunk && (pv >= pChunk->pv_write));	//THIS SLOT IS NOT OPEN
+	if ((pChunk == NULL) || (pv < pChunk->pv_write))
+		return false;
+	//THE PTR MAP HOLDS EVERY ABSOLUTE ADDRESS OF THE CODE, THE ONES INTO THE SLOT ARE MOVED TO THE EXECUTE VIEW
+	ptrdiff_t pd_delta = pChunk->pv_base - pChunk->pv_write;
+	unsigned char * pv_end = pv + pHead->st_code_size;
+	size_t st_num_pointers = (pHead->pv_global_storage - (unsigned char*)pHead->ppv_pmap)/sizeof(unsigned char*);
+	for(size_t i = 0;i < st_num_pointers;i++) {
+		unsigned char * pv_address;
+		memcpy(&pv_address,pHead->ppv_pmap[i],sizeof(pv_address));
+		if ((pv_address >= pv) && (pv_address < pv_end)) {
+			pv_address += pd_delta;
+			memcpy(pHead->ppv_pmap[i],&pv_address,sizeof(pv_address));
+		}
+		pHead->ppv_pmap[i] += pd_delta;
+	}
+	pHead->pInstructions = (FUNCTION)((unsigned char*)pHead->pInstructions + pd_delta);
+	pHead->pv_local_storage += pd_delta;
+	pHead->pv_code_storage += pd_delta;
+	return close_slot(pChunk);
+}
+
+void calculus::code_arena::release(unsigned char * pv,size_t st_size) {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	PCODE_ARENA_CHUNK pChunk = find_chunk(pv);
+	_ASSERT(pChunk);	//THIS SLOT WAS NOT ALLOCATED HERE
+	if (pChunk == NULL)
+		return;
+	//A SLOT RELEASED BEFORE IT WAS SEALED STILL HOLDS THE WRITE VIEW OPEN
+	if ((pv >= pChunk->pv_write) && (pv < pChunk->pv_write + pChunk->st_size)) {
+		pv = pChunk->pv_base + (pv - pChunk->pv_write);
+		close_slot(pChunk);
+	}
+	st_size = (st_size + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+	if (st_size == 0)
+		st_size = SLOT_ALIGNMENT;
+	size_t st_offset = pv - pChunk->pv_base;
+	//INSERT THE EXTENT IN ADDRESS ORDER AND COALESCE IT WITH ITS NEIGHBOURS
+	PCODE_ARENA_EXTENT pPrevious = NULL;
+	PCODE_ARENA_EXTENT pNext = pChunk->p_free;
+	while(pNext && (pNext->st_offset < st_offset)) {
+		pPrevious = pNext;
+		pNext = pNext->p_next;
+	}
+	if (pPrevious && (pPrevious->st_offset + pPrevious->st_size == st_offset)) {
+		pPrevious->st_size += st_size;
+		if (pNext && (pPrevious->st_offset + pPrevious->st_size == pNext->st_offset)) {
+			pPrevious->st_size += pNext->st_size;
+			pPrevious->p_next = pNext->p_next;
+			free(pNext);
+		}
+	}
+	else if (pNext && (st_offset + st_size == pNext->st_offset)) {
+		pNext->st_offset = st_offset;
+		pNext->st_size += st_size;
+	}
+	else {
+		PCODE_ARENA_EXTENT pExtent = (PCODE_ARENA_EXTENT)malloc(sizeof(CODE_ARENA_EXTENT));
+		pExtent->st_offset = st_offset;
+		pExtent->st_size = st_size;
+		pExtent->p_next = pNext;
+		if (pPrevious)
+			pPrevious->p_next = pExtent;
+		else pChunk->p_free = pExtent;
+	}
+	pChunk->st_used -= st_size;
+	//AN EMPTY CHUNK IS RETURNED TO THE SYSTEM UNLESS IT IS THE LAST ONE
+	if ((pChunk->st_used == 0) && ((pChunk != s_p_first_chunk) || (pChunk->p_next != NULL)))
+		unmap_chunk(pChunk);
+}
+
+void calculus::code_arena::free_all() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	while(s_p_first_chunk)
+		unmap_chunk(s_p_first_chunk);
+}
+
+size_t calculus::code_arena::get_mapped_size() {
+	size_t st_size = 0;
+	for(PCODE_ARENA_CHUNK pChunk = s_p_first_chunk;pChunk;pChunk = pChunk->p_next)
+		st_size += pChunk->st_size;
+	return st_size;
+}
+
+size_t calculus::code_arena::get_used_size() {
+	size_t st_size = 0;
+	for(PCODE_ARENA_CHUNK pChunk = s_p_first_chunk;pChunk;pChunk = pChunk->p_next)
+		st_size += pChunk->st_used;
+	return st_size;
+}
+
+int calculus::code_arena::get_chunk_count() {
+	int i_count = 0;
+	for(PCODE_ARENA_CHUNK pChunk = s_p_first_chunk;pChunk;pChunk = pChunk->p_next)
+		i_count++;
+	return i_count;
+}
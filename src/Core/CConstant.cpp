@@ -109,9 +109,14 @@ double calculus::constant::eval(double *pVars) {
 	return this->m_tValue;
 }
 
-int calculus::constant::to_string(char* pBuffer) {
-	char pB[32];
-	return sprintf((pBuffer)?pBuffer:pB,"%g",this->m_tValue);
+void calculus::constant::eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	UNREFERENCED_PARAMETER(ppd_columns);
+	for(size_t k = 0;k < st_n;k++)
+		pd_out[k] = this->m_tValue;
+}
+
+void calculus::constant::write_string(string_writer* psw) {
+	psw->print("%g",this->m_tValue);
 }
 
 void calculus::constant::to_IA32_binary(PCT_INFO pInfo) {
@@ -132,6 +137,49 @@ void calculus::constant::annotate(PPT_INFO pParseInfo) {
 	pParseInfo->st_pmap_size++;
 }
 
+void calculus::constant::to_X64_binary(PCT_INFO pInfo) {
+	this->to_X64_operand(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0));
+}
+
+void calculus::constant::annotate_X64(PPT_INFO pParseInfo) {
+	this->annotate_X64_operand(pParseInfo);
+}
+
+void calculus::constant::to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x) {
+	CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,code,x,this->m_tValue);
+}
+
+void calculus::constant::annotate_X64_operand(PPT_INFO pParseInfo) {
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_CONSTANT();
+	pParseInfo->st_local_storage_size			+=	sizeof(double);
+	pParseInfo->i_instruction_count++;
+	pParseInfo->i_operator_count++;
+}
+
+void calculus::constant::to_X64_vector(PCT_INFO pInfo) {
+	this->to_X64_vector_operand(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0));
+}
+
+void calculus::constant::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->annotate_X64_vector_operand(pParseInfo);
+}
+
+void calculus::constant::to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x) {
+	_ASSERT((code != VECTOR_MOVUPD_LOAD) || (x == REG_XMM(0)));	//LOADS HAVE NO FIRST SOURCE
+	CompilerWriteVECTOR_PD_VEC_CONSTANT(pInfo,code,x,x,this->m_tValue);
+}
+
+void calculus::constant::annotate_X64_vector_operand(PPT_INFO pParseInfo) {
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+	pParseInfo->st_local_storage_size			+=	CompilerLocalSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+	pParseInfo->i_instruction_count++;
+	pParseInfo->i_operator_count++;
+}
+
+void calculus::constant::to_tape(calculus::tape* pTape) {
+	pTape->write_constant(this->m_tValue);
+}
+
 calculus::algebraic_operator* calculus::constant::partial_derivative(variable * pVar) {
 	UNREFERENCED_PARAMETER(pVar);
 	return calculus::_cst(0);
@@ -149,3 +197,16 @@ bool calculus::constant::is_function_of(variable* a) {
 	UNREFERENCED_PARAMETER(a);
 	return false;
 }
+
+qword_type calculus::constant::structural_hash() {
+	//CONSTANTS ARE SHARED BY THEIR BIT PATTERN, -0. AND 0. STAY DISTINCT
+	qword_type qw_bits;
+	memcpy(&qw_bits,&this->m_tValue,sizeof(qw_bits));
+	return StructuralHashCombine(typeid(*this).hash_code(),qw_bits);
+}
+
+bool calculus::constant::structural_equal(calculus::algebraic_operator * pao_other) {
+	if (typeid(*this) != typeid(*pao_other))
+		return false;
+	return !memcmp(&this->m_tValue,&static_cast<calculus::constant*>(pao_other)->m_tValue,sizeof(this->m_tValue));
+}
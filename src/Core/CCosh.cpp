@@ -104,14 +104,23 @@ double calculus::unary_operators::hyperbolic_operators::cosh::eval_unary(double
 	return (double)::cosh(a);
 }
 
-int calculus::unary_operators::hyperbolic_operators::cosh::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"cosh(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::hyperbolic_operators::cosh::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = cosh::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::hyperbolic_operators::cosh::eval_unary_derivative(double a) {
+	return (double)::sinh(a);
+}
+
+double calculus::unary_operators::hyperbolic_operators::cosh::eval_unary_second_derivative(double a) {
+	return (double)::cosh(a);
+}
+
+void calculus::unary_operators::hyperbolic_operators::cosh::write_string(string_writer* psw) {
+	psw->write("cosh(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FSTP	qword_type PTR[ebp-10 = esp]
@@ -149,6 +158,26 @@ void calculus::unary_operators::hyperbolic_operators::cosh::annotate(PPT_INFO pP
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,cosh
+CALL	rax
+*/
+
+void calculus::unary_operators::hyperbolic_operators::cosh::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* pcosh)(double) = ::cosh;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)pcosh);
+}
+
+void calculus::unary_operators::hyperbolic_operators::cosh::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::hyperbolic_operators::cosh::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
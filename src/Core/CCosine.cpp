@@ -102,14 +102,23 @@ double calculus::unary_operators::trigonometric_operators::cosine::eval_unary(do
 	return (double)::cos(a);
 }
 
-int calculus::unary_operators::trigonometric_operators::cosine::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"cos(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::trigonometric_operators::cosine::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = cosine::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::trigonometric_operators::cosine::eval_unary_derivative(double a) {
+	return -(double)::sin(a);
+}
+
+double calculus::unary_operators::trigonometric_operators::cosine::eval_unary_second_derivative(double a) {
+	return -(double)::cos(a);
+}
+
+void calculus::unary_operators::trigonometric_operators::cosine::write_string(string_writer* psw) {
+	psw->write("cos(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::unary_operators::trigonometric_operators::cosine::to_IA32_binary(PCT_INFO pInfo) {
@@ -124,6 +133,26 @@ void calculus::unary_operators::trigonometric_operators::cosine::annotate(PPT_IN
 	pParseInfo->i_operator_count++;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,cos
+CALL	rax
+*/
+
+void calculus::unary_operators::trigonometric_operators::cosine::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* pcos)(double) = ::cos;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)pcos);
+}
+
+void calculus::unary_operators::trigonometric_operators::cosine::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::trigonometric_operators::cosine::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -128,17 +128,12 @@ calculus::unary_operators::derivative_operators::derivative_operator::~derivativ
 		m_pv_derivative_var->release();
 }
 
-int calculus::unary_operators::derivative_operators::derivative_operator::to_string(char* pBuffer) {
-	if (!pBuffer) {
-		char pB[32];
-		return sprintf(pB,"_d%up%c(",this->m_i_num_coefficients,(this->m_lMode&LMODE_CENTERED)?'c':(this->m_lMode&LMODE_BACKWARD)?'b':'f')+2+this->get_operand()->to_string(NULL)+this->get_partial_derivative_variable()->to_string(NULL);
-	}
-	int iOffset = sprintf(pBuffer,"_d%up%c(",this->m_i_num_coefficients,(this->m_lMode&LMODE_CENTERED)?'c':(this->m_lMode&LMODE_BACKWARD)?'b':'f');
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+(iOffset++),",");
-	iOffset += this->get_partial_derivative_variable()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+(iOffset++),")");
-	return iOffset;
+void calculus::unary_operators::derivative_operators::derivative_operator::write_string(string_writer* psw) {
+	psw->print("_d%up%c(",this->m_i_num_coefficients,(this->m_lMode&LMODE_CENTERED)?'c':(this->m_lMode&LMODE_BACKWARD)?'b':'f');
+	this->get_operand()->write_string(psw);
+	psw->write(',');
+	this->get_partial_derivative_variable()->write_string(psw);
+	psw->write(')');
 }
 
 double calculus::unary_operators::derivative_operators::derivative_operator::eval(double* pVars) {
@@ -159,10 +154,30 @@ double calculus::unary_operators::derivative_operators::derivative_operator::eva
 	return retVal;
 }
 
+void calculus::unary_operators::derivative_operators::derivative_operator::eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	//THE DIFFERENCE FORMULAE SHIFT THE POINT, SO THIS IS EVALUATED ONE POINT AT A TIME
+	calculus::algebraic_operator::eval_batch(ppd_columns,st_n,pd_out);
+}
+
 calculus::variable * calculus::unary_operators::derivative_operators::derivative_operator::get_partial_derivative_variable() {
 	return m_pv_derivative_var;
 }
 
+qword_type calculus::unary_operators::derivative_operators::derivative_operator::structural_hash() {
+	//THE TYPE FIXES THE COEFFICIENTS AND THE MODE
+	qword_type qw_hash = unary_operator::structural_hash();
+	return (m_pv_derivative_var)?StructuralHashCombine(qw_hash,m_pv_derivative_var->get_hash()):qw_hash;
+}
+
+bool calculus::unary_operators::derivative_operators::derivative_operator::structural_equal(calculus::algebraic_operator * pao_other) {
+	if (!unary_operator::structural_equal(pao_other))
+		return false;
+	variable* pv_other = static_cast<derivative_operator*>(pao_other)->m_pv_derivative_var;
+	if (!m_pv_derivative_var || !pv_other)
+		return m_pv_derivative_var == pv_other;
+	return m_pv_derivative_var->equals(pv_other);
+}
+
 int calculus::unary_operators::derivative_operators::derivative_operator::get_number_of_coefficients() {
 	return m_i_num_coefficients;
 }
@@ -174,3 +189,16 @@ void calculus::unary_operators::derivative_operators::derivative_operator::to_IA
 void calculus::unary_operators::derivative_operators::derivative_operator::annotate(PPT_INFO pParseInfo) {
 	UNREFERENCED_PARAMETER(pParseInfo);
 }
+
+void calculus::unary_operators::derivative_operators::derivative_operator::to_X64_vector(PCT_INFO pInfo) {
+	//THE STENCIL NEEDS THE WHOLE POINT, SO THE OPERAND CAN'T BE EVALUATED ON ITS OWN
+	calculus::algebraic_operator::to_X64_vector(pInfo);
+}
+
+void calculus::unary_operators::derivative_operators::derivative_operator::annotate_X64_vector(PPT_INFO pParseInfo) {
+	calculus::algebraic_operator::annotate_X64_vector(pParseInfo);
+}
+
+void calculus::unary_operators::derivative_operators::derivative_operator::to_tape(calculus::tape* pTape) {
+	calculus::algebraic_operator::to_tape(pTape);
+}
@@ -105,14 +105,25 @@ double calculus::unary_operators::intrinsic_operators::exponential::eval_unary(d
 	return (double)pexp(a);
 }
 
-int calculus::unary_operators::intrinsic_operators::exponential::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"exp(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::intrinsic_operators::exponential::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = exponential::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::intrinsic_operators::exponential::eval_unary_derivative(double a) {
+	double (__cdecl* pexp)(double) = ::exp;
+	return (double)pexp(a);
+}
+
+double calculus::unary_operators::intrinsic_operators::exponential::eval_unary_second_derivative(double a) {
+	double (__cdecl* pexp)(double) = ::exp;
+	return (double)pexp(a);
+}
+
+void calculus::unary_operators::intrinsic_operators::exponential::write_string(string_writer* psw) {
+	psw->write("exp(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FSTP	qword_type PTR[ebp-10 = esp]
@@ -150,6 +161,26 @@ void calculus::unary_operators::intrinsic_operators::exponential::annotate(PPT_I
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,exp
+CALL	rax
+*/
+
+void calculus::unary_operators::intrinsic_operators::exponential::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* pexp)(double) = ::exp;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)pexp);
+}
+
+void calculus::unary_operators::intrinsic_operators::exponential::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::exponential::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0.0);
@@ -104,16 +104,37 @@ double calculus::binary_operators::intrinsic_operators::exponentiation::eval_bin
 	return (double)::pow(a,b);
 }
 
-int calculus::binary_operators::intrinsic_operators::exponentiation::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 3+this->GetLeftOperand()->to_string(NULL)+this->GetRightOperand()->to_string(NULL);
-	int iOffset = 1;
-	strcpy(pBuffer,"(");
-	iOffset += this->GetLeftOperand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,"^");
-	iOffset += this->GetRightOperand()->to_string(pBuffer+(++iOffset));
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::binary_operators::intrinsic_operators::exponentiation::eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd_a[i] = exponentiation::eval_binary(pd_a[i],pd_b[i]);
+}
+
+void calculus::binary_operators::intrinsic_operators::exponentiation::eval_binary_derivatives(double x,double y,double* pd_x,double* pd_y) {
+	double d_pow = (double)::pow(x,y);
+	*pd_x = (y == 0)?0:y*(double)::pow(x,y-1);
+	//THE y PARTIAL ONLY EXISTS FOR A POSITIVE BASE
+	*pd_y = (x > 0)?d_pow*(double)::log(x):0;
+}
+
+void calculus::binary_operators::intrinsic_operators::exponentiation::eval_binary_second_derivatives(double x,double y,double* pd_xx,double* pd_xy,double* pd_yy) {
+	*pd_xx = ((y == 0)||(y == 1))?0:y*(y-1)*(double)::pow(x,y-2);
+	//AS FOR THE FIRST PARTIALS, THE y PARTIALS ONLY EXIST FOR A POSITIVE BASE
+	if (x > 0) {
+		double d_log = (double)::log(x);
+		*pd_xy = (double)::pow(x,y-1)*(1+y*d_log);
+		*pd_yy = (double)::pow(x,y)*d_log*d_log;
+	} else {
+		*pd_xy = 0;
+		*pd_yy = 0;
+	}
+}
+
+void calculus::binary_operators::intrinsic_operators::exponentiation::write_string(string_writer* psw) {
+	psw->write('(');
+	this->GetLeftOperand()->write_string(psw);
+	psw->write('^');
+	this->GetRightOperand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::binary_operators::intrinsic_operators::exponentiation::to_IA32_binary(PCT_INFO pInfo) {
@@ -152,6 +173,53 @@ void calculus::binary_operators::intrinsic_operators::exponentiation::annotate(P
 	this->GetLeftOperand()->annotate(pParseInfo);
 }
 
+/*
+	RIGHT OPERAND OPCODE
+MOVSD	qword PTR[rbp-d],xmm0
+	LEFT OPERAND OPCODE
+MOVSD	xmm1,qword PTR[rbp-d]			OR MOVSD xmm1,RIGHT OPERAND WHEN IT IS A VARIABLE OR A CONSTANT
+MOV		rax,pow
+CALL	rax
+*/
+
+void calculus::binary_operators::intrinsic_operators::exponentiation::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* ppow)(double,double) = ::pow;
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	if (bFlip) {
+		this->GetLeftOperand()->to_X64_shared(pInfo);
+		this->GetRightOperand()->to_X64_operand(pInfo,SSE2_MOVSD_LOAD,REG_XMM(1));
+	}
+	else {
+		this->GetRightOperand()->to_X64_shared(pInfo);
+		int iTemp = CompilerPushX64Temporary(pInfo);
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),iTemp);
+		this->GetLeftOperand()->to_X64_shared(pInfo);
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_LOAD,REG_XMM(1),iTemp);
+		CompilerPopX64Temporary(pInfo);
+	}
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)ppow);
+}
+
+void calculus::binary_operators::intrinsic_operators::exponentiation::annotate_X64(PPT_INFO pParseInfo) {
+	bool bFlip = ((typeid(*this->GetRightOperand()) == typeid(calculus::variable)) || (typeid(*this->GetRightOperand()) == typeid(calculus::constant))) && IsUsingFlipOptimizations();
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+	if (bFlip) {
+		this->GetLeftOperand()->annotate_X64_shared(pParseInfo);
+		this->GetRightOperand()->annotate_X64_operand(pParseInfo);
+	}
+	else {
+		this->GetRightOperand()->annotate_X64_shared(pParseInfo);
+		CompilerReserveX64Temporary(pParseInfo);
+		this->GetLeftOperand()->annotate_X64_shared(pParseInfo);
+		CompilerReleaseX64Temporary(pParseInfo);
+		pParseInfo->st_instruction_storage_size	+=	2*CompilerSizeOfSSE2_SD_XMM_FRAME();
+		pParseInfo->i_instruction_count			+=	2;
+	}
+}
+
 calculus::algebraic_operator* calculus::binary_operators::intrinsic_operators::exponentiation::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0.0);
@@ -168,7 +236,11 @@ calculus::algebraic_operator* calculus::binary_operators::intrinsic_operators::e
 	{
 		using namespace calculus::binary_operators::intrinsic_operators;
 		using namespace calculus::unary_operators::intrinsic_operators;
-		pD = _multiply(_multiply(pOpDR,_pow(this->GetLeftOperand(),this->GetRightOperand())),_divide(_log(this->GetLeftOperand()),_log(this->GetRightOperand())));
+		//d(L^R) = R*L^(R-1)*dL + L^R*ln(L)*dR
+		calculus::algebraic_operator* pL = this->GetLeftOperand();
+		calculus::algebraic_operator* pR = this->GetRightOperand();
+		pD = _add(_multiply(_multiply(pR,_pow(pL,_subtract(pR,_cst(1.0)))),pOpDL),
+				  _multiply(_multiply(this,_log(pL)),pOpDR));
 	}
 	if (pOpDL)
 		pOpDL->release();
@@ -184,28 +256,15 @@ calculus::algebraic_operator * calculus::binary_operators::intrinsic_operators::
 	arg2->addref();
 	calculus::algebraic_operator * pRet = NULL;
 	if (calculus::binary_operators::binary_operator::IsUsingConstantOptimizations()) {
-		char * pBuffer =  new char[arg1->to_string(NULL)];
-		arg1->to_string(pBuffer);
-		if (strcmp(pBuffer,"0.")) {
-			if (strcmp(pBuffer,"1.")) {
-				arg2->to_string(pBuffer);
-				if (strcmp(pBuffer,"0.")) {
-					if (strcmp(pBuffer,"1.")) {
-						pRet = calculus::binary_operators::intrinsic_operators::exponentiation::create(arg1,arg2);
-					}
-					else
-						pRet = arg1->create_copy();
-				}
-				else
-					pRet = calculus::_cst(1.0);
-
-			}
-			else
-				pRet = calculus::_cst(1.0);
-		}
+		//x^0 = 1, x^1 = x AND 1^x = 1, THE CONSTANTS ARE COMPARED BY VALUE
+		if ((typeid(*arg2) == typeid(calculus::constant))&&(static_cast<calculus::constant*>(arg2)->GetValue() == 0))
+			pRet = calculus::_cst(1.0);
+		else if ((typeid(*arg2) == typeid(calculus::constant))&&(static_cast<calculus::constant*>(arg2)->GetValue() == 1))
+			pRet = arg1->create_copy();
+		else if ((typeid(*arg1) == typeid(calculus::constant))&&(static_cast<calculus::constant*>(arg1)->GetValue() == 1))
+			pRet = calculus::_cst(1.0);
 		else
-			pRet = calculus::_cst(0.0);
-        delete [] pBuffer;
+			pRet = calculus::binary_operators::intrinsic_operators::exponentiation::create(arg1,arg2);
 	}
 	else
 		pRet = calculus::binary_operators::intrinsic_operators::exponentiation::create(arg1,arg2);
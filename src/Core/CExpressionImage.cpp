@@ -0,0 +1,633 @@
+/*
+
+CEXPRESSIONIMAGE.CPP: 
+IMPLEMENTS calculus::expression_image AND calculus::expression_view
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#include <stdio.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//THE CONSTANT POOL STARTS WITH THIS MANY BUCKETS AND DOUBLES WHEN HALF FULL
+#define EXPRESSION_IMAGE_CONSTANT_TABLE_SIZE	0x100u
+
+static int ExpressionStackDelta(unsigned int ui_opcode) {
+	switch(ui_opcode) {
+	case EXPRESSION_OP_VARIABLE :
+	case EXPRESSION_OP_CONSTANT :
+		return 1;
+	case EXPRESSION_OP_ADD :
+	case EXPRESSION_OP_SUBTRACT :
+	case EXPRESSION_OP_MULTIPLY :
+	case EXPRESSION_OP_DIVIDE :
+	case EXPRESSION_OP_POW :
+		return -1;
+	default :
+		return 0;
+	}
+}
+
+//THE OPCODE OF AN OPERATOR CALLED BACK BY A TAPE, -1 WHEN THE FORMAT HAS NONE
+static int ExpressionOpcode(void * pv_operator,int * pi_arg) {
+	using namespace calculus::unary_operators;
+	calculus::algebraic_operator * pao = (calculus::algebraic_operator*)pv_operator;
+	const std::type_info & ti = typeid(*pao);
+	*pi_arg = 0;
+	if (ti == typeid(intrinsic_operators::exponential))			return EXPRESSION_OP_EXP;
+	if (ti == typeid(intrinsic_operators::ln))					return EXPRESSION_OP_LN;
+	if (ti == typeid(intrinsic_operators::log))					return EXPRESSION_OP_LOG10;
+	if (ti == typeid(trigonometric_operators::sine))			return EXPRESSION_OP_SIN;
+	if (ti == typeid(trigonometric_operators::cosine))			return EXPRESSION_OP_COS;
+	if (ti == typeid(trigonometric_operators::tangent))			return EXPRESSION_OP_TAN;
+	if (ti == typeid(trigonometric_operators::arcsine))			return EXPRESSION_OP_ASIN;
+	if (ti == typeid(trigonometric_operators::arccosine))		return EXPRESSION_OP_ACOS;
+	if (ti == typeid(trigonometric_operators::arctangent))		return EXPRESSION_OP_ATAN;
+	if (ti == typeid(hyperbolic_operators::sinh))				return EXPRESSION_OP_SINH;
+	if (ti == typeid(hyperbolic_operators::cosh))				return EXPRESSION_OP_COSH;
+	if (ti == typeid(hyperbolic_operators::tanh))				return EXPRESSION_OP_TANH;
+	if (ti == typeid(bessel_operators::bessel_j0))				return EXPRESSION_OP_J0;
+	if (ti == typeid(bessel_operators::bessel_j1))				return EXPRESSION_OP_J1;
+	if (ti == typeid(bessel_operators::bessel_y0))				return EXPRESSION_OP_Y0;
+	if (ti == typeid(bessel_operators::bessel_y1))				return EXPRESSION_OP_Y1;
+	if (ti == typeid(bessel_operators::bessel_jn)) {
+		*pi_arg = (int)((bessel_operators::bessel_jn*)pao)->GetBesselIndex();
+		return EXPRESSION_OP_JN;
+	}
+	if (ti == typeid(bessel_operators::bessel_yn)) {
+		*pi_arg = (int)((bessel_operators::bessel_yn*)pao)->GetBesselIndex();
+		return EXPRESSION_OP_YN;
+	}
+	if (ti == typeid(calculus::binary_operators::intrinsic_operators::exponentiation))
+		return EXPRESSION_OP_POW;
+	return -1;
+}
+
+template <class T> static bool ReserveImageArray(T ** ppt,size_t * pst_capacity,size_t st_needed) {
+	if (st_needed <= *pst_capacity)
+		return true;
+	size_t st_capacity = (*pst_capacity)?2*(*pst_capacity):16;
+	if (st_capacity < st_needed)
+		st_capacity = st_needed;
+	T * pt = (T*)realloc(*ppt,st_capacity*sizeof(T));
+	if (pt == NULL)
+		return false;
+	*ppt = pt;
+	*pst_capacity = st_capacity;
+	return true;
+}
+
+//THE SECTIONS OF AN IMAGE WHILE THEY ARE WRITTEN
+typedef struct EXPRESSION_WRITER {
+	PEXPRESSION_IMAGE_ENTRY		pe_entries;
+	PEXPRESSION_IMAGE_NODE		pn_nodes;
+	size_t						st_num_nodes,st_node_capacity;
+	double*						pd_constants;
+	size_t						st_num_constants,st_constant_capacity;
+	int*						pi_constant_table;		//Index of the constant in every bucket, -1 when empty
+	size_t						st_constant_table_size;
+	unsigned int*				pui_arguments;
+	size_t						st_num_arguments,st_argument_capacity;
+	int*						pi_name_of_id;			//Index of the name of every variable id, -1 when it has none yet
+	int							i_num_ids;
+	unsigned int*				pui_name_offsets;
+	size_t						st_num_names,st_name_offset_capacity;
+	char*						psc_names;
+	size_t						st_name_size,st_name_capacity;
+} EXPRESSION_WRITER,*PEXPRESSION_WRITER;
+
+static size_t HashConstant(qword_type qw_bits,size_t st_table_size) {
+	return (size_t)((qw_bits*(qword_type)0x9E3779B97F4A7C15ull) >> 32) & (st_table_size - 1);
+}
+
+//CONSTANTS ARE POOLED BY THEIR BIT PATTERN, SO 0 AND -0 STAY APART
+static int PoolConstant(PEXPRESSION_WRITER pWriter,double d_value) {
+	qword_type qw_bits;
+	memcpy(&qw_bits,&d_value,sizeof(qw_bits));
+	if (2*(pWriter->st_num_constants + 1) > pWriter->st_constant_table_size) {
+		size_t st_table_size = (pWriter->st_constant_table_size)?2*pWriter->st_constant_table_size:EXPRESSION_IMAGE_CONSTANT_TABLE_SIZE;
+		int * pi_table = (int*)malloc(st_table_size*sizeof(int));
+		if (pi_table == NULL)
+			return -1;
+		memset(pi_table,0xff,st_table_size*sizeof(int));
+		for(size_t i = 0;i < pWriter->st_num_constants;i++) {
+			qword_type qw;
+			memcpy(&qw,pWriter->pd_constants + i,sizeof(qw));
+			size_t st_bucket = HashConstant(qw,st_table_size);
+			while (pi_table[st_bucket] >= 0)
+				st_bucket = (st_bucket + 1) & (st_table_size - 1);
+			pi_table[st_bucket] = (int)i;
+		}
+		if (pWriter->pi_constant_table)
+			free(pWriter->pi_constant_table);
+		pWriter->pi_constant_table = pi_table;
+		pWriter->st_constant_table_size = st_table_size;
+	}
+	size_t st_bucket = HashConstant(qw_bits,pWriter->st_constant_table_size);
+	for(;pWriter->pi_constant_table[st_bucket] >= 0;st_bucket = (st_bucket + 1) & (pWriter->st_constant_table_size - 1)) {
+		qword_type qw;
+		memcpy(&qw,pWriter->pd_constants + pWriter->pi_constant_table[st_bucket],sizeof(qw));
+		if (qw == qw_bits)
+			return pWriter->pi_constant_table[st_bucket];
+	}
+	if (!ReserveImageArray(&pWriter->pd_constants,&pWriter->st_constant_capacity,pWriter->st_num_constants + 1))
+		return -1;
+	pWriter->pd_constants[pWriter->st_num_constants] = d_value;
+	pWriter->pi_constant_table[st_bucket] = (int)pWriter->st_num_constants;
+	return (int)pWriter->st_num_constants++;
+}
+
+static int NameVariable(PEXPRESSION_WRITER pWriter,calculus::variable * pVar) {
+	int i_id = pVar->get_id();
+	_ASSERT((i_id >= 0) && (i_id < pWriter->i_num_ids));
+	if (pWriter->pi_name_of_id[i_id] >= 0)
+		return pWriter->pi_name_of_id[i_id];
+	const char * psc_name = pVar->get_variable_name();
+	size_t st_length = strlen(psc_name) + 1;
+	if (!ReserveImageArray(&pWriter->pui_name_offsets,&pWriter->st_name_offset_capacity,pWriter->st_num_names + 1) ||
+		!ReserveImageArray(&pWriter->psc_names,&pWriter->st_name_capacity,pWriter->st_name_size + st_length))
+		return -1;
+	//THE OFFSETS ARE MOVED PAST THE OFFSET TABLE WHEN THE SECTION IS WRITTEN
+	pWriter->pui_name_offsets[pWriter->st_num_names] = (unsigned int)pWriter->st_name_size;
+	memcpy(pWriter->psc_names + pWriter->st_name_size,psc_name,st_length);
+	pWriter->st_name_size += st_length;
+	return (pWriter->pi_name_of_id[i_id] = (int)pWriter->st_num_names++);
+}
+
+static bool WriteExpression(PEXPRESSION_WRITER pWriter,calculus::algebraic_operator * pao,PEXPRESSION_IMAGE_ENTRY pEntry) {
+	memset(pEntry,0,sizeof(EXPRESSION_IMAGE_ENTRY));
+	pEntry->ui_first_node = (unsigned int)pWriter->st_num_nodes;
+	pEntry->ui_first_argument = (unsigned int)pWriter->st_num_arguments;
+	if (pao == NULL)
+		return true;
+	int i_num_vars = pao->get_number_of_variables();
+	calculus::variable ** ppv_vars = pao->get_variables();
+	if (!ReserveImageArray(&pWriter->pui_arguments,&pWriter->st_argument_capacity,pWriter->st_num_arguments + i_num_vars))
+		return false;
+	for(int i = 0;i < i_num_vars;i++) {
+		int i_name = NameVariable(pWriter,ppv_vars[i]);
+		if (i_name < 0)
+			return false;
+		pWriter->pui_arguments[pWriter->st_num_arguments++] = (unsigned int)i_name;
+	}
+	pEntry->ui_num_arguments = (unsigned int)i_num_vars;
+	//THE TAPE IS ALREADY POST-ORDER WITH ITS VARIABLES RESOLVED TO ARGUMENTS, ONLY ITS CALL BACKS ARE TRANSLATED
+	calculus::tape * pt = pao->get_tape();
+	int i_num_instructions = pt->get_instruction_count();
+	const TAPE_INSTRUCTION * pti = pt->get_instructions();
+	if (!ReserveImageArray(&pWriter->pn_nodes,&pWriter->st_node_capacity,pWriter->st_num_nodes + i_num_instructions))
+		return false;
+	PEXPRESSION_IMAGE_NODE pn = pWriter->pn_nodes + pWriter->st_num_nodes;
+	for(int j = 0;j < i_num_instructions;j++,pti++,pn++) {
+		pn->i_arg = pti->i_arg;
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :		pn->ui_opcode = EXPRESSION_OP_VARIABLE;		break;
+		case TAPE_OP_NEGATE :		pn->ui_opcode = EXPRESSION_OP_NEGATE;		break;
+		case TAPE_OP_SQRT :			pn->ui_opcode = EXPRESSION_OP_SQRT;			break;
+		case TAPE_OP_INT_POW :		pn->ui_opcode = EXPRESSION_OP_INT_POW;		break;
+		case TAPE_OP_ADD :			pn->ui_opcode = EXPRESSION_OP_ADD;			break;
+		case TAPE_OP_SUBTRACT :		pn->ui_opcode = EXPRESSION_OP_SUBTRACT;		break;
+		case TAPE_OP_MULTIPLY :		pn->ui_opcode = EXPRESSION_OP_MULTIPLY;		break;
+		case TAPE_OP_DIVIDE :		pn->ui_opcode = EXPRESSION_OP_DIVIDE;		break;
+		case TAPE_OP_CONSTANT :
+			pn->ui_opcode = EXPRESSION_OP_CONSTANT;
+			if ((pn->i_arg = PoolConstant(pWriter,pti->d_value)) < 0)
+				return false;
+			break;
+		case TAPE_OP_UNARY :
+		case TAPE_OP_BINARY : {
+			int i_opcode = ExpressionOpcode(pti->pv_operator,&pn->i_arg);
+			if ((i_opcode < 0) || (ExpressionStackDelta(i_opcode) != ((pti->i_opcode == TAPE_OP_BINARY)?-1:0)))
+				return false;
+			pn->ui_opcode = (unsigned int)i_opcode;
+			break;
+		}
+		default :
+			//TAPE_OP_CALL, THE OPERATOR CAN'T BE SAVED
+			return false;
+		}
+	}
+	pWriter->st_num_nodes += i_num_instructions;
+	pEntry->ui_num_nodes = (unsigned int)i_num_instructions;
+	pEntry->ui_max_depth = (unsigned int)pt->get_max_depth();
+	return true;
+}
+
+static void FreeExpressionWriter(PEXPRESSION_WRITER pWriter) {
+	free(pWriter->pe_entries);
+	free(pWriter->pn_nodes);
+	free(pWriter->pd_constants);
+	free(pWriter->pi_constant_table);
+	free(pWriter->pui_arguments);
+	free(pWriter->pi_name_of_id);
+	free(pWriter->pui_name_offsets);
+	free(pWriter->psc_names);
+}
+
+static size_t AlignExpressionOffset(size_t st_offset) {
+	return (st_offset + EXPRESSION_IMAGE_ALIGNMENT - 1) & ~((size_t)EXPRESSION_IMAGE_ALIGNMENT - 1);
+}
+
+//WRITES st_size BYTES AT st_offset, THE GAP FROM *pst_position IS ZERO FILLED
+static bool WriteImageSection(FILE * pFile,size_t * pst_position,size_t st_offset,const void * pv,size_t st_size) {
+	static const unsigned char s_puc_padding[EXPRESSION_IMAGE_ALIGNMENT] = {0};
+	_ASSERT(st_offset - *pst_position <= EXPRESSION_IMAGE_ALIGNMENT);
+	if (fwrite(s_puc_padding,1,st_offset - *pst_position,pFile) != st_offset - *pst_position)
+		return false;
+	if (st_size && (fwrite(pv,1,st_size,pFile) != st_size))
+		return false;
+	*pst_position = st_offset + st_size;
+	return true;
+}
+
+bool calculus::expression_image::save(const char * psc_path,calculus::algebraic_operator ** ppao_operators,int i_count)
+{
+	EXPRESSION_WRITER writer;
+	memset(&writer,0,sizeof(writer));
+	writer.i_num_ids = calculus::variable::get_count();
+	writer.pi_name_of_id = (int*)malloc((writer.i_num_ids + 1)*sizeof(int));
+	writer.pe_entries = (PEXPRESSION_IMAGE_ENTRY)malloc((i_count + 1)*sizeof(EXPRESSION_IMAGE_ENTRY));
+	bool b_written = (writer.pi_name_of_id != NULL) && (writer.pe_entries != NULL);
+	if (b_written)
+		memset(writer.pi_name_of_id,0xff,(writer.i_num_ids + 1)*sizeof(int));
+	for(int i = 0;b_written && (i < i_count);i++)
+		b_written = WriteExpression(&writer,ppao_operators[i],writer.pe_entries + i);
+	if (!b_written) {
+		FreeExpressionWriter(&writer);
+		return false;
+	}
+	size_t st_offset_table_size = writer.st_num_names*sizeof(unsigned int);
+	for(size_t i = 0;i < writer.st_num_names;i++)
+		writer.pui_name_offsets[i] += (unsigned int)st_offset_table_size;
+
+	EXPRESSION_IMAGE_HEADER header;
+	memset(&header,0,sizeof(header));
+	header.ui_magic				= EXPRESSION_IMAGE_MAGIC;
+	header.ui_version			= EXPRESSION_IMAGE_VERSION;
+	header.ui_num_expressions	= (unsigned int)i_count;
+	header.ui_num_nodes			= (unsigned int)writer.st_num_nodes;
+	header.ui_num_constants		= (unsigned int)writer.st_num_constants;
+	header.ui_num_arguments		= (unsigned int)writer.st_num_arguments;
+	header.ui_num_names			= (unsigned int)writer.st_num_names;
+	header.ui_name_size			= (unsigned int)(st_offset_table_size + writer.st_name_size);
+	header.qw_expression_offset	= AlignExpressionOffset(sizeof(header));
+	header.qw_node_offset		= AlignExpressionOffset((size_t)header.qw_expression_offset + i_count*sizeof(EXPRESSION_IMAGE_ENTRY));
+	header.qw_constant_offset	= AlignExpressionOffset((size_t)header.qw_node_offset + writer.st_num_nodes*sizeof(EXPRESSION_IMAGE_NODE));
+	header.qw_argument_offset	= AlignExpressionOffset((size_t)header.qw_constant_offset + writer.st_num_constants*sizeof(double));
+	header.qw_name_offset		= AlignExpressionOffset((size_t)header.qw_argument_offset + writer.st_num_arguments*sizeof(unsigned int));
+
+	FILE * pFile = fopen(psc_path,"wb");
+	size_t st_position = 0;
+	b_written = (pFile != NULL)
+		&& WriteImageSection(pFile,&st_position,0,&header,sizeof(header))
+		&& WriteImageSection(pFile,&st_position,(size_t)header.qw_expression_offset,writer.pe_entries,i_count*sizeof(EXPRESSION_IMAGE_ENTRY))
+		&& WriteImageSection(pFile,&st_position,(size_t)header.qw_node_offset,writer.pn_nodes,writer.st_num_nodes*sizeof(EXPRESSION_IMAGE_NODE))
+		&& WriteImageSection(pFile,&st_position,(size_t)header.qw_constant_offset,writer.pd_constants,writer.st_num_constants*sizeof(double))
+		&& WriteImageSection(pFile,&st_position,(size_t)header.qw_argument_offset,writer.pui_arguments,writer.st_num_arguments*sizeof(unsigned int))
+		&& WriteImageSection(pFile,&st_position,(size_t)header.qw_name_offset,writer.pui_name_offsets,st_offset_table_size)
+		&& WriteImageSection(pFile,&st_position,st_position,writer.psc_names,writer.st_name_size);
+	if (pFile)
+		b_written = (fclose(pFile) == 0) && b_written;
+	FreeExpressionWriter(&writer);
+	return b_written;
+}
+
+calculus::expression_image::expression_image(const unsigned char * pv_image,size_t st_size) {
+	m_pv_image = pv_image;
+	m_st_size = st_size;
+	m_i_count = 0;
+}
+
+calculus::expression_image::~expression_image() {
+#ifdef _WIN32
+	UnmapViewOfFile(m_pv_image);
+#else
+	munmap((void*)m_pv_image,m_st_size);
+#endif
+}
+
+//TRUE WHEN st_count ITEMS OF st_item BYTES AT qw_offset LIE IN THE IMAGE
+static bool IsImageSection(qword_type qw_offset,size_t st_count,size_t st_item,size_t st_size) {
+	if ((qw_offset % EXPRESSION_IMAGE_ALIGNMENT) || (qw_offset > st_size))
+		return false;
+	return st_count <= (st_size - (size_t)qw_offset)/st_item;
+}
+
+bool calculus::expression_image::is_valid() {
+	if (m_st_size < sizeof(EXPRESSION_IMAGE_HEADER))
+		return false;
+	const EXPRESSION_IMAGE_HEADER * pHeader = (const EXPRESSION_IMAGE_HEADER*)m_pv_image;
+	if ((pHeader->ui_magic != EXPRESSION_IMAGE_MAGIC) || (pHeader->ui_version != EXPRESSION_IMAGE_VERSION))
+		return false;
+	if ((pHeader->ui_num_expressions > 0x7fffffffu) ||
+		!IsImageSection(pHeader->qw_expression_offset,pHeader->ui_num_expressions,sizeof(EXPRESSION_IMAGE_ENTRY),m_st_size) ||
+		!IsImageSection(pHeader->qw_node_offset,pHeader->ui_num_nodes,sizeof(EXPRESSION_IMAGE_NODE),m_st_size) ||
+		!IsImageSection(pHeader->qw_constant_offset,pHeader->ui_num_constants,sizeof(double),m_st_size) ||
+		!IsImageSection(pHeader->qw_argument_offset,pHeader->ui_num_arguments,sizeof(unsigned int),m_st_size) ||
+		!IsImageSection(pHeader->qw_name_offset,pHeader->ui_name_size,1,m_st_size))
+		return false;
+	//EVERY NAME STARTS PAST THE OFFSET TABLE AND THE SECTION ENDS WITH A TERMINATOR
+	const unsigned int * pui_name_offsets = (const unsigned int*)(m_pv_image + pHeader->qw_name_offset);
+	size_t st_offset_table_size = (size_t)pHeader->ui_num_names*sizeof(unsigned int);
+	if (pHeader->ui_num_names && ((st_offset_table_size >= pHeader->ui_name_size) || m_pv_image[pHeader->qw_name_offset + pHeader->ui_name_size - 1]))
+		return false;
+	for(unsigned int i = 0;i < pHeader->ui_num_names;i++)
+		if ((pui_name_offsets[i] < st_offset_table_size) || (pui_name_offsets[i] >= pHeader->ui_name_size))
+			return false;
+	const unsigned int * pui_arguments = (const unsigned int*)(m_pv_image + pHeader->qw_argument_offset);
+	for(unsigned int i = 0;i < pHeader->ui_num_arguments;i++)
+		if (pui_arguments[i] >= pHeader->ui_num_names)
+			return false;
+	//REPLAY THE STACK OF EVERY EXPRESSION
+	const EXPRESSION_IMAGE_ENTRY * pEntries = (const EXPRESSION_IMAGE_ENTRY*)(m_pv_image + pHeader->qw_expression_offset);
+	const EXPRESSION_IMAGE_NODE * pNodes = (const EXPRESSION_IMAGE_NODE*)(m_pv_image + pHeader->qw_node_offset);
+	for(unsigned int i = 0;i < pHeader->ui_num_expressions;i++) {
+		const EXPRESSION_IMAGE_ENTRY * pEntry = pEntries + i;
+		if (((qword_type)pEntry->ui_first_node + pEntry->ui_num_nodes > pHeader->ui_num_nodes) ||
+			((qword_type)pEntry->ui_first_argument + pEntry->ui_num_arguments > pHeader->ui_num_arguments) ||
+			(pEntry->ui_max_depth > pEntry->ui_num_nodes))
+			return false;
+		unsigned int ui_depth = 0;
+		for(unsigned int j = 0;j < pEntry->ui_num_nodes;j++) {
+			const EXPRESSION_IMAGE_NODE * pn = pNodes + pEntry->ui_first_node + j;
+			if (pn->ui_opcode >= EXPRESSION_OP_COUNT)
+				return false;
+			if ((pn->ui_opcode == EXPRESSION_OP_VARIABLE) && ((pn->i_arg < 0) || ((unsigned int)pn->i_arg >= pEntry->ui_num_arguments)))
+				return false;
+			if ((pn->ui_opcode == EXPRESSION_OP_CONSTANT) && ((pn->i_arg < 0) || ((unsigned int)pn->i_arg >= pHeader->ui_num_constants)))
+				return false;
+			int i_delta = ExpressionStackDelta(pn->ui_opcode);
+			if (ui_depth < (unsigned int)(1 - i_delta))
+				return false;
+			ui_depth += i_delta;
+			if (ui_depth > pEntry->ui_max_depth)
+				return false;
+		}
+		if (pEntry->ui_num_nodes && (ui_depth != 1))
+			return false;
+	}
+	m_i_count = (int)pHeader->ui_num_expressions;
+	return true;
+}
+
+calculus::expression_image * calculus::expression_image::load(const char * psc_path)
+{
+	const unsigned char * pv_image = NULL;
+	size_t st_size = 0;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(psc_path,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile,&liSize) || (liSize.QuadPart == 0)) {
+		CloseHandle(hFile);
+		return NULL;
+	}
+	st_size = (size_t)liSize.QuadPart;
+	//THE VIEW OUTLIVES ITS HANDLES
+	HANDLE hMapping = CreateFileMappingA(hFile,NULL,PAGE_READONLY,0,0,NULL);
+	if (hMapping) {
+		pv_image = (const unsigned char*)MapViewOfFile(hMapping,FILE_MAP_READ,0,0,0);
+		CloseHandle(hMapping);
+	}
+	CloseHandle(hFile);
+	if (pv_image == NULL)
+		return NULL;
+#else
+	int iFile = open(psc_path,O_RDONLY);
+	if (iFile < 0)
+		return NULL;
+	struct stat statFile;
+	if ((fstat(iFile,&statFile) != 0) || (statFile.st_size == 0)) {
+		close(iFile);
+		return NULL;
+	}
+	st_size = (size_t)statFile.st_size;
+	void * pvMap = mmap(NULL,st_size,PROT_READ,MAP_PRIVATE,iFile,0);
+	close(iFile);
+	if (pvMap == MAP_FAILED)
+		return NULL;
+	pv_image = (const unsigned char*)pvMap;
+#endif
+	expression_image * pei = new expression_image(pv_image,st_size);
+	if (!pei->is_valid()) {
+		delete pei;
+		return NULL;
+	}
+	return pei;
+}
+
+calculus::expression_view calculus::expression_image::get_expression(int i)
+{
+	_ASSERT((i >= 0) && (i < m_i_count));
+	const EXPRESSION_IMAGE_HEADER * pHeader = (const EXPRESSION_IMAGE_HEADER*)m_pv_image;
+	const EXPRESSION_IMAGE_ENTRY * pEntry = (const EXPRESSION_IMAGE_ENTRY*)(m_pv_image + pHeader->qw_expression_offset) + i;
+	expression_view ev;
+	ev.m_pn_nodes = (const EXPRESSION_IMAGE_NODE*)(m_pv_image + pHeader->qw_node_offset) + pEntry->ui_first_node;
+	ev.m_i_num_nodes = (int)pEntry->ui_num_nodes;
+	ev.m_i_max_depth = (int)pEntry->ui_max_depth;
+	ev.m_pd_constants = (const double*)(m_pv_image + pHeader->qw_constant_offset);
+	ev.m_pui_arguments = (const unsigned int*)(m_pv_image + pHeader->qw_argument_offset) + pEntry->ui_first_argument;
+	ev.m_i_num_vars = (int)pEntry->ui_num_arguments;
+	ev.m_pui_name_offsets = (const unsigned int*)(m_pv_image + pHeader->qw_name_offset);
+	ev.m_psc_names = (const char*)(m_pv_image + pHeader->qw_name_offset);
+	return ev;
+}
+
+double calculus::expression_view::eval(const double * pVars)
+{
+	if (m_i_num_nodes == 0)
+		return 0;
+	double pd_local[TAPE_LOCAL_STACK_SIZE];
+	double * pd_stack = (m_i_max_depth > (int)TAPE_LOCAL_STACK_SIZE)?new double[m_i_max_depth]:pd_local;
+	double * pd_top = pd_stack - 1;
+	const EXPRESSION_IMAGE_NODE * pn = m_pn_nodes;
+	const EXPRESSION_IMAGE_NODE * pn_end = m_pn_nodes + m_i_num_nodes;
+	for(;pn < pn_end;pn++) {
+		switch(pn->ui_opcode) {
+		case EXPRESSION_OP_VARIABLE :	*(++pd_top) = pVars[pn->i_arg];					break;
+		case EXPRESSION_OP_CONSTANT :	*(++pd_top) = m_pd_constants[pn->i_arg];		break;
+		case EXPRESSION_OP_NEGATE :		*pd_top = -*pd_top;								break;
+		case EXPRESSION_OP_SQRT :		*pd_top = (*pd_top < 0)?0:(double)::sqrt(*pd_top);	break;
+		case EXPRESSION_OP_INT_POW :	*pd_top = ::INT_POW(pn->i_arg,*pd_top);			break;
+		case EXPRESSION_OP_ADD :		pd_top--;	pd_top[0] += pd_top[1];				break;
+		case EXPRESSION_OP_SUBTRACT :	pd_top--;	pd_top[0] -= pd_top[1];				break;
+		case EXPRESSION_OP_MULTIPLY :	pd_top--;	pd_top[0] *= pd_top[1];				break;
+		case EXPRESSION_OP_DIVIDE :		pd_top--;	pd_top[0] /= pd_top[1];				break;
+		case EXPRESSION_OP_POW :		pd_top--;	pd_top[0] = (double)::pow(pd_top[0],pd_top[1]);	break;
+		case EXPRESSION_OP_EXP :		*pd_top = (double)::exp(*pd_top);				break;
+		case EXPRESSION_OP_LN :			*pd_top = (double)::log(*pd_top);				break;
+		case EXPRESSION_OP_LOG10 :		*pd_top = (double)::log10(*pd_top);				break;
+		case EXPRESSION_OP_SIN :		*pd_top = (double)::sin(*pd_top);				break;
+		case EXPRESSION_OP_COS :		*pd_top = (double)::cos(*pd_top);				break;
+		case EXPRESSION_OP_TAN :		*pd_top = (double)::tan(*pd_top);				break;
+		case EXPRESSION_OP_ASIN :		*pd_top = (double)::asin(*pd_top);				break;
+		case EXPRESSION_OP_ACOS :		*pd_top = (double)::acos(*pd_top);				break;
+		case EXPRESSION_OP_ATAN :		*pd_top = (double)::atan(*pd_top);				break;
+		case EXPRESSION_OP_SINH :		*pd_top = (double)::sinh(*pd_top);				break;
+		case EXPRESSION_OP_COSH :		*pd_top = (double)::cosh(*pd_top);				break;
+		case EXPRESSION_OP_TANH :		*pd_top = (double)::tanh(*pd_top);				break;
+		case EXPRESSION_OP_J0 :			*pd_top = (double)::_j0(*pd_top);				break;
+		case EXPRESSION_OP_J1 :			*pd_top = (double)::_j1(*pd_top);				break;
+		case EXPRESSION_OP_JN :			*pd_top = (double)::_jn(pn->i_arg,*pd_top);		break;
+		case EXPRESSION_OP_Y0 :			*pd_top = (double)::_y0(*pd_top);				break;
+		case EXPRESSION_OP_Y1 :			*pd_top = (double)::_y1(*pd_top);				break;
+		case EXPRESSION_OP_YN :			*pd_top = (double)::_yn(pn->i_arg,*pd_top);		break;
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	double d_value = *pd_top;
+	if (pd_stack != pd_local)
+		delete [] pd_stack;
+	return d_value;
+}
+
+calculus::algebraic_operator * calculus::expression_view::to_algebra()
+{
+	if (m_i_num_nodes == 0)
+		return NULL;
+	using namespace calculus::binary_operators::intrinsic_operators;
+	using namespace calculus::unary_operators::intrinsic_operators;
+	using namespace calculus::unary_operators::trigonometric_operators;
+	using namespace calculus::unary_operators::hyperbolic_operators;
+	using namespace calculus::unary_operators::bessel_operators;
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	algebraic_operator ** ppao_stack = new algebraic_operator*[m_i_max_depth];
+	algebraic_operator ** ppao_top = ppao_stack - 1;
+	for(int j = 0;j < m_i_num_nodes;j++) {
+		const EXPRESSION_IMAGE_NODE * pn = m_pn_nodes + j;
+		switch(pn->ui_opcode) {
+		case EXPRESSION_OP_VARIABLE :	*(++ppao_top) = calculus::_var(get_variable_name(pn->i_arg));	break;
+		case EXPRESSION_OP_CONSTANT :	*(++ppao_top) = calculus::_cst(m_pd_constants[pn->i_arg]);		break;
+		case EXPRESSION_OP_NEGATE :		*ppao_top = _neg(*ppao_top);					break;
+		case EXPRESSION_OP_SQRT :		*ppao_top = _sqrt(*ppao_top);					break;
+		case EXPRESSION_OP_INT_POW :	*ppao_top = _INT_POW(pn->i_arg,*ppao_top);		break;
+		case EXPRESSION_OP_ADD :		ppao_top--;	ppao_top[0] = _add(ppao_top[0],ppao_top[1]);		break;
+		case EXPRESSION_OP_SUBTRACT :	ppao_top--;	ppao_top[0] = _subtract(ppao_top[0],ppao_top[1]);	break;
+		case EXPRESSION_OP_MULTIPLY :	ppao_top--;	ppao_top[0] = _multiply(ppao_top[0],ppao_top[1]);	break;
+		case EXPRESSION_OP_DIVIDE :		ppao_top--;	ppao_top[0] = _divide(ppao_top[0],ppao_top[1]);		break;
+		case EXPRESSION_OP_POW :		ppao_top--;	ppao_top[0] = _pow(ppao_top[0],ppao_top[1]);		break;
+		case EXPRESSION_OP_EXP :		*ppao_top = _exp(*ppao_top);					break;
+		case EXPRESSION_OP_LN :			*ppao_top = _log(*ppao_top);					break;
+		case EXPRESSION_OP_LOG10 :		*ppao_top = _log10(*ppao_top);					break;
+		case EXPRESSION_OP_SIN :		*ppao_top = _sin(*ppao_top);					break;
+		case EXPRESSION_OP_COS :		*ppao_top = _cos(*ppao_top);					break;
+		case EXPRESSION_OP_TAN :		*ppao_top = _tan(*ppao_top);					break;
+		case EXPRESSION_OP_ASIN :		*ppao_top = _asin(*ppao_top);					break;
+		case EXPRESSION_OP_ACOS :		*ppao_top = _acos(*ppao_top);					break;
+		case EXPRESSION_OP_ATAN :		*ppao_top = _atan(*ppao_top);					break;
+		case EXPRESSION_OP_SINH :		*ppao_top = _sinh(*ppao_top);					break;
+		case EXPRESSION_OP_COSH :		*ppao_top = _cosh(*ppao_top);					break;
+		case EXPRESSION_OP_TANH :		*ppao_top = _tanh(*ppao_top);					break;
+		case EXPRESSION_OP_J0 :			*ppao_top = __j0(*ppao_top);					break;
+		case EXPRESSION_OP_J1 :			*ppao_top = __j1(*ppao_top);					break;
+		case EXPRESSION_OP_JN :			*ppao_top = __jn((unsigned int)pn->i_arg,*ppao_top);	break;
+		case EXPRESSION_OP_Y0 :			*ppao_top = __y0(*ppao_top);					break;
+		case EXPRESSION_OP_Y1 :			*ppao_top = __y1(*ppao_top);					break;
+		case EXPRESSION_OP_YN :			*ppao_top = __yn((unsigned int)pn->i_arg,*ppao_top);	break;
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	algebraic_operator * pao = *ppao_top;
+	delete [] ppao_stack;
+	return pao;
+}
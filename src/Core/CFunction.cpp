@@ -104,7 +104,7 @@ calculus::function_adapter::function_adapter(void * p_function_adapter,char * ps
 	this->m_i_number_of_variables = i_num_vars;
 	if (i_num_vars) {
 		_ASSERT(ppVars);
-		this->m_ppv_variables = new variable*[i_num_vars];
+		this->m_ppv_variables = calculus::node_pool::allocate_array<variable*>(i_num_vars);
 		i_num_vars--;
 		this->m_ppv_variables[i_num_vars] = ppVars[i_num_vars];
 	}
@@ -156,21 +156,64 @@ void calculus::function_adapter::annotate(PPT_INFO pParseInfo) {
 	pParseInfo->i_operator_count++;
 }
 
+/*
+	GATHER THE VARIABLES INTO double[n] AT [rbp-d]
+LEA		rdi,[rbp-d]
+MOV		rax,adapter
+CALL	rax
+*/
+
+void calculus::function_adapter::to_X64_binary(PCT_INFO pInfo) {
+	int iBase = CompilerWriteX64GatherVariables(pInfo,m_i_number_of_variables,m_ppv_variables);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_EDI);
+		CompilerWriteINT32(pInfo,iBase);
+	CompilerWriteX64CALL_IMM64(pInfo,m_pv_function_adapter);
+	CompilerPopX64Temporary(pInfo,m_i_number_of_variables);
+}
+
+void calculus::function_adapter::annotate_X64(PPT_INFO pParseInfo) {
+	CompilerReserveX64Temporary(pParseInfo,m_i_number_of_variables);
+	CompilerReleaseX64Temporary(pParseInfo,m_i_number_of_variables);
+	pParseInfo->i_instruction_count += this->m_i_number_of_variables*2 + 3;
+	pParseInfo->st_instruction_storage_size += CompilerSizeOfX64GatherVariables(this->m_i_number_of_variables)
+										 +	CompilerSizeOfLEA_RXX_RBPX_IMM32()
+										 +	CompilerSizeOfINT32()
+										 +	CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 double calculus::function_adapter::eval(double *pVars) {
     return ((REAL_FUNCTION)m_pv_function_adapter)(pVars);
 }
 
-int calculus::function_adapter::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 1024;
-	int iOffset = sprintf(pBuffer,"%s[0x%X](",m_sc_function_adapter_name,(unsigned long)this->m_pv_function_adapter);
+void calculus::function_adapter::write_string(string_writer* psw) {
+	psw->print("%s[0x%lX](",m_sc_function_adapter_name,(unsigned long)this->m_pv_function_adapter);
 	for(int i = 0;i < m_i_number_of_variables;i++) {
-		iOffset += this->m_ppv_variables[i]->to_string(pBuffer+iOffset);
-		if (i < m_i_number_of_variables-1)
-			strcpy(pBuffer+(iOffset++),",");
+		if (i)
+			psw->write(',');
+		this->m_ppv_variables[i]->write_string(psw);
 	}
-	strcpy(pBuffer+(iOffset++),")");
-	return iOffset;
+	psw->write(')');
+}
+
+qword_type calculus::function_adapter::structural_hash() {
+	qword_type qw_hash = StructuralHashCombine(typeid(*this).hash_code(),(qword_type)m_pv_function_adapter);
+	for(int i = 0;i < m_i_number_of_variables;i++)
+		qw_hash = StructuralHashCombine(qw_hash,this->m_ppv_variables[i]->get_hash());
+	return qw_hash;
+}
+
+bool calculus::function_adapter::structural_equal(calculus::algebraic_operator * pao_other) {
+	if (typeid(*this) != typeid(*pao_other))
+		return false;
+	function_adapter* pfa_other = static_cast<function_adapter*>(pao_other);
+	if ((pfa_other->m_pv_function_adapter != m_pv_function_adapter)||(pfa_other->m_i_number_of_variables != m_i_number_of_variables))
+		return false;
+	for(int i = 0;i < m_i_number_of_variables;i++)
+		if (!this->m_ppv_variables[i]->equals(pfa_other->m_ppv_variables[i]))
+			return false;
+	return true;
 }
 
 calculus::variable** calculus::function_adapter::identify_variables() {
@@ -0,0 +1,374 @@
+/*
+
+CFUNCTIONIMAGE.CPP: 
+IMPLEMENTS THE FUNCTION IMAGES OF calculus::IA32_binary
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#include <stdio.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef COMPILER_TARGET_X64
+#define FUNCTION_IMAGE_ISA		FUNCTION_IMAGE_ISA_X64
+typedef qword_type image_pointer_type;
+#else
+#define FUNCTION_IMAGE_ISA		FUNCTION_IMAGE_ISA_IA32
+typedef unsigned int image_pointer_type;
+#endif
+
+//THE NATIVE ROUTINES THE ENCODERS CALL, A FUNCTION IMAGE NAMES THEM BY THEIR NUMBER IN THIS TABLE.  THE NUMBERS ARE
+//PART OF THE FORMAT, NEW ROUTINES ARE APPENDED
+static void * FunctionImageRoutine(unsigned int ui_routine) {
+	static void * const s_ppv_routines[] = {
+		(void*)(double (__cdecl*)(double))::sin,
+		(void*)(double (__cdecl*)(double))::cos,
+		(void*)(double (__cdecl*)(double))::tan,
+		(void*)(double (__cdecl*)(double))::asin,
+		(void*)(double (__cdecl*)(double))::acos,
+		(void*)(double (__cdecl*)(double))::atan,
+		(void*)(double (__cdecl*)(double))::sinh,
+		(void*)(double (__cdecl*)(double))::cosh,
+		(void*)(double (__cdecl*)(double))::tanh,
+		(void*)(double (__cdecl*)(double))::exp,
+		(void*)(double (__cdecl*)(double))::log,
+		(void*)(double (__cdecl*)(double))::log10,
+		(void*)(double (__cdecl*)(double,double))::pow,
+		(void*)(double (__cdecl*)(double))::_j0,
+		(void*)(double (__cdecl*)(double))::_j1,
+		(void*)(double (__cdecl*)(int,double))::_jn,
+		(void*)(double (__cdecl*)(double))::_y0,
+		(void*)(double (__cdecl*)(double))::_y1,
+		(void*)(double (__cdecl*)(int,double))::_yn
+	};
+	if (ui_routine >= sizeof(s_ppv_routines)/sizeof(s_ppv_routines[0]))
+		return NULL;
+	return s_ppv_routines[ui_routine];
+}
+
+static size_t AlignImageOffset(size_t st_offset) {
+	return (st_offset + FUNCTION_IMAGE_ALIGNMENT - 1) & ~((size_t)FUNCTION_IMAGE_ALIGNMENT - 1);
+}
+
+bool calculus::IA32_binary::save_image(const char * psc_path)
+{
+	PCOMPILER_HEADER pHead = m_p_header;
+	//THE IA32 ENCODERS DON'T RECORD THEIR ROUTINES IN THE PTR MAP, ONLY THE CODE OF THE code_arena IS RELOCATABLE
+	if (pHead->pv_code_storage == NULL)
+		return false;
+	unsigned char * pv_code = pHead->pv_code_storage;
+	size_t st_code_size = pHead->st_code_size;
+	size_t st_num_relocations = (pHead->pv_global_storage - (unsigned char*)pHead->ppv_pmap)/sizeof(unsigned char*);
+	size_t st_name_size = strlen((char*)pHead->psc_name) + 1;
+
+	FUNCTION_IMAGE_HEADER header;
+	memset(&header,0,sizeof(header));
+	header.ui_magic				= FUNCTION_IMAGE_MAGIC;
+	header.ui_version			= FUNCTION_IMAGE_VERSION;
+	header.ui_isa				= FUNCTION_IMAGE_ISA;
+	header.ui_flags				= (unsigned int)pHead->i_f_flags;
+	header.i_num_vars			= pHead->i_num_vars;
+	header.i_operator_count		= pHead->i_operator_count;
+	header.i_instruction_count	= pHead->i_instruction_count;
+	header.i_clock_count		= pHead->i_clock_count;
+	header.ui_name_offset		= (unsigned int)AlignImageOffset(sizeof(FUNCTION_IMAGE_HEADER));
+	header.ui_name_size			= (unsigned int)st_name_size;
+	header.ui_relocation_offset	= (unsigned int)AlignImageOffset(header.ui_name_offset + st_name_size);
+	header.ui_num_relocations	= (unsigned int)st_num_relocations;
+	header.ui_code_offset		= (unsigned int)AlignImageOffset(header.ui_relocation_offset + st_num_relocations*sizeof(FUNCTION_IMAGE_RELOCATION));
+	header.ui_code_size			= (unsigned int)st_code_size;
+	header.ui_entry_offset		= (unsigned int)((unsigned char*)pHead->pInstructions - pv_code);
+	header.ui_local_offset		= (unsigned int)(pHead->pv_local_storage - pv_code);
+	size_t st_image_size = header.ui_code_offset + st_code_size;
+
+	unsigned char * pv_image = (unsigned char*)calloc(st_image_size,1);
+	if (pv_image == NULL)
+		return false;
+	memcpy(pv_image,&header,sizeof(header));
+	memcpy(pv_image + header.ui_name_offset,pHead->psc_name,st_name_size);
+	unsigned char * pv_image_code = pv_image + header.ui_code_offset;
+	memcpy(pv_image_code,pv_code,st_code_size);
+	//EVERY ENTRY OF THE PTR MAP IS CLASSIFIED BY THE ADDRESS IT HOLDS, WHICH IS CLEARED FROM THE WRITTEN CODE
+	PFUNCTION_IMAGE_RELOCATION pRelocations = (PFUNCTION_IMAGE_RELOCATION)(pv_image + header.ui_relocation_offset);
+	for(size_t i = 0;i < st_num_relocations;i++) {
+		size_t st_offset = pHead->ppv_pmap[i] - pv_code;
+		_ASSERT(st_offset + sizeof(image_pointer_type) <= st_code_size);
+		image_pointer_type pt_address;
+		memcpy(&pt_address,pv_code + st_offset,sizeof(pt_address));
+		memset(pv_image_code + st_offset,0,sizeof(pt_address));
+		pRelocations[i].ui_offset = (unsigned int)st_offset;
+		if (pt_address == (image_pointer_type)(size_t)&pHead->i_call_count) {
+			pRelocations[i].ui_kind = FUNCTION_IMAGE_RELOC_CALL_COUNT;
+			pRelocations[i].qw_target = 0;
+		}
+		else if ((pt_address >= (image_pointer_type)(size_t)pv_code) && (pt_address < (image_pointer_type)(size_t)(pv_code + st_code_size))) {
+			pRelocations[i].ui_kind = FUNCTION_IMAGE_RELOC_CODE;
+			pRelocations[i].qw_target = (qword_type)(pt_address - (image_pointer_type)(size_t)pv_code);
+		}
+		else {
+			unsigned int ui_routine = 0;
+			void * pv_routine;
+			while (((pv_routine = FunctionImageRoutine(ui_routine)) != NULL) && ((image_pointer_type)(size_t)pv_routine != pt_address))
+				ui_routine++;
+			//AN OPERATOR OR A USER FUNCTION OF THIS PROCESS
+			if (pv_routine == NULL) {
+				free(pv_image);
+				return false;
+			}
+			pRelocations[i].ui_kind = FUNCTION_IMAGE_RELOC_ROUTINE;
+			pRelocations[i].qw_target = ui_routine;
+		}
+	}
+
+	FILE * pFile = fopen(psc_path,"wb");
+	bool b_written = false;
+	if (pFile) {
+		b_written = (fwrite(pv_image,1,st_image_size,pFile) == st_image_size);
+		b_written = (fclose(pFile) == 0) && b_written;
+	}
+	free(pv_image);
+	return b_written;
+}
+
+//CHECKS THE LAYOUT OF THE st_size BYTES OF AN IMAGE BEFORE ANY OF IT IS TRUSTED
+static bool IsValidImage(const unsigned char * pv_image,size_t st_size) {
+	if (st_size < sizeof(FUNCTION_IMAGE_HEADER))
+		return false;
+	FUNCTION_IMAGE_HEADER header;
+	memcpy(&header,pv_image,sizeof(header));
+	if ((header.ui_magic != FUNCTION_IMAGE_MAGIC) || (header.ui_version != FUNCTION_IMAGE_VERSION) || (header.ui_isa != FUNCTION_IMAGE_ISA))
+		return false;
+	if ((header.i_num_vars < 0) || (header.ui_name_size == 0) || (header.ui_code_size == 0))
+		return false;
+	if (((size_t)header.ui_name_offset + header.ui_name_size > st_size) || (pv_image[header.ui_name_offset + header.ui_name_size - 1] != '\0'))
+		return false;
+	if ((size_t)header.ui_relocation_offset + (size_t)header.ui_num_relocations*sizeof(FUNCTION_IMAGE_RELOCATION) > st_size)
+		return false;
+	if (((size_t)header.ui_code_offset + header.ui_code_size > st_size) || (header.ui_entry_offset >= header.ui_code_size) || (header.ui_local_offset > header.ui_code_size))
+		return false;
+	for(unsigned int i = 0;i < header.ui_num_relocations;i++) {
+		FUNCTION_IMAGE_RELOCATION relocation;
+		memcpy(&relocation,pv_image + header.ui_relocation_offset + i*sizeof(FUNCTION_IMAGE_RELOCATION),sizeof(relocation));
+		if ((size_t)relocation.ui_offset + sizeof(image_pointer_type) > header.ui_code_size)
+			return false;
+		switch(relocation.ui_kind) {
+		case FUNCTION_IMAGE_RELOC_CALL_COUNT :
+			break;
+		case FUNCTION_IMAGE_RELOC_CODE :
+			if (relocation.qw_target >= header.ui_code_size)
+				return false;
+			break;
+		case FUNCTION_IMAGE_RELOC_ROUTINE :
+			if ((relocation.qw_target > 0xffffffffu) || (FunctionImageRoutine((unsigned int)relocation.qw_target) == NULL))
+				return false;
+			break;
+		default :
+			return false;
+		}
+	}
+	return true;
+}
+
+static calculus::IA32_binary * LoadImage(const unsigned char * pv_image,size_t st_size) {
+	if (!IsValidImage(pv_image,st_size))
+		return NULL;
+	FUNCTION_IMAGE_HEADER header;
+	memcpy(&header,pv_image,sizeof(header));
+	unsigned char * pv_code = calculus::code_arena::allocate(header.ui_code_size);
+	if (pv_code == NULL)
+		return NULL;
+	//THE HEADER, THE NAME AND THE PTR MAP ARE LAID OUT AS BY THE COMPILER, SO THE LOADED CODE CAN BE SAVED AGAIN
+	size_t st_mem_required = sizeof(COMPILER_HEADER)
+						+ header.ui_name_size*sizeof(char)
+						+ header.ui_num_relocations*sizeof(unsigned char*);
+	PCOMPILER_HEADER pHead = (PCOMPILER_HEADER)malloc(st_mem_required);
+	pHead->st_size					= sizeof(COMPILER_HEADER);
+	pHead->pSelf					= pHead;
+	pHead->i_f_flags				= (int)header.ui_flags;
+	pHead->i_call_count				= 0;
+	pHead->i_clock_count			= header.i_clock_count;
+	pHead->i_operator_count			= header.i_operator_count;
+	pHead->i_instruction_count		= header.i_instruction_count;
+	pHead->i_num_vars				= header.i_num_vars;
+	pHead->st_mem_size				= st_mem_required;
+	pHead->psc_name					= ((unsigned char*)pHead)+(sizeof(COMPILER_HEADER)/sizeof(unsigned char));
+	memcpy(pHead->psc_name,pv_image + header.ui_name_offset,header.ui_name_size);
+	pHead->ppv_pmap					= (unsigned char**)(pHead->psc_name + header.ui_name_size);
+	pHead->pv_global_storage		= (unsigned char*)(pHead->ppv_pmap + header.ui_num_relocations);
+	pHead->pv_code_storage			= pv_code;
+	pHead->st_code_size				= header.ui_code_size;
+	pHead->pInstructions			= (FUNCTION)(pv_code + header.ui_entry_offset);
+	pHead->pv_local_storage			= pv_code + header.ui_local_offset;
+	pHead->ppv_auxiliary_storage_toc	= NULL;
+	pHead->pv_auxiliary_storage		= NULL;
+	memcpy(pv_code,pv_image + header.ui_code_offset,header.ui_code_size);
+	for(unsigned int i = 0;i < header.ui_num_relocations;i++) {
+		FUNCTION_IMAGE_RELOCATION relocation;
+		memcpy(&relocation,pv_image + header.ui_relocation_offset + i*sizeof(FUNCTION_IMAGE_RELOCATION),sizeof(relocation));
+		image_pointer_type pt_address = 0;
+		switch(relocation.ui_kind) {
+		case FUNCTION_IMAGE_RELOC_CALL_COUNT :
+			pt_address = (image_pointer_type)(size_t)&pHead->i_call_count;
+			break;
+		case FUNCTION_IMAGE_RELOC_CODE :
+			pt_address = (image_pointer_type)(size_t)(pv_code + relocation.qw_target);
+			break;
+		case FUNCTION_IMAGE_RELOC_ROUTINE :
+			pt_address = (image_pointer_type)(size_t)FunctionImageRoutine((unsigned int)relocation.qw_target);
+			break;
+		}
+		memcpy(pv_code + relocation.ui_offset,&pt_address,sizeof(pt_address));
+		pHead->ppv_pmap[i] = pv_code + relocation.ui_offset;
+	}
+	if (!calculus::code_arena::seal(pHead)) {
+		calculus::code_arena::release(pHead->pv_code_storage,pHead->st_code_size);
+		free(pHead);
+		return NULL;
+	}
+	return new calculus::IA32_binary(pHead);
+}
+
+calculus::IA32_binary * calculus::IA32_binary::load_image(const char * psc_path)
+{
+	IA32_binary * pia32 = NULL;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(psc_path,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile,&liSize) || (liSize.QuadPart == 0)) {
+		CloseHandle(hFile);
+		return NULL;
+	}
+	HANDLE hMapping = CreateFileMappingA(hFile,NULL,PAGE_READONLY,0,0,NULL);
+	const unsigned char * pv_image = (hMapping)?(const unsigned char*)MapViewOfFile(hMapping,FILE_MAP_READ,0,0,0):NULL;
+	if (pv_image) {
+		pia32 = LoadImage(pv_image,(size_t)liSize.QuadPart);
+		UnmapViewOfFile(pv_image);
+	}
+	if (hMapping)
+		CloseHandle(hMapping);
+	CloseHandle(hFile);
+#else
+	int iFile = open(psc_path,O_RDONLY);
+	if (iFile < 0)
+		return NULL;
+	struct stat statFile;
+	if ((fstat(iFile,&statFile) != 0) || (statFile.st_size == 0)) {
+		close(iFile);
+		return NULL;
+	}
+	size_t st_size = (size_t)statFile.st_size;
+	void * pvMap = mmap(NULL,st_size,PROT_READ,MAP_PRIVATE,iFile,0);
+	close(iFile);
+	if (pvMap == MAP_FAILED)
+		return NULL;
+	pia32 = LoadImage((const unsigned char*)pvMap,st_size);
+	munmap(pvMap,st_size);
+#endif
+	return pia32;
+}
+
+bool calculus::algebraic_operator::save_image(const char * psc_path)
+{
+	if (compile() == NULL)
+		return false;
+	return m_pia32_binary.load(std::memory_order_acquire)->save_image(psc_path);
+}
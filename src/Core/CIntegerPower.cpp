@@ -103,18 +103,15 @@ double calculus::unary_operators::intrinsic_operators::integer_power::eval_unary
 	return (double)::INT_POW(this->m_iConstant,a);
 }
 
-int calculus::unary_operators::intrinsic_operators::integer_power::to_string(char* pBuffer) {
-	if (!pBuffer) {
-		char pB[32];
-		return sprintf(pB,"INT_POW(%i,)",this->m_iConstant)+this->get_operand()->to_string(NULL);
-	}
-	int iOffset = 8;
-	strcpy(pBuffer,"INT_POW(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+(iOffset++),",");
-	iOffset += sprintf(pBuffer+iOffset,"%i",this->m_iConstant);
-	strcpy(pBuffer+(iOffset++),")");
-	return iOffset;
+void calculus::unary_operators::intrinsic_operators::integer_power::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = integer_power::eval_unary(pd[i]);
+}
+
+void calculus::unary_operators::intrinsic_operators::integer_power::write_string(string_writer* psw) {
+	psw->write("INT_POW(");
+	this->get_operand()->write_string(psw);
+	psw->print(",%i)",this->m_iConstant);
 }
 /*
 
@@ -164,6 +161,132 @@ void calculus::unary_operators::intrinsic_operators::integer_power::annotate(PPT
 	pParseInfo->i_operator_count++;
 }
 
+/*
+MOVAPD	xmm1,xmm0
+MULSD	xmm0,xmm0
+MULSD	xmm0,xmm1		FOR EVERY SET BIT OF THE EXPONENT, BELOW THE HIGHEST ONE
+	...
+
+AND FOR NEGATIVE EXPONENTS
+
+MOVSD	xmm1,qword PTR[rip+1.0]
+DIVSD	xmm1,xmm0
+MOVAPD	xmm0,xmm1
+*/
+
+//NUMBER OF MULSD NEEDED TO RAISE TO THE POWER OF n BY REPEATED SQUARING
+static int CountX64Multiplications(unsigned int n) {
+	int i_count = -2;
+	for(;n;n >>= 1)
+		i_count += (n & 1)?2:1;
+	return i_count;
+}
+
+void calculus::unary_operators::intrinsic_operators::integer_power::to_X64_binary(PCT_INFO pInfo) {
+	if (this->m_iConstant == 0) {
+		CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),1.0);
+		return;
+	}
+	this->get_operand()->to_X64_shared(pInfo);
+	unsigned int n = (this->m_iConstant >= 0)?this->m_iConstant:-this->m_iConstant;
+	int iBit = 0;
+	while(n >> (iBit+1))
+		iBit++;
+	CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_MOVAPD,REG_XMM(1),REG_XMM(0));
+	while(iBit--) {
+		CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_MULSD,REG_XMM(0),REG_XMM(0));
+		if ((n >> iBit) & 1)
+			CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_MULSD,REG_XMM(0),REG_XMM(1));
+	}
+	if (this->m_iConstant < 0) {
+		CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_MOVSD_LOAD,REG_XMM(1),1.0);
+		CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_DIVSD,REG_XMM(1),REG_XMM(0));
+		CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_MOVAPD,REG_XMM(0),REG_XMM(1));
+	}
+}
+
+void calculus::unary_operators::intrinsic_operators::integer_power::annotate_X64(PPT_INFO pParseInfo) {
+	if (this->m_iConstant == 0) {
+		pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_CONSTANT();
+		pParseInfo->st_local_storage_size			+=	sizeof(double);
+		pParseInfo->i_instruction_count++;
+		pParseInfo->i_operator_count++;
+		return;
+	}
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	int i_muls = CountX64Multiplications((this->m_iConstant >= 0)?this->m_iConstant:-this->m_iConstant);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_PD_XMM_XMM()
+											+	CompilerSizeOfSSE2_SD_XMM_XMM()*i_muls;
+	pParseInfo->i_instruction_count			+=	1 + i_muls;
+	if (this->m_iConstant < 0) {
+		pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_CONSTANT()
+												+	CompilerSizeOfSSE2_SD_XMM_XMM()
+												+	CompilerSizeOfSSE2_PD_XMM_XMM();
+		pParseInfo->st_local_storage_size			+=	sizeof(double);
+		pParseInfo->i_instruction_count			+=	3;
+	}
+	pParseInfo->i_operator_count++;
+}
+
+/*
+	THE SAME SQUARE AND MULTIPLY CHAIN, ON EVERY LANE
+VMOVAPD	v1,v0
+VMULPD	v0,v0,v0
+VMULPD	v0,v0,v1
+	...
+	FOR NEGATIVE EXPONENTS
+VMOVUPD	v1,[rip+1.0]
+VDIVPD	v0,v1,v0
+*/
+
+void calculus::unary_operators::intrinsic_operators::integer_power::to_X64_vector(PCT_INFO pInfo) {
+	if (this->m_iConstant == 0) {
+		CompilerWriteVECTOR_PD_VEC_CONSTANT(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0),REG_XMM(0),1.0);
+		return;
+	}
+	this->get_operand()->to_X64_vector(pInfo);
+	unsigned int n = (this->m_iConstant >= 0)?this->m_iConstant:-this->m_iConstant;
+	int iBit = 0;
+	while(n >> (iBit+1))
+		iBit++;
+	CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_MOVAPD,REG_XMM(1),REG_XMM(0),REG_XMM(0));
+	while(iBit--) {
+		CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_MULPD,REG_XMM(0),REG_XMM(0),REG_XMM(0));
+		if ((n >> iBit) & 1)
+			CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_MULPD,REG_XMM(0),REG_XMM(0),REG_XMM(1));
+	}
+	if (this->m_iConstant < 0) {
+		CompilerWriteVECTOR_PD_VEC_CONSTANT(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(1),REG_XMM(0),1.0);
+		CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_DIVPD,REG_XMM(0),REG_XMM(1),REG_XMM(0));
+	}
+}
+
+void calculus::unary_operators::intrinsic_operators::integer_power::annotate_X64_vector(PPT_INFO pParseInfo) {
+	if (this->m_iConstant == 0) {
+		pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+		pParseInfo->st_local_storage_size			+=	CompilerLocalSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+		pParseInfo->i_instruction_count++;
+		pParseInfo->i_operator_count++;
+		return;
+	}
+	this->get_operand()->annotate_X64_vector(pParseInfo);
+	int i_muls = CountX64Multiplications((this->m_iConstant >= 0)?this->m_iConstant:-this->m_iConstant);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfVECTOR_PD_VEC_VEC(pParseInfo)*(1 + i_muls);
+	pParseInfo->i_instruction_count			+=	1 + i_muls;
+	if (this->m_iConstant < 0) {
+		pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo)
+												+	CompilerSizeOfVECTOR_PD_VEC_VEC(pParseInfo);
+		pParseInfo->st_local_storage_size			+=	CompilerLocalSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+		pParseInfo->i_instruction_count			+=	2;
+	}
+	pParseInfo->i_operator_count++;
+}
+
+void calculus::unary_operators::intrinsic_operators::integer_power::to_tape(calculus::tape* pTape) {
+	this->get_operand()->to_tape(pTape);
+	pTape->write(TAPE_OP_INT_POW,this->m_iConstant);
+}
+
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::integer_power::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -179,3 +302,11 @@ calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::in
 	}
 	return pD;
 }
+
+qword_type calculus::unary_operators::intrinsic_operators::integer_power::structural_hash() {
+	return StructuralHashCombine(unary_operator::structural_hash(),(qword_type)this->m_iConstant);
+}
+
+bool calculus::unary_operators::intrinsic_operators::integer_power::structural_equal(calculus::algebraic_operator * pao_other) {
+	return unary_operator::structural_equal(pao_other)&&(static_cast<integer_power*>(pao_other)->m_iConstant == this->m_iConstant);
+}
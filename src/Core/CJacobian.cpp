@@ -0,0 +1,398 @@
+/*
+
+CJACOBIAN.CPP: 
+IMPLEMENTS calculus::jacobian
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+
+*/
+
+#include "Calculus_cpp.h"
+
+static bool IsStructuralZero(calculus::algebraic_operator * pao_operator) {
+	return (typeid(*pao_operator) == typeid(calculus::constant)) && (pao_operator->eval(NULL) == 0);
+}
+
+calculus::jacobian::jacobian(int i_rows,int i_cols,int i_layout,calculus::variable** ppv_vars) {
+	m_i_rows = i_rows;
+	m_i_cols = i_cols;
+	m_i_layout = i_layout;
+	m_i_nonzeros = 0;
+	m_pi_row_pointers = new int[i_rows+1];
+	m_pi_column_indices = NULL;
+	m_ppao_entries = NULL;
+	m_ppv_vars = new calculus::variable*[i_cols];
+	for(int j = 0;j < i_cols;j++) {
+		m_ppv_vars[j] = ppv_vars[j];
+		m_ppv_vars[j]->addref();
+	}
+	m_pia32_binary = NULL;
+	m_pf_kernel = NULL;
+}
+
+calculus::jacobian::~jacobian() {
+	if (m_pia32_binary)
+		delete m_pia32_binary;
+	for(int k = 0;k < m_i_nonzeros;k++)
+		m_ppao_entries[k]->release();
+	for(int j = 0;j < m_i_cols;j++)
+		m_ppv_vars[j]->release();
+	if (m_ppao_entries)
+		delete [] m_ppao_entries;
+	if (m_pi_column_indices)
+		delete [] m_pi_column_indices;
+	delete [] m_ppv_vars;
+	delete [] m_pi_row_pointers;
+}
+
+calculus::jacobian* calculus::jacobian::compile_jacobian(calculus::algebraic_operator** ppao_functions,int m,calculus::variable** ppv_vars,int n,int i_layout) {
+#ifdef COMPILER_TARGET_X64
+	//THE PARTIALS, THE SHARED SLOTS AND THE CODE ARENA ARE ALL BUILT UNDER THE LOCK
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	//THE KERNEL ONLY RECEIVES THE COLUMNS, EVERY VARIABLE OF EVERY COMPONENT MUST BE ONE OF THEM
+	for(int i = 0;i < m;i++) {
+		int i_num_vars = ppao_functions[i]->get_number_of_variables();
+		calculus::variable** ppv_function_vars = ppao_functions[i]->get_variables();
+		for(int k = 0;k < i_num_vars;k++) {
+			int j = 0;
+			while((j < n) && (ppv_vars[j]->get_id() != ppv_function_vars[k]->get_id()))
+				j++;
+			if (j == n)
+				return NULL;
+		}
+	}
+	calculus::jacobian* pj = new calculus::jacobian(m,n,i_layout,ppv_vars);
+	pj->m_ppao_entries = new calculus::algebraic_operator*[m*n];
+	pj->m_pi_column_indices = new int[m*n];
+	for(int i = 0;i < m;i++) {
+		pj->m_pi_row_pointers[i] = pj->m_i_nonzeros;
+		for(int j = 0;j < n;j++) {
+			if (!ppao_functions[i]->is_function_of(ppv_vars[j]))
+				continue;
+			calculus::algebraic_operator* pao_partial = ppao_functions[i]->get_partial_derivative(ppv_vars[j]);
+			if (IsStructuralZero(pao_partial))
+				continue;
+			pao_partial->addref();
+			pj->m_ppao_entries[pj->m_i_nonzeros] = pao_partial;
+			pj->m_pi_column_indices[pj->m_i_nonzeros++] = j;
+		}
+	}
+	pj->m_pi_row_pointers[m] = pj->m_i_nonzeros;
+	pj->m_pia32_binary = pj->to_X64_binary();
+	if (pj->m_pia32_binary == NULL) {
+		delete pj;
+		return NULL;
+	}
+	pj->m_pf_kernel = (JACOBIAN_FUNCTION)(void(*)())pj->m_pia32_binary->get_header()->pInstructions;
+	return pj;
+#else
+	UNREFERENCED_PARAMETER(ppao_functions);
+	UNREFERENCED_PARAMETER(m);
+	UNREFERENCED_PARAMETER(ppv_vars);
+	UNREFERENCED_PARAMETER(n);
+	UNREFERENCED_PARAMETER(i_layout);
+	return NULL;
+#endif
+}
+
+calculus::jacobian* calculus::jacobian::compile_hessian(calculus::algebraic_operator* pao_function,calculus::variable** ppv_vars,int n,int i_layout) {
+	//THE HESSIAN IS THE JACOBIAN OF THE GRADIENT, THE GRADIENT IS HELD BY pao_function
+	calculus::algebraic_operator** ppao_gradient = new calculus::algebraic_operator*[n];
+	for(int j = 0;j < n;j++)
+		ppao_gradient[j] = pao_function->get_partial_derivative(ppv_vars[j]);
+	calculus::jacobian* pj = compile_jacobian(ppao_gradient,n,ppv_vars,n,i_layout);
+	delete [] ppao_gradient;
+	return pj;
+}
+
+/*
+THIS IS THE OPCODE BLUEPRINT FOR A JACOBIAN KERNEL, void kernel(const double* x,double* out)
+
+PUSH	rbp
+MOV		rbp,rsp
+SUB		rsp,(8*(n+1) + slots + temporaries) rounded to 16
+MOV		rax,&i_call_count
+INC		dword PTR[rax]
+MOV		qword PTR[rbp-8*(n+1)],rsi
+MOVSD	xmm0,qword PTR[rdi+8*j]					FOR EVERY COLUMN j
+MOVSD	qword PTR[rbp-8*(j+1)],xmm0
+XOR		eax,eax									DENSE LAYOUT WITH STRUCTURAL ZEROS ONLY
+MOV		ecx,rows*cols
+MOV		rdi,rsi
+REP STOSQ
+	ENTRY OPCODE, RESULT IN XMM0				FOR EVERY NONZERO k
+MOV		rax,qword PTR[rbp-8*(n+1)]
+MOVSD	qword PTR[rax+8*k],xmm0
+MOV		rsp,rbp
+POP		rbp
+RET
+*/
+
+calculus::IA32_binary* calculus::jacobian::to_X64_binary()
+{
+#ifdef COMPILER_TARGET_X64
+	char sc_name_buffer[64];
+	sprintf(sc_name_buffer,"jacobian %ix%i",m_i_rows,m_i_cols);
+	int i_num_vars = m_i_cols;
+	int i_output = COMPILER_X64_V(i_num_vars);	//THE OUTPUT POINTER IS KEPT BELOW THE VARIABLES
+	int i_num_zeros = (m_i_layout == JACOBIAN_LAYOUT_DENSE)?m_i_rows*m_i_cols - m_i_nonzeros:0;
+
+	PT_INFO parse_info;
+	parse_info.st_size = sizeof(parse_info);
+	parse_info.i_aux_features_needed = FEAT_AUX_NEED_NONE;
+	parse_info.i_features_needed = FEAT_NEED_NONE;
+	parse_info.st_global_storage_size = 0;
+	parse_info.i_instruction_count = 0;
+	parse_info.st_instruction_storage_size = 0;
+	parse_info.st_local_storage_size = 0;
+	parse_info.st_pmap_size = 1;	//MOV rax,&i_call_count
+	parse_info.i_clock_count = 0;
+	parse_info.i_operator_count = 0;
+	parse_info.i_fpu_stack_offset = 0;
+	parse_info.i_stack_offset = 0;
+	parse_info.i_max_stack_offset = 0;
+	parse_info.i_vector_isa = VECTOR_ISA_NONE;
+	parse_info.p_shared = NULL;
+
+	//ONE TABLE COUNTS THE USES ACROSS ALL THE ENTRIES, SO A SUBEXPRESSION SHARED BY TWO PARTIALS IS COMPUTED ONCE
+	COMPILER_SHARED_TABLE shared_table;
+	memset(&shared_table,0,sizeof(shared_table));
+	shared_table.b_counting = true;
+	PT_INFO count_info = parse_info;
+	count_info.p_shared = &shared_table;
+	for(int k = 0;k < m_i_nonzeros;k++)
+		m_ppao_entries[k]->annotate_X64_shared(&count_info);
+	int i_num_slots = AssignSharedSlots(&shared_table,(i_num_vars+1)*sizeof(double));
+	parse_info.p_shared = &shared_table;
+	parse_info.i_stack_offset = parse_info.i_max_stack_offset = i_num_slots*sizeof(double);
+
+	for(int k = 0;k < m_i_nonzeros;k++) {
+		m_ppao_entries[k]->annotate_X64_shared(&parse_info);
+		parse_info.st_instruction_storage_size	+=	CompilerSizeOfMOV_RXX_RBPX_IMM32()
+												+	CompilerSizeOfINT32()
+												+	CompilerSizeOfSSE2_SD_XMM_INDIRECT();
+		parse_info.i_instruction_count += 2;
+	}
+	ResetSharedTable(&shared_table);
+
+	size_t InstructionLengthCheck = parse_info.st_instruction_storage_size;
+	int i_frame_size = (int)(((i_num_vars+1)*sizeof(double) + parse_info.i_max_stack_offset + 15) & ~15);
+	parse_info.i_instruction_count += 9 + 2*i_num_vars + ((i_num_zeros)?4:0);
+	parse_info.st_instruction_storage_size	+=	CompilerSizeOfPUSH_RBP()
+											+	CompilerSizeOfMOV_RBP_RSP()
+											+	CompilerSizeOfSUB_RSP_IMM32()
+											+	CompilerSizeOfINT32()
+											+	CompilerSizeOfMOV_RXX_IMM64()
+											+	CompilerSizeOfIMM64()
+											+	CompilerSizeOfINC_dword_typePTREXX()
+											+	CompilerSizeOfMOV_RBPX_IMM32_RXX()
+											+	CompilerSizeOfINT32()
+											+	i_num_vars*(CompilerSizeOfSSE2_SD_XMM_INDIRECT() + CompilerSizeOfSSE2_SD_XMM_FRAME())
+											+	((i_num_zeros)?CompilerSizeOfXOR_EXX_EXX() + CompilerSizeOfMOV_EXX_IMM32() + CompilerSizeOfINT32()
+															+ CompilerSizeOfMOV_RXX_RYX() + CompilerSizeOfREP_STOSQ():0)
+											+	CompilerSizeOfMOV_RSP_RBP()
+											+	CompilerSizeOfPOP_RBP()
+											+	CompilerSizeOfRET();
+	//CONSTANTS FOLLOW THE INSTRUCTIONS SO THEY CAN BE ADDRESSED RIP-RELATIVE
+	size_t st_instructions = (parse_info.st_instruction_storage_size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+	size_t st_code_size = st_instructions + parse_info.st_local_storage_size;
+	size_t st_mem_required = sizeof(COMPILER_HEADER)
+						+ (strlen(sc_name_buffer)+1)*sizeof(char)
+						+ parse_info.st_pmap_size*sizeof(unsigned char*);
+
+	unsigned char * pv_code = calculus::code_arena::allocate(st_code_size);
+	if (pv_code == NULL) {
+		if (shared_table.p_entries)
+			free(shared_table.p_entries);
+		return NULL;
+	}
+	PCOMPILER_HEADER pHead = (PCOMPILER_HEADER)malloc(st_mem_required);
+
+	pHead->st_size					= sizeof(COMPILER_HEADER);
+	pHead->pSelf					= pHead;
+	pHead->i_f_flags				= COMPILER_FLAG_NOFLAGS;
+	pHead->i_call_count				= 0;
+	pHead->i_clock_count			= parse_info.i_clock_count;
+	pHead->i_operator_count			= parse_info.i_operator_count;
+	pHead->i_instruction_count		= parse_info.i_instruction_count;
+	pHead->i_num_vars				= i_num_vars;
+	pHead->st_mem_size				= st_mem_required;
+	pHead->psc_name					= ((unsigned char*)pHead)+(sizeof(COMPILER_HEADER)/sizeof(unsigned char));
+	strcpy((char*)pHead->psc_name,sc_name_buffer);
+	pHead->ppv_pmap					= (unsigned char**)(pHead->psc_name + strlen((char*)pHead->psc_name) + 1);
+	pHead->pv_global_storage		= (unsigned char*)(pHead->ppv_pmap + parse_info.st_pmap_size);
+	pHead->pv_code_storage			= pv_code;
+	pHead->st_code_size				= st_code_size;
+	pHead->pInstructions			= (FUNCTION)pv_code;
+	pHead->pv_local_storage			= pv_code + st_instructions;
+	pHead->ppv_auxiliary_storage_toc	= NULL;
+	pHead->pv_auxiliary_storage		= NULL;
+	memset(pv_code,0xCC,st_instructions);	//PAD WITH INT3
+
+	CT_INFO info;	PCT_INFO pInfo = &info;
+	pInfo->pHeader				= pHead;
+	pInfo->pv_instruction_storage_pos = pv_code;
+	pInfo->pv_local_storage_pos		= pHead->pv_local_storage;
+	pInfo->ppv_pmapPos			= pHead->ppv_pmap;
+	pInfo->pv_global_storage_pos		= pHead->pv_global_storage;
+	pInfo->pv_aux_storage_pos			= NULL;
+	pInfo->ppv_vars				= m_ppv_vars;
+	pInfo->i_stack_offset		= (i_num_vars + 1 + i_num_slots)*sizeof(double);
+	pInfo->i_fpu_stack_offset	= 0;
+	pInfo->i_vector_isa			= VECTOR_ISA_NONE;
+	pInfo->p_shared				= &shared_table;
+	//BEGIN OUTPUT TO OPCODE STREAM
+	CompilerWritePUSH_RBP(pInfo);
+	CompilerWriteMOV_RBP_RSP(pInfo);
+	CompilerWriteSUB_RSP_IMM32(pInfo);
+		CompilerWriteINT32(pInfo,i_frame_size);
+	//OUTPUT CALL COUNT INCREMENTING PROCEDURE
+	CompilerWriteMOV_RXX_IMM64(pInfo,REG_EAX);
+		CompilerWritePTR_ENTRY(pInfo,(unsigned char*)pInfo->pv_instruction_storage_pos);
+		CompilerWriteIMM64(pInfo,(qword_type)(size_t)&(pHead->i_call_count));
+	CompilerWriteINC_dword_typePTREXX(pInfo,REG_EAX);
+	//KEEP THE OUTPUT POINTER, CALLED BACK OPERATORS MAY CLOBBER RSI
+	CompilerWriteMOV_RBPX_IMM32_RXX(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,i_output);
+	//SPILL THE VARIABLES WHERE THE OPERATORS EXPECT THEM
+	for(int j = 0;j < i_num_vars;j++) {
+		CompilerWriteSSE2_SD_XMM_INDIRECT(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),REG_EDI,j*(int)sizeof(double));
+		CompilerWriteSSE2_SD_XMM_FRAME(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),COMPILER_X64_V(j));
+	}
+	//A DENSE MATRIX WITH STRUCTURAL ZEROS IS CLEARED IN ONE STRING STORE, THE ENTRIES OVERWRITE THEIR OWN POSITIONS.
+	//THE VARIABLES ARE SPILLED, SO RDI IS FREE AND THE ABI LEAVES THE DIRECTION FLAG CLEAR
+	if (i_num_zeros) {
+		CompilerWriteXOR_EXX_EXX(pInfo,REG_EAX);
+		CompilerWriteMOV_EXX_IMM32(pInfo,REG_ECX);
+			CompilerWriteINT32(pInfo,m_i_rows*m_i_cols);
+		CompilerWriteMOV_RXX_RYX(pInfo,REG_EDI,REG_ESI);
+		CompilerWriteREP_STOSQ(pInfo);
+	}
+	//RECURSE OUTPUT TO OPCODES
+	byte_type * pPreEncodePos = pInfo->pv_instruction_storage_pos;
+
+	for(int i = 0;i < m_i_rows;i++) {
+		for(int k = m_pi_row_pointers[i];k < m_pi_row_pointers[i+1];k++) {
+			int i_position = (m_i_layout == JACOBIAN_LAYOUT_DENSE)?i*m_i_cols+m_pi_column_indices[k]:k;
+			m_ppao_entries[k]->to_X64_shared(pInfo);
+			CompilerWriteMOV_RXX_RBPX_IMM32(pInfo,REG_EAX);
+				CompilerWriteINT32(pInfo,i_output);
+			CompilerWriteSSE2_SD_XMM_INDIRECT(pInfo,SSE2_MOVSD_STORE,REG_XMM(0),REG_EAX,i_position*(int)sizeof(double));
+		}
+	}
+
+	//CHECK IF THE REQUESTED SIZE DIDN'T MATCH THE USED SIZE
+	_ASSERT(pPreEncodePos+InstructionLengthCheck == pInfo->pv_instruction_storage_pos);
+	CompilerWriteMOV_RSP_RBP(pInfo);
+	CompilerWritePOP_RBP(pInfo);
+	CompilerWriteRET(pInfo);
+
+	_ASSERT(pInfo->i_stack_offset == (i_num_vars + 1 + i_num_slots)*(int)sizeof(double));	//THERE WAS A STACK LEAK
+	_ASSERT((byte_type*)pInfo->ppv_pmapPos == (byte_type*)pHead->pv_global_storage);	//THERE WERE MORE PTR ENTRIES THEN PLANNED
+	_ASSERT(pInfo->pv_local_storage_pos == pv_code + st_code_size);					//TOO MUCH LOCAL INFO WAS WRITTEN
+	_ASSERT(pInfo->pv_instruction_storage_pos == pv_code + parse_info.st_instruction_storage_size);	//THE ALLOCATED SIZE DIDN'T MATCH THE USED SIZE
+
+	//THE COMPILE FAILS WHEN THE CODE CAN'T BE SEALED
+	bool b_sealed = calculus::code_arena::seal(pHead);
+	if (!b_sealed) {
+		calculus::code_arena::release(pHead->pv_code_storage,pHead->st_code_size);
+		free(pHead);
+	}
+
+	if (shared_table.p_entries)
+		free(shared_table.p_entries);
+
+	return (b_sealed)?(new IA32_binary(pHead)):NULL;
+#else
+	return NULL;
+#endif
+}
@@ -105,14 +105,23 @@ double calculus::unary_operators::intrinsic_operators::ln::eval_unary(double a)
 	return (double)plog(a);
 }
 
-int calculus::unary_operators::intrinsic_operators::ln::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"log(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::intrinsic_operators::ln::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = ln::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::intrinsic_operators::ln::eval_unary_derivative(double a) {
+	return 1.0/a;
+}
+
+double calculus::unary_operators::intrinsic_operators::ln::eval_unary_second_derivative(double a) {
+	return -1.0/(a*a);
+}
+
+void calculus::unary_operators::intrinsic_operators::ln::write_string(string_writer* psw) {
+	psw->write("log(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FLDZ
@@ -156,6 +165,26 @@ void calculus::unary_operators::intrinsic_operators::ln::annotate(PPT_INFO pPars
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,log
+CALL	rax
+*/
+
+void calculus::unary_operators::intrinsic_operators::ln::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* plog)(double) = ::log;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)plog);
+}
+
+void calculus::unary_operators::intrinsic_operators::ln::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::ln::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -105,14 +105,25 @@ double calculus::unary_operators::intrinsic_operators::log::eval_unary(double a)
 	return (double)plog10(a);
 }
 
-int calculus::unary_operators::intrinsic_operators::log::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"log10(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::intrinsic_operators::log::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = log::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::intrinsic_operators::log::eval_unary_derivative(double a) {
+	double (__cdecl* plog)(double) = ::log;
+	return 1.0/(a*(double)plog(10.0));
+}
+
+double calculus::unary_operators::intrinsic_operators::log::eval_unary_second_derivative(double a) {
+	double (__cdecl* plog)(double) = ::log;
+	return -1.0/(a*a*(double)plog(10.0));
+}
+
+void calculus::unary_operators::intrinsic_operators::log::write_string(string_writer* psw) {
+	psw->write("log10(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FLDZ
@@ -156,6 +167,26 @@ void calculus::unary_operators::intrinsic_operators::log::annotate(PPT_INFO pPar
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,log10
+CALL	rax
+*/
+
+void calculus::unary_operators::intrinsic_operators::log::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* plog10)(double) = ::log10;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)plog10);
+}
+
+void calculus::unary_operators::intrinsic_operators::log::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::log::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -104,16 +104,17 @@ double calculus::binary_operators::intrinsic_operators::multiplication::eval_bin
 	return a*b;
 }
 
-int calculus::binary_operators::intrinsic_operators::multiplication::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 3+this->GetLeftOperand()->to_string(NULL)+this->GetRightOperand()->to_string(NULL);
-	int iOffset = 1;
-	strcpy(pBuffer,"(");
-	iOffset += this->GetLeftOperand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,"*");
-	iOffset += this->GetRightOperand()->to_string(pBuffer+(++iOffset));
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::binary_operators::intrinsic_operators::multiplication::eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd_a[i] = multiplication::eval_binary(pd_a[i],pd_b[i]);
+}
+
+void calculus::binary_operators::intrinsic_operators::multiplication::write_string(string_writer* psw) {
+	psw->write('(');
+	this->GetLeftOperand()->write_string(psw);
+	psw->write('*');
+	this->GetRightOperand()->write_string(psw);
+	psw->write(')');
 }
 
 void calculus::binary_operators::intrinsic_operators::multiplication::to_IA32_binary(PCT_INFO pInfo) {
@@ -156,6 +157,36 @@ void calculus::binary_operators::intrinsic_operators::multiplication::annotate(P
 	this->GetLeftOperand()->annotate(pParseInfo);
 }
 
+/*
+	THE X64 ENCODING IS binary_operator::to_X64_arithmetic WITH OPSD = MULSD
+*/
+
+void calculus::binary_operators::intrinsic_operators::multiplication::to_X64_binary(PCT_INFO pInfo) {
+	this->to_X64_arithmetic(pInfo,SSE2_MULSD,true);
+}
+
+void calculus::binary_operators::intrinsic_operators::multiplication::annotate_X64(PPT_INFO pParseInfo) {
+	this->annotate_X64_arithmetic(pParseInfo,true);
+}
+
+/*
+	THE BATCH ENCODING IS binary_operator::to_X64_vector_arithmetic WITH OPPD = VMULPD
+*/
+
+void calculus::binary_operators::intrinsic_operators::multiplication::to_X64_vector(PCT_INFO pInfo) {
+	this->to_X64_vector_arithmetic(pInfo,VECTOR_MULPD,true);
+}
+
+void calculus::binary_operators::intrinsic_operators::multiplication::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->annotate_X64_vector_arithmetic(pParseInfo,true);
+}
+
+void calculus::binary_operators::intrinsic_operators::multiplication::to_tape(calculus::tape* pTape) {
+	this->GetLeftOperand()->to_tape(pTape);
+	this->GetRightOperand()->to_tape(pTape);
+	pTape->write(TAPE_OP_MULTIPLY);
+}
+
 calculus::algebraic_operator* calculus::binary_operators::intrinsic_operators::multiplication::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0.0);
@@ -103,13 +103,15 @@ double calculus::unary_operators::intrinsic_operators::negate::eval_unary(double
 	return -(a);
 }
 
-int calculus::unary_operators::intrinsic_operators::negate::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 3+this->get_operand()->to_string(NULL);
-	int iOffset = sprintf(pBuffer,"-(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::intrinsic_operators::negate::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = negate::eval_unary(pd[i]);
+}
+
+void calculus::unary_operators::intrinsic_operators::negate::write_string(string_writer* psw) {
+	psw->write("-(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FCHS
@@ -126,6 +128,51 @@ void calculus::unary_operators::intrinsic_operators::negate::annotate(PPT_INFO p
 	pParseInfo->i_instruction_count++;
 	pParseInfo->i_operator_count++;
 }
+/*
+MOVSD	xmm1,qword PTR[rip+sign mask]
+XORPD	xmm0,xmm1
+*/
+
+void calculus::unary_operators::intrinsic_operators::negate::to_X64_binary(PCT_INFO pInfo) {
+	qword_type q_sign_mask = 0x8000000000000000ull;
+	double d_sign_mask = *((double*)&q_sign_mask);
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_MOVSD_LOAD,REG_XMM(1),d_sign_mask);
+	CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_XORPD,REG_XMM(0),REG_XMM(1));
+}
+
+void calculus::unary_operators::intrinsic_operators::negate::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_CONSTANT()
+											+	CompilerSizeOfSSE2_PD_XMM_XMM();
+	pParseInfo->st_local_storage_size			+=	sizeof(double);
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+}
+
+/*
+VPXOR	v0,v0,[rip+sign masks]
+*/
+
+void calculus::unary_operators::intrinsic_operators::negate::to_X64_vector(PCT_INFO pInfo) {
+	qword_type q_sign_mask = 0x8000000000000000ull;
+	double d_sign_mask = *((double*)&q_sign_mask);
+	this->get_operand()->to_X64_vector(pInfo);
+	CompilerWriteVECTOR_PD_VEC_CONSTANT(pInfo,VECTOR_PXOR,REG_XMM(0),REG_XMM(0),d_sign_mask);
+}
+
+void calculus::unary_operators::intrinsic_operators::negate::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_vector(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+	pParseInfo->st_local_storage_size			+=	CompilerLocalSizeOfVECTOR_PD_VEC_CONSTANT(pParseInfo);
+	pParseInfo->i_instruction_count++;
+	pParseInfo->i_operator_count++;
+}
+
+void calculus::unary_operators::intrinsic_operators::negate::to_tape(calculus::tape* pTape) {
+	this->get_operand()->to_tape(pTape);
+	pTape->write(TAPE_OP_NEGATE);
+}
 
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::negate::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
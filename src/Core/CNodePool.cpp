@@ -0,0 +1,226 @@
+/*
+
+CNODEPOOL.CPP: 
+IMPLEMENTS calculus::node_pool
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#include <new>
+
+calculus::node_pool::NODE_POOL_CLASS calculus::node_pool::s_npc_classes[NODE_POOL_CLASSES];
+void* calculus::node_pool::s_pv_first_chunk = NULL;
+size_t calculus::node_pool::s_st_chunk_count = 0;
+std::mutex calculus::node_pool::s_m_lock;
+thread_local calculus::node_pool::NODE_POOL_CACHE calculus::node_pool::s_npc_cache;
+
+#define NODE_POOL_CLASS_OF(st_size)		(((st_size) + NODE_POOL_GRANULE - 1)/NODE_POOL_GRANULE - (((st_size) != 0)?1:0))
+#define NODE_POOL_BLOCK_SIZE(i_class)	(((i_class) + 1)*NODE_POOL_GRANULE)
+
+calculus::node_pool::NODE_POOL_CACHE::~NODE_POOL_CACHE() {
+	//THE BLOCKS OF A THREAD THAT EXITS GO BACK TO THE SHARED LISTS
+	for(int i = 0;i < (int)NODE_POOL_CLASSES;i++)
+		if (pui_count[i])
+			calculus::node_pool::flush(i,pui_count[i]);
+}
+
+void calculus::node_pool::refill(int i_class) {
+	std::lock_guard<std::mutex> lg(s_m_lock);
+	PNODE_POOL_CLASS pClass = s_npc_classes + i_class;
+	if (pClass->st_free < NODE_POOL_BATCH) {
+		//CARVE A NEW CHUNK, THE FIRST GRANULE LINKS THE CHUNKS
+		unsigned char* pv_chunk = (unsigned char*)malloc(NODE_POOL_CHUNK_SIZE);
+		if (pv_chunk == NULL)
+			throw std::bad_alloc();
+		*(void**)pv_chunk = s_pv_first_chunk;
+		s_pv_first_chunk = pv_chunk;
+		s_st_chunk_count++;
+		size_t st_block = NODE_POOL_BLOCK_SIZE(i_class);
+		//PUSHED FROM THE END SO THE BLOCKS ARE HANDED OUT BY INCREASING ADDRESS
+		for(size_t st_block_count = (NODE_POOL_CHUNK_SIZE - NODE_POOL_GRANULE)/st_block;st_block_count;) {
+			void* pv = pv_chunk + NODE_POOL_GRANULE + (--st_block_count)*st_block;
+			*(void**)pv = pClass->pv_free;
+			pClass->pv_free = pv;
+			pClass->st_free++;
+		}
+	}
+	//HAND A BATCH TO THIS THREAD
+	void** ppv_free = s_npc_cache.ppv_free + i_class;
+	for(unsigned int ui = 0;(ui < NODE_POOL_BATCH)&&(pClass->pv_free);ui++) {
+		void* pv = pClass->pv_free;
+		pClass->pv_free = *(void**)pv;
+		pClass->st_free--;
+		pClass->st_outstanding++;
+		*(void**)pv = *ppv_free;
+		*ppv_free = pv;
+		s_npc_cache.pui_count[i_class]++;
+	}
+}
+
+void calculus::node_pool::flush(int i_class,unsigned int ui_count) {
+	//DETACH THE FIRST ui_count BLOCKS OF THIS THREAD, THEN LINK THEM IN FRONT OF THE SHARED LIST
+	void* pv_first = s_npc_cache.ppv_free[i_class];
+	void* pv_last = pv_first;
+	for(unsigned int ui = 1;ui < ui_count;ui++)
+		pv_last = *(void**)pv_last;
+	s_npc_cache.ppv_free[i_class] = *(void**)pv_last;
+	s_npc_cache.pui_count[i_class] -= ui_count;
+	std::lock_guard<std::mutex> lg(s_m_lock);
+	PNODE_POOL_CLASS pClass = s_npc_classes + i_class;
+	*(void**)pv_last = pClass->pv_free;
+	pClass->pv_free = pv_first;
+	pClass->st_free += ui_count;
+	pClass->st_outstanding -= ui_count;
+}
+
+void* calculus::node_pool::allocate(size_t st_size) {
+	if (st_size > NODE_POOL_MAX_SIZE)
+		return ::operator new(st_size);
+	int i_class = NODE_POOL_CLASS_OF(st_size);
+	if (s_npc_cache.ppv_free[i_class] == NULL)
+		refill(i_class);
+	void* pv = s_npc_cache.ppv_free[i_class];
+	s_npc_cache.ppv_free[i_class] = *(void**)pv;
+	s_npc_cache.pui_count[i_class]--;
+	return pv;
+}
+
+void calculus::node_pool::release(void* pv,size_t st_size) {
+	if (pv == NULL)
+		return;
+	if (st_size > NODE_POOL_MAX_SIZE) {
+		::operator delete(pv);
+		return;
+	}
+	int i_class = NODE_POOL_CLASS_OF(st_size);
+	*(void**)pv = s_npc_cache.ppv_free[i_class];
+	s_npc_cache.ppv_free[i_class] = pv;
+	//KEEP ONE BATCH IN HAND AFTER GIVING ONE BACK
+	if (++s_npc_cache.pui_count[i_class] > 2*NODE_POOL_BATCH)
+		flush(i_class,NODE_POOL_BATCH);
+}
+
+bool calculus::node_pool::trim() {
+	//THE BLOCKS CACHED BY THIS THREAD ARE FREE
+	for(int i = 0;i < (int)NODE_POOL_CLASSES;i++)
+		if (s_npc_cache.pui_count[i])
+			flush(i,s_npc_cache.pui_count[i]);
+	std::lock_guard<std::mutex> lg(s_m_lock);
+	for(int i = 0;i < (int)NODE_POOL_CLASSES;i++)
+		if (s_npc_classes[i].st_outstanding)
+			return false;
+	while(s_pv_first_chunk) {
+		void* pv_next = *(void**)s_pv_first_chunk;
+		free(s_pv_first_chunk);
+		s_pv_first_chunk = pv_next;
+	}
+	s_st_chunk_count = 0;
+	for(int i = 0;i < (int)NODE_POOL_CLASSES;i++) {
+		s_npc_classes[i].pv_free = NULL;
+		s_npc_classes[i].st_free = 0;
+	}
+	return true;
+}
+
+size_t calculus::node_pool::get_outstanding_count() {
+	std::lock_guard<std::mutex> lg(s_m_lock);
+	size_t st_count = 0;
+	for(int i = 0;i < (int)NODE_POOL_CLASSES;i++)
+		st_count += s_npc_classes[i].st_outstanding;
+	return st_count;
+}
+
+size_t calculus::node_pool::get_chunk_count() {
+	std::lock_guard<std::mutex> lg(s_m_lock);
+	return s_st_chunk_count;
+}
@@ -102,8 +102,21 @@ double calculus::unary_operators::intrinsic_operators::nop::eval_unary(double a)
 	return a;
 }
 
-int calculus::unary_operators::intrinsic_operators::nop::to_string(char* pBuffer) {
-	return this->get_operand()->to_string(pBuffer);
+void calculus::unary_operators::intrinsic_operators::nop::eval_unary_batch(double* pd,size_t st_n) {
+	UNREFERENCED_PARAMETER(pd);
+	UNREFERENCED_PARAMETER(st_n);
+}
+
+double calculus::unary_operators::intrinsic_operators::nop::eval_unary_derivative(double) {
+	return 1.0;
+}
+
+double calculus::unary_operators::intrinsic_operators::nop::eval_unary_second_derivative(double) {
+	return 0.0;
+}
+
+void calculus::unary_operators::intrinsic_operators::nop::write_string(string_writer* psw) {
+	this->get_operand()->write_string(psw);
 }
 
 void calculus::unary_operators::intrinsic_operators::nop::to_IA32_binary(PCT_INFO pInfo) {
@@ -114,6 +127,26 @@ void calculus::unary_operators::intrinsic_operators::nop::annotate(PPT_INFO pPar
 	this->get_operand()->annotate(pParseInfo);
 }
 
+void calculus::unary_operators::intrinsic_operators::nop::to_X64_binary(PCT_INFO pInfo) {
+	this->get_operand()->to_X64_shared(pInfo);
+}
+
+void calculus::unary_operators::intrinsic_operators::nop::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+}
+
+void calculus::unary_operators::intrinsic_operators::nop::to_X64_vector(PCT_INFO pInfo) {
+	this->get_operand()->to_X64_vector(pInfo);
+}
+
+void calculus::unary_operators::intrinsic_operators::nop::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_vector(pParseInfo);
+}
+
+void calculus::unary_operators::intrinsic_operators::nop::to_tape(calculus::tape* pTape) {
+	this->get_operand()->to_tape(pTape);
+}
+
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::nop::partial_derivative(variable * pVar) {
 	return this->get_operand()->get_partial_derivative(pVar);
 }
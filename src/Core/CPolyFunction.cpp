@@ -152,12 +152,35 @@ calculus::unary_operators::polynomials::polynomial::~polynomial() {
 	}
 }
 
+qword_type calculus::unary_operators::polynomials::polynomial::structural_hash() {
+	qword_type qw_hash = StructuralHashCombine(unary_operator::structural_hash(),(qword_type)this->m_epoly_function_type);
+	qw_hash = StructuralHashCombine(qw_hash,(qword_type)this->m_uiOrder);
+	int i_rows = (this->m_epoly_function_type == Interpolatory)?2:1;
+	for(int j = 0;j < i_rows;j++)
+		for(unsigned int i = 0;i < this->m_uiOrder+1;i++) {
+			qword_type qw_bits;
+			memcpy(&qw_bits,&this->m_ppi_coefficients[j][i],sizeof(qw_bits));
+			qw_hash = StructuralHashCombine(qw_hash,qw_bits);
+		}
+	return qw_hash;
+}
+
+bool calculus::unary_operators::polynomials::polynomial::structural_equal(calculus::algebraic_operator * pao_other) {
+	if (!unary_operator::structural_equal(pao_other))
+		return false;
+	polynomial* pp_other = static_cast<polynomial*>(pao_other);
+	if ((pp_other->m_epoly_function_type != this->m_epoly_function_type)||(pp_other->m_uiOrder != this->m_uiOrder))
+		return false;
+	int i_rows = (this->m_epoly_function_type == Interpolatory)?2:1;
+	for(int j = 0;j < i_rows;j++)
+		if (memcmp(pp_other->m_ppi_coefficients[j],this->m_ppi_coefficients[j],(this->m_uiOrder+1)*sizeof(double)))
+			return false;
+	return true;
+}
+
 double calculus::unary_operators::polynomials::polynomial::eval_unary(double a) {
 	double retVal = 0,temp = 1;
 	unsigned int i;
-	calculus::algebraic_operator * pOperand = this->get_operand();
-	_ASSERT(pOperand != NULL);
-    a = pOperand->eval(&a); //ASSUMES THIS IS A FUNCVTION OF ONLY ONE VARIABLES
 	switch(this->m_epoly_function_type) {
 	case Standard :
 //		STANDARD ALGEBRAIC REPRESENTATION OF POLYNOMIALS
@@ -190,6 +213,11 @@ double calculus::unary_operators::polynomials::polynomial::eval_unary(double a)
 	return retVal;
 }
 
+void calculus::unary_operators::polynomials::polynomial::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = polynomial::eval_unary(pd[i]);
+}
+
 calculus::algebraic_operator* calculus::unary_operators::polynomials::polynomial::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
@@ -243,41 +271,38 @@ calculus::algebraic_operator* calculus::unary_operators::polynomials::polynomial
 	return ppartial_derivative;
 }
 
-int calculus::unary_operators::polynomials::polynomial::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 1024;
-	char scNameBuffer[4096] = "";
-	char scNamePartBuffer[4096] = "";
-	this->get_operand()->to_string(scNameBuffer);
-	strcpy(pBuffer,"POLY(");
+void calculus::unary_operators::polynomials::polynomial::write_string(string_writer* psw) {
+	//THE OPERAND IS REPEATED IN EVERY TERM, IT IS RENDERED ONCE
+	string_writer sw_operand;
+	this->get_operand()->write_string(&sw_operand);
+	const char* scOperand = sw_operand.get_string();
+	psw->write("POLY(");
 	for(unsigned int i = 0;i < this->m_uiOrder+1;i++) {
 		if (i) {
 			switch(this->m_epoly_function_type) {
 //	-Standard : a0 + a1x + a2x^2 + a3x^3 + ...
 			case Standard :
-				sprintf(scNamePartBuffer,(i>1)?"+%g*(%s)^%u":"+%g*(%s)",this->m_ppi_coefficients[0][i],scNameBuffer,i);
+				psw->print((i>1)?"+%g*(%s)^%u":"+%g*(%s)",this->m_ppi_coefficients[0][i],scOperand,i);
 				break;
 //	-Optimized : a0 + x(a1 + x( a2 + x(...)))
 			case Optimized :
-				sprintf(scNamePartBuffer,"+(%s)*(%g",scNameBuffer,this->m_ppi_coefficients[0][i]);
+				psw->print("+(%s)*(%g",scOperand,this->m_ppi_coefficients[0][i]);
 				break;
 //	-Interpolatory : a0 + a1(x-x0) + a2(x-x0)(x-x1) + ...
 			case Interpolatory :
-				sprintf(scNamePartBuffer+strlen(scNamePartBuffer),"*(%s-%g)",scNameBuffer,this->m_ppi_coefficients[1][i]);
-				sprintf(pBuffer+strlen(pBuffer),"+%g%s",this->m_ppi_coefficients[0][i],scNamePartBuffer);
-				continue;
+				psw->print("+%g",this->m_ppi_coefficients[0][i]);
+				for(unsigned int j = 1;j <= i;j++)
+					psw->print("*(%s-%g)",scOperand,this->m_ppi_coefficients[1][j]);
+				break;
 			}
-			strcat(pBuffer,scNamePartBuffer);
 		}
 		else
-			sprintf(pBuffer+strlen(pBuffer),"%g",this->m_ppi_coefficients[0][i]);
-
+			psw->print("%g",this->m_ppi_coefficients[0][i]);
 	}
 	if (this->m_epoly_function_type == Optimized)
 		for(unsigned int i = 0;i < this->m_uiOrder;i++)
-			strcat(pBuffer,")");
-	strcat(pBuffer,")");	
-	return 1024;
+			psw->write(')');
+	psw->write(')');
 }
 
 void calculus::unary_operators::polynomials::polynomial::to_IA32_binary(PCT_INFO pInfo) {
@@ -377,6 +402,58 @@ void calculus::unary_operators::polynomials::polynomial::annotate(PPT_INFO pPars
 	}
 }
 
+/*
+	ALL REPRESENTATIONS ARE EVALUATED BY HORNER'S RULE
+MOVAPD	xmm1,xmm0
+MOVSD	xmm0,qword PTR[rip+a(n)]
+MULSD	xmm0,xmm1			STANDARD/OPTIMIZED
+	OR
+MOVAPD	xmm2,xmm1			INTERPOLATORY
+SUBSD	xmm2,qword PTR[rip+x(i)]
+MULSD	xmm0,xmm2
+ADDSD	xmm0,qword PTR[rip+a(i)]
+	...
+*/
+
+void calculus::unary_operators::polynomials::polynomial::to_X64_binary(PCT_INFO pInfo) {
+	this->get_operand()->to_X64_shared(pInfo);
+	unsigned int i = this->m_uiOrder;
+	CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_MOVAPD,REG_XMM(1),REG_XMM(0));
+	CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0),this->m_ppi_coefficients[0][i]);
+	for(i--;i != 0xffffffffu;i--)
+	{
+		if (this->m_epoly_function_type == Interpolatory) {
+			CompilerWriteSSE2_PD_XMM_XMM(pInfo,SSE2_MOVAPD,REG_XMM(2),REG_XMM(1));
+			CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_SUBSD,REG_XMM(2),this->m_ppi_coefficients[1][i]);
+			CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_MULSD,REG_XMM(0),REG_XMM(2));
+		}
+		else
+			CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_MULSD,REG_XMM(0),REG_XMM(1));
+		CompilerWriteSSE2_SD_XMM_CONSTANT(pInfo,SSE2_ADDSD,REG_XMM(0),this->m_ppi_coefficients[0][i]);
+	}
+}
+
+void calculus::unary_operators::polynomials::polynomial::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+
+    pParseInfo->i_operator_count++;
+
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfSSE2_PD_XMM_XMM()
+											+ CompilerSizeOfSSE2_SD_XMM_CONSTANT()
+											+ this->m_uiOrder*(
+												  CompilerSizeOfSSE2_SD_XMM_XMM()
+												+ CompilerSizeOfSSE2_SD_XMM_CONSTANT());
+	pParseInfo->i_instruction_count			+= 2 + this->m_uiOrder*2;
+	pParseInfo->st_local_storage_size			+= sizeof(double)*(this->m_uiOrder+1);
+	if (this->m_epoly_function_type == Interpolatory) {
+		pParseInfo->st_instruction_storage_size	+= this->m_uiOrder*(
+													  CompilerSizeOfSSE2_PD_XMM_XMM()
+													+ CompilerSizeOfSSE2_SD_XMM_CONSTANT());
+		pParseInfo->i_instruction_count			+= this->m_uiOrder*2;
+		pParseInfo->st_local_storage_size			+= sizeof(double)*this->m_uiOrder;
+	}
+}
+
 calculus::unary_operators::polynomials::polynomial * calculus::unary_operators::polynomials::_poly(unsigned int uiOrder,poly_function_type pft,double * pAis,calculus::algebraic_operator* pF) {
 	return calculus::unary_operators::polynomials::polynomial::create(uiOrder,pft,pAis,pF);
 }
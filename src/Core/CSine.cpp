@@ -102,15 +102,24 @@ double calculus::unary_operators::trigonometric_operators::sine::eval_unary(doub
 	return (double)::sin(a);
 }
 
+void calculus::unary_operators::trigonometric_operators::sine::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = sine::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::trigonometric_operators::sine::eval_unary_derivative(double a) {
+	return (double)::cos(a);
+}
 
-int calculus::unary_operators::trigonometric_operators::sine::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"sin(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+double calculus::unary_operators::trigonometric_operators::sine::eval_unary_second_derivative(double a) {
+	return -(double)::sin(a);
+}
+
+
+void calculus::unary_operators::trigonometric_operators::sine::write_string(string_writer* psw) {
+	psw->write("sin(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 
@@ -127,6 +136,26 @@ void calculus::unary_operators::trigonometric_operators::sine::annotate(PPT_INFO
 	pParseInfo->i_operator_count++;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,sin
+CALL	rax
+*/
+
+void calculus::unary_operators::trigonometric_operators::sine::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* psin)(double) = ::sin;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)psin);
+}
+
+void calculus::unary_operators::trigonometric_operators::sine::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 
 calculus::algebraic_operator* calculus::unary_operators::trigonometric_operators::sine::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
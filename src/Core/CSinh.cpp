@@ -105,15 +105,27 @@ double calculus::unary_operators::hyperbolic_operators::sinh::eval_unary(double
 	return (double)::sinh(a);
 };
 
-int calculus::unary_operators::hyperbolic_operators::sinh::to_string(char* pBuffer)
+void calculus::unary_operators::hyperbolic_operators::sinh::eval_unary_batch(double* pd,size_t st_n)
 {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"sinh(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = sinh::eval_unary(pd[i]);
+};
+
+double calculus::unary_operators::hyperbolic_operators::sinh::eval_unary_derivative(double a)
+{
+	return (double)::cosh(a);
+};
+
+double calculus::unary_operators::hyperbolic_operators::sinh::eval_unary_second_derivative(double a)
+{
+	return (double)::sinh(a);
+};
+
+void calculus::unary_operators::hyperbolic_operators::sinh::write_string(string_writer* psw)
+{
+	psw->write("sinh(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 };
 
 /*
@@ -155,6 +167,28 @@ void calculus::unary_operators::hyperbolic_operators::sinh::annotate(PPT_INFO pP
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 };
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,sinh
+CALL	rax
+*/
+
+void calculus::unary_operators::hyperbolic_operators::sinh::to_X64_binary(PCT_INFO pInfo)
+{
+	double (__cdecl* psinh)(double) = ::sinh;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)psinh);
+};
+
+void calculus::unary_operators::hyperbolic_operators::sinh::annotate_X64(PPT_INFO pParseInfo)
+{
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+};
+
 calculus::algebraic_operator* calculus::unary_operators::hyperbolic_operators::sinh::partial_derivative(variable * pVar)
 {
 	if (!this->is_function_of(pVar))
@@ -0,0 +1,313 @@
+/*
+
+CSPARSEHESSIAN.CPP: 
+IMPLEMENTS calculus::sparse_hessian
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+
+*/
+
+#include "Calculus_cpp.h"
+
+typedef struct HESSIAN_PATTERN_WALK {
+	int*							pi_columns;			//Column of every variable id, -1 for the ids that are no column
+	int*							pi_rows;			//Row of every pair found so far
+	int*							pi_cols;			//Column of every pair found so far
+	int								i_pairs;
+	int								i_pair_capacity;
+	calculus::algebraic_operator**	ppao_visited;		//Operators already walked, open addressed by pointer
+	int								i_visited_capacity;	//A power of 2
+	int								i_visited_count;
+} HESSIAN_PATTERN_WALK,*PHESSIAN_PATTERN_WALK;
+
+static int CompareColumns(const void* pv_a,const void* pv_b) {
+	return *(const int*)pv_a - *(const int*)pv_b;
+}
+
+static bool PatternFirstVisit(PHESSIAN_PATTERN_WALK pWalk,calculus::algebraic_operator* pao_operator) {
+	//A SHARED OPERATOR CONTRIBUTES THE SAME PAIRS EVERY TIME, IT IS WALKED ONCE
+	if (2*(pWalk->i_visited_count+1) > pWalk->i_visited_capacity) {
+		calculus::algebraic_operator** ppao_old = pWalk->ppao_visited;
+		int i_old = pWalk->i_visited_capacity;
+		pWalk->i_visited_capacity = (i_old)?2*i_old:0x40;
+		pWalk->ppao_visited = (calculus::algebraic_operator**)calloc(pWalk->i_visited_capacity,sizeof(calculus::algebraic_operator*));
+		pWalk->i_visited_count = 0;
+		for(int i = 0;i < i_old;i++)
+			if (ppao_old[i])
+				PatternFirstVisit(pWalk,ppao_old[i]);
+		if (ppao_old)
+			free(ppao_old);
+	}
+	int i_mask = pWalk->i_visited_capacity-1;
+	for(int i = (int)((((size_t)pao_operator)>>4)*2654435761u) & i_mask;;i = (i+1) & i_mask) {
+		if (pWalk->ppao_visited[i] == pao_operator)
+			return false;
+		if (pWalk->ppao_visited[i] == NULL) {
+			pWalk->ppao_visited[i] = pao_operator;
+			pWalk->i_visited_count++;
+			return true;
+		}
+	}
+}
+
+static void PatternAddBlock(PHESSIAN_PATTERN_WALK pWalk,calculus::algebraic_operator* pao_a,calculus::algebraic_operator* pao_b) {
+	//EVERY VARIABLE OF pao_a MAY MEET EVERY VARIABLE OF pao_b, BOTH WAYS
+	int i_num_a = pao_a->get_number_of_variables();
+	int i_num_b = pao_b->get_number_of_variables();
+	calculus::variable** ppv_a = pao_a->get_variables();
+	calculus::variable** ppv_b = pao_b->get_variables();
+	if (pWalk->i_pairs + 2*i_num_a*i_num_b > pWalk->i_pair_capacity) {
+		while(pWalk->i_pairs + 2*i_num_a*i_num_b > pWalk->i_pair_capacity)
+			pWalk->i_pair_capacity = (pWalk->i_pair_capacity)?2*pWalk->i_pair_capacity:0x100;
+		pWalk->pi_rows = (int*)realloc(pWalk->pi_rows,pWalk->i_pair_capacity*sizeof(int));
+		pWalk->pi_cols = (int*)realloc(pWalk->pi_cols,pWalk->i_pair_capacity*sizeof(int));
+	}
+	for(int k = 0;k < i_num_a;k++) {
+		int i = pWalk->pi_columns[ppv_a[k]->get_id()];
+		for(int l = 0;l < i_num_b;l++) {
+			int j = pWalk->pi_columns[ppv_b[l]->get_id()];
+			pWalk->pi_rows[pWalk->i_pairs] = i;		pWalk->pi_cols[pWalk->i_pairs++] = j;
+			pWalk->pi_rows[pWalk->i_pairs] = j;		pWalk->pi_cols[pWalk->i_pairs++] = i;
+		}
+	}
+}
+
+static void PatternWalk(PHESSIAN_PATTERN_WALK pWalk,calculus::algebraic_operator* pao_operator) {
+	//LINEAR OPERATORS PASS THE PATTERNS OF THEIR OPERANDS THROUGH, A PRODUCT ALSO COUPLES THE VARIABLES OF ITS
+	//TWO FACTORS AND ANY OTHER OPERATOR MAY COUPLE ALL OF ITS VARIABLES
+	if ((pao_operator->get_number_of_variables() == 0) || !PatternFirstVisit(pWalk,pao_operator))
+		return;
+	const std::type_info& ti = typeid(*pao_operator);
+	if (ti == typeid(calculus::variable))
+		return;
+	if ((ti == typeid(calculus::binary_operators::intrinsic_operators::addition)) || (ti == typeid(calculus::binary_operators::intrinsic_operators::subtraction))) {
+		calculus::binary_operators::binary_operator* pbo = (calculus::binary_operators::binary_operator*)pao_operator;
+		PatternWalk(pWalk,pbo->GetLeftOperand());
+		PatternWalk(pWalk,pbo->GetRightOperand());
+	}
+	else if (ti == typeid(calculus::binary_operators::intrinsic_operators::multiplication)) {
+		calculus::binary_operators::binary_operator* pbo = (calculus::binary_operators::binary_operator*)pao_operator;
+		PatternWalk(pWalk,pbo->GetLeftOperand());
+		PatternWalk(pWalk,pbo->GetRightOperand());
+		PatternAddBlock(pWalk,pbo->GetLeftOperand(),pbo->GetRightOperand());
+	}
+	else if ((ti == typeid(calculus::unary_operators::intrinsic_operators::negate)) || (ti == typeid(calculus::unary_operators::intrinsic_operators::nop)))
+		PatternWalk(pWalk,((calculus::unary_operators::unary_operator*)pao_operator)->get_operand());
+	else if ((ti == typeid(calculus::unary_operators::intrinsic_operators::integer_power)) && (((calculus::unary_operators::intrinsic_operators::integer_power*)pao_operator)->GetExponent() == 1))
+		PatternWalk(pWalk,((calculus::unary_operators::unary_operator*)pao_operator)->get_operand());
+	else
+		PatternAddBlock(pWalk,pao_operator,pao_operator);
+}
+
+calculus::sparse_hessian::sparse_hessian(calculus::algebraic_operator* pao_function) {
+	m_pao_function = pao_function;
+	m_pao_function->addref();
+	m_i_num_vars = pao_function->get_number_of_variables();
+	int n = m_i_num_vars;
+	//COLLECT THE PAIRS OF VARIABLES THE OPERATORS MAY COUPLE, MIRRORED SO THE PATTERN STAYS SYMMETRIC
+	HESSIAN_PATTERN_WALK walk;
+	memset(&walk,0,sizeof(walk));
+	calculus::variable** ppv_vars = pao_function->get_variables();
+	int i_num_ids = calculus::variable::get_count();
+	walk.pi_columns = new int[(i_num_ids)?i_num_ids:1];
+	for(int i = 0;i < i_num_ids;i++)
+		walk.pi_columns[i] = -1;
+	for(int i = 0;i < n;i++)
+		walk.pi_columns[ppv_vars[i]->get_id()] = i;
+	PatternWalk(&walk,pao_function);
+	delete [] walk.pi_columns;
+	if (walk.ppao_visited)
+		free(walk.ppao_visited);
+	int i_pairs = walk.i_pairs;
+	int* pi_pair_rows = walk.pi_rows;
+	int* pi_pair_cols = walk.pi_cols;
+	//BUCKET THE PAIRS BY ROW, THEN SORT AND DROP THE DUPLICATES OF EVERY ROW
+	m_pi_row_pointers = new int[n+1];
+	for(int i = 0;i <= n;i++)
+		m_pi_row_pointers[i] = 0;
+	for(int k = 0;k < i_pairs;k++)
+		m_pi_row_pointers[pi_pair_rows[k]+1]++;
+	for(int i = 0;i < n;i++)
+		m_pi_row_pointers[i+1] += m_pi_row_pointers[i];
+	int* pi_fill = new int[n];
+	for(int i = 0;i < n;i++)
+		pi_fill[i] = m_pi_row_pointers[i];
+	int* pi_columns = new int[(i_pairs)?i_pairs:1];
+	for(int k = 0;k < i_pairs;k++)
+		pi_columns[pi_fill[pi_pair_rows[k]]++] = pi_pair_cols[k];
+	m_i_nonzeros = 0;
+	for(int i = 0;i < n;i++) {
+		int i_begin = m_pi_row_pointers[i];
+		int i_end = m_pi_row_pointers[i+1];
+		qsort(pi_columns+i_begin,i_end-i_begin,sizeof(int),CompareColumns);
+		m_pi_row_pointers[i] = m_i_nonzeros;
+		for(int k = i_begin;k < i_end;k++)
+			if ((k == i_begin) || (pi_columns[k] != pi_columns[k-1]))
+				pi_columns[m_i_nonzeros++] = pi_columns[k];
+	}
+	m_pi_row_pointers[n] = m_i_nonzeros;
+	m_pi_column_indices = new int[(m_i_nonzeros)?m_i_nonzeros:1];
+	memcpy(m_pi_column_indices,pi_columns,m_i_nonzeros*sizeof(int));
+	delete [] pi_columns;
+	delete [] pi_fill;
+	if (pi_pair_cols)
+		free(pi_pair_cols);
+	if (pi_pair_rows)
+		free(pi_pair_rows);
+
+	color_columns();
+	m_pd_direction = new double[(n)?n:1];
+	m_pd_gradient = new double[(n)?n:1];
+	m_pd_products = new double[(n*m_i_num_colors != 0)?n*m_i_num_colors:1];
+	m_pd_values = new double[(m_i_nonzeros)?m_i_nonzeros:1];
+}
+
+calculus::sparse_hessian::~sparse_hessian() {
+	delete [] m_pd_values;
+	delete [] m_pd_products;
+	delete [] m_pd_gradient;
+	delete [] m_pd_direction;
+	delete [] m_pi_colors;
+	delete [] m_pi_column_indices;
+	delete [] m_pi_row_pointers;
+	m_pao_function->release();
+}
+
+calculus::sparse_hessian* calculus::sparse_hessian::create(calculus::algebraic_operator* pao_function) {
+	return new calculus::sparse_hessian(pao_function);
+}
+
+void calculus::sparse_hessian::color_columns() {
+	//GREEDY DISTANCE-2 COLORING, A COLUMN TAKES THE FIRST COLOR NOT USED BY A COLUMN SHARING ONE OF ITS ROWS.
+	//THE PATTERN IS SYMMETRIC SO THE ROWS OF COLUMN j ARE THE COLUMNS OF ROW j
+	int n = m_i_num_vars;
+	m_pi_colors = new int[(n)?n:1];
+	int* pi_forbidden = new int[(n)?n:1];
+	for(int c = 0;c < n;c++)
+		pi_forbidden[c] = -1;
+	m_i_num_colors = 0;
+	for(int j = 0;j < n;j++) {
+		for(int k = m_pi_row_pointers[j];k < m_pi_row_pointers[j+1];k++) {
+			int r = m_pi_column_indices[k];
+			for(int l = m_pi_row_pointers[r];l < m_pi_row_pointers[r+1];l++)
+				if (m_pi_column_indices[l] < j)
+					pi_forbidden[m_pi_colors[m_pi_column_indices[l]]] = j;
+		}
+		int c = 0;
+		while((c < m_i_num_colors) && (pi_forbidden[c] == j))
+			c++;
+		m_pi_colors[j] = c;
+		if (c == m_i_num_colors)
+			m_i_num_colors++;
+	}
+	delete [] pi_forbidden;
+}
+
+double calculus::sparse_hessian::eval(double* pVars,double* pd_values,double* pd_gradient) {
+	int n = m_i_num_vars;
+	if (m_i_num_colors == 0)
+		return m_pao_function->eval_tape(pVars);
+	double d_value = 0;
+	//ONE HESSIAN-VECTOR PRODUCT PER COLOR, SEEDED WITH THE SUM OF THE UNIT VECTORS OF ITS COLUMNS
+	for(int c = 0;c < m_i_num_colors;c++) {
+		for(int j = 0;j < n;j++)
+			m_pd_direction[j] = (m_pi_colors[j] == c)?1.0:0.0;
+		d_value = m_pao_function->eval_hessian_vector(pVars,m_pd_direction,m_pd_gradient,m_pd_products+c*n);
+	}
+	//NO OTHER COLUMN OF THE SAME COLOR REACHES ROW r, SO THE PRODUCT OF THE COLOR OF COLUMN j HOLDS H[r][j] AT r
+	for(int r = 0;r < n;r++)
+		for(int k = m_pi_row_pointers[r];k < m_pi_row_pointers[r+1];k++)
+			pd_values[k] = m_pd_products[m_pi_colors[m_pi_column_indices[k]]*n + r];
+	if (pd_gradient)
+		memcpy(pd_gradient,m_pd_gradient,n*sizeof(double));
+	return d_value;
+}
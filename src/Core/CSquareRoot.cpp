@@ -106,15 +106,17 @@ double calculus::unary_operators::intrinsic_operators::square_root::eval_unary(d
 	return (a < 0)?0:(double)psqrt(a);
 };
 
-int calculus::unary_operators::intrinsic_operators::square_root::to_string(char* pBuffer)
+void calculus::unary_operators::intrinsic_operators::square_root::eval_unary_batch(double* pd,size_t st_n)
 {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"sqrt(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = square_root::eval_unary(pd[i]);
+};
+
+void calculus::unary_operators::intrinsic_operators::square_root::write_string(string_writer* psw)
+{
+	psw->write("sqrt(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 };
 /*
 FLDZ
@@ -142,6 +144,54 @@ void calculus::unary_operators::intrinsic_operators::square_root::annotate(PPT_I
 	pParseInfo->i_operator_count++;
 };
 
+/*
+SQRTSD	xmm0,xmm0
+*/
+
+void calculus::unary_operators::intrinsic_operators::square_root::to_X64_binary(PCT_INFO pInfo)
+{
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteSSE2_SD_XMM_XMM(pInfo,SSE2_SQRTSD,REG_XMM(0),REG_XMM(0));
+};
+
+
+void calculus::unary_operators::intrinsic_operators::square_root::annotate_X64(PPT_INFO pParseInfo)
+{
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+=	CompilerSizeOfSSE2_SD_XMM_XMM();
+	pParseInfo->i_instruction_count++;
+	pParseInfo->i_operator_count++;
+};
+
+/*
+	NEGATIVE LANES ARE CLAMPED TO 0 LIKE eval_unary(), NaN IS PASSED THROUGH
+VPXOR	v1,v1,v1
+VMAXPD	v0,v1,v0
+VSQRTPD	v0,v0
+*/
+
+void calculus::unary_operators::intrinsic_operators::square_root::to_X64_vector(PCT_INFO pInfo)
+{
+	this->get_operand()->to_X64_vector(pInfo);
+	CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_PXOR,REG_XMM(1),REG_XMM(1),REG_XMM(1));
+	CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_MAXPD,REG_XMM(0),REG_XMM(1),REG_XMM(0));
+	CompilerWriteVECTOR_PD_VEC_VEC(pInfo,VECTOR_SQRTPD,REG_XMM(0),REG_XMM(0),REG_XMM(0));
+};
+
+void calculus::unary_operators::intrinsic_operators::square_root::annotate_X64_vector(PPT_INFO pParseInfo)
+{
+	this->get_operand()->annotate_X64_vector(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+=	3*CompilerSizeOfVECTOR_PD_VEC_VEC(pParseInfo);
+	pParseInfo->i_instruction_count			+=	3;
+	pParseInfo->i_operator_count++;
+};
+
+void calculus::unary_operators::intrinsic_operators::square_root::to_tape(calculus::tape* pTape)
+{
+	this->get_operand()->to_tape(pTape);
+	pTape->write(TAPE_OP_SQRT);
+};
+
 
 calculus::algebraic_operator* calculus::unary_operators::intrinsic_operators::square_root::partial_derivative(variable * pVar)
 {
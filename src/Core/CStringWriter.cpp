@@ -0,0 +1,167 @@
+/*
+
+CSTRINGWRITER.CPP: IMPLEMENTS calculus::string_writer
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#include <cstdarg>
+
+calculus::string_writer::string_writer() {
+	m_psc_buffer = m_psc_local;
+	m_psc_buffer[0] = 0;
+	m_st_length = 0;
+	m_st_capacity = STRING_WRITER_LOCAL_SIZE;
+}
+
+calculus::string_writer::~string_writer() {
+	if (m_psc_buffer != m_psc_local)
+		free(m_psc_buffer);
+}
+
+//MAKES ROOM FOR st_length MORE CHARACTERS AND THE TERMINATOR, THE CAPACITY AT LEAST DOUBLES SO APPENDING STAYS LINEAR
+void calculus::string_writer::grow(size_t st_length) {
+	size_t st_capacity = m_st_capacity*2;
+	while (st_capacity < m_st_length+st_length+1)
+		st_capacity *= 2;
+	char* psc_buffer = (char*)malloc(st_capacity);
+	_ASSERT(psc_buffer != NULL);
+	memcpy(psc_buffer,m_psc_buffer,m_st_length+1);
+	if (m_psc_buffer != m_psc_local)
+		free(m_psc_buffer);
+	m_psc_buffer = psc_buffer;
+	m_st_capacity = st_capacity;
+}
+
+void calculus::string_writer::write(const char* psc) {
+	write(psc,strlen(psc));
+}
+
+void calculus::string_writer::write(const char* psc,size_t st_length) {
+	if (m_st_length+st_length >= m_st_capacity)
+		grow(st_length);
+	memcpy(m_psc_buffer+m_st_length,psc,st_length);
+	m_st_length += st_length;
+	m_psc_buffer[m_st_length] = 0;
+}
+
+void calculus::string_writer::write(char c) {
+	if (m_st_length+1 >= m_st_capacity)
+		grow(1);
+	m_psc_buffer[m_st_length++] = c;
+	m_psc_buffer[m_st_length] = 0;
+}
+
+void calculus::string_writer::print(const char* psc_format,...) {
+	va_list marker;
+	va_start(marker,psc_format);
+	int i_length = vsnprintf(m_psc_buffer+m_st_length,m_st_capacity-m_st_length,psc_format,marker);
+	va_end(marker);
+	if (i_length < 0) {
+		m_psc_buffer[m_st_length] = 0;
+		return;
+	}
+	//IT DIDN'T FIT, FORMAT AGAIN ONCE THERE IS ROOM
+	if (m_st_length+i_length >= m_st_capacity) {
+		grow(i_length);
+		va_start(marker,psc_format);
+		vsnprintf(m_psc_buffer+m_st_length,m_st_capacity-m_st_length,psc_format,marker);
+		va_end(marker);
+	}
+	m_st_length += i_length;
+}
+
+void calculus::string_writer::clear() {
+	m_st_length = 0;
+	m_psc_buffer[0] = 0;
+}
@@ -104,16 +104,17 @@ double calculus::binary_operators::intrinsic_operators::subtraction::eval_binary
 	return a-b;
 }
 
-int calculus::binary_operators::intrinsic_operators::subtraction::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 3+this->GetLeftOperand()->to_string(NULL)+this->GetRightOperand()->to_string(NULL);
-	int iOffset = 1;
-	strcpy(pBuffer,"(");
-	iOffset += this->GetLeftOperand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,"-");
-	iOffset += this->GetRightOperand()->to_string(pBuffer+(++iOffset));
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::binary_operators::intrinsic_operators::subtraction::eval_binary_batch(double* pd_a,const double* pd_b,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd_a[i] = subtraction::eval_binary(pd_a[i],pd_b[i]);
+}
+
+void calculus::binary_operators::intrinsic_operators::subtraction::write_string(string_writer* psw) {
+	psw->write('(');
+	this->GetLeftOperand()->write_string(psw);
+	psw->write('-');
+	this->GetRightOperand()->write_string(psw);
+	psw->write(')');
 }
 /*
 THIS IS THE OPCODE BLUEPRINT FOR THE BINARY INTRINSIC OPERATOR SUB
@@ -169,6 +170,36 @@ void calculus::binary_operators::intrinsic_operators::subtraction::annotate(PPT_
 	this->GetLeftOperand()->annotate(pParseInfo);
 }
 
+/*
+	THE X64 ENCODING IS binary_operator::to_X64_arithmetic WITH OPSD = SUBSD
+*/
+
+void calculus::binary_operators::intrinsic_operators::subtraction::to_X64_binary(PCT_INFO pInfo) {
+	this->to_X64_arithmetic(pInfo,SSE2_SUBSD,false);
+}
+
+void calculus::binary_operators::intrinsic_operators::subtraction::annotate_X64(PPT_INFO pParseInfo) {
+	this->annotate_X64_arithmetic(pParseInfo,false);
+}
+
+/*
+	THE BATCH ENCODING IS binary_operator::to_X64_vector_arithmetic WITH OPPD = VSUBPD
+*/
+
+void calculus::binary_operators::intrinsic_operators::subtraction::to_X64_vector(PCT_INFO pInfo) {
+	this->to_X64_vector_arithmetic(pInfo,VECTOR_SUBPD,false);
+}
+
+void calculus::binary_operators::intrinsic_operators::subtraction::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->annotate_X64_vector_arithmetic(pParseInfo,false);
+}
+
+void calculus::binary_operators::intrinsic_operators::subtraction::to_tape(calculus::tape* pTape) {
+	this->GetLeftOperand()->to_tape(pTape);
+	this->GetRightOperand()->to_tape(pTape);
+	pTape->write(TAPE_OP_SUBTRACT);
+}
+
 calculus::algebraic_operator* calculus::binary_operators::intrinsic_operators::subtraction::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0.0);
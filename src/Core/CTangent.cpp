@@ -104,14 +104,25 @@ double calculus::unary_operators::trigonometric_operators::tangent::eval_unary(d
 	return (double)::tan(a);
 }
 
-int calculus::unary_operators::trigonometric_operators::tangent::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 5+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"tan(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::trigonometric_operators::tangent::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = tangent::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::trigonometric_operators::tangent::eval_unary_derivative(double a) {
+	double c = (double)::cos(a);
+	return 1.0/(c*c);
+}
+
+double calculus::unary_operators::trigonometric_operators::tangent::eval_unary_second_derivative(double a) {
+	double t = (double)::tan(a);
+	return 2.0*t*(1.0+t*t);
+}
+
+void calculus::unary_operators::trigonometric_operators::tangent::write_string(string_writer* psw) {
+	psw->write("tan(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 /*
 FLD		st(0)
@@ -144,6 +155,26 @@ void calculus::unary_operators::trigonometric_operators::tangent::annotate(PPT_I
 	pParseInfo->i_operator_count++;
 }
 
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,tan
+CALL	rax
+*/
+
+void calculus::unary_operators::trigonometric_operators::tangent::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* ptan)(double) = ::tan;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)ptan);
+}
+
+void calculus::unary_operators::trigonometric_operators::tangent::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
+
 calculus::algebraic_operator* calculus::unary_operators::trigonometric_operators::tangent::partial_derivative(variable * pVar) {
 	if (!this->is_function_of(pVar))
 		return calculus::_cst(0);
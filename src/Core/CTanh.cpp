@@ -104,14 +104,25 @@ double calculus::unary_operators::hyperbolic_operators::tanh::eval_unary(double
 	return (double)::tanh(a);
 }
 
-int calculus::unary_operators::hyperbolic_operators::tanh::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return 6+this->get_operand()->to_string(NULL);
-	int iOffset = 4;
-	strcpy(pBuffer,"tanh(");
-	iOffset += this->get_operand()->to_string(pBuffer+iOffset);
-	strcpy(pBuffer+iOffset,")");
-	return iOffset+1;
+void calculus::unary_operators::hyperbolic_operators::tanh::eval_unary_batch(double* pd,size_t st_n) {
+	for(size_t i = 0;i < st_n;i++)
+		pd[i] = tanh::eval_unary(pd[i]);
+}
+
+double calculus::unary_operators::hyperbolic_operators::tanh::eval_unary_derivative(double a) {
+	double t = (double)::tanh(a);
+	return 1.0-t*t;
+}
+
+double calculus::unary_operators::hyperbolic_operators::tanh::eval_unary_second_derivative(double a) {
+	double t = (double)::tanh(a);
+	return -2.0*t*(1.0-t*t);
+}
+
+void calculus::unary_operators::hyperbolic_operators::tanh::write_string(string_writer* psw) {
+	psw->write("tanh(");
+	this->get_operand()->write_string(psw);
+	psw->write(')');
 }
 
 /*
@@ -149,3 +160,23 @@ void calculus::unary_operators::hyperbolic_operators::tanh::annotate(PPT_INFO pP
 	pParseInfo->i_operator_count++;
 	pParseInfo->i_features_needed			|= FEAT_NEED_EAX;
 }
+
+/*
+	OPERAND OPCODE, RESULT IN XMM0
+MOV		rax,tanh
+CALL	rax
+*/
+
+void calculus::unary_operators::hyperbolic_operators::tanh::to_X64_binary(PCT_INFO pInfo) {
+	double (__cdecl* ptanh)(double) = ::tanh;
+	this->get_operand()->to_X64_shared(pInfo);
+	CompilerWriteX64CALL_IMM64(pInfo,(void*)ptanh);
+}
+
+void calculus::unary_operators::hyperbolic_operators::tanh::annotate_X64(PPT_INFO pParseInfo) {
+	this->get_operand()->annotate_X64_shared(pParseInfo);
+	pParseInfo->st_instruction_storage_size	+= CompilerSizeOfX64CALL_IMM64();
+	pParseInfo->i_instruction_count			+=	2;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size++;
+}
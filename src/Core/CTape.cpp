@@ -0,0 +1,812 @@
+/*
+
+CTAPE.CPP: 
+IMPLEMENTS calculus::tape
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+
+static int TapeStackDelta(int i_opcode) {
+	switch(i_opcode) {
+	case TAPE_OP_VARIABLE :
+	case TAPE_OP_CONSTANT :
+	case TAPE_OP_CALL :
+		return 1;
+	case TAPE_OP_ADD :
+	case TAPE_OP_SUBTRACT :
+	case TAPE_OP_MULTIPLY :
+	case TAPE_OP_DIVIDE :
+	case TAPE_OP_BINARY :
+		return -1;
+	default :
+		return 0;
+	}
+}
+
+//EVERY THREAD KEEPS ONE SCRATCH BUFFER THAT ONLY GROWS, SO A SHARED TAPE IS SWEPT WITHOUT LOCKS.  A SWEEP NESTED
+//IN ANOTHER ON THE SAME THREAD (A CALLED BACK OPERATOR THAT SWEEPS A TAPE) FINDS IT BUSY AND ALLOCATES ITS OWN
+typedef struct TAPE_THREAD_SCRATCH {
+	double* pd_buffer;
+	size_t st_size;
+	bool b_busy;
+	~TAPE_THREAD_SCRATCH() {
+		if (pd_buffer)
+			delete [] pd_buffer;
+	}
+} TAPE_THREAD_SCRATCH;
+
+static thread_local TAPE_THREAD_SCRATCH s_tts_scratch = {NULL,0,false};
+
+class TapeScratch {
+	double* m_pd_buffer;
+	bool m_b_leased;
+public :
+	TapeScratch(size_t st_size) {
+		m_pd_buffer = NULL;
+		m_b_leased = false;
+		if (!st_size)
+			return;
+		if (s_tts_scratch.b_busy) {
+			m_pd_buffer = new double[st_size];
+			return;
+		}
+		if (st_size > s_tts_scratch.st_size) {
+			if (s_tts_scratch.pd_buffer)
+				delete [] s_tts_scratch.pd_buffer;
+			s_tts_scratch.pd_buffer = new double[st_size];
+			s_tts_scratch.st_size = st_size;
+		}
+		s_tts_scratch.b_busy = true;
+		m_pd_buffer = s_tts_scratch.pd_buffer;
+		m_b_leased = true;
+	}
+	~TapeScratch() {
+		if (m_b_leased)
+			s_tts_scratch.b_busy = false;
+		else if (m_pd_buffer)
+			delete [] m_pd_buffer;
+	}
+	double* get() { return m_pd_buffer; }
+};
+
+calculus::tape::tape(int i_num_vars,calculus::variable** ppv_vars) {
+	m_pti_instructions = NULL;
+	m_i_instruction_count = 0;
+	m_i_instruction_capacity = 0;
+	m_pi_indices = NULL;
+	m_i_index_count = 0;
+	m_i_index_capacity = 0;
+	m_i_depth = 0;
+	m_i_max_depth = 0;
+	m_i_max_gather = 0;
+	m_i_num_vars = i_num_vars;
+	m_ppv_vars = ppv_vars;
+	m_pi_operands = NULL;
+}
+
+calculus::tape::~tape() {
+	if (m_pti_instructions)
+		delete [] m_pti_instructions;
+	if (m_pi_indices)
+		delete [] m_pi_indices;
+	if (m_pi_operands)
+		delete [] m_pi_operands;
+}
+
+PTAPE_INSTRUCTION calculus::tape::append(int i_opcode,int i_arg,int i_stack_delta) {
+	if (m_i_instruction_count == m_i_instruction_capacity) {
+		m_i_instruction_capacity = (m_i_instruction_capacity)?2*m_i_instruction_capacity:16;
+		PTAPE_INSTRUCTION pti = new TAPE_INSTRUCTION[m_i_instruction_capacity];
+		if (m_pti_instructions) {
+			memcpy(pti,m_pti_instructions,m_i_instruction_count*sizeof(TAPE_INSTRUCTION));
+			delete [] m_pti_instructions;
+		}
+		m_pti_instructions = pti;
+	}
+	m_i_depth += i_stack_delta;
+	_ASSERT(m_i_depth > 0);	//AN OPERATOR POPPED MORE THAN IT PUSHED
+	if (m_i_depth > m_i_max_depth)
+		m_i_max_depth = m_i_depth;
+	PTAPE_INSTRUCTION pti = m_pti_instructions + m_i_instruction_count++;
+	pti->i_opcode = i_opcode;
+	pti->i_arg = i_arg;
+	pti->pv_operator = NULL;
+	return pti;
+}
+
+void calculus::tape::write(int i_opcode,int i_arg) {
+	append(i_opcode,i_arg,TapeStackDelta(i_opcode));
+}
+
+void calculus::tape::write_constant(double d_value) {
+	append(TAPE_OP_CONSTANT,0,TapeStackDelta(TAPE_OP_CONSTANT))->d_value = d_value;
+}
+
+void calculus::tape::write_operator(int i_opcode,calculus::algebraic_operator* pao_operator,int i_arg) {
+	append(i_opcode,i_arg,TapeStackDelta(i_opcode))->pv_operator = pao_operator;
+}
+
+void calculus::tape::write_call(calculus::algebraic_operator* pao_operator,int i_num_vars,calculus::variable** ppv_vars) {
+	//THE INDEX TABLE MAPS THE ARGUMENTS OF pao_operator TO THOSE OF THE ROOT
+	if (m_i_index_count + i_num_vars > m_i_index_capacity) {
+		m_i_index_capacity = 2*(m_i_index_count + i_num_vars);
+		int* pi = new int[m_i_index_capacity];
+		if (m_pi_indices) {
+			memcpy(pi,m_pi_indices,m_i_index_count*sizeof(int));
+			delete [] m_pi_indices;
+		}
+		m_pi_indices = pi;
+	}
+	int i_offset = m_i_index_count;
+	for(int i = 0;i < i_num_vars;i++)
+		m_pi_indices[m_i_index_count++] = index_of(ppv_vars[i]);
+	if (i_num_vars > m_i_max_gather)
+		m_i_max_gather = i_num_vars;
+	write_operator(TAPE_OP_CALL,pao_operator,i_offset);
+}
+
+int calculus::tape::index_of(calculus::variable* pVar) {
+	for(int i = 0;i < m_i_num_vars;i++)
+		if (m_ppv_vars[i]->get_id() == pVar->get_id())
+			return i;
+	_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+	return 0;
+}
+
+void calculus::tape::finalize() {
+	_ASSERT(m_i_depth == 1);	//A TAPE LEAVES EXACTLY ONE VALUE
+	//NOTHING IS BUILT LAZILY, THE SWEEPS ONLY READ THE TAPE
+	link_operands();
+}
+
+size_t calculus::tape::stack_scratch_size() {
+	if ((m_i_max_depth > (int)TAPE_LOCAL_STACK_SIZE) || (m_i_max_gather > (int)TAPE_LOCAL_STACK_SIZE))
+		return 2*m_i_max_depth + m_i_max_gather;
+	return 0;
+}
+
+double calculus::tape::eval(double* pVars) {
+	double pd_local[2*TAPE_LOCAL_STACK_SIZE];
+	TapeScratch ts_scratch(stack_scratch_size());
+	double* pd_scratch = ts_scratch.get();
+	double* pd_stack = (pd_scratch)?pd_scratch:pd_local;
+	double* pd_gather = (pd_scratch)?pd_scratch+m_i_max_depth:pd_local+TAPE_LOCAL_STACK_SIZE;
+	double* pd_top = pd_stack - 1;
+	PTAPE_INSTRUCTION pti = m_pti_instructions;
+	PTAPE_INSTRUCTION pti_end = m_pti_instructions + m_i_instruction_count;
+	for(;pti < pti_end;pti++) {
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			*(++pd_top) = pVars[pti->i_arg];
+			break;
+		case TAPE_OP_CONSTANT :
+			*(++pd_top) = pti->d_value;
+			break;
+		case TAPE_OP_NEGATE :
+			*pd_top = -*pd_top;
+			break;
+		case TAPE_OP_SQRT :
+			*pd_top = (*pd_top < 0)?0:(double)::sqrt(*pd_top);
+			break;
+		case TAPE_OP_INT_POW :
+			*pd_top = ::INT_POW(pti->i_arg,*pd_top);
+			break;
+		case TAPE_OP_UNARY :
+			*pd_top = ((calculus::unary_operators::unary_operator*)pti->pv_operator)->eval_unary(*pd_top);
+			break;
+		case TAPE_OP_ADD :
+			pd_top--;
+			pd_top[0] += pd_top[1];
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_top--;
+			pd_top[0] -= pd_top[1];
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_top--;
+			pd_top[0] *= pd_top[1];
+			break;
+		case TAPE_OP_DIVIDE :
+			pd_top--;
+			pd_top[0] /= pd_top[1];
+			break;
+		case TAPE_OP_BINARY :
+			pd_top--;
+			pd_top[0] = ((calculus::binary_operators::binary_operator*)pti->pv_operator)->eval_binary(pd_top[0],pd_top[1]);
+			break;
+		case TAPE_OP_CALL : {
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]];
+			*(++pd_top) = pao->eval(pd_gather);
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	return *pd_top;
+}
+
+//THE CENTRED DIFFERENCE OF AN OPAQUE OPERATOR ALONG ITS i-TH VARIABLE, AROUND pd_point
+static double TapeCallPartial(calculus::algebraic_operator* pao,double* pd_point,int i) {
+	double d_point = pd_point[i];
+	double h = TapeDifferenceStep(d_point);
+	pd_point[i] = d_point + h;
+	double d_forward = pao->eval(pd_point);
+	pd_point[i] = d_point - h;
+	double d_backward = pao->eval(pd_point);
+	pd_point[i] = d_point;
+	return (d_forward-d_backward)/(2*h);
+}
+
+void calculus::tape::link_operands() {
+	//REPLAY THE STACK ONCE TO LINK EVERY INSTRUCTION TO THE INSTRUCTIONS PRODUCING ITS OPERANDS
+	int* pi_stack = new int[m_i_max_depth];
+	int i_top = -1;
+	m_pi_operands = new int[2*m_i_instruction_count];
+	for(int j = 0;j < m_i_instruction_count;j++) {
+		int* pi_operands = m_pi_operands + 2*j;
+		pi_operands[0] = pi_operands[1] = -1;
+		switch(TapeStackDelta(m_pti_instructions[j].i_opcode)) {
+		case 1 :
+			pi_stack[++i_top] = j;
+			break;
+		case 0 :
+			pi_operands[0] = pi_stack[i_top];
+			pi_stack[i_top] = j;
+			break;
+		default :
+			pi_operands[1] = pi_stack[i_top--];
+			pi_operands[0] = pi_stack[i_top];
+			pi_stack[i_top] = j;
+		}
+	}
+	delete [] pi_stack;
+}
+
+double calculus::tape::gradient(double* pVars,double* pd_gradient) {
+	_ASSERT(m_pi_operands);	//THE TAPE WAS NOT FINALIZED
+	TapeScratch ts_scratch(2*m_i_instruction_count + m_i_max_gather);
+	double* pd_value = ts_scratch.get();
+	double* pd_adjoint = pd_value + m_i_instruction_count;
+	double* pd_gather = pd_value + 2*m_i_instruction_count;
+	//FORWARD SWEEP, KEEPS THE VALUE OF EVERY INSTRUCTION
+	for(int j = 0;j < m_i_instruction_count;j++) {
+		PTAPE_INSTRUCTION pti = m_pti_instructions + j;
+		const int* pi_operands = m_pi_operands + 2*j;
+		double x = (pi_operands[0] >= 0)?pd_value[pi_operands[0]]:0;
+		double y = (pi_operands[1] >= 0)?pd_value[pi_operands[1]]:0;
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			pd_value[j] = pVars[pti->i_arg];
+			break;
+		case TAPE_OP_CONSTANT :
+			pd_value[j] = pti->d_value;
+			break;
+		case TAPE_OP_NEGATE :
+			pd_value[j] = -x;
+			break;
+		case TAPE_OP_SQRT :
+			pd_value[j] = (x < 0)?0:(double)::sqrt(x);
+			break;
+		case TAPE_OP_INT_POW :
+			pd_value[j] = ::INT_POW(pti->i_arg,x);
+			break;
+		case TAPE_OP_UNARY :
+			pd_value[j] = ((calculus::unary_operators::unary_operator*)pti->pv_operator)->eval_unary(x);
+			break;
+		case TAPE_OP_ADD :
+			pd_value[j] = x + y;
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_value[j] = x - y;
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_value[j] = x * y;
+			break;
+		case TAPE_OP_DIVIDE :
+			pd_value[j] = x / y;
+			break;
+		case TAPE_OP_BINARY :
+			pd_value[j] = ((calculus::binary_operators::binary_operator*)pti->pv_operator)->eval_binary(x,y);
+			break;
+		case TAPE_OP_CALL : {
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]];
+			pd_value[j] = pao->eval(pd_gather);
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+		pd_adjoint[j] = 0;
+	}
+	//REVERSE SWEEP, EVERY INSTRUCTION PUSHES ITS ADJOINT DOWN TO ITS OPERANDS
+	for(int i = 0;i < m_i_num_vars;i++)
+		pd_gradient[i] = 0;
+	pd_adjoint[m_i_instruction_count-1] = 1;
+	for(int j = m_i_instruction_count-1;j >= 0;j--) {
+		double a = pd_adjoint[j];
+		if (a == 0)
+			continue;
+		PTAPE_INSTRUCTION pti = m_pti_instructions + j;
+		const int* pi_operands = m_pi_operands + 2*j;
+		double x = (pi_operands[0] >= 0)?pd_value[pi_operands[0]]:0;
+		double y = (pi_operands[1] >= 0)?pd_value[pi_operands[1]]:0;
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			pd_gradient[pti->i_arg] += a;
+			break;
+		case TAPE_OP_CONSTANT :
+			break;
+		case TAPE_OP_NEGATE :
+			pd_adjoint[pi_operands[0]] -= a;
+			break;
+		case TAPE_OP_SQRT :
+			if (pd_value[j] > 0)
+				pd_adjoint[pi_operands[0]] += a*0.5/pd_value[j];
+			break;
+		case TAPE_OP_INT_POW :
+			if (pti->i_arg)
+				pd_adjoint[pi_operands[0]] += a*pti->i_arg*::INT_POW(pti->i_arg-1,x);
+			break;
+		case TAPE_OP_UNARY :
+			pd_adjoint[pi_operands[0]] += a*((calculus::unary_operators::unary_operator*)pti->pv_operator)->eval_unary_derivative(x);
+			break;
+		case TAPE_OP_ADD :
+			pd_adjoint[pi_operands[0]] += a;
+			pd_adjoint[pi_operands[1]] += a;
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_adjoint[pi_operands[0]] += a;
+			pd_adjoint[pi_operands[1]] -= a;
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_adjoint[pi_operands[0]] += a*y;
+			pd_adjoint[pi_operands[1]] += a*x;
+			break;
+		case TAPE_OP_DIVIDE :
+			pd_adjoint[pi_operands[0]] += a/y;
+			pd_adjoint[pi_operands[1]] -= a*pd_value[j]/y;
+			break;
+		case TAPE_OP_BINARY : {
+			double d_x,d_y;
+			((calculus::binary_operators::binary_operator*)pti->pv_operator)->eval_binary_derivatives(x,y,&d_x,&d_y);
+			pd_adjoint[pi_operands[0]] += a*d_x;
+			pd_adjoint[pi_operands[1]] += a*d_y;
+			break;
+		}
+		case TAPE_OP_CALL : {
+			//AN OPAQUE OPERATOR, ITS PARTIALS ARE CENTRED DIFFERENCES
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]];
+			for(int i = 0;i < i_num_vars;i++) {
+				double h = TapeDifferenceStep(pd_gather[i]);
+				pd_gather[i] = pVars[pi_indices[i]] + h;
+				double d_forward = pao->eval(pd_gather);
+				pd_gather[i] = pVars[pi_indices[i]] - h;
+				double d_backward = pao->eval(pd_gather);
+				pd_gather[i] = pVars[pi_indices[i]];
+				pd_gradient[pi_indices[i]] += a*(d_forward-d_backward)/(2*h);
+			}
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	return pd_value[m_i_instruction_count-1];
+}
+
+double calculus::tape::eval_dual(double* pVars,const double* pd_direction,double* pd_tangent) {
+	//THE TANGENT STACK MOVES IN LOCKSTEP WITH THE VALUE STACK
+	double pd_local[3*TAPE_LOCAL_STACK_SIZE];
+	TapeScratch ts_scratch(stack_scratch_size());
+	double* pd_scratch = ts_scratch.get();
+	double* pd_stack = (pd_scratch)?pd_scratch:pd_local;
+	double* pd_gather = (pd_scratch)?pd_scratch+m_i_max_depth:pd_local+TAPE_LOCAL_STACK_SIZE;
+	double* pd_top = pd_stack - 1;
+	double* pd_dtop = ((pd_scratch)?pd_scratch+m_i_max_depth+m_i_max_gather:pd_local+2*TAPE_LOCAL_STACK_SIZE) - 1;
+	PTAPE_INSTRUCTION pti = m_pti_instructions;
+	PTAPE_INSTRUCTION pti_end = m_pti_instructions + m_i_instruction_count;
+	for(;pti < pti_end;pti++) {
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			*(++pd_top) = pVars[pti->i_arg];
+			*(++pd_dtop) = pd_direction[pti->i_arg];
+			break;
+		case TAPE_OP_CONSTANT :
+			*(++pd_top) = pti->d_value;
+			*(++pd_dtop) = 0;
+			break;
+		case TAPE_OP_NEGATE :
+			*pd_top = -*pd_top;
+			*pd_dtop = -*pd_dtop;
+			break;
+		case TAPE_OP_SQRT :
+			*pd_top = (*pd_top < 0)?0:(double)::sqrt(*pd_top);
+			*pd_dtop = (*pd_top > 0)?0.5*(*pd_dtop)/(*pd_top):0;
+			break;
+		case TAPE_OP_INT_POW :
+			*pd_dtop = (pti->i_arg)?(*pd_dtop)*pti->i_arg*::INT_POW(pti->i_arg-1,*pd_top):0;
+			*pd_top = ::INT_POW(pti->i_arg,*pd_top);
+			break;
+		case TAPE_OP_UNARY : {
+			calculus::unary_operators::unary_operator* puo = (calculus::unary_operators::unary_operator*)pti->pv_operator;
+			*pd_dtop *= puo->eval_unary_derivative(*pd_top);
+			*pd_top = puo->eval_unary(*pd_top);
+			break;
+		}
+		case TAPE_OP_ADD :
+			pd_top--;	pd_dtop--;
+			pd_top[0] += pd_top[1];
+			pd_dtop[0] += pd_dtop[1];
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_top--;	pd_dtop--;
+			pd_top[0] -= pd_top[1];
+			pd_dtop[0] -= pd_dtop[1];
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_top--;	pd_dtop--;
+			pd_dtop[0] = pd_dtop[0]*pd_top[1] + pd_top[0]*pd_dtop[1];
+			pd_top[0] *= pd_top[1];
+			break;
+		case TAPE_OP_DIVIDE :
+			pd_top--;	pd_dtop--;
+			pd_top[0] /= pd_top[1];
+			pd_dtop[0] = (pd_dtop[0] - pd_top[0]*pd_dtop[1])/pd_top[1];
+			break;
+		case TAPE_OP_BINARY : {
+			calculus::binary_operators::binary_operator* pbo = (calculus::binary_operators::binary_operator*)pti->pv_operator;
+			double d_x,d_y;
+			pd_top--;	pd_dtop--;
+			pbo->eval_binary_derivatives(pd_top[0],pd_top[1],&d_x,&d_y);
+			pd_dtop[0] = d_x*pd_dtop[0] + d_y*pd_dtop[1];
+			pd_top[0] = pbo->eval_binary(pd_top[0],pd_top[1]);
+			break;
+		}
+		case TAPE_OP_CALL : {
+			//AN OPAQUE OPERATOR, ITS DIRECTIONAL DERIVATIVE IS A CENTRED DIFFERENCE ALONG THE GATHERED DIRECTION
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			double d_norm = 0;
+			for(int i = 0;i < i_num_vars;i++)
+				if (fabs(pVars[pi_indices[i]]) > d_norm)
+					d_norm = fabs(pVars[pi_indices[i]]);
+			double h = TapeDifferenceStep(d_norm);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]] + h*pd_direction[pi_indices[i]];
+			double d_forward = pao->eval(pd_gather);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]] - h*pd_direction[pi_indices[i]];
+			double d_backward = pao->eval(pd_gather);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]];
+			*(++pd_top) = pao->eval(pd_gather);
+			*(++pd_dtop) = (d_forward-d_backward)/(2*h);
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	*pd_tangent = *pd_dtop;
+	return *pd_top;
+}
+
+double calculus::tape::hessian_vector(double* pVars,const double* pd_direction,double* pd_gradient,double* pd_hv) {
+	_ASSERT(m_pi_operands);	//THE TAPE WAS NOT FINALIZED
+	TapeScratch ts_scratch(4*m_i_instruction_count + m_i_max_gather);
+	double* pd_value = ts_scratch.get();
+	double* pd_tangent = pd_value + m_i_instruction_count;
+	double* pd_adjoint = pd_value + 2*m_i_instruction_count;
+	double* pd_adjoint_tangent = pd_value + 3*m_i_instruction_count;
+	double* pd_gather = pd_value + 4*m_i_instruction_count;
+	//FORWARD SWEEP, KEEPS THE VALUE OF EVERY INSTRUCTION AND ITS DERIVATIVE ALONG pd_direction
+	for(int j = 0;j < m_i_instruction_count;j++) {
+		PTAPE_INSTRUCTION pti = m_pti_instructions + j;
+		const int* pi_operands = m_pi_operands + 2*j;
+		double x = (pi_operands[0] >= 0)?pd_value[pi_operands[0]]:0;
+		double y = (pi_operands[1] >= 0)?pd_value[pi_operands[1]]:0;
+		double t_x = (pi_operands[0] >= 0)?pd_tangent[pi_operands[0]]:0;
+		double t_y = (pi_operands[1] >= 0)?pd_tangent[pi_operands[1]]:0;
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			pd_value[j] = pVars[pti->i_arg];
+			pd_tangent[j] = pd_direction[pti->i_arg];
+			break;
+		case TAPE_OP_CONSTANT :
+			pd_value[j] = pti->d_value;
+			pd_tangent[j] = 0;
+			break;
+		case TAPE_OP_NEGATE :
+			pd_value[j] = -x;
+			pd_tangent[j] = -t_x;
+			break;
+		case TAPE_OP_SQRT :
+			pd_value[j] = (x < 0)?0:(double)::sqrt(x);
+			pd_tangent[j] = (pd_value[j] > 0)?0.5*t_x/pd_value[j]:0;
+			break;
+		case TAPE_OP_INT_POW :
+			pd_value[j] = ::INT_POW(pti->i_arg,x);
+			pd_tangent[j] = (pti->i_arg)?t_x*pti->i_arg*::INT_POW(pti->i_arg-1,x):0;
+			break;
+		case TAPE_OP_UNARY : {
+			calculus::unary_operators::unary_operator* puo = (calculus::unary_operators::unary_operator*)pti->pv_operator;
+			pd_value[j] = puo->eval_unary(x);
+			pd_tangent[j] = t_x*puo->eval_unary_derivative(x);
+			break;
+		}
+		case TAPE_OP_ADD :
+			pd_value[j] = x + y;
+			pd_tangent[j] = t_x + t_y;
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_value[j] = x - y;
+			pd_tangent[j] = t_x - t_y;
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_value[j] = x * y;
+			pd_tangent[j] = t_x*y + x*t_y;
+			break;
+		case TAPE_OP_DIVIDE :
+			pd_value[j] = x / y;
+			pd_tangent[j] = (t_x - pd_value[j]*t_y)/y;
+			break;
+		case TAPE_OP_BINARY : {
+			calculus::binary_operators::binary_operator* pbo = (calculus::binary_operators::binary_operator*)pti->pv_operator;
+			double d_x,d_y;
+			pbo->eval_binary_derivatives(x,y,&d_x,&d_y);
+			pd_value[j] = pbo->eval_binary(x,y);
+			pd_tangent[j] = d_x*t_x + d_y*t_y;
+			break;
+		}
+		case TAPE_OP_CALL : {
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			double d_norm = 0;
+			for(int i = 0;i < i_num_vars;i++)
+				if (fabs(pVars[pi_indices[i]]) > d_norm)
+					d_norm = fabs(pVars[pi_indices[i]]);
+			double h = TapeDifferenceStep(d_norm);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]] + h*pd_direction[pi_indices[i]];
+			double d_forward = pao->eval(pd_gather);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]] - h*pd_direction[pi_indices[i]];
+			double d_backward = pao->eval(pd_gather);
+			for(int i = 0;i < i_num_vars;i++)
+				pd_gather[i] = pVars[pi_indices[i]];
+			pd_value[j] = pao->eval(pd_gather);
+			pd_tangent[j] = (d_forward-d_backward)/(2*h);
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+		pd_adjoint[j] = pd_adjoint_tangent[j] = 0;
+	}
+	//REVERSE SWEEP OF THE ADJOINTS AND OF THEIR DERIVATIVES ALONG pd_direction, THE LATTER SUM TO H*pd_direction
+	for(int i = 0;i < m_i_num_vars;i++)
+		pd_gradient[i] = pd_hv[i] = 0;
+	pd_adjoint[m_i_instruction_count-1] = 1;
+	for(int j = m_i_instruction_count-1;j >= 0;j--) {
+		double a = pd_adjoint[j];
+		double b = pd_adjoint_tangent[j];
+		if ((a == 0) && (b == 0))
+			continue;
+		PTAPE_INSTRUCTION pti = m_pti_instructions + j;
+		const int* pi_operands = m_pi_operands + 2*j;
+		double x = (pi_operands[0] >= 0)?pd_value[pi_operands[0]]:0;
+		double y = (pi_operands[1] >= 0)?pd_value[pi_operands[1]]:0;
+		double t_x = (pi_operands[0] >= 0)?pd_tangent[pi_operands[0]]:0;
+		double t_y = (pi_operands[1] >= 0)?pd_tangent[pi_operands[1]]:0;
+		switch(pti->i_opcode) {
+		case TAPE_OP_VARIABLE :
+			pd_gradient[pti->i_arg] += a;
+			pd_hv[pti->i_arg] += b;
+			break;
+		case TAPE_OP_CONSTANT :
+			break;
+		case TAPE_OP_NEGATE :
+			pd_adjoint[pi_operands[0]] -= a;
+			pd_adjoint_tangent[pi_operands[0]] -= b;
+			break;
+		case TAPE_OP_SQRT :
+			if (pd_value[j] > 0) {
+				double d = 0.5/pd_value[j];
+				double dd = -0.25/(pd_value[j]*pd_value[j]*pd_value[j]);
+				pd_adjoint[pi_operands[0]] += a*d;
+				pd_adjoint_tangent[pi_operands[0]] += b*d + a*dd*t_x;
+			}
+			break;
+		case TAPE_OP_INT_POW :
+			if (pti->i_arg) {
+				double d = pti->i_arg*::INT_POW(pti->i_arg-1,x);
+				double dd = (pti->i_arg != 1)?pti->i_arg*(pti->i_arg-1)*::INT_POW(pti->i_arg-2,x):0;
+				pd_adjoint[pi_operands[0]] += a*d;
+				pd_adjoint_tangent[pi_operands[0]] += b*d + a*dd*t_x;
+			}
+			break;
+		case TAPE_OP_UNARY : {
+			calculus::unary_operators::unary_operator* puo = (calculus::unary_operators::unary_operator*)pti->pv_operator;
+			double d = puo->eval_unary_derivative(x);
+			pd_adjoint[pi_operands[0]] += a*d;
+			pd_adjoint_tangent[pi_operands[0]] += b*d + a*puo->eval_unary_second_derivative(x)*t_x;
+			break;
+		}
+		case TAPE_OP_ADD :
+			pd_adjoint[pi_operands[0]] += a;
+			pd_adjoint[pi_operands[1]] += a;
+			pd_adjoint_tangent[pi_operands[0]] += b;
+			pd_adjoint_tangent[pi_operands[1]] += b;
+			break;
+		case TAPE_OP_SUBTRACT :
+			pd_adjoint[pi_operands[0]] += a;
+			pd_adjoint[pi_operands[1]] -= a;
+			pd_adjoint_tangent[pi_operands[0]] += b;
+			pd_adjoint_tangent[pi_operands[1]] -= b;
+			break;
+		case TAPE_OP_MULTIPLY :
+			pd_adjoint[pi_operands[0]] += a*y;
+			pd_adjoint[pi_operands[1]] += a*x;
+			pd_adjoint_tangent[pi_operands[0]] += b*y + a*t_y;
+			pd_adjoint_tangent[pi_operands[1]] += b*x + a*t_x;
+			break;
+		case TAPE_OP_DIVIDE : {
+			double q = pd_value[j];
+			pd_adjoint[pi_operands[0]] += a/y;
+			pd_adjoint[pi_operands[1]] -= a*q/y;
+			pd_adjoint_tangent[pi_operands[0]] += (b - a*t_y/y)/y;
+			pd_adjoint_tangent[pi_operands[1]] -= (b*q + a*(pd_tangent[j] - q*t_y/y))/y;
+			break;
+		}
+		case TAPE_OP_BINARY : {
+			calculus::binary_operators::binary_operator* pbo = (calculus::binary_operators::binary_operator*)pti->pv_operator;
+			double d_x,d_y,d_xx,d_xy,d_yy;
+			pbo->eval_binary_derivatives(x,y,&d_x,&d_y);
+			pbo->eval_binary_second_derivatives(x,y,&d_xx,&d_xy,&d_yy);
+			pd_adjoint[pi_operands[0]] += a*d_x;
+			pd_adjoint[pi_operands[1]] += a*d_y;
+			pd_adjoint_tangent[pi_operands[0]] += b*d_x + a*(d_xx*t_x + d_xy*t_y);
+			pd_adjoint_tangent[pi_operands[1]] += b*d_y + a*(d_xy*t_x + d_yy*t_y);
+			break;
+		}
+		case TAPE_OP_CALL : {
+			//AN OPAQUE OPERATOR, ITS PARTIALS ARE CENTRED DIFFERENCES AND THEIR DERIVATIVES ALONG pd_direction
+			//ARE CENTRED DIFFERENCES OF THOSE, TAKEN WITH THE WIDER SECOND DIFFERENCE STEP
+			calculus::algebraic_operator* pao = (calculus::algebraic_operator*)pti->pv_operator;
+			int i_num_vars = pao->get_number_of_variables();
+			const int* pi_indices = m_pi_indices + pti->i_arg;
+			double d_norm = 0;
+			for(int i = 0;i < i_num_vars;i++)
+				if (fabs(pVars[pi_indices[i]]) > d_norm)
+					d_norm = fabs(pVars[pi_indices[i]]);
+			double s = TapeSecondDifferenceStep(d_norm);
+			for(int i = 0;i < i_num_vars;i++) {
+				for(int k = 0;k < i_num_vars;k++)
+					pd_gather[k] = pVars[pi_indices[k]];
+				double d = TapeCallPartial(pao,pd_gather,i);
+				pd_gradient[pi_indices[i]] += a*d;
+				pd_hv[pi_indices[i]] += b*d;
+				if (a == 0)
+					continue;
+				for(int k = 0;k < i_num_vars;k++)
+					pd_gather[k] = pVars[pi_indices[k]] + s*pd_direction[pi_indices[k]];
+				double d_forward = TapeCallPartial(pao,pd_gather,i);
+				for(int k = 0;k < i_num_vars;k++)
+					pd_gather[k] = pVars[pi_indices[k]] - s*pd_direction[pi_indices[k]];
+				double d_backward = TapeCallPartial(pao,pd_gather,i);
+				pd_hv[pi_indices[i]] += a*(d_forward-d_backward)/(2*s);
+			}
+			break;
+		}
+		default :
+			_ASSERT(0);	//THIS IS AN ILLEGAL PROGRAM STATE
+		}
+	}
+	return pd_value[m_i_instruction_count-1];
+}
@@ -0,0 +1,291 @@
+/*
+
+CTHREADPOOL.CPP: 
+IMPLEMENTS calculus::thread_pool
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
+typedef struct THREAD_POOL_JOB {
+	PARALLEL_TASK			pf_task;
+	void*					pv_context;
+	std::atomic<size_t>		st_remaining;			//Chunks not yet finished, the caller waits for 0
+} THREAD_POOL_JOB,*PTHREAD_POOL_JOB;
+
+typedef struct THREAD_POOL_CHUNK {
+	PTHREAD_POOL_JOB		pj_job;
+	size_t					st_begin;
+	size_t					st_end;
+} THREAD_POOL_CHUNK,*PTHREAD_POOL_CHUNK;
+
+typedef struct THREAD_POOL_QUEUE {
+	std::mutex						m_lock;
+	std::deque<THREAD_POOL_CHUNK>	dq_chunks;		//The owner works at the back, the thieves at the front
+} THREAD_POOL_QUEUE,*PTHREAD_POOL_QUEUE;
+
+struct calculus::THREAD_POOL_STATE {
+	int						i_num_workers;
+	std::thread*			pth_workers;
+	PTHREAD_POOL_QUEUE		pq_queues;				//One per worker
+	std::atomic<size_t>		st_queued;				//Chunks waiting in the queues
+	std::atomic<unsigned>	ui_next_queue;			//Where the next external caller starts dealing
+	std::mutex				m_sleep;
+	std::condition_variable	cv_wake;
+	bool					b_stop;
+};
+
+std::atomic<calculus::thread_pool*> calculus::thread_pool::s_ptp_service(NULL);
+
+//THE QUEUE OF THE WORKER RUNNING ON THIS THREAD, -1 ON ANY OTHER THREAD
+static thread_local int s_i_worker_queue = -1;
+
+static bool ThreadPoolTake(calculus::THREAD_POOL_STATE* pState,int i_home,PTHREAD_POOL_CHUNK pChunk) {
+	int n = pState->i_num_workers;
+	//THE NEWEST CHUNK OF THE HOME QUEUE IS STILL WARM IN THE CACHE
+	if (i_home >= 0) {
+		PTHREAD_POOL_QUEUE pq = pState->pq_queues + i_home;
+		std::lock_guard<std::mutex> lg(pq->m_lock);
+		if (!pq->dq_chunks.empty()) {
+			*pChunk = pq->dq_chunks.back();
+			pq->dq_chunks.pop_back();
+			pState->st_queued--;
+			return true;
+		}
+	}
+	//STEAL THE OLDEST CHUNK OF THE NEXT QUEUE THAT HAS ONE
+	int i_first = (i_home >= 0)?i_home+1:0;
+	for(int i = 0;i < n;i++) {
+		if ((i_first+i)%n == i_home)
+			continue;
+		PTHREAD_POOL_QUEUE pq = pState->pq_queues + (i_first+i)%n;
+		std::lock_guard<std::mutex> lg(pq->m_lock);
+		if (!pq->dq_chunks.empty()) {
+			*pChunk = pq->dq_chunks.front();
+			pq->dq_chunks.pop_front();
+			pState->st_queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+static void ThreadPoolRun(PTHREAD_POOL_CHUNK pChunk) {
+	PTHREAD_POOL_JOB pj = pChunk->pj_job;
+	pj->pf_task(pj->pv_context,pChunk->st_begin,pChunk->st_end);
+	//THE CALLER MAY RETURN AND FREE THE JOB AS SOON AS THE COUNT REACHES 0, IT IS NOT TOUCHED AFTERWARDS
+	pj->st_remaining.fetch_sub(1,std::memory_order_acq_rel);
+}
+
+calculus::thread_pool::thread_pool(int i_num_threads) {
+	m_p_state = new THREAD_POOL_STATE();
+	m_p_state->i_num_workers = (i_num_threads > 1)?i_num_threads-1:0;
+	m_p_state->st_queued = 0;
+	m_p_state->ui_next_queue = 0;
+	m_p_state->b_stop = false;
+	m_p_state->pq_queues = (m_p_state->i_num_workers)?new THREAD_POOL_QUEUE[m_p_state->i_num_workers]:NULL;
+	m_p_state->pth_workers = (m_p_state->i_num_workers)?new std::thread[m_p_state->i_num_workers]:NULL;
+	for(int i = 0;i < m_p_state->i_num_workers;i++)
+		m_p_state->pth_workers[i] = std::thread(worker,this,i);
+}
+
+calculus::thread_pool::~thread_pool() {
+	{
+		std::lock_guard<std::mutex> lg(m_p_state->m_sleep);
+		m_p_state->b_stop = true;
+	}
+	m_p_state->cv_wake.notify_all();
+	for(int i = 0;i < m_p_state->i_num_workers;i++)
+		m_p_state->pth_workers[i].join();
+	if (m_p_state->pth_workers)
+		delete [] m_p_state->pth_workers;
+	if (m_p_state->pq_queues)
+		delete [] m_p_state->pq_queues;
+	delete m_p_state;
+}
+
+void calculus::thread_pool::worker(calculus::thread_pool* ptp,int i_worker) {
+	THREAD_POOL_STATE* pState = ptp->m_p_state;
+	s_i_worker_queue = i_worker;
+	THREAD_POOL_CHUNK chunk;
+	for(;;) {
+		if (ThreadPoolTake(pState,i_worker,&chunk)) {
+			ThreadPoolRun(&chunk);
+			continue;
+		}
+		//SLEEP UNTIL A CHUNK IS DEALT, THE DEALER COUNTS IT BEFORE IT TAKES m_sleep TO NOTIFY
+		std::unique_lock<std::mutex> ul(pState->m_sleep);
+		pState->cv_wake.wait(ul,[pState] { return (pState->b_stop)||(pState->st_queued.load() > 0); });
+		if ((pState->b_stop)&&(pState->st_queued.load() == 0))
+			return;
+	}
+}
+
+calculus::thread_pool* calculus::thread_pool::get_service() {
+	thread_pool* ptp = s_ptp_service.load(std::memory_order_acquire);
+	if (ptp == NULL) {
+		std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+		ptp = s_ptp_service.load(std::memory_order_relaxed);
+		if (ptp == NULL)
+			ptp = restart_service(0);
+	}
+	return ptp;
+}
+
+void calculus::thread_pool::kill_service() {
+	//NO parallel_for() MAY BE RUNNING
+	thread_pool* ptp = s_ptp_service.exchange(NULL);
+	if (ptp)
+		delete ptp;
+}
+
+calculus::thread_pool* calculus::thread_pool::restart_service(int i_num_threads) {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	kill_service();
+	if (i_num_threads <= 0) {
+		unsigned int ui_threads = std::thread::hardware_concurrency();
+		i_num_threads = (ui_threads)?(int)ui_threads:1;
+	}
+	thread_pool* ptp = new thread_pool(i_num_threads);
+	s_ptp_service.store(ptp,std::memory_order_release);
+	return ptp;
+}
+
+int calculus::thread_pool::get_num_threads() {
+	return m_p_state->i_num_workers + 1;
+}
+
+void calculus::thread_pool::parallel_for(size_t st_n,size_t st_grain,PARALLEL_TASK pf_task,void* pv_context) {
+	if (st_grain == 0)
+		st_grain = 1;
+	int n = m_p_state->i_num_workers;
+	//NOTHING TO SHARE, THE CALLER DOES IT ALL
+	if ((n == 0)||(st_n <= st_grain)) {
+		if (st_n)
+			pf_task(pv_context,0,st_n);
+		return;
+	}
+	THREAD_POOL_JOB job;
+	job.pf_task = pf_task;
+	job.pv_context = pv_context;
+	size_t st_chunks = (st_n + st_grain - 1)/st_grain;
+	job.st_remaining = st_chunks;
+	//A WORKER KEEPS ITS CHUNKS, THE OTHERS STEAL THEM.  AN OUTSIDE CALLER DEALS THEM ROUND ROBIN
+	int i_home = s_i_worker_queue;
+	unsigned int ui_queue = (i_home >= 0)?(unsigned int)i_home:m_p_state->ui_next_queue.fetch_add(1,std::memory_order_relaxed);
+	for(size_t k = 0;k < st_chunks;k++) {
+		THREAD_POOL_CHUNK chunk;
+		chunk.pj_job = &job;
+		chunk.st_begin = k*st_grain;
+		chunk.st_end = (chunk.st_begin + st_grain < st_n)?chunk.st_begin + st_grain:st_n;
+		PTHREAD_POOL_QUEUE pq = m_p_state->pq_queues + ((i_home >= 0)?i_home:(ui_queue+k)%n);
+		std::lock_guard<std::mutex> lg(pq->m_lock);
+		pq->dq_chunks.push_back(chunk);
+		m_p_state->st_queued++;
+	}
+	{
+		std::lock_guard<std::mutex> lg(m_p_state->m_sleep);
+	}
+	m_p_state->cv_wake.notify_all();
+	//WORK ON ANY CHUNK, OURS OR NOT, UNTIL OURS ARE ALL DONE
+	THREAD_POOL_CHUNK chunk;
+	while(job.st_remaining.load(std::memory_order_acquire)) {
+		if (ThreadPoolTake(m_p_state,i_home,&chunk))
+			ThreadPoolRun(&chunk);
+		else
+			std::this_thread::yield();
+	}
+}
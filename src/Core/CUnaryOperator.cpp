@@ -0,0 +1,176 @@
+/*
+
+CUNARYOPERATOR.CPP: 
+IMPLEMENTS THE BATCH KERNEL ENCODING OF calculus::unary_operators::unary_operator
+
+* calculus-cpp: Scientific "Functional" Library
+*
+* This software was developed at McGill University (Montreal, 2002) by
+* Olivier Giroux in the course of his studies in Mechanical Engineering.
+* It was presented, along with an accompanying paper, for credit in the fall
+* of 2002.
+*
+* Calculus-cpp was not designed to prove a point or to serve as a formal
+* framework within which exact solutions can be derived.  Instead it was
+* created to fill the need for run-time functional constructions and to
+* accomplish very real and tangible goals.  It remains your responsibility
+* to use it properly - as much more sophisticated <math.h>, which allows
+* functions to be treated as first-class objects.
+*
+* You are welcome to make any additions you feel are necessary.
+
+COPYRIGHT AND PERMISSION NOTICE
+
+Copyright (c) 2002, Olivier Giroux, <oliver@canada.com>.
+
+All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without any restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+provided that the copyright notice(s) and this permission notice appear
+in all copies of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF THIRD PARTY RIGHTS. IN
+NO EVENT SHALL THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE BE
+LIABLE FOR ANY CLAIM, OR ANY SPECIAL INDIRECT OR CONSEQUENTIAL DAMAGES, OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+Except as contained in this notice, the name of a copyright holder shall not
+be used in advertising or otherwise to promote the sale, use or other dealings
+in this Software without prior written authorization of the copyright holder.
+
+THIS SOFTWARE INCLUDES THE NIST'S TNT PACKAGE FOR USE WITH THE EXAMPLES FURNISHED.
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO THE TNT-->
+* Template Numerical Toolkit (TNT): Linear Algebra Module
+*
+* Mathematical and Computational Sciences Division
+* National Institute of Technology,
+* Gaithersburg, MD USA
+*
+*
+* This software was developed at the National Institute of Standards and
+* Technology (NIST) by employees of the Federal Government in the course
+* of their official duties. Pursuant to title 17 Section 105 of the
+* United States Code, this software is not subject to copyright protection
+* and is in the public domain. NIST assumes no responsibility whatsoever for
+* its use by other parties, and makes no guarantees, expressed or implied,
+* about its quality, reliability, or any other characteristic.
+<--END NOTICE
+
+THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
+** Copyright (c) 1991, 1994, 1997, 1998 D. Richard Hipp
+**
+** This file contains all sources (including headers) to the LEMON
+** LALR(1) parser generator.  The sources have been combined into a
+** single file to make it easy to include LEMON as part of another
+** program.
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public
+** License as published by the Free Software Foundation; either
+** version 2 of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** General Public License for more details.
+** 
+** You should have received a copy of the GNU General Public
+** License along with this library; if not, write to the
+** Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+** Boston, MA  02111-1307, USA.
+**
+** Author contact information:
+**   drh@acm.org
+**   http://www.hwaci.com/drh/
+<--END NOTICE
+
+*/
+
+#include "Calculus_cpp.h"
+
+void calculus::unary_operators::unary_operator::eval_unary_batch_callback(calculus::unary_operators::unary_operator * puo_operator,double* pd,size_t st_n)
+{
+	puo_operator->eval_unary_batch(pd,st_n);
+}
+
+void calculus::unary_operators::unary_operator::to_X64_vector(PCT_INFO pInfo)
+//THE DEFAULT BATCH ENCODING EVALUATES THE OPERAND NATIVELY AND CALLS BACK INTO eval_unary_batch() FOR ITS W LANES
+/*
+	OPERAND
+VMOVUPD	[rbp-t],v0
+MOV		rdi,this
+LEA		rsi,[rbp-t]
+MOV		edx,W
+VZEROUPPER
+MOV		rax,unary_operator::eval_unary_batch_callback
+CALL	rax
+VMOVUPD	v0,[rbp-t]
+*/
+{
+	int i_width = CompilerVectorWidth(pInfo->i_vector_isa);
+	this->get_operand()->to_X64_vector(pInfo);
+	int iTemp = CompilerPushX64Temporary(pInfo,i_width);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_STORE,REG_XMM(0),REG_XMM(0),iTemp);
+	CompilerWriteX64ThisArgument(pInfo,this);
+	CompilerWriteLEA_RXX_RBPX_IMM32(pInfo,REG_ESI);
+		CompilerWriteINT32(pInfo,iTemp);
+	CompilerWriteMOV_EXX_IMM32(pInfo,REG_EDX);
+		CompilerWriteINT32(pInfo,i_width);
+	CompilerWriteX64VectorCALL_IMM64(pInfo,(void*)calculus::unary_operators::unary_operator::eval_unary_batch_callback);
+	CompilerWriteVECTOR_PD_VEC_FRAME(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0),REG_XMM(0),iTemp);
+	CompilerPopX64Temporary(pInfo,i_width);
+}
+
+void calculus::unary_operators::unary_operator::annotate_X64_vector(PPT_INFO pParseInfo)
+{
+	int i_width = CompilerVectorWidth(pParseInfo->i_vector_isa);
+	this->get_operand()->annotate_X64_vector(pParseInfo);
+	CompilerReserveX64Temporary(pParseInfo,i_width);
+	CompilerReleaseX64Temporary(pParseInfo,i_width);
+	pParseInfo->st_instruction_storage_size	+=	2*CompilerSizeOfVECTOR_PD_VEC_FRAME(pParseInfo)
+											+	CompilerSizeOfX64ThisArgument()
+											+	CompilerSizeOfLEA_RXX_RBPX_IMM32()
+											+	CompilerSizeOfMOV_EXX_IMM32()
+											+	2*CompilerSizeOfINT32()
+											+	CompilerSizeOfX64VectorCALL_IMM64();
+	pParseInfo->i_instruction_count			+=	7;
+	pParseInfo->i_operator_count++;
+	pParseInfo->st_pmap_size				+=	2;
+}
+
+void calculus::unary_operators::unary_operator::to_tape(calculus::tape* pTape)
+{
+	this->get_operand()->to_tape(pTape);
+	pTape->write_operator(TAPE_OP_UNARY,this);
+}
+
+qword_type calculus::unary_operators::unary_operator::structural_hash()
+{
+	return StructuralHashCombine(typeid(*this).hash_code(),this->m_pao_operand->get_hash());
+}
+
+bool calculus::unary_operators::unary_operator::structural_equal(calculus::algebraic_operator * pao_other)
+{
+	return (typeid(*this) == typeid(*pao_other))&&this->m_pao_operand->equals(static_cast<unary_operator*>(pao_other)->m_pao_operand);
+}
+
+double calculus::unary_operators::unary_operator::eval_unary_derivative(double a)
+{
+	double h = TapeDifferenceStep(a);
+	return (eval_unary(a+h)-eval_unary(a-h))/(2*h);
+}
+
+double calculus::unary_operators::unary_operator::eval_unary_second_derivative(double a)
+{
+	double h = TapeDifferenceStep(a);
+	return (eval_unary_derivative(a+h)-eval_unary_derivative(a-h))/(2*h);
+}
@@ -98,65 +98,125 @@ THE FOLLOWING NOTICE APPLIES SOLELY TO LEMON-->
 #include "Calculus_cpp.h"
 
 unsigned int calculus::variable::uiNextAutoVarName = 0;
-unsigned int calculus::variable::nums[27] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-calculus::variable ** calculus::variable::ppVars[27] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+calculus::variable ** calculus::variable::s_ppv_registry = NULL;
+size_t calculus::variable::s_st_registry_size = 0;
+calculus::variable ** calculus::variable::s_ppv_by_id = NULL;
+int calculus::variable::s_i_count = 0;
+int calculus::variable::s_i_capacity = 0;
+
+#define VARIABLE_REGISTRY_INITIAL_SIZE 0x40
+
+//FNV-1a, THE GENERATED NAMES x_0..x_n ONLY DIFFER IN THEIR LAST CHARACTERS
+static size_t HashVariableName(const char * psc_name) {
+	size_t st_hash = (size_t)14695981039346656037ull;
+	for(;*psc_name;psc_name++)
+		st_hash = (st_hash ^ (unsigned char)*psc_name)*(size_t)1099511628211ull;
+	return st_hash;
+}
 
 void calculus::variable::FreeRegistry() {
-	for(unsigned int uiCatNum = 0;uiCatNum < 27;uiCatNum++) {
-		if (nums[uiCatNum]) {
-			for(unsigned int ui = nums[uiCatNum];ui;) {
-				ui--;
-				ppVars[uiCatNum][ui]->release();
-			}
-			free(ppVars[uiCatNum]);
-		}
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	for(int i = s_i_count;i;) {
+		i--;
+		s_ppv_by_id[i]->release();
 	}
+	if (s_ppv_by_id)
+		free(s_ppv_by_id);
+	if (s_ppv_registry)
+		free(s_ppv_registry);
+	s_ppv_by_id = NULL;
+	s_ppv_registry = NULL;
+	s_st_registry_size = 0;
+	s_i_count = 0;
+	s_i_capacity = 0;
 }
 
 calculus::algebraic_operator * calculus::variable::create(const char * psc_name) { 
 	if (strlen(psc_name) > (MAX_VARIABLE_NAME_LENGTH-1))
 		return NULL;
-	int iCatNum = toupper(*psc_name)-'A';
-    if ((iCatNum < 0)||(iCatNum > 26))
-        iCatNum = 26;
-	if (nums[iCatNum]) {
-		for(unsigned int ui = nums[iCatNum];ui;) {
-			ui--;
-			if (!strcmp(ppVars[iCatNum][ui]->get_variable_name(),psc_name))
-				return ppVars[iCatNum][ui];
-		}
+	size_t st_hash = HashVariableName(psc_name);
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	if (s_ppv_registry) {
+		for(variable* pv = s_ppv_registry[st_hash&(s_st_registry_size-1)];pv;pv = pv->m_pv_registry_next)
+			if ((pv->m_st_name_hash == st_hash)&&(!strcmp(pv->m_scVarName,psc_name)))
+				return pv;
 	}
-	nums[iCatNum]++;
-	if (ppVars[iCatNum]) {
-		ppVars[iCatNum] = (calculus::variable**)realloc(ppVars[iCatNum],nums[iCatNum]*sizeof(calculus::variable*));
+	if ((size_t)s_i_count >= s_st_registry_size) {
+		//DOUBLE THE BUCKETS AND RELINK EVERY VARIABLE
+		size_t st_size = (s_st_registry_size)?2*s_st_registry_size:VARIABLE_REGISTRY_INITIAL_SIZE;
+		variable** ppv_registry = (variable**)calloc(st_size,sizeof(variable*));
+		if (!ppv_registry)
+			return NULL;
+		for(int i = 0;i < s_i_count;i++) {
+			variable* pv = s_ppv_by_id[i];
+			pv->m_pv_registry_next = ppv_registry[pv->m_st_name_hash&(st_size-1)];
+			ppv_registry[pv->m_st_name_hash&(st_size-1)] = pv;
+		}
+		if (s_ppv_registry)
+			free(s_ppv_registry);
+		s_ppv_registry = ppv_registry;
+		s_st_registry_size = st_size;
 	}
-	else {
-		ppVars[iCatNum] = (calculus::variable**)malloc(sizeof(calculus::variable*));
+	if (s_i_count == s_i_capacity) {
+		int i_capacity = (s_i_capacity)?2*s_i_capacity:VARIABLE_REGISTRY_INITIAL_SIZE;
+		variable** ppv_by_id = (variable**)realloc(s_ppv_by_id,i_capacity*sizeof(variable*));
+		if (!ppv_by_id)
+			return NULL;
+		s_ppv_by_id = ppv_by_id;
+		s_i_capacity = i_capacity;
 	}
-	ppVars[iCatNum][nums[iCatNum]-1] = new calculus::variable(psc_name);
-	ppVars[iCatNum][nums[iCatNum]-1]->addref();
-	return ppVars[iCatNum][nums[iCatNum]-1];
+	variable* pv = new calculus::variable(psc_name,s_i_count);
+	pv->m_st_name_hash = st_hash;
+	pv->m_pv_registry_next = s_ppv_registry[st_hash&(s_st_registry_size-1)];
+	s_ppv_registry[st_hash&(s_st_registry_size-1)] = pv;
+	s_ppv_by_id[s_i_count++] = pv;
+	pv->addref();
+	return pv;
+}
+
+calculus::variable * calculus::variable::get_by_id(int i_id) {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	return ((i_id >= 0)&&(i_id < s_i_count))?s_ppv_by_id[i_id]:NULL;
+}
+
+int calculus::variable::get_count() {
+	std::lock_guard<std::recursive_mutex> lg_build(calculus::build_lock());
+	return s_i_count;
 }
 
-calculus::variable::variable(const char *pVarName) : calculus::algebraic_operator() {
+calculus::variable::variable(const char *pVarName,int i_id) : calculus::algebraic_operator() {
 	pThis = this;
 	m_ppv_variables = &pThis;
 	m_i_number_of_variables = 1;
 	::strcpy(this->m_scVarName,pVarName);
+	m_i_id = i_id;
+	m_st_name_hash = HashVariableName(pVarName);
+	m_pv_registry_next = NULL;
     m_b_variables_identified = true;
     m_i_number_of_variables = 1;
 }
 
-int calculus::variable::to_string(char* pBuffer) {
-	if (!pBuffer)
-		return strlen(this->m_scVarName);
-	return sprintf(pBuffer,this->m_scVarName);
+void calculus::variable::write_string(string_writer* psw) {
+	psw->write(this->m_scVarName);
+}
+
+qword_type calculus::variable::structural_hash() {
+	//A COPY HAS THE ID OF THE REGISTERED VARIABLE, IT IS THE SAME VARIABLE
+	return StructuralHashCombine(typeid(*this).hash_code(),(qword_type)this->m_i_id);
+}
+
+bool calculus::variable::structural_equal(calculus::algebraic_operator * pao_other) {
+	return (typeid(*this) == typeid(*pao_other))&&(static_cast<variable*>(pao_other)->m_i_id == this->m_i_id);
 }
 
 double calculus::variable::eval(double* pVars) {
 	return *pVars;
 }
 
+void calculus::variable::eval_batch(const double* const* ppd_columns,size_t st_n,double* pd_out) {
+	memcpy(pd_out,ppd_columns[0],st_n*sizeof(double));
+}
+
 void calculus::variable::to_IA32_binary(PCT_INFO pInfo) {	
     unsigned short varNumber;
 	for(varNumber = 0;varNumber < pInfo->pHeader->i_num_vars;varNumber++) {
@@ -176,8 +236,56 @@ void calculus::variable::annotate(PPT_INFO pParseInfo) {
 	pParseInfo->i_instruction_count++;
 }
 
+void calculus::variable::to_X64_binary(PCT_INFO pInfo) {
+	this->to_X64_operand(pInfo,SSE2_MOVSD_LOAD,REG_XMM(0));
+}
+
+void calculus::variable::annotate_X64(PPT_INFO pParseInfo) {
+	this->annotate_X64_operand(pParseInfo);
+}
+
+void calculus::variable::to_X64_operand(PCT_INFO pInfo,byte_type code,byte_type x) {
+	CompilerWriteSSE2_SD_XMM_FRAME(pInfo,code,x,COMPILER_X64_V(CompilerIndexOfVariable(pInfo,this)));
+}
+
+void calculus::variable::annotate_X64_operand(PPT_INFO pParseInfo) {
+	pParseInfo->st_instruction_storage_size += CompilerSizeOfSSE2_SD_XMM_FRAME();
+	pParseInfo->i_operator_count++;
+	pParseInfo->i_instruction_count++;
+}
+
+void calculus::variable::to_X64_vector(PCT_INFO pInfo) {
+	this->to_X64_vector_operand(pInfo,VECTOR_MOVUPD_LOAD,REG_XMM(0));
+}
+
+void calculus::variable::annotate_X64_vector(PPT_INFO pParseInfo) {
+	this->annotate_X64_vector_operand(pParseInfo);
+}
+
+/*
+MOV		rax,[rbp-16]
+MOV		rax,[rax+8*index]
+code	v(x),v(x),[rax+rbx]
+*/
+
+void calculus::variable::to_X64_vector_operand(PCT_INFO pInfo,byte_type code,byte_type x) {
+	_ASSERT((code != VECTOR_MOVUPD_LOAD) || (x == REG_XMM(0)));	//LOADS HAVE NO FIRST SOURCE
+	CompilerWriteX64LoadColumn(pInfo,CompilerIndexOfVariable(pInfo,this));
+	CompilerWriteVECTOR_PD_VEC_RAX_RBX(pInfo,code,x,x);
+}
+
+void calculus::variable::annotate_X64_vector_operand(PPT_INFO pParseInfo) {
+	pParseInfo->st_instruction_storage_size += CompilerSizeOfX64LoadColumn() + CompilerSizeOfVECTOR_PD_VEC_RAX_RBX(pParseInfo);
+	pParseInfo->i_operator_count++;
+	pParseInfo->i_instruction_count += 3;
+}
+
+void calculus::variable::to_tape(calculus::tape* pTape) {
+	pTape->write(TAPE_OP_VARIABLE,pTape->index_of(this));
+}
+
 calculus::algebraic_operator* calculus::variable::partial_derivative(calculus::variable * pVar) {
-	return (pVar==this)?calculus::_cst(1):calculus::_cst(0);
+	return (pVar->get_id()==m_i_id)?calculus::_cst(1):calculus::_cst(0);
 }
 
 calculus::variable** calculus::variable::identify_variables() {
@@ -189,5 +297,5 @@ int calculus::variable::get_number_of_variables() {
 }
 
 bool calculus::variable::is_function_of(calculus::variable* a) {
-	return (a == this);
+	return (a->get_id() == m_i_id);
 }
@@ -141,18 +141,34 @@ void initialize_calculus(unsigned int cMode) {
 	calculus::binary_operators::intrinsic_operators::multiplication::Register(pService);
 	calculus::binary_operators::intrinsic_operators::subtraction::Register(pService);
 
+	//PICK THE WIDEST VECTOR ISA FOR THE BATCH KERNELS
+#ifdef COMPILER_TARGET_X64
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		calculus::algebraic_operator::set_vector_isa(VECTOR_ISA_AVX512);
+	else if (__builtin_cpu_supports("avx2"))
+		calculus::algebraic_operator::set_vector_isa(VECTOR_ISA_AVX2);
+#endif
+
 	bcalculusinitialized = true;
 }
 
 int uninitialize_calculus() {
 	if (!bcalculusinitialized)
 		return -1;
+	//STOP THE WORKERS
+	calculus::thread_pool::kill_service();
 	//KILL THE TRIVIAL COMPILER
 	calculus::algebra_parser::kill_service();
 	//FREE COMPILED STRUCTURES
 	calculus::IA32_binary::free_all_IA32_binaries();
+	calculus::code_arena::free_all();
+	//FREE THE SHARED OPERATORS
+	calculus::algebraic_operator::FreeConsTable();
 	//FREE THE VARIABLE REGISTRY
 	calculus::variable::FreeRegistry();
+	//RETURN THE NODE CHUNKS, UNLESS THE CALLER STILL HOLDS OPERATORS
+	calculus::node_pool::trim();
 
 #ifdef _DEBUG
 #ifdef _MSC_VER
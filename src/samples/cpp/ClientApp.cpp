@@ -228,42 +228,25 @@ void gradmin(
     calculus::variable ** variables = f->get_variables();
     //Build the gradient vector for this Function
     Function * grad_f = new Function[num_vars];
-    Function * grad_div_f = new Function[num_vars];
-    {for(int i = 0;i<num_vars;i++) {
-        grad_f[i] = f->get_partial_derivative(variables[i]);
-        grad_div_f[i] = grad_f[i]->get_partial_derivative(variables[i]);
-    }}
+    {for(int i = 0;i<num_vars;i++)
+        grad_f[i] = f->get_partial_derivative(variables[i]);}
 
-    //Gradient components may be Functions of fewer (but no more) Variables 
-    //than the original Function so we need to rebuild local Variable/value 
-    //sets for each gradient vector component.
-    int *gradient_num_vars = new int[num_vars],*gradient_div_num_vars = new int[num_vars];
-    int **gradient_var_mask = new int*[num_vars],**gradient_div_var_mask = new int*[num_vars];
-    {for(int i = 0;i < num_vars;i++) {
-        gradient_num_vars[i] = grad_f[i]->get_number_of_variables();
-        gradient_div_num_vars[i] = grad_div_f[i]->get_number_of_variables();
-        calculus::variable **ppGradientVars = grad_f[i]->get_variables(),**ppGradientDivVars = grad_div_f[i]->get_variables();
-        gradient_var_mask[i] = new int[gradient_num_vars[i]];
-        gradient_div_var_mask[i] = new int[gradient_div_num_vars[i]];
-        {for(int j = 0,k = 0;(j < num_vars) && (k < gradient_num_vars[i]);j++) {
-            if (ppGradientVars[k] == variables[j])
-                gradient_var_mask[i][k++] = j;
-        }}
-        {for(int j = 0,k = 0;(j < num_vars) && (k < gradient_div_num_vars[i]);j++) {
-            if (ppGradientDivVars[k] == variables[j])
-                gradient_div_var_mask[i][k++] = j;
-        }}
-    }}
+    //The structurally nonzero second derivatives are filled by one compiled kernel,
+    //only the diagonal is used. The gradient itself is swept from f directly.
+    calculus::jacobian * hessian = calculus::jacobian::compile_hessian(f,variables,num_vars);
+    //Without a kernel the diagonal is taken one unit direction at a time
+    int num_values = (hessian != NULL)?hessian->get_nonzeros():num_vars;
 
     //More variable allocations which I will need in the iteration
     double delta_value = 0,
-        *local_p = new double[num_vars],
+        *hessian_value = new double[(num_values > 0)?num_values:1],
+        *direction = new double[num_vars],
         *grad_value = new double[num_vars],
         *delta = new double[num_vars],
         *grad_div_value = new double[num_vars];
 
     {for(int i = 0;i < num_vars;i++)
-        local_p[i] = grad_div_value[i] = grad_value[i] = delta[i] = 0;}
+        grad_div_value[i] = grad_value[i] = delta[i] = 0;}
     //Get the local Function value
     value = f(p);
     iterations = 0;
@@ -272,15 +255,29 @@ void gradmin(
     do
     {
         report_info(num_vars,iterations,value,p,grad_value,grad_div_value,delta,delta_value);
-        //Get the local gradient value
-        {for(int i = 0;i < num_vars;i++) {
-            {for(int j = 0;j < gradient_num_vars[i];j++)
-                local_p[j] = p[gradient_var_mask[i][j]];}
-            grad_value[i] = grad_f[i](local_p);
-            {for(int j = 0;j < gradient_div_num_vars[i];j++)
-                local_p[j] = p[gradient_div_var_mask[i][j]];
-            grad_div_value[i] = grad_div_f[i](local_p);}
-        }}
+        //Get the local gradient value, all components in one forward and one reverse sweep
+        f.gradient(p,grad_value);
+        if (hessian != NULL) {
+            hessian->eval(p,hessian_value);
+            const int * row_pointers = hessian->get_row_pointers();
+            const int * column_indices = hessian->get_column_indices();
+            {for(int i = 0;i < num_vars;i++) {
+                grad_div_value[i] = 0;
+                for(int k = row_pointers[i];k < row_pointers[i+1];k++)
+                    if (column_indices[k] == i)
+                        grad_div_value[i] = hessian_value[k];
+            }}
+        }
+        else
+        {
+            {for(int i = 0;i < num_vars;i++) {
+                {for(int j = 0;j < num_vars;j++)
+                    direction[j] = (i == j)?1.0:0.0;}
+                //delta only receives the gradient here, it is computed below
+                f->eval_hessian_vector(p,direction,delta,hessian_value);
+                grad_div_value[i] = hessian_value[i];
+            }}
+        }
         //Get the various directional deltas
         {for(int i = 0;i < num_vars;i++)
             delta[i] = -grad_value[i]/fabs(grad_div_value[i]);}
@@ -300,19 +297,13 @@ void gradmin(
     while(fabs(delta_value) > tolerance);
     
     //Free all memory allocated
-    {for(int i = 0;i < num_vars;i++) {
-        delete [] gradient_div_var_mask[i];
-        delete [] gradient_var_mask[i];
-    }}
-    delete [] local_p;
-    delete [] gradient_div_var_mask;
-    delete [] gradient_var_mask;
-    delete [] gradient_div_num_vars;
-    delete [] gradient_num_vars;
+    if (hessian != NULL)
+        delete hessian;
+    delete [] hessian_value;
+    delete [] direction;
     delete [] delta;
     delete [] grad_div_value;
     delete [] grad_value;
-    delete [] grad_div_f;
     delete [] grad_f;
 }
 
@@ -0,0 +1,244 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace calculus::unary_operators::polynomials;
+
+static double Adapter(double* pd_args) {
+	return pd_args[0]*10 + pd_args[1];
+}
+
+TEST_CASE("Compiled functions agree with the closed form", "[compiler]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y", z = "z";
+	const double X = 0.7, Y = 1.9, Z = -0.3;
+
+	{ Function f = x*y + sin(x); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(X*Y + std::sin(X))); }
+	{ Function f = (x-y)/(y+x); FUNCTION F = f; REQUIRE(F(X,Y) == Approx((X-Y)/(Y+X))); }
+	{ Function f = cst(2.0)-x; FUNCTION F = f; REQUIRE(F(X) == Approx(2-X)); }
+	{ Function f = cst(2.0)/x; FUNCTION F = f; REQUIRE(F(X) == Approx(2/X)); }
+	{ Function f = (x*x)/(sin(y)*cos(x)); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(X*X/(std::sin(Y)*std::cos(X)))); }
+	{ Function f = neg(x) + sqrt(y); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(-X + std::sqrt(Y))); }
+	{ Function f = INT_POW(5,x) + INT_POW(-3,y) + INT_POW(0,x) + INT_POW(1,y); FUNCTION F = f;
+	  REQUIRE(F(X,Y) == Approx(std::pow(X,5) + std::pow(Y,-3) + 1 + Y)); }
+	{ Function f = INT_POW(13,x+y); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(std::pow(X+Y,13))); }
+	{ Function f = pow(x,y) + pow(y,x*x); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(std::pow(X,Y) + std::pow(Y,X*X))); }
+	{ Function f = exp(x) + log(y) + log10(y) + tan(x) + asin(x) + acos(x) + atan(y); FUNCTION F = f;
+	  REQUIRE(F(X,Y) == Approx(std::exp(X) + std::log(Y) + std::log10(Y) + std::tan(X) + std::asin(X) + std::acos(X) + std::atan(Y))); }
+	{ Function f = sinh(x)*cosh(y) - tanh(x); FUNCTION F = f; REQUIRE(F(X,Y) == Approx(std::sinh(X)*std::cosh(Y) - std::tanh(X))); }
+	{ Function f = _j0(x) + _j1(y) + _jn(3,x) + _y0(y) + _y1(x) + _yn(2,y); FUNCTION F = f;
+	  REQUIRE(F(X,Y) == Approx(j0(X) + j1(Y) + jn(3,X) + y0(Y) + y1(X) + yn(2,Y))); }
+	{ double a[4] = {1,2,3,4}; Function f = poly(3,Optimized,a,x); FUNCTION F = f;
+	  REQUIRE(F(X) == Approx(1 + 2*X + 3*X*X + 4*X*X*X)); }
+	{ double a[3] = {1,2,3}, xs[3] = {0.1,0.2,0.3}; Function f = poly(2,xs,a,x); FUNCTION F = f;
+	  REQUIRE(F(X) == Approx(1 + 2*(X-0.1) + 3*(X-0.1)*(X-0.2))); }
+	{ calculus::variable* vv[2] = {x,y}; Function f = linkf((void*)Adapter,(char*)"adapter",2,vv) + z; FUNCTION F = f;
+	  REQUIRE(F(X,Y,Z) == Approx(X*10 + Y + Z)); }
+	{ Function f = cst(3.25); FUNCTION F = f; REQUIRE(F(0.0) == 3.25); }
+}
+
+TEST_CASE("Arguments follow the variable names, not their registration order", "[compiler][variables]")
+{
+	initialize_calculus(0);
+	//y IS REGISTERED BEFORE x
+	Variable y = "oy", x = "ox";
+	Function f = x - y;
+	REQUIRE(strcmp(f->get_variables()[0]->get_variable_name(),"ox") == 0);
+	REQUIRE(f(1.0,2.0) == -1);
+	double p[2] = {1,2};
+	REQUIRE(f->eval_tape(p) == -1);
+	FUNCTION F = f;
+	REQUIRE(F(1.0,2.0) == -1);
+
+	//NAMES REGISTERED BACKWARDS AND ADDED OUT OF ORDER, EVERY PARENT MERGES ITS OPERANDS
+	const int N = 30;
+	std::vector<Variable> v(N);
+	char sz_name[16];
+	for (int i = N - 1; i >= 0; i--) {
+		sprintf(sz_name,"o%d",i);
+		v[i] = Variable(sz_name);
+	}
+	Function g = cst(0.0);
+	for (int k = 0; k < N; k++) {
+		int i = (k*7)%N;
+		g = g + cst(i + 1.0)*v[i]*v[(i + 1)%N];
+	}
+	int n = g->get_number_of_variables();
+	REQUIRE(n == N);
+	calculus::variable** pv = g->get_variables();
+	std::vector<double> q(n);
+	for (int i = 1; i < n; i++)
+		REQUIRE(strcmp(pv[i-1]->get_variable_name(),pv[i]->get_variable_name()) < 0);
+	for (int i = 0; i < n; i++)
+		q[i] = 0.1*atoi(pv[i]->get_variable_name() + 1);
+	double d_ref = 0;
+	for (int i = 0; i < N; i++)
+		d_ref += (i + 1.0)*(0.1*i)*(0.1*((i + 1)%N));
+	REQUIRE(g->eval(q.data()) == Approx(d_ref).epsilon(1e-12));
+	REQUIRE(g->eval_tape(q.data()) == Approx(d_ref).epsilon(1e-12));
+}
+
+TEST_CASE("Compiled functions agree with the tree evaluator", "[compiler]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y";
+	Function g = x;
+	for (int i = 0; i < 12; i++)
+		g = (g*y + cst(i))/(x + cst(2)) - (y - g);
+	FUNCTION F = g;
+	REQUIRE(F != NULL);
+	for (int k = 0; k < 50; k++) {
+		double p[2] = {-0.3 + 0.02*k, 0.4 + 0.01*k};
+		REQUIRE(F(p[0],p[1]) == Approx(g->eval(p)).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("Batch kernels agree with the interpreted batch for every vector ISA", "[compiler][batch]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y", z = "z";
+	const int i_detected = calculus::algebraic_operator::get_vector_isa();
+	const size_t N = 1003;
+	std::vector<double> cols[3];
+	for (int i = 0; i < 3; i++) {
+		cols[i].resize(N);
+		for (size_t k = 0; k < N; k++)
+			cols[i][k] = -0.3 + 0.37*i + 0.001*k;
+	}
+	const double* pc[3] = {cols[0].data(),cols[1].data(),cols[2].data()};
+	double a[4] = {1,2,3,4};
+
+	for (int isa = i_detected; isa >= (int)VECTOR_ISA_NONE; isa--) {
+		calculus::algebraic_operator::set_vector_isa(isa);
+		Function fs[] = { x*y + sin(x), (x-z)/(y+x), (cst(2)-x) + (cst(3)/y) + (x-cst(1))*(cst(2)*y),
+			INT_POW(5,x) + INT_POW(-3,y) + INT_POW(0,x), neg(x) + sqrt(x*x + y*y), pow(x+cst(1),y) + exp(neg(z)),
+			tan(x) + asin(x*cst(0.3)) + acos(y*cst(0.2)) + atan(z), sinh(x)*cosh(y) - tanh(z),
+			poly(3,Optimized,a,x+y) };
+		for (Function& f : fs) {
+			std::vector<double> out(N), ref(N);
+			f.eval_batch(pc,N,ref.data());
+			f.eval_batch_compiled(pc,N,out.data());
+			for (size_t k = 0; k < N; k++) {
+				std::vector<double> p(f->get_number_of_variables());
+				for (size_t i = 0; i < p.size(); i++)
+					p[i] = cols[i][k];
+				REQUIRE(ref[k] == Approx(f->eval(p.data())).epsilon(1e-12));
+				REQUIRE(out[k] == Approx(ref[k]).epsilon(1e-12));
+			}
+		}
+	}
+	calculus::algebraic_operator::set_vector_isa(i_detected);
+}
+
+TEST_CASE("Batches over many variables agree with the tree evaluator", "[compiler][batch]")
+{
+	initialize_calculus(0);
+	const int N = 40;
+	const size_t M = 300;
+	std::vector<Variable> v(N);
+	char sz_name[16];
+	for (int i = 0; i < N; i++) {
+		sprintf(sz_name,"b%03d",i);
+		v[i] = Variable(sz_name);
+	}
+	//THE OPERANDS OF THE ROOT GATHER MORE COLUMNS THAN FIT ON THE STACK
+	Function f = cst(0.0), g = cst(1.0);
+	for (int i = 0; i < N; i += 2)
+		f = f + v[i]*sin(v[i+1]);
+	for (int i = N - 1; i > 0; i -= 2)
+		g = g + v[i]*v[i-1];
+	Function h = f/g;
+	std::vector<std::vector<double>> cols(N,std::vector<double>(M));
+	std::vector<const double*> pc(N);
+	for (int i = 0; i < N; i++) {
+		for (size_t k = 0; k < M; k++)
+			cols[i][k] = 0.01*i + 0.001*k;
+		pc[i] = cols[i].data();
+	}
+	std::vector<double> out(M), p(N);
+	h.eval_batch(pc.data(),M,out.data());
+	for (size_t k = 0; k < M; k++) {
+		for (int i = 0; i < N; i++)
+			p[i] = cols[i][k];
+		REQUIRE(out[k] == Approx(h->eval(p.data())).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("Compiled functions stay callable while new code is allocated", "[compiler][arena]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y";
+	Function f = x*y + sin(x);
+	FUNCTION F = f;
+	REQUIRE(F != NULL);
+	const double d_expected = 0.7*1.9 + std::sin(0.7);
+	for (int i = 0; i < 100; i++) {
+		unsigned char* pv = calculus::code_arena::allocate(64 + i);
+		REQUIRE(pv != NULL);
+		pv[0] = 0xC3u;
+		REQUIRE(F(0.7,1.9) == Approx(d_expected));
+		Function g = x*cst(i + 1.0) - y;
+		FUNCTION G = g;
+		REQUIRE(G(0.7,1.9) == Approx(0.7*(i + 1.0) - 1.9));
+		REQUIRE(F(0.7,1.9) == Approx(d_expected));
+		calculus::code_arena::release(pv,64 + i);
+		REQUIRE(F(0.7,1.9) == Approx(d_expected));
+	}
+}
+
+TEST_CASE("Compiled functions stay callable while other threads compile", "[compiler][arena][threads]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y";
+	Function f = x*y - cos(y);
+	FUNCTION F = f;
+	REQUIRE(F != NULL);
+	const double d_expected = 0.7*1.9 - std::cos(1.9);
+	std::atomic<bool> b_done(false);
+	std::atomic<int> i_failures(0);
+	std::thread caller([&] {
+		while (!b_done.load())
+			if (F(0.7,1.9) != d_expected)
+				i_failures++;
+	});
+	std::vector<std::thread> compilers;
+	for (int t = 0; t < 4; t++)
+		compilers.emplace_back([&,t] {
+			for (int i = 0; i < 50; i++) {
+				Function g = x*cst(t*100 + i + 1.0) + y;
+				FUNCTION G = g;
+				if (!G || (G(0.5,0.25) != 0.5*(t*100 + i + 1.0) + 0.25))
+					i_failures++;
+			}
+		});
+	for (std::thread& th : compilers)
+		th.join();
+	b_done = true;
+	caller.join();
+	REQUIRE(i_failures.load() == 0);
+}
+
+TEST_CASE("Small compiled functions share the pages of the code arena", "[compiler][arena]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y";
+	std::vector<Function> functions;
+	std::vector<FUNCTION> compiled;
+	size_t st_used = calculus::code_arena::get_used_size();
+	for (int i = 0; i < 32; i++) {
+		functions.push_back(x*cst(1000.0 + i) - y);
+		compiled.push_back(functions.back());
+		REQUIRE(compiled.back() != NULL);
+	}
+	REQUIRE(calculus::code_arena::get_used_size() - st_used < 32*1024);
+	for (int i = 0; i < 32; i++)
+		REQUIRE(compiled[i](0.5,0.25) == 0.5*(1000.0 + i) - 0.25);
+}
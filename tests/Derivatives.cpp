@@ -0,0 +1,366 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+#include <tnt/tnt_sparse_matrix_csr.h>
+
+#include <cmath>
+#include <vector>
+
+//CENTRAL DIFFERENCE OF f ALONG ITS VARIABLE i
+static double Difference(const Function& f,const double* pd_point,int i,double d_step = 1e-6) {
+	std::vector<double> q(pd_point,pd_point + f->get_number_of_variables());
+	q[i] += d_step;
+	double d_right = f->eval(q.data());
+	q[i] -= 2*d_step;
+	double d_left = f->eval(q.data());
+	return (d_right - d_left)/(2*d_step);
+}
+
+//CENTRAL DIFFERENCE OF THE GRADIENT ENTRY i ALONG THE VARIABLE j
+static double SecondDifference(const Function& f,const double* pd_point,int i,int j,double d_step = 1e-5) {
+	int n = f->get_number_of_variables();
+	std::vector<double> q(pd_point,pd_point + n), g_right(n), g_left(n);
+	q[j] += d_step;
+	f.gradient(q.data(),g_right.data());
+	q[j] -= 2*d_step;
+	f.gradient(q.data(),g_left.data());
+	return (g_right[i] - g_left[i])/(2*d_step);
+}
+
+//VALUE OF pao AT THE POINT GIVEN FOR vars, pao MAY DEPEND ON A SUBSET OF THEM
+static double EvalAt(calculus::algebraic_operator* pao,calculus::variable** vars,int n,const double* pd_point) {
+	int m = pao->get_number_of_variables();
+	calculus::variable** pv = pao->get_variables();
+	std::vector<double> q(m + 1);
+	for (int k = 0; k < m; k++)
+		for (int c = 0; c < n; c++)
+			if (pv[k] == vars[c])
+				q[k] = pd_point[c];
+	return pao->eval(q.data());
+}
+
+//CENTRAL DIFFERENCE OF pao ALONG vars[j], pao MAY DEPEND ON A SUBSET OF vars
+static double DifferenceAt(calculus::algebraic_operator* pao,calculus::variable** vars,int n,const double* pd_point,int j,double d_step = 1e-6) {
+	std::vector<double> q(pd_point,pd_point + n);
+	q[j] += d_step;
+	double d_right = EvalAt(pao,vars,n,q.data());
+	q[j] -= 2*d_step;
+	double d_left = EvalAt(pao,vars,n,q.data());
+	return (d_right - d_left)/(2*d_step);
+}
+
+static std::vector<Function> Functions() {
+	Variable x = "x", y = "y", z = "z";
+	return { sin(x*y)*exp(z)/(x*x + y), pow(x,y) + INT_POW(3,z)*sqrt(y) - neg(x),
+		tan(x) + asin(z) + acos(z) + atan(y) + log(y) + log10(x), sinh(x)*cosh(y) - tanh(z),
+		_j0(x) + _j1(y) + _jn(3,z) + _y0(y) + _y1(x) + _yn(2,y), x - y/z, INT_POW(0,x) + y };
+}
+
+TEST_CASE("The tape agrees with the tree evaluator", "[tape]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y";
+	std::vector<Function> fs = Functions();
+	Function g = x;
+	for (int i = 0; i < 100; i++)
+		g = g*cst(0.5) + (y*cst(1.01) + (x - y));
+	fs.push_back(g);
+	Function h = x;
+	for (int i = 0; i < 100; i++)
+		h = cst(0.5)*(y - h);
+	fs.push_back(h);
+
+	for (Function& f : fs) {
+		calculus::algebraic_operator* pao = f;
+		for (int k = 0; k < 50; k++) {
+			double p[3] = {0.3 + 0.005*k, 1.1 + 0.01*k, 0.2 + 0.004*k};
+			REQUIRE(pao->eval_tape(p) == Approx(pao->eval(p)).epsilon(1e-13));
+		}
+		REQUIRE(pao->get_tape()->get_instruction_count() > 0);
+	}
+}
+
+TEST_CASE("Gradients agree with finite differences", "[gradient]")
+{
+	initialize_calculus(0);
+	double P[3] = {0.7,1.9,0.45};
+	for (Function& f : Functions()) {
+		int n = f->get_number_of_variables();
+		double g[3];
+		REQUIRE(f.gradient(P,g) == Approx(f->eval(P)).epsilon(1e-12));
+		for (int i = 0; i < n; i++)
+			REQUIRE(g[i] == Approx(Difference(f,P,i)).epsilon(1e-6).margin(1e-6));
+	}
+}
+
+TEST_CASE("Gradients of a long chain agree with finite differences", "[gradient]")
+{
+	initialize_calculus(0);
+	const int N = 200;
+	std::vector<Variable> v(N);
+	char sz_name[16];
+	Function f = cst(0.0);
+	for (int i = 0; i < N; i++) {
+		sprintf(sz_name,"p%03d",i);
+		v[i] = Variable(sz_name);
+	}
+	for (int i = 0; i < N - 1; i++)
+		f = f + INT_POW(2,v[i+1] - v[i]*v[i]) + cos(v[i]);
+	double p[N], g[N];
+	for (int i = 0; i < N; i++)
+		p[i] = 0.01*i;
+	f.gradient(p,g);
+	for (int i = 0; i < N; i += 17)
+		REQUIRE(g[i] == Approx(Difference(f,p,i)).epsilon(1e-6).margin(1e-6));
+}
+
+TEST_CASE("Dual numbers agree with the gradient", "[dual]")
+{
+	initialize_calculus(0);
+	double P[3] = {0.7,1.9,0.45}, D[3] = {0.3,-1.1,0.8};
+	for (Function& f : Functions()) {
+		int n = f->get_number_of_variables();
+		double g[3], d_tangent;
+		double d_value = f.gradient(P,g);
+		REQUIRE(f.eval_dual(P,D,&d_tangent) == Approx(d_value).epsilon(1e-12));
+		double d_jvp = 0;
+		for (int i = 0; i < n; i++)
+			d_jvp += g[i]*D[i];
+		REQUIRE(d_tangent == Approx(d_jvp).epsilon(1e-9).margin(1e-12));
+	}
+}
+
+TEST_CASE("Hessian-vector products agree with finite differences", "[dual]")
+{
+	initialize_calculus(0);
+	double P[3] = {0.7,1.9,0.45};
+	for (Function& f : Functions()) {
+		int n = f->get_number_of_variables();
+		for (int j = 0; j < n; j++) {
+			double D[3] = {0,0,0}, g[3], hv[3];
+			D[j] = 1;
+			f->eval_hessian_vector(P,D,g,hv);
+			for (int i = 0; i < n; i++)
+				REQUIRE(hv[i] == Approx(SecondDifference(f,P,i,j)).epsilon(1e-5).margin(1e-5));
+		}
+	}
+}
+
+TEST_CASE("Compiled Jacobians agree with the partial derivatives", "[jacobian]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y", z = "z", w = "w";
+	calculus::variable* vars[4] = {x,y,z,w};
+	Function fs[] = { sin(x*y)*exp(z)/(x*x + y), INT_POW(3,z)*sqrt(y) - neg(x), x*y*z, cst(2.0), w*w + sin(x*y),
+		pow(x,y), pow(y + z,x)*w };
+	const int N = sizeof(fs)/sizeof(fs[0]);
+	calculus::algebraic_operator* ops[N];
+	for (int i = 0; i < N; i++)
+		ops[i] = fs[i];
+	double P[4] = {0.7,1.9,0.45,-1.3};
+
+	for (int i_layout = 0; i_layout < 2; i_layout++) {
+		calculus::jacobian* J = calculus::jacobian::compile_jacobian(ops,N,vars,4,i_layout);
+		REQUIRE(J != NULL);
+		double out[4*N];
+		//EVERY DENSE ENTRY IS WRITTEN, THE STRUCTURAL ZEROS TOO
+		for (int k = 0; k < 4*N; k++)
+			out[k] = std::nan("");
+		J->eval(P,out);
+		const int* rp = J->get_row_pointers();
+		const int* ci = J->get_column_indices();
+		for (int i = 0; i < N; i++)
+			for (int j = 0; j < 4; j++) {
+				double d_ref = EvalAt(fs[i]->get_partial_derivative(vars[j]),vars,4,P);
+				double d_got = 0;
+				if (i_layout == 1)
+					d_got = out[i*4 + j];
+				else
+					for (int k = rp[i]; k < rp[i+1]; k++)
+						if (ci[k] == j)
+							d_got = out[k];
+				REQUIRE(d_got == Approx(d_ref).epsilon(1e-12));
+				REQUIRE(d_got == Approx(DifferenceAt(fs[i],vars,4,P,j)).epsilon(1e-6).margin(1e-6));
+			}
+		delete J;
+	}
+	calculus::algebraic_operator* o1[1] = {fs[4]};
+	REQUIRE(calculus::jacobian::compile_jacobian(o1,1,vars,3) == NULL);
+	//THE COLUMNS ARE MATCHED BY ID, A COPY OF A VARIABLE NAMES THE SAME COLUMN
+	calculus::variable* copies[4];
+	for (int j = 0; j < 4; j++) {
+		copies[j] = (calculus::variable*)vars[j]->create_copy();
+		copies[j]->addref();
+	}
+	calculus::jacobian* C = calculus::jacobian::compile_jacobian(o1,1,copies,4,1);
+	REQUIRE(C != NULL);
+	double Pw[4] = {0.7,1.9,0.45,-1.3}, dense[4];
+	C->eval(Pw,dense);
+	REQUIRE(dense[0] == Approx(1.9*std::cos(0.7*1.9)).epsilon(1e-12));
+	REQUIRE(dense[1] == Approx(0.7*std::cos(0.7*1.9)).epsilon(1e-12));
+	REQUIRE(dense[2] == 0);
+	REQUIRE(dense[3] == Approx(-2.6).epsilon(1e-12));
+	delete C;
+	for (int j = 0; j < 4; j++)
+		copies[j]->release();
+	//THE CLOSED FORM OF d(x^y) = y*x^(y-1)*dx + x^y*ln(x)*dy
+	calculus::jacobian* J = calculus::jacobian::compile_jacobian(ops + 5,1,vars,2,1);
+	REQUIRE(J != NULL);
+	double Q[2] = {1.7,2.3}, out[2];
+	J->eval(Q,out);
+	REQUIRE(out[0] == Approx(2.3*std::pow(1.7,1.3)).epsilon(1e-12));
+	REQUIRE(out[1] == Approx(std::pow(1.7,2.3)*std::log(1.7)).epsilon(1e-12));
+	delete J;
+}
+
+//THE ENTRY (i,j) OF A SPARSE HESSIAN, ZERO OUTSIDE OF ITS PATTERN
+static double HessianEntry(calculus::sparse_hessian* H,const double* pd_values,int i,int j) {
+	const int* rp = H->get_row_pointers();
+	const int* ci = H->get_column_indices();
+	for (int k = rp[i]; k < rp[i+1]; k++)
+		if (ci[k] == j)
+			return pd_values[k];
+	return 0;
+}
+
+TEST_CASE("Sparse Hessians of the built-in operators match their closed forms", "[hessian]")
+{
+	initialize_calculus(0);
+	Variable x = "x";
+	const double a = 0.4;
+	struct { Function f; double d_second; } unary[] = {
+		{ sin(x), -std::sin(a) }, { cos(x), -std::cos(a) },
+		{ tan(x), 2*std::tan(a)/(std::cos(a)*std::cos(a)) },
+		{ asin(x), a/std::pow(1 - a*a,1.5) }, { acos(x), -a/std::pow(1 - a*a,1.5) },
+		{ atan(x), -2*a/((1 + a*a)*(1 + a*a)) },
+		{ sinh(x), std::sinh(a) }, { cosh(x), std::cosh(a) },
+		{ tanh(x), -2*std::tanh(a)/(std::cosh(a)*std::cosh(a)) },
+		{ exp(x), std::exp(a) }, { log(x), -1/(a*a) }, { log10(x), -1/(a*a*std::log(10.0)) },
+		{ _j0(x), 0.5*(jn(2,a) - j0(a)) }, { _j1(x), 0.25*(jn(3,a) - 3*j1(a)) },
+		{ _jn(1,x), 0.25*(jn(3,a) - 3*j1(a)) }, { _jn(3,x), 0.25*(j1(a) - 2*jn(3,a) + jn(5,a)) },
+		{ _y0(x), 0.5*(yn(2,a) - y0(a)) }, { _y1(x), 0.25*(yn(3,a) - 3*y1(a)) },
+		{ _yn(0,x), 0.5*(yn(2,a) - y0(a)) }, { _yn(4,x), 0.25*(yn(2,a) - 2*yn(4,a) + yn(6,a)) } };
+	for (auto& u : unary) {
+		calculus::sparse_hessian* H = calculus::sparse_hessian::create(u.f);
+		REQUIRE(H != NULL);
+		REQUIRE(H->get_num_vars() == 1);
+		double P[1] = {a}, vals[1];
+		H->eval(P,vals);
+		REQUIRE(HessianEntry(H,vals,0,0) == Approx(u.d_second).epsilon(1e-12));
+		delete H;
+	}
+	//x^y AND sin(x*y), THE COLUMNS ARE get_variables()
+	Variable y = "y";
+	const double X = 1.7, Y = 2.3;
+	Function fs[] = { pow(x,y), sin(x*y) };
+	double d_xx[] = { Y*(Y - 1)*std::pow(X,Y - 2), -Y*Y*std::sin(X*Y) };
+	double d_xy[] = { std::pow(X,Y - 1)*(1 + Y*std::log(X)), std::cos(X*Y) - X*Y*std::sin(X*Y) };
+	double d_yy[] = { std::pow(X,Y)*std::log(X)*std::log(X), -X*X*std::sin(X*Y) };
+	for (int t = 0; t < 2; t++) {
+		calculus::sparse_hessian* H = calculus::sparse_hessian::create(fs[t]);
+		REQUIRE(H != NULL);
+		REQUIRE(H->get_num_vars() == 2);
+		int ix = (fs[t]->get_variables()[0] == (calculus::variable*)x)?0:1, iy = 1 - ix;
+		double P[2], vals[4];
+		P[ix] = X;
+		P[iy] = Y;
+		H->eval(P,vals);
+		REQUIRE(HessianEntry(H,vals,ix,ix) == Approx(d_xx[t]).epsilon(1e-12));
+		REQUIRE(HessianEntry(H,vals,ix,iy) == Approx(d_xy[t]).epsilon(1e-12));
+		REQUIRE(HessianEntry(H,vals,iy,ix) == Approx(d_xy[t]).epsilon(1e-12));
+		REQUIRE(HessianEntry(H,vals,iy,iy) == Approx(d_yy[t]).epsilon(1e-12));
+		delete H;
+	}
+}
+
+TEST_CASE("Compiled Hessians agree with finite differences", "[jacobian]")
+{
+	initialize_calculus(0);
+	const int N = 30;
+	std::vector<Variable> v(N);
+	calculus::variable* vv[N];
+	char sz_name[16];
+	Function f = cst(0.0);
+	for (int i = 0; i < N; i++) {
+		sprintf(sz_name,"h%03d",i);
+		v[i] = Variable(sz_name);
+		vv[i] = v[i];
+	}
+	for (int i = 0; i < N - 1; i++)
+		f = f + INT_POW(2,v[i+1] - v[i]*v[i]) + cos(v[i])*exp(v[i+1]);
+	double p[N];
+	for (int i = 0; i < N; i++)
+		p[i] = 0.01*i;
+	calculus::jacobian* H = calculus::jacobian::compile_hessian(f,vv,N);
+	REQUIRE(H != NULL);
+	std::vector<double> hv(H->get_nonzeros());
+	H->eval(p,hv.data());
+	const int* rp = H->get_row_pointers();
+	const int* ci = H->get_column_indices();
+	for (int i = 0; i < N; i++)
+		for (int k = rp[i]; k < rp[i+1]; k++)
+			REQUIRE(hv[k] == Approx(SecondDifference(f,p,i,ci[k])).epsilon(1e-5).margin(1e-5));
+	delete H;
+}
+
+TEST_CASE("Sparse Hessians agree with finite differences", "[hessian]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y", z = "z", w = "w";
+	Function fs[] = { sin(x*y)*exp(z)/(x*x + y) + w, pow(x,y) + INT_POW(3,z)*sqrt(y) - neg(x) + log(w),
+		x*x + y*y + z*z + w*w, tan(x) + atan(y*z) + cosh(w)*_j1(x) + _yn(2,y) };
+	double P[4] = {0.7,1.9,0.45,1.3};
+	for (Function& f : fs) {
+		calculus::sparse_hessian* H = calculus::sparse_hessian::create(f);
+		REQUIRE(H != NULL);
+		int n = H->get_num_vars();
+		double vals[16], g[4], gref[4];
+		REQUIRE(H->eval(P,vals,g) == Approx(f->eval(P)).epsilon(1e-12));
+		f.gradient(P,gref);
+		const int* rp = H->get_row_pointers();
+		const int* ci = H->get_column_indices();
+		for (int i = 0; i < n; i++) {
+			REQUIRE(g[i] == Approx(gref[i]).epsilon(1e-12));
+			for (int j = 0; j < n; j++) {
+				double d_got = 0;
+				for (int k = rp[i]; k < rp[i+1]; k++)
+					if (ci[k] == j)
+						d_got = vals[k];
+				REQUIRE(d_got == Approx(SecondDifference(f,P,i,j)).epsilon(1e-5).margin(1e-5));
+			}
+		}
+		delete H;
+	}
+}
+
+TEST_CASE("Sparse Hessians come back as TNT compressed row matrices", "[hessian]")
+{
+	initialize_calculus(0);
+	Variable x = "x", y = "y", z = "z", w = "w";
+	Function f = sin(x*y)*exp(z) + w*w + pow(y,z);
+	calculus::sparse_hessian* H = calculus::sparse_hessian::create(f);
+	REQUIRE(H != NULL);
+	int n = H->get_num_vars();
+	double P[4] = {0.7,1.9,0.45,1.3}, vals[16];
+	H->eval(P,vals);
+	TNT::Sparse_Matrix_CompRow<double> M = H->eval_comp_row<TNT::Sparse_Matrix_CompRow<double> >(P);
+	REQUIRE(M.dim1() == n);
+	REQUIRE(M.dim2() == n);
+	REQUIRE(M.NumNonzeros() == H->get_nonzeros());
+	const int* rp = H->get_row_pointers();
+	const int* ci = H->get_column_indices();
+	for (int i = 0; i <= n; i++)
+		REQUIRE(M.row_ptr(i) == rp[i]);
+	for (int k = 0; k < H->get_nonzeros(); k++) {
+		REQUIRE(M.col_ind(k) == ci[k]);
+		REQUIRE(M.val(k) == vals[k]);
+	}
+	//w ONLY MEETS ITSELF
+	int iw = 0;
+	while (f->get_variables()[iw] != (calculus::variable*)w)
+		iw++;
+	REQUIRE(M.row_ptr(iw+1) - M.row_ptr(iw) == 1);
+	REQUIRE(M.col_ind(M.row_ptr(iw)) == iw);
+	REQUIRE(M.val(M.row_ptr(iw)) == Approx(2.0).epsilon(1e-12));
+	delete H;
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace calculus;
+
+static const char* s_psc_formulas[] = {
+	"sin(x)*cos(y)+exp(-x*0.25)/(1+y^2)-sqrt(x*x+1)+log(x+3)*log10(y+4)+tan(x*0.1)+atan(y)",
+	"x^y+sinh(x*0.1)+cosh(y*0.1)+tanh(x)+asin(x*0.1)+acos(y*0.1)",
+	"x*y+2.5",
+};
+
+static std::vector<unsigned char> ReadFile(const char* psc_path) {
+	std::vector<unsigned char> bytes;
+	FILE* pf = fopen(psc_path,"rb");
+	if (!pf)
+		return bytes;
+	int c;
+	while ((c = fgetc(pf)) != EOF)
+		bytes.push_back((unsigned char)c);
+	fclose(pf);
+	return bytes;
+}
+
+static void WriteFile(const char* psc_path,const unsigned char* pb,size_t st_size) {
+	FILE* pf = fopen(psc_path,"wb");
+	fwrite(pb,1,st_size,pf);
+	fclose(pf);
+}
+
+TEST_CASE("Function images load back to the same code", "[images]")
+{
+	initialize_calculus(0);
+	_var("x");
+	_var("y");
+	const char* psc_path = "calculus_test_function.img";
+	const char* psc_copy = "calculus_test_copy.img";
+	for (const char* psc : s_psc_formulas) {
+		algebraic_operator* p = algebra_parser::get_service()->parse_to_algebra(psc);
+		REQUIRE(p != NULL);
+		p->addref();
+		double v[2] = {0.3,0.7};
+		double d_ref = p->eval(v);
+		REQUIRE(p->save_image(psc_path));
+		p->release();
+
+		FUNCTION fn = load_function_image(psc_path);
+		REQUIRE(fn != NULL);
+		REQUIRE(fn(0.3,0.7) == d_ref);
+		IA32_binary* b = IA32_binary::load_image(psc_path);
+		REQUIRE(b != NULL);
+		REQUIRE(b->get_header()->pInstructions(0.3,0.7) == d_ref);
+		REQUIRE(b->save_image(psc_copy));
+		delete b;
+	}
+
+	std::vector<unsigned char> bytes = ReadFile(psc_path);
+	REQUIRE(bytes.size() > 0);
+	for (size_t st_cut = 0; st_cut < bytes.size(); st_cut += 7) {
+		WriteFile(psc_copy,bytes.data(),st_cut);
+		REQUIRE(IA32_binary::load_image(psc_copy) == NULL);
+	}
+	REQUIRE(IA32_binary::load_image("calculus_test_nonexistent.img") == NULL);
+
+	//CODE THAT CALLS BACK INTO AN OPERATOR CAN'T BE RELOCATED
+	variable* x = _var("x");
+	algebraic_operator* q = unary_operators::derivative_operators::__d3pc(x,binary_operators::intrinsic_operators::_multiply(x,_var("y")));
+	q->addref();
+	REQUIRE_FALSE(q->save_image(psc_path));
+	q->release();
+	remove(psc_path);
+	remove(psc_copy);
+}
+
+TEST_CASE("Expression images are evaluated in place", "[images]")
+{
+	initialize_calculus(0);
+	_var("x");
+	_var("y");
+	const char* psc_path = "calculus_test_expressions.img";
+	const char* psc_copy = "calculus_test_truncated.img";
+	const int N = sizeof(s_psc_formulas)/sizeof(s_psc_formulas[0]);
+	algebraic_operator* pp[N + 1];
+	for (int i = 0; i < N; i++) {
+		pp[i] = algebra_parser::get_service()->parse_to_algebra(s_psc_formulas[i]);
+		REQUIRE(pp[i] != NULL);
+		pp[i]->addref();
+	}
+	pp[N] = NULL;
+	REQUIRE(expression_image::save(psc_path,pp,N + 1));
+
+	expression_image* pe = expression_image::load(psc_path);
+	REQUIRE(pe != NULL);
+	REQUIRE(pe->get_count() == N + 1);
+	for (int i = 0; i < N; i++) {
+		expression_view ev = pe->get_expression(i);
+		int n = pp[i]->get_number_of_variables();
+		REQUIRE(ev.get_number_of_variables() == n);
+		double v[2] = {0.3,0.7};
+		for (int j = 0; j < n; j++)
+			REQUIRE(strcmp(ev.get_variable_name(j),pp[i]->get_variables()[j]->get_variable_name()) == 0);
+		REQUIRE(ev.eval(v) == pp[i]->eval(v));
+		algebraic_operator* pa = ev.to_algebra();
+		REQUIRE(pa != NULL);
+		pa->addref();
+		REQUIRE(pa->eval(v) == Approx(pp[i]->eval(v)).epsilon(1e-12));
+		pa->release();
+	}
+	REQUIRE(pe->get_expression(N).get_node_count() == 0);
+	delete pe;
+
+	std::vector<unsigned char> bytes = ReadFile(psc_path);
+	for (size_t st_cut = 0; st_cut < bytes.size(); st_cut += 5) {
+		WriteFile(psc_copy,bytes.data(),st_cut);
+		REQUIRE(expression_image::load(psc_copy) == NULL);
+	}
+	for (int i = 0; i < N; i++)
+		pp[i]->release();
+	remove(psc_path);
+	remove(psc_copy);
+}
@@ -0,0 +1,280 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace calculus;
+
+//VALUE OF pao WITH x = 0.3 AND y = 0.7, WHICHEVER OF THEM IT DEPENDS ON
+static double EvalXY(algebraic_operator* pao) {
+	variable** pv = pao->get_variables();
+	double v[2] = {0,0};
+	for (int i = 0; i < pao->get_number_of_variables(); i++)
+		v[i] = strcmp(pv[i]->get_variable_name(),"x")?0.7:0.3;
+	return pao->eval(v);
+}
+
+TEST_CASE("The parser honours precedence and the registered functions", "[parser]")
+{
+	initialize_calculus(0);
+	_var("x");
+	_var("y");
+	algebra_parser* ap = algebra_parser::get_service();
+	const double X = 0.3, Y = 0.7;
+	struct { const char* psc; double d; } cases[] = {
+		{"1+2*3", 7},
+		{"2^3^2", 512},
+		{"-x^2", -X*X},
+		{"(x+y)*(x-y)", (X+Y)*(X-Y)},
+		{"x/y/2", X/Y/2},
+		{"sin(x)*cos(y)+exp(x*y)/(1+x*x)", std::sin(X)*std::cos(Y) + std::exp(X*Y)/(1 + X*X)},
+		{"sqrt(x)+log(y)+log10(y)", std::sqrt(X) + std::log(Y) + std::log10(Y)},
+		{"tan(x)+asin(x)+acos(y)+atan(y)", std::tan(X) + std::asin(X) + std::acos(Y) + std::atan(Y)},
+		{"sinh(x)-cosh(y)*tanh(x)", std::sinh(X) - std::cosh(Y)*std::tanh(X)},
+		{"x^y", std::pow(X,Y)},
+		{"2.5e-1*x", 0.25*X},
+	};
+	for (auto& c : cases) {
+		PARSE_ERROR pe;
+		algebraic_operator* pao = ap->parse_to_algebra(c.psc,&pe);
+		INFO(c.psc);
+		REQUIRE(pao != NULL);
+		pao->addref();
+		REQUIRE(EvalXY(pao) == Approx(c.d).epsilon(1e-12));
+		pao->release();
+	}
+}
+
+//THE TEXT write_string() GIVES pao
+static std::string Print(algebraic_operator* pao) {
+	std::vector<char> sz(pao->to_string(NULL) + 1);
+	pao->to_string(sz.data());
+	return std::string(sz.data());
+}
+
+TEST_CASE("Every operator parses back from its printed text", "[parser][roundtrip]")
+{
+	initialize_calculus(0);
+	using namespace unary_operators::intrinsic_operators;
+	using namespace unary_operators::trigonometric_operators;
+	using namespace unary_operators::hyperbolic_operators;
+	using namespace unary_operators::bessel_operators;
+	using namespace unary_operators::derivative_operators;
+	using namespace binary_operators::intrinsic_operators;
+	variable* x = _var("x");
+	variable* y = _var("y");
+	algebraic_operator* xy = _multiply(x,_add(y,_cst(0.5)));
+	algebraic_operator* ops[] = {
+		_nop(xy), _neg(xy), _sqrt(xy), _log(y), _log10(y), _exp(xy), _INT_POW(3,xy), _INT_POW(-2,y), _INT_POW(0,x),
+		_sin(xy), _cos(xy), _tan(xy), _asin(x), _acos(x), _atan(xy), _sinh(xy), _cosh(xy), _tanh(xy),
+		__j0(xy), __j1(xy), __jn(3,xy), __y0(xy), __y1(xy), __yn(2,xy),
+		__d3pc(x,_sin(xy)), __d3pf(x,_sin(xy)), __d3pb(y,_sin(xy)), __d5pc(x,_sin(xy)), __d5pf(y,_sin(xy)), __d5pb(x,_sin(xy)),
+		_add(x,y), _subtract(x,y), _multiply(x,y), _divide(x,y), _pow(y,x), _subtract(_cst(-2.5),_divide(xy,_cst(-4))),
+	};
+	algebra_parser* ap = algebra_parser::get_service();
+	for (algebraic_operator* pao : ops) {
+		pao->addref();
+		std::string sz = Print(pao);
+		INFO(sz);
+		PARSE_ERROR pe;
+		algebraic_operator* pp = ap->parse_to_algebra(sz.c_str(),&pe);
+		REQUIRE(pp != NULL);
+		pp->addref();
+		REQUIRE(Print(pp) == sz);
+		REQUIRE(EvalXY(pp) == Approx(EvalXY(pao)).epsilon(1e-9));
+		pp->release();
+		pao->release();
+	}
+	PARSE_ERROR pe;
+	REQUIRE(ap->parse_to_algebra("INT_POW(x,y)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("_jn(x,2)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("INT_POW(x,1e300)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("INT_POW(x,2.5)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("INT_POW(x,inf)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("_jn(1e10,x)",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("_jn(-2147483649,x)",&pe) == NULL);
+	REQUIRE(pe.i_position == 5);
+	REQUIRE(ap->parse_to_algebra("_jn(-2147483648,x)",&pe) != NULL);
+	REQUIRE(ap->parse_to_algebra("_d3pc(sin(x),x*y)",&pe) == NULL);
+	REQUIRE(pe.i_position == 13);
+}
+
+TEST_CASE("Infinite and undefined constants parse back from their printed text", "[parser][roundtrip]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebra_parser* ap = algebra_parser::get_service();
+	algebraic_operator* ops[] = { _cst(HUGE_VAL), _cst(-HUGE_VAL), _cst(NAN),
+		binary_operators::intrinsic_operators::_add(x,_cst(-HUGE_VAL)) };
+	for (algebraic_operator* pao : ops) {
+		pao->addref();
+		std::string sz = Print(pao);
+		INFO(sz);
+		PARSE_ERROR pe;
+		algebraic_operator* pp = ap->parse_to_algebra(sz.c_str(),&pe);
+		REQUIRE(pp != NULL);
+		pp->addref();
+		REQUIRE(Print(pp) == sz);
+		double d = EvalXY(pp), d_ref = EvalXY(pao);
+		if (std::isnan(d_ref))
+			REQUIRE(std::isnan(d));
+		else
+			REQUIRE(d == d_ref);
+		pp->release();
+		pao->release();
+	}
+}
+
+TEST_CASE("The parser refuses text nested deeper than its limit", "[parser]")
+{
+	initialize_calculus(0);
+	_var("x");
+	algebra_parser* ap = algebra_parser::get_service();
+	const int N = 100000;
+	PARSE_ERROR pe;
+	std::string sz = std::string(N,'(') + "x" + std::string(N,')');
+	REQUIRE(ap->parse_to_algebra(sz.c_str(),&pe) == NULL);
+	REQUIRE(pe.psc_message != NULL);
+	REQUIRE(pe.i_position > 0);
+	sz = std::string(N,'-') + "x";
+	REQUIRE(ap->parse_to_algebra(sz.c_str(),&pe) == NULL);
+	REQUIRE(pe.psc_message != NULL);
+	sz = "x";
+	for (int i = 0; i < N; i++)
+		sz += "^x";
+	REQUIRE(ap->parse_to_algebra(sz.c_str(),&pe) == NULL);
+
+	//A PRINTED SUM OF A FEW HUNDRED TERMS IS STILL WELL WITHIN THE LIMIT
+	sz = "x";
+	for (int i = 0; i < 500; i++)
+		sz = "(" + sz + "+1)";
+	algebraic_operator* pao = ap->parse_to_algebra(sz.c_str(),&pe);
+	REQUIRE(pao != NULL);
+	pao->addref();
+	REQUIRE(EvalXY(pao) == Approx(500.3));
+	pao->release();
+}
+
+TEST_CASE("The parser reports where it failed", "[parser]")
+{
+	initialize_calculus(0);
+	_var("x");
+	algebra_parser* ap = algebra_parser::get_service();
+	PARSE_ERROR pe;
+	REQUIRE(ap->parse_to_algebra("x y",&pe) == NULL);
+	REQUIRE(pe.i_position == 2);
+	REQUIRE(pe.psc_message != NULL);
+	REQUIRE(ap->parse_to_algebra("sin(x",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("x+",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("",&pe) == NULL);
+	REQUIRE(ap->parse_to_algebra("nosuch(x)",&pe) == NULL);
+}
+
+TEST_CASE("The parse cache returns the same operator for the same text", "[parser][cache]")
+{
+	initialize_calculus(0);
+	_var("x");
+	_var("y");
+	algebra_parser* ap = algebra_parser::get_service();
+	ap->set_cache_capacity(1000);
+	PARSE_CACHE_STATISTICS st_before, st;
+	ap->get_cache_statistics(&st_before);
+	algebraic_operator* a = ap->parse_cached("sin(x)*cos(y) + exp(x*y)/(1+x*x*x)");
+	algebraic_operator* b = ap->parse_cached("  sin( x ) * cos(y)+exp(x * y) / (1 + x*x*x)  ");
+	REQUIRE(a != NULL);
+	REQUIRE(a == b);
+	ap->get_cache_statistics(&st);
+	REQUIRE(st.st_hits == st_before.st_hits + 1);
+	REQUIRE(st.st_misses == st_before.st_misses + 1);
+	a->release();
+	b->release();
+
+	PARSE_ERROR pe;
+	REQUIRE(ap->parse_cached("x y",&pe) == NULL);
+	REQUIRE(pe.i_position == 2);
+	a = ap->parse_cached("x*1e-5");
+	REQUIRE(a != NULL);
+	REQUIRE(ap->parse_cached("x*1e -5",&pe) == NULL);
+	REQUIRE(ap->parse_cached("x*1e- 5",&pe) == NULL);
+	REQUIRE(ap->parse_cached("x * 1e-5") == a);
+	a->release();
+	a->release();
+	a = ap->parse_cached("x*1e-5 - y");
+	b = ap->parse_cached("x*1e-5-y");
+	REQUIRE(a == b);
+	a->release();
+	b->release();
+
+	ap->set_cache_capacity(4);
+	char sz[64];
+	for (int i = 1; i < 10; i++) {
+		sprintf(sz,"x*%d+y",i);
+		algebraic_operator* p = ap->parse_cached(sz);
+		REQUIRE(p != NULL);
+		REQUIRE(EvalXY(p) == Approx(0.3*i + 0.7));
+		p->release();
+	}
+	ap->get_cache_statistics(&st);
+	REQUIRE(st.st_entries == 4);
+	ap->set_cache_capacity(1000);
+
+	Function f = parse_cached("x*y+1");
+	REQUIRE(f(2.0,3.0) == Approx(7));
+}
+
+TEST_CASE("Formula files are parsed line by line", "[parser][loader]")
+{
+	initialize_calculus(0);
+	const char* psc_path = "calculus_test_formulas.txt";
+	const int N = 500;
+	FILE* pf = fopen(psc_path,"w");
+	REQUIRE(pf != NULL);
+	for (int i = 0; i < N; i++) {
+		if (i%100 == 7)
+			fprintf(pf,"\n");
+		else if (i%100 == 9)
+			fprintf(pf,"sin(x_%d +\n",i%97);
+		else
+			fprintf(pf,"sin(x_%d)*cos(y_%d) + exp(-x_%d*%d.5e-3)/(1+y_%d^2)\r\n",i%97,i%89,i%97,i,i%89);
+	}
+	fprintf(pf,"x_1+y_2");
+	fclose(pf);
+
+	int n;
+	PARSE_ERROR* pe;
+	algebraic_operator** pp = algebra_parser::get_service()->parse_file(psc_path,&n,&pe);
+	REQUIRE(pp != NULL);
+	REQUIRE(n == N + 1);
+	for (int i = 0; i < N; i++) {
+		if (i%100 == 7) {
+			REQUIRE(pp[i] == NULL);
+			REQUIRE(pe[i].psc_message == NULL);
+		} else if (i%100 == 9) {
+			REQUIRE(pp[i] == NULL);
+			REQUIRE(pe[i].psc_message != NULL);
+		} else
+			REQUIRE(pp[i] != NULL);
+	}
+	{
+		variable* x = _var("x_5");
+		variable** pv = pp[5]->get_variables();
+		double v[2];
+		for (int k = 0; k < 2; k++)
+			v[k] = (pv[k] == x)?0.3:0.7;
+		REQUIRE(pp[5]->eval(v) == Approx(std::sin(0.3)*std::cos(0.7) + std::exp(-0.3*5.5e-3)/(1 + 0.49)));
+	}
+	REQUIRE(pp[N]->get_number_of_variables() == 2);
+	algebra_parser::release_lines(pp,n);
+	delete[] pe;
+
+	std::vector<Function> fs = load_functions(psc_path);
+	REQUIRE(fs.size() == (size_t)N + 1);
+	fs.clear();
+	REQUIRE(algebra_parser::get_service()->parse_file("calculus_test_nonexistent.txt",&n) == NULL);
+	remove(psc_path);
+}
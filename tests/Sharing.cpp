@@ -0,0 +1,214 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+
+#include <cmath>
+
+using namespace calculus;
+using namespace calculus::binary_operators::intrinsic_operators;
+using namespace calculus::unary_operators::trigonometric_operators;
+using namespace calculus::unary_operators::hyperbolic_operators;
+
+TEST_CASE("Structurally equal expressions are the same operator", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	variable* y = _var("y");
+	algebraic_operator* a = _add(_sin(x),_multiply(x,y));
+	a->addref();
+	algebraic_operator* b = _add(_sin(x),_multiply(x,y));
+	b->addref();
+	REQUIRE(a == b);
+	REQUIRE(a->equals(b));
+	REQUIRE(a->get_hash() == b->get_hash());
+
+	algebraic_operator* c = _add(_sin(y),_multiply(x,y));
+	c->addref();
+	REQUIRE(c != a);
+	REQUIRE_FALSE(c->equals(a));
+
+	double v[2] = {0.3,0.7};
+	algebraic_operator* d = a->get_partial_derivative(x);
+	algebraic_operator* dd = d->get_partial_derivative(x);
+	REQUIRE(dd->eval(v) == Approx(-std::sin(0.3)));
+	a->release();
+	b->release();
+	c->release();
+}
+
+TEST_CASE("The cons table finds twins by their structural hash", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	//A COPY OF A VARIABLE IS THE SAME VARIABLE, WHAT IS BUILT ON IT IS SHARED WITH WHAT IS BUILT ON THE ORIGINAL
+	algebraic_operator* xc = x->create_copy();
+	xc->addref();
+	REQUIRE(xc != x);
+	REQUIRE(xc->equals(x));
+	algebraic_operator* a = _add(_sin(x),_cst(2.0));
+	a->addref();
+	algebraic_operator* b = _add(_sin(xc),_cst(2.0));
+	b->addref();
+	REQUIRE(b == a);
+	REQUIRE(b->get_hash() == a->get_hash());
+	algebraic_operator* c = _add(_sin(x),_cst(-2.0));
+	c->addref();
+	REQUIRE(c != a);
+	REQUIRE(c->get_hash() != a->get_hash());
+	a->release();
+	b->release();
+	c->release();
+	xc->release();
+}
+
+//COLLECTS THE CONS TABLE ONCE THIS THREAD HOLDS NOTHING BUT THE 0 CONSTANT IN ITS HAND_OUT_RING
+static size_t Collect() {
+	for (int i = 0; i < (int)CONS_HAND_OUT_RING; i++)
+		_cst(0.0);
+	return algebraic_operator::collect_cons_table();
+}
+
+TEST_CASE("Collecting the cons table frees the operators nobody references", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebra_parser::get_service()->set_cache_capacity(0);
+	Collect();
+	size_t st_before = algebraic_operator::get_cons_count();
+	algebraic_operator* a = _add(_cos(_multiply(x,_cst(3.5))),_tan(x));
+	a->addref();
+	REQUIRE(algebraic_operator::get_cons_count() > st_before);
+	a->release();
+	Collect();
+	REQUIRE(algebraic_operator::get_cons_count() == st_before);
+}
+
+TEST_CASE("The last operators handed out to a thread survive a collection", "[cons]")
+{
+	initialize_calculus(0);
+	Collect();
+	size_t st_before = algebraic_operator::get_cons_count();
+	algebraic_operator* a = _cosh(_cst(41.5));
+	algebraic_operator* b = _cosh(_cst(41.5));
+	REQUIRE(b == a);
+	algebraic_operator::collect_cons_table();
+	REQUIRE(algebraic_operator::get_cons_count() == st_before + 2);
+	REQUIRE(a->eval(NULL) == Approx(std::cosh(41.5)));
+	//ONCE THE RING HAS MOVED ON, ONLY A REFERENCE KEEPS AN OPERATOR.  THE 0 CONSTANT MAY GO TOO
+	for (int i = 0; i < (int)CONS_HAND_OUT_RING; i++)
+		_cst(0.5 + i);
+	algebraic_operator::collect_cons_table();
+	size_t st_ring = algebraic_operator::get_cons_count();
+	REQUIRE(st_ring <= st_before + CONS_HAND_OUT_RING);
+	for (int i = 0; i < (int)CONS_HAND_OUT_RING; i++)
+		_cst(-0.5 - i);
+	algebraic_operator::collect_cons_table();
+	REQUIRE(algebraic_operator::get_cons_count() == st_ring);
+}
+
+TEST_CASE("Only a collection frees what the builds released", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebra_parser::get_service()->set_cache_capacity(0);
+	Collect();
+	size_t st_before = algebraic_operator::get_cons_count();
+	for (int i = 0; i < 100000; i++) {
+		algebraic_operator* a = _sin(_multiply(x,_cst(1.0 + i)));
+		a->addref();
+		a->release();
+	}
+	REQUIRE(algebraic_operator::get_cons_count() > st_before + 200000);
+	Collect();
+	REQUIRE(algebraic_operator::get_cons_count() == st_before);
+}
+
+TEST_CASE("A released chain is freed by a single collection", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	Collect();
+	size_t st_before = algebraic_operator::get_cons_count();
+	algebraic_operator* a = x;
+	for (int i = 0; i < 100000; i++)
+		a = _add(_sin(a),_cst(1.0));
+	a->addref();
+	a->release();
+	REQUIRE(Collect() >= 200000);
+	REQUIRE(algebraic_operator::get_cons_count() == st_before);
+}
+
+TEST_CASE("An unreferenced result outlives a Function that adopts and releases its twin", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebraic_operator* p = _sin(x);
+	{ Function g(_sin(x)); }
+	for (int i = 0; i < 5000; i++)
+		Function h(_cst(1000.0 + i));
+	double v = 0.5;
+	REQUIRE(p->eval(&v) == Approx(std::sin(0.5)));
+}
+
+TEST_CASE("Unreferenced results outlive the builds that follow them", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebraic_operator* held[64];
+	for (int i = 0; i < 64; i++)
+		held[i] = _sin(_multiply(x,_cst(-1.0 - i)));
+	for (int i = 0; i < 100000; i++) {
+		algebraic_operator* a = _cos(_multiply(x,_cst(1.0 + i)));
+		a->addref();
+		a->release();
+	}
+	double v[1] = {0.3};
+	for (int i = 0; i < 64; i++) {
+		held[i]->addref();
+		REQUIRE(held[i]->eval(v) == Approx(std::sin(-0.3*(1.0 + i))));
+		REQUIRE(held[i] == _sin(_multiply(x,_cst(-1.0 - i))));
+	}
+	for (int i = 0; i < 64; i++)
+		held[i]->release();
+}
+
+TEST_CASE("The derivative of a power outlives its temporaries", "[cons]")
+{
+	initialize_calculus(0);
+	variable* x = _var("x");
+	algebraic_operator::collect_cons_table();
+	algebraic_operator* a = _pow(x,_cst(2.0));
+	a->addref();
+	algebraic_operator* d = a->get_partial_derivative(x);
+	d->addref();
+	algebraic_operator::collect_cons_table();
+	double v[1] = {0.3};
+	REQUIRE(std::isfinite(d->eval(v)));
+	REQUIRE(a->get_partial_derivative(x) == d);
+	d->release();
+	a->release();
+}
+
+TEST_CASE("Operator blocks go back to the node pool", "[pool]")
+{
+	initialize_calculus(0);
+	Collect();
+	size_t st_before = node_pool::get_outstanding_count(), st_peak;
+	{
+		Variable v[50];
+		char sz_name[16];
+		for (int i = 0; i < 50; i++) {
+			sprintf(sz_name,"n%03d",i);
+			v[i] = Variable(sz_name);
+		}
+		Function f = cst(0.0);
+		for (int i = 0; i < 49; i++)
+			f = f + sin(v[i]*v[i+1]) + exp(v[i] - cst(0.5*i))*cos(v[i+1]);
+		Function d = f->get_partial_derivative(v[3]);
+		st_peak = node_pool::get_outstanding_count();
+		REQUIRE(st_peak > st_before + 500);
+	}
+	//THE VARIABLES STAY REGISTERED AND THE THREAD CACHES KEEP A FEW BLOCKS
+	Collect();
+	REQUIRE(node_pool::get_outstanding_count() < st_before + (st_peak - st_before)/4);
+}
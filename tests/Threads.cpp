@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+
+#include <Calculus.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Parallel evaluation agrees with the tree evaluator", "[threads]")
+{
+	initialize_calculus(0);
+	calculus::thread_pool::restart_service(4);
+	Variable x = "x", y = "y", z = "z";
+	Function f = sin(x*y)*exp(z)/(x*x + y) + INT_POW(3,z)*sqrt(y) + cos(x)*cos(x)*sin(z);
+	const size_t N = 20011;
+	int n = f->get_number_of_variables();
+	std::vector<double> P(N*n), out(N);
+	for (size_t k = 0; k < N; k++)
+		for (int i = 0; i < n; i++)
+			P[k*n + i] = 0.5 + 0.3*std::sin(0.001*k + i);
+	parallel_eval(f,P.data(),N,out.data());
+	for (size_t k = 0; k < N; k++)
+		REQUIRE(out[k] == Approx(f->eval(&P[k*n])).epsilon(1e-12));
+
+	//MORE VARIABLES THAN THE COMPILER TAKES ARGUMENTS, AND SEVERAL CALLERS AT ONCE
+	std::vector<Variable> v(20);
+	char sz_name[16];
+	Function g = cst(0.0);
+	for (int i = 0; i < 20; i++) {
+		sprintf(sz_name,"w%02d",i);
+		v[i] = Variable(sz_name);
+	}
+	for (int i = 0; i < 19; i++)
+		g = g + v[i]*v[i+1];
+	int m = g->get_number_of_variables();
+	const size_t M = 5000;
+	std::vector<double> Q(M*m), o2(M), o3(M);
+	for (size_t k = 0; k < M*m; k++)
+		Q[k] = 0.001*(k%977);
+	std::thread a([&]{ for (int r = 0; r < 20; r++) parallel_eval(g,Q.data(),M,o2.data()); });
+	std::thread b([&]{ for (int r = 0; r < 20; r++) parallel_eval(f,P.data(),10,o3.data()); });
+	a.join();
+	b.join();
+	for (size_t k = 0; k < M; k++)
+		REQUIRE(o2[k] == Approx(g->eval(&Q[k*m])).epsilon(1e-12));
+}
+
+TEST_CASE("A shared expression is differentiated and compiled from many threads", "[threads]")
+{
+	initialize_calculus(0);
+	const int N = 40;
+	std::vector<Variable> v(N);
+	char sz_name[16];
+	for (int i = 0; i < N; i++) {
+		sprintf(sz_name,"q%03d",i);
+		v[i] = Variable(sz_name);
+	}
+	Function f = cst(0.0), g = cst(0.0);
+	for (int i = 0; i < N - 1; i++) {
+		f = f + INT_POW(2,v[i+1] - v[i]*v[i]) + sin(v[i])*exp(v[i+1]*cst(0.1));
+		g = g + INT_POW(2,v[i+1] - v[i]*v[i]) + sin(v[i])*exp(v[i+1]*cst(0.1));
+	}
+	double p[N], gref[N];
+	for (int i = 0; i < N; i++)
+		p[i] = 0.01*i;
+	double d_ref = g.gradient(p,gref);
+
+	std::atomic<int> i_failures(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; t++)
+		threads.emplace_back([&,t] {
+			for (int r = 0; r < 50; r++) {
+				Function h = f;
+				double gr[N], dir[N], gg[N], hv[N];
+				if (std::fabs(h.gradient(p,gr) - d_ref) > 1e-9*(1 + std::fabs(d_ref)))
+					i_failures++;
+				for (int i = 0; i < N; i++)
+					if (std::fabs(gr[i] - gref[i]) > 1e-9*(1 + std::fabs(gref[i])))
+						i_failures++;
+				if (std::fabs(f->eval_tape(p) - d_ref) > 1e-9*(1 + std::fabs(d_ref)))
+					i_failures++;
+				if (!f->compile())
+					i_failures++;
+				f->get_partial_derivative(v[(t + r)%N]);
+				for (int i = 0; i < N; i++)
+					dir[i] = (i == t)?1:0;
+				f->eval_hessian_vector(p,dir,gg,hv);
+			}
+		});
+	for (std::thread& th : threads)
+		th.join();
+	REQUIRE(i_failures.load() == 0);
+}